@@ -15,13 +15,20 @@
 
 #include <cerrno>
 #include <ashmem.h>
+#include <new>
 #include <unordered_map>
 #include <mutex>
+#include <vector>
 #include "ddk_api.h"
+#include "ddk_ashmem_pool.h"
+#include "ddk_map_flags.h"
 #include "ddk_types.h"
 #include "hilog_wrapper.h"
 
 #define PORT_MAX 7
+#define PORT_READ 0x01
+#define PORT_WRITE 0x02
+#define POOL_BLOCK_ALIGNMENT 64
 
 using namespace OHOS::ExternalDeviceManager;
 namespace {
@@ -29,6 +36,24 @@ static std::unordered_map<int32_t, OHOS::sptr<OHOS::Ashmem>> g_shareMemoryMap;
 std::mutex g_mutex;
 }
 
+struct DDK_AshmemPool {
+    DDK_AshmemPool(OHOS::sptr<OHOS::Ashmem> memory, const uint8_t *address, uint32_t blockSize, uint32_t blockCount)
+        : shareMemory(memory), blockSize(blockSize), allocator(blockCount)
+    {
+        // one descriptor per block, handed out for the buffer starting at that block
+        uint32_t size = blockSize * blockCount;
+        buffers.reserve(blockCount);
+        for (uint32_t i = 0; i < blockCount; ++i) {
+            buffers.push_back({shareMemory->GetAshmemFd(), address, size, i * blockSize, 0, 0});
+        }
+    }
+
+    OHOS::sptr<OHOS::Ashmem> shareMemory;
+    uint32_t blockSize;
+    AshmemBlockAllocator allocator;
+    std::vector<DDK_Ashmem> buffers;
+};
+
 DDK_RetCode OH_DDK_CreateAshmem(const uint8_t *name, uint32_t size, DDK_Ashmem **ashmem)
 {
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
@@ -91,10 +116,9 @@ static DDK_RetCode AshmemValidityCheck(DDK_Ashmem *ashmem)
 }
 #endif
 
-DDK_RetCode OH_DDK_MapAshmem(DDK_Ashmem *ashmem, const uint8_t ashmemMapType)
-{
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
-    std::lock_guard<std::mutex> lock(g_mutex);
+static DDK_RetCode MapAshmemInner(DDK_Ashmem *ashmem, const uint8_t ashmemMapType)
+{
     DDK_RetCode ret = AshmemValidityCheck(ashmem);
     if (ret != DDK_SUCCESS) {
         EDM_LOGE(MODULE_BASE_DDK, "%{public}s: check the validity of ashmem fail!", __func__);
@@ -115,6 +139,49 @@ DDK_RetCode OH_DDK_MapAshmem(DDK_Ashmem *ashmem, const uint8_t ashmemMapType)
     ashmem->address =
         reinterpret_cast<const uint8_t *>(g_shareMemoryMap[ashmem->ashmemFd]->ReadFromAshmem(ashmem->size, 0));
     return DDK_SUCCESS;
+}
+#endif
+
+DDK_RetCode OH_DDK_MapAshmem(DDK_Ashmem *ashmem, const uint8_t ashmemMapType)
+{
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    std::lock_guard<std::mutex> lock(g_mutex);
+    return MapAshmemInner(ashmem, ashmemMapType);
+#else
+    return DDK_INVALID_OPERATION;
+#endif
+}
+
+DDK_RetCode OH_DDK_MapAshmemWithFlags(DDK_Ashmem *ashmem, const uint8_t ashmemMapType, uint32_t mapFlags)
+{
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    if ((mapFlags & ~DDK_MAP_FLAG_ALL) != 0) {
+        EDM_LOGE(MODULE_BASE_DDK, "%{public}s: invalid mapFlags = %{public}u", __func__, mapFlags);
+        return DDK_INVALID_PARAMETER;
+    }
+
+    std::lock_guard<std::mutex> lock(g_mutex);
+    DDK_RetCode ret = MapAshmemInner(ashmem, ashmemMapType);
+    if (ret != DDK_SUCCESS || mapFlags == 0) {
+        return ret;
+    }
+
+    // the flags act on the mapped address, a caller that asked for them must not get a mapping without them
+    if (ashmem->address == nullptr) {
+        EDM_LOGE(MODULE_BASE_DDK, "%{public}s: ashmem is not readable, mapFlags cannot be applied", __func__);
+        g_shareMemoryMap[ashmem->ashmemFd]->UnmapAshmem();
+        return DDK_INVALID_OPERATION;
+    }
+
+    int32_t err = ApplyDdkMapFlags(const_cast<uint8_t *>(ashmem->address), ashmem->size, mapFlags,
+        (ashmemMapType & PORT_WRITE) != 0);
+    if (err != 0) {
+        EDM_LOGE(MODULE_BASE_DDK, "%{public}s: lock pages fail! errno = %{public}d", __func__, err);
+        g_shareMemoryMap[ashmem->ashmemFd]->UnmapAshmem();
+        ashmem->address = nullptr;
+        return DDK_FAILURE;
+    }
+    return DDK_SUCCESS;
 #else
     return DDK_INVALID_OPERATION;
 #endif
@@ -157,3 +224,147 @@ DDK_RetCode OH_DDK_DestroyAshmem(DDK_Ashmem *ashmem)
     return DDK_INVALID_OPERATION;
 #endif
 }
+
+DDK_RetCode OH_DDK_CreateAshmemPool(const uint8_t *name, uint32_t blockSize, uint32_t blockCount,
+    const uint8_t ashmemMapType, DDK_AshmemPool **pool)
+{
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    if (name == nullptr || pool == nullptr) {
+        EDM_LOGE(MODULE_BASE_DDK, "invalid pointer of name or pool!");
+        return DDK_INVALID_PARAMETER;
+    }
+
+    uint64_t alignedBlockSize =
+        (static_cast<uint64_t>(blockSize) + POOL_BLOCK_ALIGNMENT - 1) / POOL_BLOCK_ALIGNMENT * POOL_BLOCK_ALIGNMENT;
+    uint64_t size = alignedBlockSize * blockCount;
+    if (size == 0 || size > INT32_MAX) {
+        EDM_LOGE(MODULE_BASE_DDK, "invalid pool size! blockSize = %{public}u, blockCount = %{public}u",
+            blockSize, blockCount);
+        return DDK_INVALID_PARAMETER;
+    }
+
+    if (ashmemMapType > PORT_MAX || (ashmemMapType & PORT_READ) == 0) {
+        EDM_LOGE(MODULE_BASE_DDK, "%{public}s: the ashmemMapType is illegal ,ashmemMapType = %{public}u",
+            __func__, ashmemMapType);
+        return DDK_INVALID_OPERATION;
+    }
+
+    OHOS::sptr<OHOS::Ashmem> shareMemory =
+        OHOS::Ashmem::CreateAshmem(reinterpret_cast<const char*>(name), static_cast<int32_t>(size));
+    if (shareMemory == nullptr) {
+        EDM_LOGE(MODULE_BASE_DDK, "create ashmem failed! errno = %{public}d", errno);
+        return DDK_FAILURE;
+    }
+
+    if (!shareMemory->MapAshmem(ashmemMapType)) {
+        EDM_LOGE(MODULE_BASE_DDK, "MapAshmem fail! errno = %{public}d", errno);
+        return DDK_INVALID_OPERATION;
+    }
+
+    auto address = reinterpret_cast<const uint8_t *>(shareMemory->ReadFromAshmem(static_cast<int32_t>(size), 0));
+    if (address == nullptr) {
+        EDM_LOGE(MODULE_BASE_DDK, "get address of ashmem failed!");
+        return DDK_INVALID_OPERATION;
+    }
+
+    DDK_AshmemPool *ddkPool = new (std::nothrow) DDK_AshmemPool(shareMemory, address,
+        static_cast<uint32_t>(alignedBlockSize), blockCount);
+    if (ddkPool == nullptr) {
+        EDM_LOGE(MODULE_BASE_DDK, "alloc ddk ashmem pool failed!");
+        return DDK_FAILURE;
+    }
+    *pool = ddkPool;
+    return DDK_SUCCESS;
+#else
+    return DDK_INVALID_OPERATION;
+#endif
+}
+
+DDK_RetCode OH_DDK_AllocAshmemBuffer(DDK_AshmemPool *pool, uint32_t size, DDK_Ashmem **buffer)
+{
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    if (pool == nullptr || buffer == nullptr) {
+        EDM_LOGE(MODULE_BASE_DDK, "pool or buffer is nullptr!");
+        return DDK_NULL_PTR;
+    }
+
+    uint64_t blocks = (static_cast<uint64_t>(size) + pool->blockSize - 1) / pool->blockSize;
+    if (blocks == 0 || blocks > AshmemBlockAllocator::MAX_RUN_BLOCKS) {
+        EDM_LOGE(MODULE_BASE_DDK, "invalid buffer size!, size = %{public}u", size);
+        return DDK_INVALID_PARAMETER;
+    }
+
+    uint32_t index = pool->allocator.Alloc(static_cast<uint32_t>(blocks));
+    if (index == AshmemBlockAllocator::INVALID_BLOCK) {
+        EDM_LOGE(MODULE_BASE_DDK, "no free run of %{public}u blocks in pool!", static_cast<uint32_t>(blocks));
+        return DDK_FAILURE;
+    }
+
+    DDK_Ashmem &ddkAshmem = pool->buffers[index];
+    ddkAshmem.offset = index * pool->blockSize;
+    ddkAshmem.bufferLength = size;
+    ddkAshmem.transferredLength = 0;
+    *buffer = &ddkAshmem;
+    return DDK_SUCCESS;
+#else
+    return DDK_INVALID_OPERATION;
+#endif
+}
+
+DDK_RetCode OH_DDK_FreeAshmemBuffer(DDK_AshmemPool *pool, DDK_Ashmem *buffer)
+{
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    if (pool == nullptr || buffer == nullptr) {
+        EDM_LOGE(MODULE_BASE_DDK, "pool or buffer is nullptr!");
+        return DDK_NULL_PTR;
+    }
+
+    uintptr_t begin = reinterpret_cast<uintptr_t>(pool->buffers.data());
+    uintptr_t addr = reinterpret_cast<uintptr_t>(buffer);
+    if (addr < begin || (addr - begin) % sizeof(DDK_Ashmem) != 0 ||
+        (addr - begin) / sizeof(DDK_Ashmem) >= pool->buffers.size()) {
+        EDM_LOGE(MODULE_BASE_DDK, "buffer does not belong to the pool!");
+        return DDK_INVALID_PARAMETER;
+    }
+
+    if (pool->allocator.Free(static_cast<uint32_t>((addr - begin) / sizeof(DDK_Ashmem))) == 0) {
+        EDM_LOGE(MODULE_BASE_DDK, "buffer is not allocated!");
+        return DDK_INVALID_OPERATION;
+    }
+    return DDK_SUCCESS;
+#else
+    return DDK_INVALID_OPERATION;
+#endif
+}
+
+DDK_RetCode OH_DDK_GetAshmemPoolStats(const DDK_AshmemPool *pool, DDK_AshmemPoolStats *stats)
+{
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    if (pool == nullptr || stats == nullptr) {
+        EDM_LOGE(MODULE_BASE_DDK, "pool or stats is nullptr!");
+        return DDK_NULL_PTR;
+    }
+
+    pool->allocator.GetStats(*stats);
+    stats->blockSize = pool->blockSize;
+    return DDK_SUCCESS;
+#else
+    return DDK_INVALID_OPERATION;
+#endif
+}
+
+DDK_RetCode OH_DDK_DestroyAshmemPool(DDK_AshmemPool *pool)
+{
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    if (pool == nullptr) {
+        EDM_LOGE(MODULE_BASE_DDK, "pool is nullptr!");
+        return DDK_NULL_PTR;
+    }
+
+    pool->shareMemory->UnmapAshmem();
+    delete pool;
+    return DDK_SUCCESS;
+#else
+    return DDK_INVALID_OPERATION;
+#endif
+}
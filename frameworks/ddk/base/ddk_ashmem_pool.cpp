@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ddk_ashmem_pool.h"
+
+#include <algorithm>
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr uint64_t FULL_WORD = UINT64_MAX;
+
+uint64_t RunMask(uint32_t blocks)
+{
+    return blocks >= AshmemBlockAllocator::BLOCKS_PER_WORD ? FULL_WORD : ((1ULL << blocks) - 1);
+}
+
+// bit i of the result is set when `blocks` free bits start at bit i
+uint64_t FreeRunStarts(uint64_t word, uint32_t blocks)
+{
+    uint64_t starts = ~word;
+    uint32_t len = 1;
+    while (len < blocks && starts != 0) {
+        uint32_t step = std::min(len, blocks - len);
+        starts &= starts >> step;
+        len += step;
+    }
+    return starts;
+}
+} // namespace
+
+AshmemBlockAllocator::AshmemBlockAllocator(uint32_t blockCount)
+    : blockCount_(blockCount), wordCount_((blockCount + BLOCKS_PER_WORD - 1) / BLOCKS_PER_WORD),
+    bitmap_(std::make_unique<std::atomic<uint64_t>[]>(wordCount_)),
+    runs_(std::make_unique<std::atomic<uint8_t>[]>(blockCount))
+{
+    for (uint32_t i = 0; i < wordCount_; ++i) {
+        bitmap_[i].store(0, std::memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i < blockCount_; ++i) {
+        runs_[i].store(0, std::memory_order_relaxed);
+    }
+    uint32_t tail = blockCount_ % BLOCKS_PER_WORD;
+    if (tail != 0) {
+        // blocks past the end of the pool are never handed out
+        bitmap_[wordCount_ - 1].store(~RunMask(tail), std::memory_order_relaxed);
+    }
+}
+
+uint32_t AshmemBlockAllocator::Alloc(uint32_t blocks)
+{
+    if (blocks == 0 || blocks > MAX_RUN_BLOCKS) {
+        return INVALID_BLOCK;
+    }
+    uint64_t mask = RunMask(blocks);
+    uint32_t start = hint_.load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < wordCount_; ++i) {
+        uint32_t wordIndex = (start + i) % wordCount_;
+        std::atomic<uint64_t> &word = bitmap_[wordIndex];
+        uint64_t cur = word.load(std::memory_order_relaxed);
+        uint64_t starts = FreeRunStarts(cur, blocks);
+        while (starts != 0) {
+            uint32_t shift = static_cast<uint32_t>(__builtin_ctzll(starts));
+            if (word.compare_exchange_weak(cur, cur | (mask << shift), std::memory_order_acquire,
+                std::memory_order_relaxed)) {
+                uint32_t index = wordIndex * BLOCKS_PER_WORD + shift;
+                runs_[index].store(static_cast<uint8_t>(blocks), std::memory_order_relaxed);
+                hint_.store(wordIndex, std::memory_order_relaxed);
+                usedBlocks_.fetch_add(blocks, std::memory_order_relaxed);
+                allocCount_.fetch_add(1, std::memory_order_relaxed);
+                return index;
+            }
+            // cur was reloaded by the failed CAS
+            starts = FreeRunStarts(cur, blocks);
+        }
+    }
+    allocFailures_.fetch_add(1, std::memory_order_relaxed);
+    return INVALID_BLOCK;
+}
+
+uint32_t AshmemBlockAllocator::Free(uint32_t index)
+{
+    if (index >= blockCount_) {
+        return 0;
+    }
+    uint32_t blocks = runs_[index].exchange(0, std::memory_order_relaxed);
+    if (blocks == 0) {
+        return 0;
+    }
+    uint64_t mask = RunMask(blocks) << (index % BLOCKS_PER_WORD);
+    bitmap_[index / BLOCKS_PER_WORD].fetch_and(~mask, std::memory_order_release);
+    usedBlocks_.fetch_sub(blocks, std::memory_order_relaxed);
+    return blocks;
+}
+
+void AshmemBlockAllocator::GetStats(DDK_AshmemPoolStats &stats) const
+{
+    stats.blockCount = blockCount_;
+    stats.usedBlocks = usedBlocks_.load(std::memory_order_relaxed);
+    stats.allocCount = allocCount_.load(std::memory_order_relaxed);
+    stats.allocFailures = allocFailures_.load(std::memory_order_relaxed);
+    stats.largestFreeBlocks = 0;
+    stats.freeRuns = 0;
+    // a buffer never crosses a bitmap word, so runs are measured per word
+    for (uint32_t i = 0; i < wordCount_; ++i) {
+        uint64_t free = ~bitmap_[i].load(std::memory_order_relaxed);
+        while (free != 0) {
+            uint32_t begin = static_cast<uint32_t>(__builtin_ctzll(free));
+            uint64_t rest = free >> begin;
+            uint32_t len = (rest == FULL_WORD) ? BLOCKS_PER_WORD - begin :
+                static_cast<uint32_t>(__builtin_ctzll(~rest));
+            stats.freeRuns++;
+            stats.largestFreeBlocks = std::max(stats.largestFreeBlocks, len);
+            free &= ~(RunMask(len) << begin);
+        }
+    }
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
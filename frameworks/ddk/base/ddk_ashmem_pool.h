@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DDK_ASHMEM_POOL_H
+#define DDK_ASHMEM_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "ddk_types.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+// Lock-free block allocator backing the ashmem pool. Every 64 blocks share one bitmap word and a buffer
+// is a run of consecutive blocks inside a single word, so allocation and release are one CAS each.
+class AshmemBlockAllocator {
+public:
+    static constexpr uint32_t BLOCKS_PER_WORD = 64;
+    static constexpr uint32_t MAX_RUN_BLOCKS = BLOCKS_PER_WORD;
+    static constexpr uint32_t INVALID_BLOCK = UINT32_MAX;
+
+    explicit AshmemBlockAllocator(uint32_t blockCount);
+    ~AshmemBlockAllocator() = default;
+
+    // returns the first block of `blocks` consecutive free blocks, or INVALID_BLOCK
+    uint32_t Alloc(uint32_t blocks);
+    // returns the number of blocks released, 0 if no run starts at `index`
+    uint32_t Free(uint32_t index);
+    // fills everything except blockSize
+    void GetStats(DDK_AshmemPoolStats &stats) const;
+    uint32_t GetBlockCount() const
+    {
+        return blockCount_;
+    }
+
+private:
+    uint32_t blockCount_;
+    uint32_t wordCount_;
+    std::unique_ptr<std::atomic<uint64_t>[]> bitmap_;
+    // run length of each allocated buffer, indexed by its first block
+    std::unique_ptr<std::atomic<uint8_t>[]> runs_;
+    std::atomic<uint32_t> hint_ {0};
+    std::atomic<uint32_t> usedBlocks_ {0};
+    std::atomic<uint64_t> allocCount_ {0};
+    std::atomic<uint64_t> allocFailures_ {0};
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // DDK_ASHMEM_POOL_H
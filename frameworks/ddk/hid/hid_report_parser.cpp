@@ -0,0 +1,479 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hid_report_parser.h"
+
+#include <algorithm>
+#include <endian.h>
+#include <map>
+#include <securec.h>
+#include <tuple>
+#include <utility>
+
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr uint32_t MAX_GLOBAL_STACK_DEPTH = 16;
+constexpr uint32_t MAX_COLLECTION_DEPTH = 32;
+constexpr uint32_t MAX_REPORT_FIELDS = 8192;
+constexpr uint32_t MAX_FIELD_BITS = 32;
+constexpr uint32_t MAX_REPORT_BITS = HID_MAX_REPORT_BUFFER_SIZE * 8;
+constexpr uint32_t REPORT_ID_BITS = 8;
+constexpr uint32_t BITS_PER_BYTE = 8;
+constexpr uint8_t LONG_ITEM_PREFIX = 0xFE;
+constexpr uint8_t LONG_ITEM_HEADER_SIZE = 3;
+constexpr uint8_t ITEM_SIZE_MASK = 0x03;
+constexpr uint8_t ITEM_TYPE_SHIFT = 2;
+constexpr uint8_t ITEM_TYPE_MASK = 0x03;
+constexpr uint8_t ITEM_TAG_SHIFT = 4;
+constexpr uint8_t ITEM_SIZE_FOUR_BYTES = 3;
+constexpr uint32_t USAGE_PAGE_SHIFT = 16;
+constexpr uint32_t USAGE_ID_MASK = 0xFFFF;
+constexpr uint32_t MAIN_FLAGS_MASK = HID_FIELD_FLAG_CONSTANT | HID_FIELD_FLAG_VARIABLE | HID_FIELD_FLAG_RELATIVE |
+    HID_FIELD_FLAG_NULL_STATE;
+
+enum HidItemType : uint8_t {
+    ITEM_TYPE_MAIN = 0,
+    ITEM_TYPE_GLOBAL = 1,
+    ITEM_TYPE_LOCAL = 2,
+};
+
+enum HidMainTag : uint8_t {
+    MAIN_INPUT = 0x8,
+    MAIN_OUTPUT = 0x9,
+    MAIN_COLLECTION = 0xA,
+    MAIN_FEATURE = 0xB,
+    MAIN_END_COLLECTION = 0xC,
+};
+
+enum HidGlobalTag : uint8_t {
+    GLOBAL_USAGE_PAGE = 0x0,
+    GLOBAL_LOGICAL_MIN = 0x1,
+    GLOBAL_LOGICAL_MAX = 0x2,
+    GLOBAL_REPORT_SIZE = 0x7,
+    GLOBAL_REPORT_ID = 0x8,
+    GLOBAL_REPORT_COUNT = 0x9,
+    GLOBAL_PUSH = 0xA,
+    GLOBAL_POP = 0xB,
+};
+
+enum HidLocalTag : uint8_t {
+    LOCAL_USAGE = 0x0,
+    LOCAL_USAGE_MIN = 0x1,
+    LOCAL_USAGE_MAX = 0x2,
+};
+
+struct HidItem {
+    uint8_t type;
+    uint8_t tag;
+    uint8_t size;
+    uint32_t data;
+};
+
+struct GlobalState {
+    uint16_t usagePage = 0;
+    int32_t logicalMin = 0;
+    uint32_t logicalMaxRaw = 0;
+    uint8_t logicalMaxSize = 0;
+    uint32_t reportSize = 0;
+    uint32_t reportCount = 0;
+    uint8_t reportId = 0;
+};
+
+// usages are kept as (page << 16 | id) so that extended usages carry their own page
+struct LocalState {
+    std::vector<uint32_t> usages;
+    uint32_t usageMin = 0;
+    uint32_t usageMax = 0;
+    bool hasUsageMin = false;
+    bool hasUsageMax = false;
+};
+
+class DescriptorParser {
+public:
+    explicit DescriptorParser(Hid_ReportLayout &layout) : layout_(layout) {}
+    int32_t Run(const uint8_t *descriptor, uint32_t length);
+
+private:
+    bool HandleMain(const HidItem &item);
+    bool HandleGlobal(const HidItem &item);
+    bool HandleLocal(const HidItem &item);
+    bool AddFields(uint8_t reportType, uint32_t mainFlags);
+    uint32_t FieldUsage(uint32_t index, bool isVariable) const;
+    int32_t LogicalMax() const;
+    uint32_t ToUsage(const HidItem &item) const;
+    void BuildIndex();
+
+    Hid_ReportLayout &layout_;
+    GlobalState global_;
+    std::vector<GlobalState> globalStack_;
+    LocalState local_;
+    uint32_t collectionDepth_ = 0;
+    std::map<std::pair<uint8_t, uint8_t>, uint32_t> bitOffsets_;
+};
+
+static bool ReadItem(const uint8_t *descriptor, uint32_t length, uint32_t &pos, HidItem &item, bool &isLongItem)
+{
+    uint8_t prefix = descriptor[pos];
+    if (prefix == LONG_ITEM_PREFIX) {
+        if (pos + 1 >= length) {
+            return false;
+        }
+        uint32_t itemLength = LONG_ITEM_HEADER_SIZE + descriptor[pos + 1];
+        if (itemLength > length - pos) {
+            return false;
+        }
+        pos += itemLength;
+        isLongItem = true;
+        return true;
+    }
+    isLongItem = false;
+    uint8_t sizeCode = prefix & ITEM_SIZE_MASK;
+    item.size = (sizeCode == ITEM_SIZE_FOUR_BYTES) ? sizeof(uint32_t) : sizeCode;
+    item.type = (prefix >> ITEM_TYPE_SHIFT) & ITEM_TYPE_MASK;
+    item.tag = prefix >> ITEM_TAG_SHIFT;
+    if (item.size > length - pos - 1) {
+        return false;
+    }
+    item.data = 0;
+    for (uint8_t i = 0; i < item.size; ++i) {
+        item.data |= static_cast<uint32_t>(descriptor[pos + 1 + i]) << (i * BITS_PER_BYTE);
+    }
+    pos += 1 + item.size;
+    return true;
+}
+
+static int32_t SignExtend(uint32_t value, uint8_t size)
+{
+    if (size == 0 || size >= sizeof(uint32_t)) {
+        return static_cast<int32_t>(value);
+    }
+    uint32_t bits = size * BITS_PER_BYTE;
+    uint32_t signBit = 1U << (bits - 1);
+    return static_cast<int32_t>((value ^ signBit) - signBit);
+}
+
+int32_t DescriptorParser::Run(const uint8_t *descriptor, uint32_t length)
+{
+    uint32_t pos = 0;
+    while (pos < length) {
+        HidItem item = {};
+        bool isLongItem = false;
+        if (!ReadItem(descriptor, length, pos, item, isLongItem)) {
+            EDM_LOGE(MODULE_HID_DDK, "truncated item at %{public}u", pos);
+            return HID_DDK_INVALID_PARAMETER;
+        }
+        if (isLongItem) {
+            continue;
+        }
+        bool ret = false;
+        switch (item.type) {
+            case ITEM_TYPE_MAIN:
+                ret = HandleMain(item);
+                break;
+            case ITEM_TYPE_GLOBAL:
+                ret = HandleGlobal(item);
+                break;
+            case ITEM_TYPE_LOCAL:
+                ret = HandleLocal(item);
+                break;
+            default:
+                ret = true;
+                break;
+        }
+        if (!ret) {
+            EDM_LOGE(MODULE_HID_DDK, "invalid item type %{public}u tag %{public}u", item.type, item.tag);
+            return HID_DDK_INVALID_PARAMETER;
+        }
+    }
+    if (collectionDepth_ != 0) {
+        EDM_LOGE(MODULE_HID_DDK, "unbalanced collection");
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    BuildIndex();
+    return HID_DDK_SUCCESS;
+}
+
+bool DescriptorParser::HandleMain(const HidItem &item)
+{
+    bool ret = true;
+    switch (item.tag) {
+        case MAIN_INPUT:
+            ret = AddFields(HID_INPUT_REPORT, item.data);
+            break;
+        case MAIN_OUTPUT:
+            ret = AddFields(HID_OUTPUT_REPORT, item.data);
+            break;
+        case MAIN_FEATURE:
+            ret = AddFields(HID_FEATURE_REPORT, item.data);
+            break;
+        case MAIN_COLLECTION:
+            ret = ++collectionDepth_ <= MAX_COLLECTION_DEPTH;
+            break;
+        case MAIN_END_COLLECTION:
+            ret = collectionDepth_ > 0;
+            collectionDepth_ = ret ? collectionDepth_ - 1 : 0;
+            break;
+        default:
+            break;
+    }
+    local_ = LocalState();
+    return ret;
+}
+
+bool DescriptorParser::HandleGlobal(const HidItem &item)
+{
+    switch (item.tag) {
+        case GLOBAL_USAGE_PAGE:
+            global_.usagePage = static_cast<uint16_t>(item.data & USAGE_ID_MASK);
+            break;
+        case GLOBAL_LOGICAL_MIN:
+            global_.logicalMin = SignExtend(item.data, item.size);
+            break;
+        case GLOBAL_LOGICAL_MAX:
+            global_.logicalMaxRaw = item.data;
+            global_.logicalMaxSize = item.size;
+            break;
+        case GLOBAL_REPORT_SIZE:
+            global_.reportSize = item.data;
+            break;
+        case GLOBAL_REPORT_ID:
+            if (item.data == 0 || item.data > UINT8_MAX) {
+                return false;
+            }
+            global_.reportId = static_cast<uint8_t>(item.data);
+            layout_.useReportId = true;
+            break;
+        case GLOBAL_REPORT_COUNT:
+            global_.reportCount = item.data;
+            break;
+        case GLOBAL_PUSH:
+            if (globalStack_.size() >= MAX_GLOBAL_STACK_DEPTH) {
+                return false;
+            }
+            globalStack_.push_back(global_);
+            break;
+        case GLOBAL_POP:
+            if (globalStack_.empty()) {
+                return false;
+            }
+            global_ = globalStack_.back();
+            globalStack_.pop_back();
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+uint32_t DescriptorParser::ToUsage(const HidItem &item) const
+{
+    if (item.size == sizeof(uint32_t)) {
+        return item.data;
+    }
+    return (static_cast<uint32_t>(global_.usagePage) << USAGE_PAGE_SHIFT) | (item.data & USAGE_ID_MASK);
+}
+
+bool DescriptorParser::HandleLocal(const HidItem &item)
+{
+    switch (item.tag) {
+        case LOCAL_USAGE:
+            if (local_.usages.size() >= MAX_REPORT_FIELDS) {
+                return false;
+            }
+            local_.usages.push_back(ToUsage(item));
+            break;
+        case LOCAL_USAGE_MIN:
+            local_.usageMin = ToUsage(item);
+            local_.hasUsageMin = true;
+            break;
+        case LOCAL_USAGE_MAX:
+            local_.usageMax = ToUsage(item);
+            local_.hasUsageMax = true;
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+int32_t DescriptorParser::LogicalMax() const
+{
+    int32_t logicalMax = SignExtend(global_.logicalMaxRaw, global_.logicalMaxSize);
+    // devices commonly declare e.g. 0..255 with a one byte maximum, which only makes sense unsigned
+    if (global_.logicalMin >= 0 && logicalMax < global_.logicalMin) {
+        return static_cast<int32_t>(global_.logicalMaxRaw);
+    }
+    return logicalMax;
+}
+
+uint32_t DescriptorParser::FieldUsage(uint32_t index, bool isVariable) const
+{
+    bool hasRange = local_.hasUsageMin && local_.hasUsageMax;
+    if (!isVariable) {
+        if (local_.hasUsageMin) {
+            return local_.usageMin;
+        }
+        return local_.usages.empty() ? 0 : local_.usages.front();
+    }
+    if (!local_.usages.empty()) {
+        return local_.usages[std::min<size_t>(index, local_.usages.size() - 1)];
+    }
+    if (hasRange) {
+        uint32_t span = local_.usageMax >= local_.usageMin ? local_.usageMax - local_.usageMin : 0;
+        return local_.usageMin + std::min(index, span);
+    }
+    return 0;
+}
+
+bool DescriptorParser::AddFields(uint8_t reportType, uint32_t mainFlags)
+{
+    auto key = std::make_pair(reportType, global_.reportId);
+    auto iter = bitOffsets_.find(key);
+    if (iter == bitOffsets_.end()) {
+        iter = bitOffsets_.emplace(key, global_.reportId != 0 ? REPORT_ID_BITS : 0).first;
+    }
+    uint32_t &bitOffset = iter->second;
+    uint64_t totalBits = static_cast<uint64_t>(global_.reportSize) * global_.reportCount;
+    if (totalBits > MAX_REPORT_BITS - bitOffset) {
+        EDM_LOGE(MODULE_HID_DDK, "report %{public}u exceeds max report size", global_.reportId);
+        return false;
+    }
+    bool isConstant = (mainFlags & HID_FIELD_FLAG_CONSTANT) != 0;
+    if (isConstant || global_.reportSize == 0 || global_.reportSize > MAX_FIELD_BITS) {
+        // padding, or fields too wide to decode into int32_t, only occupy space in the report
+        bitOffset += static_cast<uint32_t>(totalBits);
+        return true;
+    }
+    if (layout_.fields.size() + global_.reportCount > MAX_REPORT_FIELDS) {
+        EDM_LOGE(MODULE_HID_DDK, "too many report fields");
+        return false;
+    }
+    bool isVariable = (mainFlags & HID_FIELD_FLAG_VARIABLE) != 0;
+    uint16_t flags = static_cast<uint16_t>(mainFlags & MAIN_FLAGS_MASK);
+    int32_t logicalMax = LogicalMax();
+    if (global_.logicalMin < 0) {
+        flags |= HID_FIELD_FLAG_SIGNED;
+    }
+    for (uint32_t i = 0; i < global_.reportCount; ++i) {
+        uint32_t usage = FieldUsage(i, isVariable);
+        Hid_ReportField field = {
+            .reportType = reportType,
+            .reportId = global_.reportId,
+            .flags = flags,
+            .usagePage = static_cast<uint16_t>(usage >> USAGE_PAGE_SHIFT),
+            .usage = static_cast<uint16_t>(usage & USAGE_ID_MASK),
+            .bitOffset = bitOffset,
+            .bitSize = global_.reportSize,
+            .logicalMin = global_.logicalMin,
+            .logicalMax = logicalMax,
+        };
+        layout_.fields.push_back(field);
+        bitOffset += global_.reportSize;
+    }
+    return true;
+}
+
+void DescriptorParser::BuildIndex()
+{
+    std::stable_sort(layout_.fields.begin(), layout_.fields.end(),
+        [](const Hid_ReportField &lhs, const Hid_ReportField &rhs) {
+            return std::tie(lhs.reportType, lhs.reportId) < std::tie(rhs.reportType, rhs.reportId);
+        });
+    layout_.inputReports.fill(HidReportRange());
+    for (uint32_t i = 0; i < layout_.fields.size(); ++i) {
+        const Hid_ReportField &field = layout_.fields[i];
+        if (field.reportType != HID_INPUT_REPORT) {
+            continue;
+        }
+        HidReportRange &range = layout_.inputReports[field.reportId];
+        if (range.begin == range.end) {
+            range.begin = i;
+        }
+        range.end = i + 1;
+        uint32_t endByte = (field.bitOffset + field.bitSize + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
+        range.minLength = std::max(range.minLength, endByte);
+    }
+}
+
+// loads the up to 39 bits spanned by a field with one little-endian word read, no per-bit loop
+static inline int32_t ExtractField(const uint8_t *report, uint32_t length, const Hid_ReportField &field)
+{
+    uint32_t byteOffset = field.bitOffset / BITS_PER_BYTE;
+    uint32_t shift = field.bitOffset % BITS_PER_BYTE;
+    uint64_t raw = 0;
+    if (length - byteOffset >= sizeof(raw)) {
+        (void)memcpy_s(&raw, sizeof(raw), report + byteOffset, sizeof(raw));
+        raw = le64toh(raw);
+    } else {
+        for (uint32_t i = 0; i < length - byteOffset; ++i) {
+            raw |= static_cast<uint64_t>(report[byteOffset + i]) << (i * BITS_PER_BYTE);
+        }
+    }
+    raw >>= shift;
+    if (field.bitSize == MAX_FIELD_BITS) {
+        return static_cast<int32_t>(static_cast<uint32_t>(raw));
+    }
+    uint32_t mask = (1U << field.bitSize) - 1;
+    uint32_t value = static_cast<uint32_t>(raw) & mask;
+    if ((field.flags & HID_FIELD_FLAG_SIGNED) != 0) {
+        uint32_t signBit = 1U << (field.bitSize - 1);
+        value = (value ^ signBit) - signBit;
+    }
+    return static_cast<int32_t>(value);
+}
+} // namespace
+
+int32_t HidReportParser::Parse(const uint8_t *descriptor, uint32_t length, Hid_ReportLayout &layout)
+{
+    layout.fields.clear();
+    layout.useReportId = false;
+    DescriptorParser parser(layout);
+    return parser.Run(descriptor, length);
+}
+
+int32_t HidReportParser::DecodeInput(const Hid_ReportLayout &layout, const uint8_t *report, uint32_t length,
+    int32_t *values, uint32_t valueCount, uint32_t &firstField, uint32_t &decodedCount)
+{
+    if (length == 0) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    uint8_t reportId = layout.useReportId ? report[0] : 0;
+    const HidReportRange &range = layout.inputReports[reportId];
+    if (range.begin == range.end) {
+        EDM_LOGE(MODULE_HID_DDK, "report id %{public}u is not described", reportId);
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    if (length < range.minLength) {
+        EDM_LOGE(MODULE_HID_DDK, "report too short: %{public}u < %{public}u", length, range.minLength);
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    uint32_t count = range.end - range.begin;
+    if (valueCount < count) {
+        EDM_LOGE(MODULE_HID_DDK, "value buffer too small: %{public}u < %{public}u", valueCount, count);
+        return HID_DDK_MEMORY_ERROR;
+    }
+    const Hid_ReportField *fields = layout.fields.data() + range.begin;
+    for (uint32_t i = 0; i < count; ++i) {
+        values[i] = ExtractField(report, length, fields[i]);
+    }
+    firstField = range.begin;
+    decodedCount = count;
+    return HID_DDK_SUCCESS;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HID_REPORT_PARSER_H
+#define HID_REPORT_PARSER_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "hid_ddk_types.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+struct HidReportRange {
+    uint32_t begin = 0;
+    uint32_t end = 0;
+    uint32_t minLength = 0;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+
+struct Hid_ReportLayout {
+    std::vector<Hid_ReportField> fields;
+    // input fields of each report id, indexed by report id
+    std::array<OHOS::ExternalDeviceManager::HidReportRange, UINT8_MAX + 1> inputReports;
+    bool useReportId = false;
+};
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+class HidReportParser {
+public:
+    static int32_t Parse(const uint8_t *descriptor, uint32_t length, Hid_ReportLayout &layout);
+    static int32_t DecodeInput(const Hid_ReportLayout &layout, const uint8_t *report, uint32_t length,
+        int32_t *values, uint32_t valueCount, uint32_t &firstField, uint32_t &decodedCount);
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // HID_REPORT_PARSER_H
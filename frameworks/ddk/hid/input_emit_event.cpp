@@ -14,17 +14,26 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
+#include <condition_variable>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <iproxy_broker.h>
 #include <memory.h>
 #include <securec.h>
+#include <shared_mutex>
+#include <sys/eventfd.h>
+#include <thread>
+#include <unistd.h>
 #include <unordered_map>
 #include <vector>
 
 #include "hid_ddk_api.h"
+#include "ext_dev_api_histogram.h"
 #include "hid_ddk_types.h"
+#include "hid_report_parser.h"
 #include "v1_1/ihid_ddk.h"
 #include "hilog_wrapper.h"
 #include "ipc_error_code.h"
@@ -34,7 +43,10 @@ using namespace OHOS::ExternalDeviceManager;
 namespace {
 static OHOS::sptr<OHOS::HDI::Input::Ddk::V1_1::IHidDdk> g_ddk = nullptr;
 static OHOS::sptr<IRemoteObject::DeathRecipient> recipient_ = nullptr;
-std::mutex g_mutex;
+// exclusive for connect/create/destroy, shared for event emission so devices do not serialize on each other
+std::shared_mutex g_mutex;
+// when set, the service is taken in-process from here instead of the HDF service manager
+std::function<OHOS::sptr<OHOS::HDI::Input::Ddk::V1_1::IHidDdk>()> g_ddkFactory = nullptr;
 
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
 constexpr uint32_t MAX_EMIT_ITEM_NUM = 20;
@@ -45,9 +57,24 @@ constexpr uint32_t MAX_HID_ABS_LEN = 26;
 constexpr uint32_t MAX_HID_REL_BITS_LEN = 13;
 constexpr uint32_t MAX_HID_MISC_EVENT_LEN = 6;
 constexpr uint32_t MAX_NAME_LENGTH = 80;
+constexpr uint32_t RX_QUEUE_SLOTS = 256;
+constexpr int32_t RX_POLL_TIMEOUT_MS = 1000;
+static_assert(sizeof(Hid_EmitItem) == sizeof(OHOS::HDI::Input::Ddk::V1_0::Hid_EmitItem),
+    "Hid_EmitItem must share the layout of the HDI emit item");
 #endif
 
 }
+
+void SetDdk(OHOS::sptr<OHOS::HDI::Input::Ddk::V1_1::IHidDdk> &ddk)
+{
+    g_ddk = ddk;
+}
+
+void SetDdkFactory(std::function<OHOS::sptr<OHOS::HDI::Input::Ddk::V1_1::IHidDdk>()> factory)
+{
+    g_ddkFactory = factory;
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -61,6 +88,21 @@ struct TempDevice {
 
 struct Hid_DeviceHandle {
     OHOS::HDI::Input::Ddk::V1_1::HidDeviceHandle impl;
+    // reused by OH_Hid_Read/OH_Hid_ReadTimeout so that reads do not allocate
+    std::mutex readMutex;
+    std::vector<uint8_t> readBuff;
+    // read event mode: a receive thread queues reports into fixed size slots and signals eventFd
+    int32_t eventFd = -1;
+    std::thread rxThread;
+    std::atomic<bool> rxRunning {false};
+    std::mutex rxMutex;
+    std::condition_variable rxCond;
+    uint32_t rxSlotSize = 0;
+    std::vector<uint8_t> rxSlots;
+    std::vector<uint32_t> rxSizes;
+    uint32_t rxHead = 0;
+    uint32_t rxCount = 0;
+    int32_t rxError = 0;
 
     Hid_DeviceHandle()
     {
@@ -69,6 +111,10 @@ struct Hid_DeviceHandle {
     }
 } __attribute__ ((aligned(8)));
 
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+static void StopReadEvent(Hid_DeviceHandle *dev);
+#endif
+
 Hid_DeviceHandle *NewHidDeviceHandle(void)
 {
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
@@ -82,6 +128,7 @@ void DeleteHidDeviceHandle(Hid_DeviceHandle **dev)
 {
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (*dev != nullptr) {
+        StopReadEvent(*dev);
         delete *dev;
         *dev = nullptr;
     }
@@ -98,6 +145,147 @@ static int32_t TransToHidCode(int32_t ret)
     }
     return ret;
 }
+
+static void NotifyReadEvent(Hid_DeviceHandle *dev)
+{
+    uint64_t value = 1;
+    if (write(dev->eventFd, &value, sizeof(value)) != sizeof(value) && errno != EAGAIN) {
+        EDM_LOGW(MODULE_HID_DDK, "notify read event failed, errno=%{public}d", errno);
+    }
+}
+
+static void ClearReadEvent(Hid_DeviceHandle *dev)
+{
+    uint64_t value = 0;
+    (void)read(dev->eventFd, &value, sizeof(value));
+}
+
+static void RxLoop(Hid_DeviceHandle *dev)
+{
+    std::vector<uint8_t> report(dev->rxSlotSize);
+    while (dev->rxRunning.load()) {
+        {
+            std::unique_lock<std::mutex> lock(dev->rxMutex);
+            dev->rxCond.wait(lock, [dev] { return !dev->rxRunning.load() || dev->rxCount < RX_QUEUE_SLOTS; });
+        }
+        auto ddk = g_ddk;
+        if (!dev->rxRunning.load()) {
+            break;
+        }
+        uint32_t bytesRead = 0;
+        int32_t ret = (ddk == nullptr) ? HID_DDK_INIT_ERROR :
+            TransToHidCode(ddk->ReadTimeout(dev->impl, report, dev->rxSlotSize, RX_POLL_TIMEOUT_MS, bytesRead));
+        std::lock_guard<std::mutex> lock(dev->rxMutex);
+        if (ret == HID_DDK_TIMEOUT) {
+            continue;
+        }
+        if (ret != HID_DDK_SUCCESS) {
+            EDM_LOGE(MODULE_HID_DDK, "rx loop read error: %{public}d", ret);
+            dev->rxError = ret;
+            NotifyReadEvent(dev);
+            break;
+        }
+        if (bytesRead == 0) {
+            continue;
+        }
+        uint32_t tail = (dev->rxHead + dev->rxCount) % RX_QUEUE_SLOTS;
+        uint32_t size = std::min(bytesRead, dev->rxSlotSize);
+        if (memcpy_s(dev->rxSlots.data() + tail * dev->rxSlotSize, dev->rxSlotSize, report.data(), size) != EOK) {
+            EDM_LOGE(MODULE_HID_DDK, "memcpy_s failed");
+            continue;
+        }
+        dev->rxSizes[tail] = size;
+        dev->rxCount++;
+        NotifyReadEvent(dev);
+    }
+}
+
+static void StopReadEvent(Hid_DeviceHandle *dev)
+{
+    if (dev->eventFd < 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(dev->rxMutex);
+        dev->rxRunning.store(false);
+    }
+    dev->rxCond.notify_all();
+    if (dev->rxThread.joinable()) {
+        dev->rxThread.join();
+    }
+    close(dev->eventFd);
+    dev->eventFd = -1;
+    dev->rxSlots.clear();
+    dev->rxSlots.shrink_to_fit();
+    dev->rxSizes.clear();
+    dev->rxHead = 0;
+    dev->rxCount = 0;
+    dev->rxError = 0;
+}
+
+// pops queued reports back to back into data; must be called with rxMutex held
+static int32_t PopReports(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSize, uint32_t *reportSizes,
+    uint32_t maxReports, uint32_t &reportCount, uint32_t &totalBytes)
+{
+    reportCount = 0;
+    totalBytes = 0;
+    while (dev->rxCount > 0 && reportCount < maxReports) {
+        uint32_t size = dev->rxSizes[dev->rxHead];
+        if (size > bufSize - totalBytes) {
+            break;
+        }
+        if (memcpy_s(data + totalBytes, bufSize - totalBytes, dev->rxSlots.data() + dev->rxHead * dev->rxSlotSize,
+            size) != EOK) {
+            EDM_LOGE(MODULE_HID_DDK, "memcpy_s failed");
+            return HID_DDK_MEMORY_ERROR;
+        }
+        if (reportSizes != nullptr) {
+            reportSizes[reportCount] = size;
+        }
+        totalBytes += size;
+        reportCount++;
+        dev->rxHead = (dev->rxHead + 1) % RX_QUEUE_SLOTS;
+        dev->rxCount--;
+    }
+    if (reportCount > 0) {
+        dev->rxCond.notify_one();
+    }
+    if (dev->rxCount == 0) {
+        if (dev->rxError != 0) {
+            return reportCount > 0 ? HID_DDK_SUCCESS : dev->rxError;
+        }
+        ClearReadEvent(dev);
+    } else if (reportCount == 0) {
+        EDM_LOGE(MODULE_HID_DDK, "buffer too small for the next report");
+        return HID_DDK_MEMORY_ERROR;
+    }
+    return HID_DDK_SUCCESS;
+}
+
+static int32_t ReadFromQueue(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSize, uint32_t *bytesRead)
+{
+    std::lock_guard<std::mutex> lock(dev->rxMutex);
+    uint32_t reportCount = 0;
+    return PopReports(dev, data, bufSize, nullptr, 1, reportCount, *bytesRead);
+}
+
+static int32_t ReadToBuffer(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSize, int timeout,
+    uint32_t *bytesRead)
+{
+    std::lock_guard<std::mutex> lock(dev->readMutex);
+    std::vector<uint8_t> &readData = dev->readBuff;
+    readData.resize(bufSize);
+    int32_t ret = TransToHidCode(g_ddk->ReadTimeout(dev->impl, readData, bufSize, timeout, *bytesRead));
+    if (ret != HID_DDK_SUCCESS) {
+        return ret;
+    }
+    errno_t err = memcpy_s(data, bufSize, readData.data(), *bytesRead);
+    if (err != EOK) {
+        EDM_LOGE(MODULE_HID_DDK, "memcpy_s failed");
+        return HID_DDK_MEMORY_ERROR;
+    }
+    return HID_DDK_SUCCESS;
+}
 #endif
 
 class HidDeathRecipient : public IRemoteObject::DeathRecipient {
@@ -107,7 +295,7 @@ public:
 
 void HidDeathRecipient::OnRemoteDied(const wptr<IRemoteObject> &object)
 {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    std::lock_guard<std::shared_mutex> lock(g_mutex);
     EDM_LOGI(MODULE_HID_DDK, "hid_ddk remote died");
     if (g_ddk != nullptr) {
         sptr<IRemoteObject> remote = OHOS::HDI::hdi_objcast<OHOS::HDI::Input::Ddk::V1_0::IHidDdk>(g_ddk);
@@ -121,18 +309,22 @@ void HidDeathRecipient::OnRemoteDied(const wptr<IRemoteObject> &object)
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
 static uint32_t GetRealDeviceId(int32_t deviceId)
 {
-    if (g_deviceMap.find(deviceId) != g_deviceMap.end()) {
-        if (g_deviceMap[deviceId] != nullptr) {
-            return g_deviceMap[deviceId]->realId;
-        }
+    auto iter = g_deviceMap.find(deviceId);
+    if (iter != g_deviceMap.end() && iter->second != nullptr) {
+        return iter->second->realId;
     }
     return static_cast<uint32_t>(deviceId);
 }
 
+static OHOS::sptr<OHOS::HDI::Input::Ddk::V1_1::IHidDdk> GetHidDdk(void)
+{
+    return g_ddkFactory != nullptr ? g_ddkFactory() : OHOS::HDI::Input::Ddk::V1_1::IHidDdk::Get();
+}
+
 static int32_t Connect(void)
 {
     if (g_ddk == nullptr) {
-        g_ddk = OHOS::HDI::Input::Ddk::V1_1::IHidDdk::Get();
+        g_ddk = GetHidDdk();
         if (g_ddk == nullptr) {
             EDM_LOGE(MODULE_HID_DDK, "get hid ddk faild");
             return HID_DDK_FAILURE;
@@ -142,6 +334,10 @@ static int32_t Connect(void)
                 (void)g_ddk->CreateDevice(value->tempDevice, value->tempProperties, value->realId);
             }
         }
+        if (g_ddkFactory != nullptr) {
+            // an in-process service is not a proxy, there is no remote to watch
+            return HID_DDK_SUCCESS;
+        }
         recipient_ = new HidDeathRecipient();
         sptr<IRemoteObject> remote = OHOS::HDI::hdi_objcast<OHOS::HDI::Input::Ddk::V1_1::IHidDdk>(g_ddk);
         if (!remote->AddDeathRecipient(recipient_)) {
@@ -266,8 +462,9 @@ static bool CheckHidDevice(Hid_Device *hidDevice)
 
 int32_t OH_Hid_CreateDevice(Hid_Device *hidDevice, Hid_EventProperties *hidEventProperties)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
-    std::lock_guard<std::mutex> lock(g_mutex);
+    std::lock_guard<std::shared_mutex> lock(g_mutex);
     if (Connect() != HID_DDK_SUCCESS) {
         return HID_DDK_INVALID_OPERATION;
     }
@@ -324,10 +521,22 @@ int32_t OH_Hid_CreateDevice(Hid_Device *hidDevice, Hid_EventProperties *hidEvent
 
 int32_t OH_Hid_EmitEvent(int32_t deviceId, const Hid_EmitItem items[], uint16_t length)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
-    std::lock_guard<std::mutex> lock(g_mutex);
-    if (Connect() != HID_DDK_SUCCESS) {
-        return HID_DDK_INVALID_OPERATION;
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    if (g_ddk == nullptr) {
+        lock.unlock();
+        {
+            std::lock_guard<std::shared_mutex> connectLock(g_mutex);
+            if (Connect() != HID_DDK_SUCCESS) {
+                return HID_DDK_INVALID_OPERATION;
+            }
+        }
+        lock.lock();
+        if (g_ddk == nullptr) {
+            EDM_LOGE(MODULE_HID_DDK, "hid ddk died while connecting");
+            return HID_DDK_INVALID_OPERATION;
+        }
     }
 
     if (deviceId < 0) {
@@ -345,10 +554,10 @@ int32_t OH_Hid_EmitEvent(int32_t deviceId, const Hid_EmitItem items[], uint16_t
         return HID_DDK_INVALID_PARAMETER;
     }
 
-    std::vector<OHOS::HDI::Input::Ddk::V1_0::Hid_EmitItem> itemsTemp;
-    std::transform(items, items + length, std::back_inserter(itemsTemp), [](Hid_EmitItem item) {
-        return *reinterpret_cast<OHOS::HDI::Input::Ddk::V1_0::Hid_EmitItem *>(&item);
-    });
+    // the layouts are identical, so the caller array is copied in one block into a per-thread buffer
+    thread_local std::vector<OHOS::HDI::Input::Ddk::V1_0::Hid_EmitItem> itemsTemp;
+    auto first = reinterpret_cast<const OHOS::HDI::Input::Ddk::V1_0::Hid_EmitItem *>(items);
+    itemsTemp.assign(first, first + length);
 
     auto ret = g_ddk->EmitEvent(GetRealDeviceId(deviceId), itemsTemp);
     ret = (ret == HDF_ERR_NOPERM) ? HID_DDK_NO_PERM : ret;
@@ -364,8 +573,9 @@ int32_t OH_Hid_EmitEvent(int32_t deviceId, const Hid_EmitItem items[], uint16_t
 
 int32_t OH_Hid_DestroyDevice(int32_t deviceId)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
-    std::lock_guard<std::mutex> lock(g_mutex);
+    std::lock_guard<std::shared_mutex> lock(g_mutex);
     if (Connect() != HID_DDK_SUCCESS) {
         return HID_DDK_INVALID_OPERATION;
     }
@@ -386,8 +596,9 @@ int32_t OH_Hid_DestroyDevice(int32_t deviceId)
 
 int32_t OH_Hid_Init(void)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
-    g_ddk = OHOS::HDI::Input::Ddk::V1_1::IHidDdk::Get();
+    g_ddk = GetHidDdk();
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "get ddk failed");
         return HID_DDK_INIT_ERROR;
@@ -401,6 +612,7 @@ int32_t OH_Hid_Init(void)
 
 int32_t OH_Hid_Release(void)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "ddk is null");
@@ -417,6 +629,7 @@ int32_t OH_Hid_Release(void)
 
 int32_t OH_Hid_Open(uint64_t deviceId, uint8_t interfaceIndex, Hid_DeviceHandle **dev)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -441,6 +654,7 @@ int32_t OH_Hid_Open(uint64_t deviceId, uint8_t interfaceIndex, Hid_DeviceHandle
 
 int32_t OH_Hid_Close(Hid_DeviceHandle **dev)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -451,6 +665,7 @@ int32_t OH_Hid_Close(Hid_DeviceHandle **dev)
         return HID_DDK_INVALID_PARAMETER;
     }
 
+    StopReadEvent(*dev);
     int32_t ret = g_ddk->Close((*dev)->impl);
     DeleteHidDeviceHandle(dev);
 
@@ -462,6 +677,7 @@ int32_t OH_Hid_Close(Hid_DeviceHandle **dev)
 
 int32_t OH_Hid_Write(Hid_DeviceHandle *dev, uint8_t *data, uint32_t length, uint32_t *bytesWritten)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -489,6 +705,7 @@ int32_t OH_Hid_Write(Hid_DeviceHandle *dev, uint8_t *data, uint32_t length, uint
 
 int32_t OH_Hid_ReadTimeout(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSize, int timeout, uint32_t *bytesRead)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -501,17 +718,14 @@ int32_t OH_Hid_ReadTimeout(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSiz
         return HID_DDK_INVALID_PARAMETER;
     }
 
-    std::vector<uint8_t> readData(bufSize);
-    int32_t ret = TransToHidCode(g_ddk->ReadTimeout(dev->impl, readData, bufSize, timeout, *bytesRead));
+    if (dev->eventFd >= 0) {
+        return ReadFromQueue(dev, data, bufSize, bytesRead);
+    }
+    int32_t ret = ReadToBuffer(dev, data, bufSize, timeout, bytesRead);
     if (ret != HID_DDK_SUCCESS) {
         EDM_LOGE(MODULE_HID_DDK, "read timeout failed");
         return ret;
     }
-    errno_t err = memcpy_s(data, bufSize, readData.data(), *bytesRead);
-    if (err != EOK) {
-        EDM_LOGE(MODULE_HID_DDK, "memcpy_s failed");
-        return HID_DDK_MEMORY_ERROR;
-    }
 
     return HID_DDK_SUCCESS;
 #else
@@ -521,6 +735,7 @@ int32_t OH_Hid_ReadTimeout(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSiz
 
 int32_t OH_Hid_Read(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSize, uint32_t *bytesRead)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -533,18 +748,14 @@ int32_t OH_Hid_Read(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSize, uint
         return HID_DDK_INVALID_PARAMETER;
     }
 
-    std::vector<uint8_t> readData(bufSize);
-    int32_t ret = TransToHidCode(g_ddk->ReadTimeout(dev->impl, readData, bufSize, (dev->impl.nonBlock) ? 0 : -1,
-        *bytesRead));
+    if (dev->eventFd >= 0) {
+        return ReadFromQueue(dev, data, bufSize, bytesRead);
+    }
+    int32_t ret = ReadToBuffer(dev, data, bufSize, (dev->impl.nonBlock) ? 0 : -1, bytesRead);
     if (ret != HID_DDK_SUCCESS) {
         EDM_LOGE(MODULE_HID_DDK, "read failed");
         return ret;
     }
-    errno_t err = memcpy_s(data, bufSize, readData.data(), *bytesRead);
-    if (err != EOK) {
-        EDM_LOGE(MODULE_HID_DDK, "memcpy_s failed");
-        return HID_DDK_MEMORY_ERROR;
-    }
 
     return HID_DDK_SUCCESS;
 #else
@@ -554,6 +765,7 @@ int32_t OH_Hid_Read(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSize, uint
 
 int32_t OH_Hid_SetNonBlocking(Hid_DeviceHandle *dev, int nonBlock)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -577,6 +789,7 @@ int32_t OH_Hid_SetNonBlocking(Hid_DeviceHandle *dev, int nonBlock)
 
 int32_t OH_Hid_GetRawInfo(Hid_DeviceHandle *dev, Hid_RawDevInfo *rawDevInfo)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -607,6 +820,7 @@ int32_t OH_Hid_GetRawInfo(Hid_DeviceHandle *dev, Hid_RawDevInfo *rawDevInfo)
 
 int32_t OH_Hid_GetRawName(Hid_DeviceHandle *dev, char *data, uint32_t bufSize)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -639,6 +853,7 @@ int32_t OH_Hid_GetRawName(Hid_DeviceHandle *dev, char *data, uint32_t bufSize)
 
 int32_t OH_Hid_GetPhysicalAddress(Hid_DeviceHandle *dev, char *data, uint32_t bufSize)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -671,6 +886,7 @@ int32_t OH_Hid_GetPhysicalAddress(Hid_DeviceHandle *dev, char *data, uint32_t bu
 
 int32_t OH_Hid_GetRawUniqueId(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSize)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -703,6 +919,7 @@ int32_t OH_Hid_GetRawUniqueId(Hid_DeviceHandle *dev, uint8_t *data, uint32_t buf
 
 int32_t OH_Hid_SendReport(Hid_DeviceHandle *dev, Hid_ReportType reportType, const uint8_t *data, uint32_t length)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -730,6 +947,7 @@ int32_t OH_Hid_SendReport(Hid_DeviceHandle *dev, Hid_ReportType reportType, cons
 
 int32_t OH_Hid_GetReport(Hid_DeviceHandle *dev, Hid_ReportType reportType, uint8_t *data, uint32_t bufSize)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -764,6 +982,7 @@ int32_t OH_Hid_GetReport(Hid_DeviceHandle *dev, Hid_ReportType reportType, uint8
 
 int32_t OH_Hid_GetReportDescriptor(Hid_DeviceHandle *dev, uint8_t *buf, uint32_t bufSize, uint32_t *bytesRead)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_HID_DDK, "invalid obj");
@@ -795,6 +1014,151 @@ int32_t OH_Hid_GetReportDescriptor(Hid_DeviceHandle *dev, uint8_t *buf, uint32_t
 #endif
 }
 
+int32_t OH_Hid_StartReadEvent(Hid_DeviceHandle *dev, uint32_t maxReportSize, int32_t *eventFd)
+{
+    EXT_DEV_API_TIMER();
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    if (g_ddk == nullptr) {
+        EDM_LOGE(MODULE_HID_DDK, "invalid obj");
+        return HID_DDK_INIT_ERROR;
+    }
+
+    if (dev == nullptr || maxReportSize == 0 || maxReportSize > HID_MAX_REPORT_BUFFER_SIZE || eventFd == nullptr) {
+        EDM_LOGE(MODULE_HID_DDK, "invalid param");
+        return HID_DDK_INVALID_PARAMETER;
+    }
+
+    if (dev->eventFd >= 0) {
+        *eventFd = dev->eventFd;
+        return HID_DDK_SUCCESS;
+    }
+    int32_t fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        EDM_LOGE(MODULE_HID_DDK, "eventfd failed, errno=%{public}d", errno);
+        return HID_DDK_MEMORY_ERROR;
+    }
+    dev->rxSlotSize = maxReportSize;
+    dev->rxSlots.assign(static_cast<size_t>(maxReportSize) * RX_QUEUE_SLOTS, 0);
+    dev->rxSizes.assign(RX_QUEUE_SLOTS, 0);
+    dev->rxHead = 0;
+    dev->rxCount = 0;
+    dev->rxError = 0;
+    dev->eventFd = fd;
+    dev->rxRunning.store(true);
+    dev->rxThread = std::thread(RxLoop, dev);
+    pthread_setname_np(dev->rxThread.native_handle(), "hid_rx");
+    *eventFd = fd;
+    return HID_DDK_SUCCESS;
+#else
+    return HID_DDK_INVALID_OPERATION;
+#endif
+}
+
+int32_t OH_Hid_StopReadEvent(Hid_DeviceHandle *dev)
+{
+    EXT_DEV_API_TIMER();
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    if (dev == nullptr) {
+        EDM_LOGE(MODULE_HID_DDK, "invalid param");
+        return HID_DDK_INVALID_PARAMETER;
+    }
+
+    if (dev->eventFd < 0) {
+        EDM_LOGE(MODULE_HID_DDK, "read event not started");
+        return HID_DDK_INVALID_OPERATION;
+    }
+    StopReadEvent(dev);
+    return HID_DDK_SUCCESS;
+#else
+    return HID_DDK_INVALID_OPERATION;
+#endif
+}
+
+int32_t OH_Hid_ReadReports(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSize, uint32_t *reportSizes,
+    uint32_t maxReports, uint32_t *reportCount)
+{
+    EXT_DEV_API_TIMER();
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    if (dev == nullptr || data == nullptr || bufSize == 0 || reportSizes == nullptr || maxReports == 0 ||
+        reportCount == nullptr) {
+        EDM_LOGE(MODULE_HID_DDK, "invalid param");
+        return HID_DDK_INVALID_PARAMETER;
+    }
+
+    if (dev->eventFd < 0) {
+        EDM_LOGE(MODULE_HID_DDK, "read event not started");
+        return HID_DDK_INVALID_OPERATION;
+    }
+    std::lock_guard<std::mutex> lock(dev->rxMutex);
+    uint32_t totalBytes = 0;
+    return PopReports(dev, data, bufSize, reportSizes, maxReports, *reportCount, totalBytes);
+#else
+    return HID_DDK_INVALID_OPERATION;
+#endif
+}
+
+int32_t OH_Hid_CreateReportLayout(const uint8_t *descriptor, uint32_t length, Hid_ReportLayout **layout)
+{
+    EXT_DEV_API_TIMER();
+    if (descriptor == nullptr || length == 0 || length > HID_MAX_REPORT_BUFFER_SIZE || layout == nullptr) {
+        EDM_LOGE(MODULE_HID_DDK, "invalid param");
+        return HID_DDK_INVALID_PARAMETER;
+    }
+
+    auto tmpLayout = new (std::nothrow) Hid_ReportLayout;
+    if (tmpLayout == nullptr) {
+        EDM_LOGE(MODULE_HID_DDK, "malloc failed, errno=%{public}d", errno);
+        return HID_DDK_MEMORY_ERROR;
+    }
+    int32_t ret = HidReportParser::Parse(descriptor, length, *tmpLayout);
+    if (ret != HID_DDK_SUCCESS) {
+        EDM_LOGE(MODULE_HID_DDK, "parse report descriptor failed");
+        delete tmpLayout;
+        return ret;
+    }
+    *layout = tmpLayout;
+    return HID_DDK_SUCCESS;
+}
+
+int32_t OH_Hid_GetReportFields(const Hid_ReportLayout *layout, const Hid_ReportField **fields, uint32_t *count)
+{
+    EXT_DEV_API_TIMER();
+    if (layout == nullptr || fields == nullptr || count == nullptr) {
+        EDM_LOGE(MODULE_HID_DDK, "invalid param");
+        return HID_DDK_INVALID_PARAMETER;
+    }
+
+    *fields = layout->fields.data();
+    *count = static_cast<uint32_t>(layout->fields.size());
+    return HID_DDK_SUCCESS;
+}
+
+int32_t OH_Hid_DecodeInputReport(const Hid_ReportLayout *layout, const uint8_t *report, uint32_t length,
+    int32_t *values, uint32_t valueCount, uint32_t *firstField, uint32_t *decodedCount)
+{
+    EXT_DEV_API_TIMER();
+    if (layout == nullptr || report == nullptr || values == nullptr || firstField == nullptr ||
+        decodedCount == nullptr) {
+        EDM_LOGE(MODULE_HID_DDK, "invalid param");
+        return HID_DDK_INVALID_PARAMETER;
+    }
+
+    return HidReportParser::DecodeInput(*layout, report, length, values, valueCount, *firstField, *decodedCount);
+}
+
+int32_t OH_Hid_DestroyReportLayout(Hid_ReportLayout **layout)
+{
+    EXT_DEV_API_TIMER();
+    if (layout == nullptr || *layout == nullptr) {
+        EDM_LOGE(MODULE_HID_DDK, "invalid param");
+        return HID_DDK_INVALID_PARAMETER;
+    }
+
+    delete *layout;
+    *layout = nullptr;
+    return HID_DDK_SUCCESS;
+}
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
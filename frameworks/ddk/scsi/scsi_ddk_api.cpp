@@ -15,6 +15,7 @@
 
 #include "scsi_peripheral_api.h"
 #include <cerrno>
+#include <functional>
 #include <iproxy_broker.h>
 #include <memory.h>
 #include <mutex>
@@ -27,6 +28,7 @@
 #include <unordered_map>
 
 #include "edm_errors.h"
+#include "ext_dev_api_histogram.h"
 #include "hilog_wrapper.h"
 #include "ipc_error_code.h"
 #include "scsi_peripheral_types.h"
@@ -38,6 +40,8 @@ namespace {
 OHOS::sptr<OHOS::HDI::Usb::ScsiDdk::V1_0::IScsiPeripheralDdk> g_ddk = nullptr;
 static OHOS::sptr<IRemoteObject::DeathRecipient> recipient_ = nullptr;
 std::mutex g_mutex;
+// when set, OH_ScsiPeripheral_Init takes an in-process service from here instead of the HDF service manager
+std::function<OHOS::sptr<OHOS::HDI::Usb::ScsiDdk::V1_0::IScsiPeripheralDdk>()> g_ddkFactory = nullptr;
 
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
 constexpr uint8_t ONE_BYTE = 1;
@@ -109,6 +113,11 @@ void SetDdk(OHOS::sptr<OHOS::HDI::Usb::ScsiDdk::V1_0::IScsiPeripheralDdk> &ddk)
     g_ddk = ddk;
 }
 
+void SetDdkFactory(std::function<OHOS::sptr<OHOS::HDI::Usb::ScsiDdk::V1_0::IScsiPeripheralDdk>()> factory)
+{
+    g_ddkFactory = factory;
+}
+
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
 static int32_t TransToDdkErrCode(int32_t ret)
 {
@@ -295,13 +304,19 @@ void ScsiPeripheralDeathRecipient::OnRemoteDied(const wptr<IRemoteObject> &objec
 
 int32_t OH_ScsiPeripheral_Init(void)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
-    auto ddk = OHOS::HDI::Usb::ScsiDdk::V1_0::IScsiPeripheralDdk::Get();
+    bool inProcess = g_ddkFactory != nullptr;
+    auto ddk = inProcess ? g_ddkFactory() : OHOS::HDI::Usb::ScsiDdk::V1_0::IScsiPeripheralDdk::Get();
     SetDdk(ddk);
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "get ddk failed");
         return SCSIPERIPHERAL_DDK_INIT_ERROR;
     }
+    if (inProcess) {
+        // an in-process service is not a proxy, there is no remote to watch
+        return TransToDdkErrCode(g_ddk->Init());
+    }
     recipient_ = new ScsiPeripheralDeathRecipient();
     sptr<IRemoteObject> remote = OHOS::HDI::hdi_objcast<OHOS::HDI::Usb::ScsiDdk::V1_0::IScsiPeripheralDdk>(g_ddk);
     if (!remote->AddDeathRecipient(recipient_)) {
@@ -316,6 +331,7 @@ int32_t OH_ScsiPeripheral_Init(void)
 
 int32_t OH_ScsiPeripheral_Release(void)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "ddk is null");
@@ -332,6 +348,7 @@ int32_t OH_ScsiPeripheral_Release(void)
 
 int32_t OH_ScsiPeripheral_Open(uint64_t deviceId, uint8_t interfaceIndex, ScsiPeripheral_Device **dev)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "invalid obj");
@@ -356,6 +373,7 @@ int32_t OH_ScsiPeripheral_Open(uint64_t deviceId, uint8_t interfaceIndex, ScsiPe
 
 int32_t OH_ScsiPeripheral_Close(ScsiPeripheral_Device **dev)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "invalid obj");
@@ -383,6 +401,7 @@ int32_t OH_ScsiPeripheral_Close(ScsiPeripheral_Device **dev)
 int32_t OH_ScsiPeripheral_TestUnitReady(ScsiPeripheral_Device *dev, ScsiPeripheral_TestUnitReadyRequest *request,
     ScsiPeripheral_Response *response)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "invalid obj");
@@ -411,6 +430,7 @@ int32_t OH_ScsiPeripheral_TestUnitReady(ScsiPeripheral_Device *dev, ScsiPeripher
 int32_t OH_ScsiPeripheral_Inquiry(ScsiPeripheral_Device *dev, ScsiPeripheral_InquiryRequest *request,
     ScsiPeripheral_InquiryInfo *inquiryInfo, ScsiPeripheral_Response *response)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "invalid obj");
@@ -467,6 +487,7 @@ int32_t OH_ScsiPeripheral_Inquiry(ScsiPeripheral_Device *dev, ScsiPeripheral_Inq
 int32_t OH_ScsiPeripheral_ReadCapacity10(ScsiPeripheral_Device *dev, ScsiPeripheral_ReadCapacityRequest *request,
     ScsiPeripheral_CapacityInfo *capacityInfo, ScsiPeripheral_Response *response)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "invalid obj");
@@ -501,6 +522,7 @@ int32_t OH_ScsiPeripheral_ReadCapacity10(ScsiPeripheral_Device *dev, ScsiPeriphe
 int32_t OH_ScsiPeripheral_RequestSense(ScsiPeripheral_Device *dev, ScsiPeripheral_RequestSenseRequest *request,
     ScsiPeripheral_Response *response)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "invalid obj");
@@ -529,6 +551,7 @@ int32_t OH_ScsiPeripheral_RequestSense(ScsiPeripheral_Device *dev, ScsiPeriphera
 int32_t OH_ScsiPeripheral_Read10(ScsiPeripheral_Device *dev, ScsiPeripheral_IORequest *request,
     ScsiPeripheral_Response *response)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     EDM_LOGD(MODULE_SCSIPERIPHERAL_DDK, "Read10 start");
     if (g_ddk == nullptr) {
@@ -562,6 +585,7 @@ int32_t OH_ScsiPeripheral_Read10(ScsiPeripheral_Device *dev, ScsiPeripheral_IORe
 int32_t OH_ScsiPeripheral_Write10(ScsiPeripheral_Device *dev, ScsiPeripheral_IORequest *request,
     ScsiPeripheral_Response *response)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "invalid obj");
@@ -594,6 +618,7 @@ int32_t OH_ScsiPeripheral_Write10(ScsiPeripheral_Device *dev, ScsiPeripheral_IOR
 int32_t OH_ScsiPeripheral_Verify10(ScsiPeripheral_Device *dev, ScsiPeripheral_VerifyRequest *request,
     ScsiPeripheral_Response *response)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "invalid obj");
@@ -629,6 +654,7 @@ int32_t OH_ScsiPeripheral_Verify10(ScsiPeripheral_Device *dev, ScsiPeripheral_Ve
 int32_t OH_ScsiPeripheral_SendRequestByCdb(ScsiPeripheral_Device *dev, ScsiPeripheral_Request *request,
     ScsiPeripheral_Response *response)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     EDM_LOGD(MODULE_SCSIPERIPHERAL_DDK, "SendRequestByCDB start");
     if (g_ddk == nullptr) {
@@ -670,6 +696,7 @@ int32_t OH_ScsiPeripheral_SendRequestByCdb(ScsiPeripheral_Device *dev, ScsiPerip
 int32_t OH_ScsiPeripheral_CreateDeviceMemMap(ScsiPeripheral_Device *dev, size_t size,
     ScsiPeripheral_DeviceMemMap **devMmap)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (dev == nullptr || devMmap == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "param is null");
@@ -702,6 +729,7 @@ int32_t OH_ScsiPeripheral_CreateDeviceMemMap(ScsiPeripheral_Device *dev, size_t
 
 int32_t OH_ScsiPeripheral_DestroyDeviceMemMap(ScsiPeripheral_DeviceMemMap *devMmap)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (devMmap == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "devMmap is nullptr");
@@ -723,6 +751,7 @@ int32_t OH_ScsiPeripheral_DestroyDeviceMemMap(ScsiPeripheral_DeviceMemMap *devMm
 int32_t OH_ScsiPeripheral_ParseBasicSenseInfo(uint8_t *senseData, uint8_t senseDataLen,
     ScsiPeripheral_BasicSenseInfo *senseInfo)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (senseData == nullptr || senseInfo == nullptr) {
         EDM_LOGE(MODULE_SCSIPERIPHERAL_DDK, "param is null");
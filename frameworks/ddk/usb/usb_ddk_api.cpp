@@ -14,7 +14,10 @@
  */
 
 #include "usb_ddk_api.h"
+#include <algorithm>
+#include <ashmem.h>
 #include <cerrno>
+#include <functional>
 #include <memory.h>
 #include <securec.h>
 #include <sys/mman.h>
@@ -22,7 +25,9 @@
 #include <vector>
 #include <unordered_map>
 
+#include "ddk_map_flags.h"
 #include "edm_errors.h"
+#include "ext_dev_api_histogram.h"
 #include "hilog_wrapper.h"
 #include "usb_config_desc_parser.h"
 #include "usb_ddk_types.h"
@@ -44,8 +49,21 @@ std::unordered_map<int32_t, int32_t> g_errorMap = {
     {HDF_ERR_TIMEOUT, USB_DDK_TIMEOUT}
 };
 std::unordered_map<uint8_t*, int32_t> g_fdMap;
+constexpr uint8_t USB_ENDPOINT_DIR_MASK = 0x80;
+// when set, OH_Usb_Init takes the service from here instead of the HDF service manager
+std::function<OHOS::sptr<OHOS::HDI::Usb::Ddk::V1_2::IUsbDdk>()> g_ddkFactory = nullptr;
 } // namespace
 
+void SetDdk(OHOS::sptr<OHOS::HDI::Usb::Ddk::V1_2::IUsbDdk> &ddk)
+{
+    g_ddk = ddk;
+}
+
+void SetDdkFactory(std::function<OHOS::sptr<OHOS::HDI::Usb::Ddk::V1_2::IUsbDdk>()> factory)
+{
+    g_ddkFactory = factory;
+}
+
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
 static int32_t TransToUsbCode(int32_t ret, int32_t defaultCode = USB_DDK_SUCCESS)
 {
@@ -57,12 +75,51 @@ static int32_t TransToUsbCode(int32_t ret, int32_t defaultCode = USB_DDK_SUCCESS
         return ret;
     }
 }
+
+// The service is only known to use a whole ashmem from offset 0, so a buffer that is part of a larger ashmem, such
+// as one from an ashmem pool, is sent through an ashmem of its own and copied back after an IN transfer.
+static int32_t SendPipeRequestWithSubBuffer(
+    const OHOS::HDI::Usb::Ddk::V1_2::UsbRequestPipe &pipe, DDK_Ashmem *ashmem)
+{
+    if (ashmem->bufferLength == 0) {
+        EDM_LOGE(MODULE_USB_DDK, "sub buffer is empty");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+    uint8_t *data = const_cast<uint8_t *>(ashmem->address) + ashmem->offset;
+    OHOS::sptr<OHOS::Ashmem> memory = OHOS::Ashmem::CreateAshmem("usb_ddk_sub_buffer", ashmem->bufferLength);
+    if (memory == nullptr || !memory->MapReadAndWriteAshmem()) {
+        EDM_LOGE(MODULE_USB_DDK, "create sub buffer ashmem failed");
+        return USB_DDK_MEMORY_ERROR;
+    }
+    bool isIn = (pipe.endpoint & USB_ENDPOINT_DIR_MASK) != 0;
+    if (!isIn && !memory->WriteToAshmem(data, ashmem->bufferLength, 0)) {
+        EDM_LOGE(MODULE_USB_DDK, "write sub buffer ashmem failed");
+        memory->CloseAshmem();
+        return USB_DDK_MEMORY_ERROR;
+    }
+    std::vector<uint8_t> address = std::vector<uint8_t>(data, data + ashmem->bufferLength);
+    OHOS::HDI::Usb::Ddk::V1_2::UsbAshmem usbAshmem = {
+        memory->GetAshmemFd(), address, ashmem->bufferLength, 0, ashmem->bufferLength, 0};
+    int32_t ret = g_ddk->SendPipeRequestWithAshmem(pipe, usbAshmem, ashmem->transferredLength);
+    if (ret == HDF_SUCCESS && isIn) {
+        uint32_t length = std::min(ashmem->transferredLength, ashmem->bufferLength);
+        const void *received = memory->ReadFromAshmem(length, 0);
+        if (length != 0 && (received == nullptr || memcpy_s(data, ashmem->bufferLength, received, length) != 0)) {
+            EDM_LOGE(MODULE_USB_DDK, "read sub buffer ashmem failed");
+            ret = HDF_ERR_IO;
+        }
+    }
+    memory->UnmapAshmem();
+    memory->CloseAshmem();
+    return TransToUsbCode(ret);
+}
 #endif
 
 int32_t OH_Usb_Init(void)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
-    g_ddk = OHOS::HDI::Usb::Ddk::V1_2::IUsbDdk::Get();
+    g_ddk = g_ddkFactory != nullptr ? g_ddkFactory() : OHOS::HDI::Usb::Ddk::V1_2::IUsbDdk::Get();
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "get ddk failed");
         return USB_DDK_INVALID_OPERATION;
@@ -76,6 +133,7 @@ int32_t OH_Usb_Init(void)
 
 void OH_Usb_Release(void)
 {
+    EXT_DEV_API_TIMER();
 #ifndef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     return;
 #else
@@ -96,6 +154,7 @@ void OH_Usb_Release(void)
 
 int32_t OH_Usb_ReleaseResource()
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "ddk is null");
@@ -120,6 +179,7 @@ int32_t OH_Usb_ReleaseResource()
 
 int32_t OH_Usb_GetDeviceDescriptor(uint64_t deviceId, UsbDeviceDescriptor *desc)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
@@ -145,6 +205,7 @@ int32_t OH_Usb_GetDeviceDescriptor(uint64_t deviceId, UsbDeviceDescriptor *desc)
 int32_t OH_Usb_GetConfigDescriptor(
     uint64_t deviceId, uint8_t configIndex, struct UsbDdkConfigDescriptor ** const config)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
@@ -169,6 +230,7 @@ int32_t OH_Usb_GetConfigDescriptor(
 
 void OH_Usb_FreeConfigDescriptor(UsbDdkConfigDescriptor * const config)
 {
+    EXT_DEV_API_TIMER();
 #ifndef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     (void)config;
 #else
@@ -178,6 +240,7 @@ void OH_Usb_FreeConfigDescriptor(UsbDdkConfigDescriptor * const config)
 
 int32_t OH_Usb_ClaimInterface(uint64_t deviceId, uint8_t interfaceIndex, uint64_t *interfaceHandle)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
@@ -196,6 +259,7 @@ int32_t OH_Usb_ClaimInterface(uint64_t deviceId, uint8_t interfaceIndex, uint64_
 
 int32_t OH_Usb_ReleaseInterface(uint64_t interfaceHandle)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
@@ -210,6 +274,7 @@ int32_t OH_Usb_ReleaseInterface(uint64_t interfaceHandle)
 
 int32_t OH_Usb_SelectInterfaceSetting(uint64_t interfaceHandle, uint8_t settingIndex)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
@@ -224,6 +289,7 @@ int32_t OH_Usb_SelectInterfaceSetting(uint64_t interfaceHandle, uint8_t settingI
 
 int32_t OH_Usb_GetCurrentInterfaceSetting(uint64_t interfaceHandle, uint8_t *settingIndex)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
@@ -244,6 +310,7 @@ int32_t OH_Usb_GetCurrentInterfaceSetting(uint64_t interfaceHandle, uint8_t *set
 int32_t OH_Usb_SendControlReadRequest(
     uint64_t interfaceHandle, const UsbControlRequestSetup *setup, uint32_t timeout, uint8_t *data, uint32_t *dataLen)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
@@ -282,6 +349,7 @@ int32_t OH_Usb_SendControlReadRequest(
 int32_t OH_Usb_SendControlWriteRequest(uint64_t interfaceHandle, const UsbControlRequestSetup *setup, uint32_t timeout,
     const uint8_t *data, uint32_t dataLen)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
@@ -303,6 +371,7 @@ int32_t OH_Usb_SendControlWriteRequest(uint64_t interfaceHandle, const UsbContro
 
 int32_t OH_Usb_SendPipeRequest(const UsbRequestPipe *pipe, UsbDeviceMemMap *devMmap)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
@@ -324,6 +393,7 @@ int32_t OH_Usb_SendPipeRequest(const UsbRequestPipe *pipe, UsbDeviceMemMap *devM
 
 int32_t OH_Usb_SendPipeRequestWithAshmem(const UsbRequestPipe *pipe, DDK_Ashmem *ashmem)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "invalid obj");
@@ -335,7 +405,15 @@ int32_t OH_Usb_SendPipeRequestWithAshmem(const UsbRequestPipe *pipe, DDK_Ashmem
         return USB_DDK_INVALID_PARAMETER;
     }
 
+    if (ashmem->offset > ashmem->size || ashmem->bufferLength > ashmem->size - ashmem->offset) {
+        EDM_LOGE(MODULE_USB_DDK, "buffer is out of the ashmem");
+        return USB_DDK_INVALID_PARAMETER;
+    }
+
     auto tmpSetUp = reinterpret_cast<const OHOS::HDI::Usb::Ddk::V1_2::UsbRequestPipe *>(pipe);
+    if (ashmem->offset != 0 || ashmem->bufferLength != ashmem->size) {
+        return SendPipeRequestWithSubBuffer(*tmpSetUp, ashmem);
+    }
     std::vector<uint8_t> address = std::vector<uint8_t>(ashmem->address, ashmem->address + ashmem->size);
     OHOS::HDI::Usb::Ddk::V1_2::UsbAshmem usbAshmem = {ashmem->ashmemFd, address, ashmem->size, 0, ashmem->size, 0};
     return TransToUsbCode(g_ddk->SendPipeRequestWithAshmem(*tmpSetUp, usbAshmem, ashmem->transferredLength));
@@ -346,8 +424,16 @@ int32_t OH_Usb_SendPipeRequestWithAshmem(const UsbRequestPipe *pipe, DDK_Ashmem
 
 int32_t OH_Usb_CreateDeviceMemMap(uint64_t deviceId, size_t size, UsbDeviceMemMap **devMmap)
 {
+    EXT_DEV_API_TIMER();
+    return OH_Usb_CreateDeviceMemMapWithFlags(deviceId, size, 0, devMmap);
+}
+
+int32_t OH_Usb_CreateDeviceMemMapWithFlags(uint64_t deviceId, size_t size, uint32_t mapFlags,
+    UsbDeviceMemMap **devMmap)
+{
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
-    if (devMmap == nullptr) {
+    if (devMmap == nullptr || (mapFlags & ~DDK_MAP_FLAG_ALL) != 0) {
         EDM_LOGE(MODULE_USB_DDK, "invalid param");
         return USB_DDK_INVALID_PARAMETER;
     }
@@ -366,6 +452,14 @@ int32_t OH_Usb_CreateDeviceMemMap(uint64_t deviceId, size_t size, UsbDeviceMemMa
         return USB_DDK_MEMORY_ERROR;
     }
 
+    int32_t err = ApplyDdkMapFlags(buffer, size, mapFlags, true);
+    if (err != 0) {
+        EDM_LOGE(MODULE_USB_DDK, "lock pages failed, errno=%{public}d", err);
+        munmap(buffer, size);
+        close(fd);
+        return USB_DDK_MEMORY_ERROR;
+    }
+
     if (g_fdMap.find(buffer) != g_fdMap.end() && g_fdMap[buffer] != -1) {
         EDM_LOGW(MODULE_USB_DDK, "fd exist, close old fd");
         close(g_fdMap[buffer]);
@@ -387,6 +481,7 @@ int32_t OH_Usb_CreateDeviceMemMap(uint64_t deviceId, size_t size, UsbDeviceMemMa
 
 void OH_Usb_DestroyDeviceMemMap(UsbDeviceMemMap *devMmap)
 {
+    EXT_DEV_API_TIMER();
 #ifndef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     (void)devMmap;
 #else
@@ -414,6 +509,7 @@ void OH_Usb_DestroyDeviceMemMap(UsbDeviceMemMap *devMmap)
 
 int32_t OH_Usb_GetDevices(struct Usb_DeviceArray *devices)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "%{public}s: invalid obj", __func__);
@@ -445,6 +541,7 @@ int32_t OH_Usb_GetDevices(struct Usb_DeviceArray *devices)
 int32_t OH_Usb_ControlTransfer(uint64_t deviceID, const struct UsbControlRequestSetup *setupPacket, uint8_t *data,
     uint32_t timeout)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "%{public}s: invalid obj", __func__);
@@ -479,6 +576,7 @@ int32_t OH_Usb_ControlTransfer(uint64_t deviceID, const struct UsbControlRequest
 
 int32_t OH_Usb_GetNonRootHubs(struct Usb_NonRootHubArray *nonRootHub)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_ddk == nullptr) {
         EDM_LOGE(MODULE_USB_DDK, "%{public}s: invalid obj", __func__);
@@ -14,15 +14,23 @@
  */
 
 #include "usb_serial_api.h"
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
+#include <condition_variable>
+#include <functional>
 #include <iproxy_broker.h>
 #include <memory.h>
+#include <mutex>
 #include <securec.h>
+#include <sys/eventfd.h>
 #include <sys/mman.h>
+#include <thread>
 #include <unistd.h>
 #include <vector>
 #include <unordered_map>
 
+#include "ext_dev_api_histogram.h"
 #include "hilog_wrapper.h"
 #include "v1_0/iusb_serial_ddk.h"
 #include "ipc_error_code.h"
@@ -33,15 +41,34 @@ namespace {
 OHOS::sptr<OHOS::HDI::Usb::UsbSerialDdk::V1_0::IUsbSerialDdk> g_serialDdk = nullptr;
 static OHOS::sptr<IRemoteObject::DeathRecipient> recipient_ = nullptr;
 std::mutex g_mutex;
+// when set, OH_UsbSerial_Init takes an in-process service from here instead of the HDF service manager
+std::function<OHOS::sptr<OHOS::HDI::Usb::UsbSerialDdk::V1_0::IUsbSerialDdk>()> g_ddkFactory = nullptr;
 
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
 constexpr uint32_t MAX_BUFFER_SIZE = 4096;
+constexpr uint32_t RX_PENDING_LIMIT = 64 * 1024;
+constexpr int32_t RX_POLL_TIMEOUT_MS = 1000;
 #endif
 
 } // namespace
 
 struct UsbSerial_Device {
     OHOS::HDI::Usb::UsbSerialDdk::V1_0::UsbSerialDeviceHandle impl;
+    // staging buffers are kept per device so that steady-state read/write does not allocate
+    std::mutex readMutex;
+    std::vector<uint8_t> readBuff;
+    std::mutex writeMutex;
+    std::vector<uint8_t> writeBuff;
+    // read event mode: a receive thread drains the port into rxPending and signals eventFd
+    int32_t eventFd = -1;
+    std::thread rxThread;
+    std::atomic<bool> rxRunning {false};
+    std::mutex rxMutex;
+    std::condition_variable rxCond;
+    std::vector<uint8_t> rxPending;
+    int32_t rxError = 0;
+    // the read timeout set by the caller, read event mode overrides it while active and restores it on stop
+    int32_t timeout = 0;
 
     UsbSerial_Device()
     {
@@ -49,6 +76,10 @@ struct UsbSerial_Device {
     }
 } __attribute__ ((aligned(8)));
 
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+static void StopReadEvent(UsbSerial_Device *dev);
+#endif
+
 UsbSerial_Device *NewSerialDeviceHandle(void)
 {
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
@@ -64,6 +95,7 @@ void DeleteUsbSerialDeviceHandle(UsbSerial_Device **dev)
     (void)dev;
 #else
     if (*dev != nullptr) {
+        StopReadEvent(*dev);
         delete *dev;
         *dev = nullptr;
     }
@@ -75,6 +107,11 @@ void SetDdk(OHOS::sptr<OHOS::HDI::Usb::UsbSerialDdk::V1_0::IUsbSerialDdk> &ddk)
     g_serialDdk = ddk;
 }
 
+void SetDdkFactory(std::function<OHOS::sptr<OHOS::HDI::Usb::UsbSerialDdk::V1_0::IUsbSerialDdk>()> factory)
+{
+    g_ddkFactory = factory;
+}
+
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
 static int32_t TransToUsbSerialCode(int32_t ret)
 {
@@ -86,6 +123,94 @@ static int32_t TransToUsbSerialCode(int32_t ret)
     }
     return ret;
 }
+
+static void NotifyReadEvent(UsbSerial_Device *dev)
+{
+    uint64_t value = 1;
+    if (write(dev->eventFd, &value, sizeof(value)) != sizeof(value) && errno != EAGAIN) {
+        EDM_LOGW(MODULE_USB_SERIAL_DDK, "notify read event failed, errno=%{public}d", errno);
+    }
+}
+
+static void ClearReadEvent(UsbSerial_Device *dev)
+{
+    uint64_t value = 0;
+    (void)read(dev->eventFd, &value, sizeof(value));
+}
+
+static void RxLoop(UsbSerial_Device *dev)
+{
+    std::vector<uint8_t> chunk;
+    chunk.reserve(MAX_BUFFER_SIZE);
+    while (dev->rxRunning.load()) {
+        {
+            std::unique_lock<std::mutex> lock(dev->rxMutex);
+            dev->rxCond.wait(lock, [dev] {
+                return !dev->rxRunning.load() || dev->rxPending.size() < RX_PENDING_LIMIT;
+            });
+        }
+        auto ddk = g_serialDdk;
+        if (!dev->rxRunning.load()) {
+            break;
+        }
+        int32_t ret = (ddk == nullptr) ? USB_SERIAL_DDK_INIT_ERROR :
+            TransToUsbSerialCode(ddk->Read(dev->impl, MAX_BUFFER_SIZE, chunk));
+        std::lock_guard<std::mutex> lock(dev->rxMutex);
+        if (ret != USB_SERIAL_DDK_SUCCESS) {
+            EDM_LOGE(MODULE_USB_SERIAL_DDK, "rx loop read error: %{public}d", ret);
+            dev->rxError = ret;
+            NotifyReadEvent(dev);
+            break;
+        }
+        if (!chunk.empty()) {
+            dev->rxPending.insert(dev->rxPending.end(), chunk.begin(), chunk.end());
+            chunk.clear();
+            NotifyReadEvent(dev);
+        }
+    }
+}
+
+static void StopReadEvent(UsbSerial_Device *dev)
+{
+    if (dev->eventFd < 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(dev->rxMutex);
+        dev->rxRunning.store(false);
+    }
+    dev->rxCond.notify_all();
+    if (dev->rxThread.joinable()) {
+        dev->rxThread.join();
+    }
+    close(dev->eventFd);
+    dev->eventFd = -1;
+    dev->rxPending.clear();
+    dev->rxError = 0;
+}
+
+static int32_t ReadFromPending(UsbSerial_Device *dev, uint8_t *buff, uint32_t bufferSize, uint32_t *bytesRead)
+{
+    std::lock_guard<std::mutex> lock(dev->rxMutex);
+    if (dev->rxPending.empty()) {
+        *bytesRead = 0;
+        ClearReadEvent(dev);
+        return dev->rxError == 0 ? USB_SERIAL_DDK_SUCCESS : dev->rxError;
+    }
+    uint32_t size = std::min(bufferSize, static_cast<uint32_t>(dev->rxPending.size()));
+    errno_t err = memcpy_s(buff, bufferSize, dev->rxPending.data(), size);
+    if (err != 0) {
+        EDM_LOGE(MODULE_USB_SERIAL_DDK, "memcpy_s error: %{public}d.", err);
+        return USB_SERIAL_DDK_MEMORY_ERROR;
+    }
+    dev->rxPending.erase(dev->rxPending.begin(), dev->rxPending.begin() + size);
+    *bytesRead = size;
+    if (dev->rxPending.empty() && dev->rxError == 0) {
+        ClearReadEvent(dev);
+    }
+    dev->rxCond.notify_one();
+    return USB_SERIAL_DDK_SUCCESS;
+}
 #endif
 
 class UsbSerialDeathRecipient : public IRemoteObject::DeathRecipient {
@@ -109,12 +234,18 @@ void UsbSerialDeathRecipient::OnRemoteDied(const wptr<IRemoteObject> &object)
 
 int32_t OH_UsbSerial_Init(void)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
-    g_serialDdk = OHOS::HDI::Usb::UsbSerialDdk::V1_0::IUsbSerialDdk::Get();
+    bool inProcess = g_ddkFactory != nullptr;
+    g_serialDdk = inProcess ? g_ddkFactory() : OHOS::HDI::Usb::UsbSerialDdk::V1_0::IUsbSerialDdk::Get();
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "get ddk failed");
         return USB_SERIAL_DDK_INIT_ERROR;
     }
+    if (inProcess) {
+        // an in-process service is not a proxy, there is no remote to watch
+        return TransToUsbSerialCode(g_serialDdk->Init());
+    }
     recipient_ = new UsbSerialDeathRecipient();
     sptr<IRemoteObject> remote = OHOS::HDI::hdi_objcast<OHOS::HDI::Usb::UsbSerialDdk::V1_0::IUsbSerialDdk>(g_serialDdk);
     if (!remote->AddDeathRecipient(recipient_)) {
@@ -129,6 +260,7 @@ int32_t OH_UsbSerial_Init(void)
 
 int32_t OH_UsbSerial_Release(void)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -144,6 +276,7 @@ int32_t OH_UsbSerial_Release(void)
 
 int32_t OH_UsbSerial_Open(uint64_t deviceId, uint8_t interfaceIndex, UsbSerial_Device **dev)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -166,6 +299,7 @@ int32_t OH_UsbSerial_Open(uint64_t deviceId, uint8_t interfaceIndex, UsbSerial_D
 
 int32_t OH_UsbSerial_Close(UsbSerial_Device **dev)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -175,6 +309,7 @@ int32_t OH_UsbSerial_Close(UsbSerial_Device **dev)
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "param is null");
         return USB_SERIAL_DDK_INVALID_PARAMETER;
     }
+    StopReadEvent(*dev);
     int32_t ret = g_serialDdk->Close((*dev)->impl);
     DeleteUsbSerialDeviceHandle(dev);
     return TransToUsbSerialCode(ret);
@@ -185,6 +320,7 @@ int32_t OH_UsbSerial_Close(UsbSerial_Device **dev)
 
 int32_t OH_UsbSerial_Read(UsbSerial_Device *dev, uint8_t *buff, uint32_t bufferSize, uint32_t *bytesRead)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -194,16 +330,28 @@ int32_t OH_UsbSerial_Read(UsbSerial_Device *dev, uint8_t *buff, uint32_t bufferS
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "param is null");
         return USB_SERIAL_DDK_INVALID_PARAMETER;
     }
+    if (dev->eventFd >= 0) {
+        return ReadFromPending(dev, buff, bufferSize, bytesRead);
+    }
     uint32_t readBufferSize = bufferSize;
     if (readBufferSize > MAX_BUFFER_SIZE) {
         readBufferSize = MAX_BUFFER_SIZE;
     }
-    std::vector<uint8_t> readBuff;
+    std::lock_guard<std::mutex> lock(dev->readMutex);
+    std::vector<uint8_t> &readBuff = dev->readBuff;
+    if (readBuff.capacity() < MAX_BUFFER_SIZE) {
+        readBuff.reserve(MAX_BUFFER_SIZE);
+    }
+    readBuff.clear();
     int32_t ret = g_serialDdk->Read(dev->impl, readBufferSize, readBuff);
     if (ret != HDF_SUCCESS) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "read error.");
         return TransToUsbSerialCode(ret);
     }
+    if (readBuff.size() > bufferSize) {
+        EDM_LOGE(MODULE_USB_SERIAL_DDK, "read size %{public}zu exceeds buffer size", readBuff.size());
+        return USB_SERIAL_DDK_MEMORY_ERROR;
+    }
     *bytesRead = readBuff.size();
     if (readBuff.empty()) {
         return USB_SERIAL_DDK_SUCCESS;
@@ -221,6 +369,7 @@ int32_t OH_UsbSerial_Read(UsbSerial_Device *dev, uint8_t *buff, uint32_t bufferS
 
 int32_t OH_UsbSerial_Write(UsbSerial_Device *dev, uint8_t *buff, uint32_t bufferSize, uint32_t *bytesWritten)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -230,8 +379,11 @@ int32_t OH_UsbSerial_Write(UsbSerial_Device *dev, uint8_t *buff, uint32_t buffer
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "param is null");
         return USB_SERIAL_DDK_INVALID_PARAMETER;
     }
-    std::vector<uint8_t> writeBuff(buff, buff + bufferSize);
-    int32_t ret = g_serialDdk->Write(dev->impl, writeBuff, *bytesWritten);
+    std::lock_guard<std::mutex> lock(dev->writeMutex);
+    // the hdi takes a std::vector and the proxy copies it into the parcel anyway, a vector cannot borrow the
+    // caller's buffer, so this copy stays; reusing writeBuff only saves the allocation
+    dev->writeBuff.assign(buff, buff + bufferSize);
+    int32_t ret = g_serialDdk->Write(dev->impl, dev->writeBuff, *bytesWritten);
     if (ret != HDF_SUCCESS) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "write error.");
         *bytesWritten = 0;
@@ -245,6 +397,7 @@ int32_t OH_UsbSerial_Write(UsbSerial_Device *dev, uint8_t *buff, uint32_t buffer
 
 int32_t OH_UsbSerial_SetBaudRate(UsbSerial_Device *dev, uint32_t baudRate)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -262,6 +415,7 @@ int32_t OH_UsbSerial_SetBaudRate(UsbSerial_Device *dev, uint32_t baudRate)
 
 int32_t OH_UsbSerial_SetParams(UsbSerial_Device *dev, UsbSerial_Params *params)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -284,6 +438,7 @@ int32_t OH_UsbSerial_SetParams(UsbSerial_Device *dev, UsbSerial_Params *params)
 
 int32_t OH_UsbSerial_SetTimeout(UsbSerial_Device *dev, int timeout)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -293,7 +448,15 @@ int32_t OH_UsbSerial_SetTimeout(UsbSerial_Device *dev, int timeout)
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "param is null");
         return USB_SERIAL_DDK_INVALID_PARAMETER;
     }
-    return TransToUsbSerialCode(g_serialDdk->SetTimeout(dev->impl, timeout));
+    if (dev->eventFd >= 0) {
+        EDM_LOGE(MODULE_USB_SERIAL_DDK, "timeout is owned by read event mode");
+        return USB_SERIAL_DDK_INVALID_OPERATION;
+    }
+    int32_t ret = TransToUsbSerialCode(g_serialDdk->SetTimeout(dev->impl, timeout));
+    if (ret == USB_SERIAL_DDK_SUCCESS) {
+        dev->timeout = timeout;
+    }
+    return ret;
 #else
     return USB_SERIAL_DDK_INVALID_OPERATION;
 #endif
@@ -301,6 +464,7 @@ int32_t OH_UsbSerial_SetTimeout(UsbSerial_Device *dev, int timeout)
 
 int32_t OH_UsbSerial_SetFlowControl(UsbSerial_Device *dev, UsbSerial_FlowControl flowControl)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -319,6 +483,7 @@ int32_t OH_UsbSerial_SetFlowControl(UsbSerial_Device *dev, UsbSerial_FlowControl
 
 int32_t OH_UsbSerial_Flush(UsbSerial_Device *dev)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -336,6 +501,7 @@ int32_t OH_UsbSerial_Flush(UsbSerial_Device *dev)
 
 int32_t OH_UsbSerial_FlushInput(UsbSerial_Device *dev)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -345,6 +511,12 @@ int32_t OH_UsbSerial_FlushInput(UsbSerial_Device *dev)
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "param is null");
         return USB_SERIAL_DDK_INVALID_PARAMETER;
     }
+    if (dev->eventFd >= 0) {
+        std::lock_guard<std::mutex> lock(dev->rxMutex);
+        dev->rxPending.clear();
+        ClearReadEvent(dev);
+        dev->rxCond.notify_one();
+    }
     return TransToUsbSerialCode(g_serialDdk->FlushInput(dev->impl));
 #else
     return USB_SERIAL_DDK_INVALID_OPERATION;
@@ -353,6 +525,7 @@ int32_t OH_UsbSerial_FlushInput(UsbSerial_Device *dev)
 
 int32_t OH_UsbSerial_FlushOutput(UsbSerial_Device *dev)
 {
+    EXT_DEV_API_TIMER();
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (g_serialDdk == nullptr) {
         EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
@@ -367,3 +540,68 @@ int32_t OH_UsbSerial_FlushOutput(UsbSerial_Device *dev)
     return USB_SERIAL_DDK_INVALID_OPERATION;
 #endif
 }
+
+int32_t OH_UsbSerial_StartReadEvent(UsbSerial_Device *dev, int32_t *eventFd)
+{
+    EXT_DEV_API_TIMER();
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    if (g_serialDdk == nullptr) {
+        EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
+        return USB_SERIAL_DDK_INIT_ERROR;
+    }
+    if (dev == nullptr || eventFd == nullptr) {
+        EDM_LOGE(MODULE_USB_SERIAL_DDK, "param is null");
+        return USB_SERIAL_DDK_INVALID_PARAMETER;
+    }
+    if (dev->eventFd >= 0) {
+        *eventFd = dev->eventFd;
+        return USB_SERIAL_DDK_SUCCESS;
+    }
+    int32_t ret = TransToUsbSerialCode(g_serialDdk->SetTimeout(dev->impl, RX_POLL_TIMEOUT_MS));
+    if (ret != USB_SERIAL_DDK_SUCCESS) {
+        EDM_LOGE(MODULE_USB_SERIAL_DDK, "set rx timeout failed: %{public}d", ret);
+        return ret;
+    }
+    int32_t fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd < 0) {
+        EDM_LOGE(MODULE_USB_SERIAL_DDK, "eventfd failed, errno=%{public}d", errno);
+        return USB_SERIAL_DDK_MEMORY_ERROR;
+    }
+    dev->eventFd = fd;
+    dev->rxError = 0;
+    dev->rxRunning.store(true);
+    dev->rxThread = std::thread(RxLoop, dev);
+    pthread_setname_np(dev->rxThread.native_handle(), "serial_rx");
+    *eventFd = fd;
+    return USB_SERIAL_DDK_SUCCESS;
+#else
+    return USB_SERIAL_DDK_INVALID_OPERATION;
+#endif
+}
+
+int32_t OH_UsbSerial_StopReadEvent(UsbSerial_Device *dev)
+{
+    EXT_DEV_API_TIMER();
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    if (dev == nullptr) {
+        EDM_LOGE(MODULE_USB_SERIAL_DDK, "param is null");
+        return USB_SERIAL_DDK_INVALID_PARAMETER;
+    }
+    if (dev->eventFd < 0) {
+        EDM_LOGE(MODULE_USB_SERIAL_DDK, "read event not started");
+        return USB_SERIAL_DDK_INVALID_OPERATION;
+    }
+    StopReadEvent(dev);
+    if (g_serialDdk == nullptr) {
+        EDM_LOGE(MODULE_USB_SERIAL_DDK, "ddk is null");
+        return USB_SERIAL_DDK_INIT_ERROR;
+    }
+    int32_t ret = TransToUsbSerialCode(g_serialDdk->SetTimeout(dev->impl, dev->timeout));
+    if (ret != USB_SERIAL_DDK_SUCCESS) {
+        EDM_LOGE(MODULE_USB_SERIAL_DDK, "restore timeout failed: %{public}d", ret);
+    }
+    return ret;
+#else
+    return USB_SERIAL_DDK_INVALID_OPERATION;
+#endif
+}
@@ -14,6 +14,7 @@
  */
 
 #include "driver_ext_mgr_client.h"
+#include <algorithm>
 #include <if_system_ability_manager.h>
 #include <iservice_registry.h>
 #include <system_ability_definition.h>
@@ -114,6 +115,8 @@ void DriverExtMgrClient::DisConnect(const wptr<IRemoteObject> &remote)
     if ((serviceRemote != nullptr) && (serviceRemote == remote.promote())) {
         serviceRemote->RemoveDeathRecipient(deathRecipient_);
         proxy_ = nullptr;
+        // a restarted service counts generations from scratch
+        ResetQueryCache();
     }
 #endif
 }
@@ -222,13 +225,53 @@ UsbErrCode DriverExtMgrClient::UnbindDriverWithDeviceId(uint64_t deviceId)
 
 UsbErrCode DriverExtMgrClient::QueryDeviceInfo(std::vector<std::shared_ptr<DeviceInfoData>> &deviceInfos)
 {
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    return QueryDeviceInfoCached(false, 0, deviceInfos);
+#else
+    return static_cast<UsbErrCode>(SERVICE_EXCEPTION);
+#endif
+}
+
+UsbErrCode DriverExtMgrClient::QueryDeviceInfo(const uint64_t deviceId,
+    std::vector<std::shared_ptr<DeviceInfoData>> &deviceInfos)
+{
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    return QueryDeviceInfoCached(true, deviceId, deviceInfos);
+#else
+    return static_cast<UsbErrCode>(SERVICE_EXCEPTION);
+#endif
+}
+
+UsbErrCode DriverExtMgrClient::QueryDriverInfo(std::vector<std::shared_ptr<DriverInfoData>> &driverInfos)
+{
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    return QueryDriverInfoCached(false, "", driverInfos);
+#else
+    return static_cast<UsbErrCode>(SERVICE_EXCEPTION);
+#endif
+}
+
+UsbErrCode DriverExtMgrClient::QueryDriverInfo(const std::string &driverUid,
+    std::vector<std::shared_ptr<DriverInfoData>> &driverInfos)
+{
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    return QueryDriverInfoCached(true, driverUid, driverInfos);
+#else
+    return static_cast<UsbErrCode>(SERVICE_EXCEPTION);
+#endif
+}
+
+UsbErrCode DriverExtMgrClient::NotifyUsbPeripheralFault(const std::string &domain, const std::string &faultName)
+{
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (Connect() != UsbErrCode::EDM_OK) {
         return UsbErrCode::EDM_ERR_CONNECTION_FAILED;
     }
+
     int32_t ret = EDM_OK;
-    int32_t proxyRet = proxy_->QueryDeviceInfo(ret, deviceInfos, false, 0);
+    int32_t proxyRet = proxy_->NotifyUsbPeripheralFault(domain, faultName);
     if (proxyRet != ERR_OK) {
+        EDM_LOGE(MODULE_FRAMEWORK, "Usb peripheral fault notify failed.");
         return ProxyRetTranslate(proxyRet);
     }
     return static_cast<UsbErrCode>(ret);
@@ -237,15 +280,15 @@ UsbErrCode DriverExtMgrClient::QueryDeviceInfo(std::vector<std::shared_ptr<Devic
 #endif
 }
 
-UsbErrCode DriverExtMgrClient::QueryDeviceInfo(const uint64_t deviceId,
-    std::vector<std::shared_ptr<DeviceInfoData>> &deviceInfos)
+UsbErrCode DriverExtMgrClient::SubscribeDeviceChanges(const sptr<IDeviceSubscribeCallback> &callback,
+    uint64_t &sequence, std::vector<std::shared_ptr<DeviceInfoData>> &deviceInfos)
 {
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (Connect() != UsbErrCode::EDM_OK) {
         return UsbErrCode::EDM_ERR_CONNECTION_FAILED;
     }
     int32_t ret = EDM_OK;
-    int32_t proxyRet = proxy_->QueryDeviceInfo(ret, deviceInfos, true, deviceId);
+    int32_t proxyRet = proxy_->SubscribeDeviceChanges(ret, callback, sequence, deviceInfos);
     if (proxyRet != ERR_OK) {
         return ProxyRetTranslate(proxyRet);
     }
@@ -255,14 +298,14 @@ UsbErrCode DriverExtMgrClient::QueryDeviceInfo(const uint64_t deviceId,
 #endif
 }
 
-UsbErrCode DriverExtMgrClient::QueryDriverInfo(std::vector<std::shared_ptr<DriverInfoData>> &driverInfos)
+UsbErrCode DriverExtMgrClient::UnsubscribeDeviceChanges(const sptr<IDeviceSubscribeCallback> &callback)
 {
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
     if (Connect() != UsbErrCode::EDM_OK) {
         return UsbErrCode::EDM_ERR_CONNECTION_FAILED;
     }
     int32_t ret = EDM_OK;
-    int32_t proxyRet = proxy_->QueryDriverInfo(ret, driverInfos, false, "");
+    int32_t proxyRet = proxy_->UnsubscribeDeviceChanges(ret, callback);
     if (proxyRet != ERR_OK) {
         return ProxyRetTranslate(proxyRet);
     }
@@ -272,42 +315,179 @@ UsbErrCode DriverExtMgrClient::QueryDriverInfo(std::vector<std::shared_ptr<Drive
 #endif
 }
 
-UsbErrCode DriverExtMgrClient::QueryDriverInfo(const std::string &driverUid,
-    std::vector<std::shared_ptr<DriverInfoData>> &driverInfos)
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+template <typename T, typename Pred>
+static void CopyMatchedInfos(const std::vector<std::shared_ptr<T>> &src, std::vector<std::shared_ptr<T>> &dst,
+    Pred pred)
+{
+    for (const auto &info : src) {
+        if (info != nullptr && pred(*info)) {
+            dst.push_back(info);
+        }
+    }
+}
+#endif
+
+bool DriverExtMgrClient::PrepareQueryCache(uint64_t &generation)
+{
+#ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (!cacheRegistered_) {
+        sptr<IQueryCacheCallback> callback = new (std::nothrow) QueryCacheCallback();
+        if (callback == nullptr) {
+            EDM_LOGE(MODULE_FRAMEWORK, "Failed to create QueryCacheCallback");
+            return false;
+        }
+        int32_t ret = EDM_OK;
+        uint64_t serviceGeneration = 0;
+        int32_t proxyRet = proxy_->RegisterQueryCacheCallback(ret, callback, serviceGeneration);
+        if (proxyRet != ERR_OK || ret != EDM_OK) {
+            EDM_LOGW(MODULE_FRAMEWORK, "query cache disabled, proxyRet = %{public}d, ret = %{public}d", proxyRet, ret);
+            return false;
+        }
+        // invalidations may have been delivered before the reply
+        generation_ = std::max(generation_, serviceGeneration);
+        cacheCallback_ = callback;
+        cacheRegistered_ = true;
+    }
+    generation = generation_;
+    return true;
+#else
+    (void)generation;
+    return false;
+#endif
+}
+
+void DriverExtMgrClient::OnQueryInvalidated(uint64_t generation)
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (generation <= generation_) {
+        return;
+    }
+    generation_ = generation;
+    deviceInfoCache_ = {};
+    driverInfoCache_ = {};
+}
+
+void DriverExtMgrClient::ResetQueryCache()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cacheRegistered_ = false;
+    cacheCallback_ = nullptr;
+    generation_ = 0;
+    deviceInfoCache_ = {};
+    driverInfoCache_ = {};
+}
+
+ErrCode DriverExtMgrClient::QueryCacheCallback::OnQueryInvalidated(uint64_t generation)
+{
+    DriverExtMgrClient::GetInstance().OnQueryInvalidated(generation);
+    return EDM_OK;
+}
+
+// Results are cached as the whole list and tagged with the generation known before the query was sent.
+// A change racing with the query pushes a newer generation, so such a result is dropped at the latest
+// when that push arrives.
+UsbErrCode DriverExtMgrClient::QueryDeviceInfoCached(bool isByDeviceId, uint64_t deviceId,
+    std::vector<std::shared_ptr<DeviceInfoData>> &deviceInfos)
 {
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    auto matched = [isByDeviceId, deviceId](const DeviceInfoData &info) {
+        return !isByDeviceId || info.deviceId == deviceId;
+    };
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        if (cacheRegistered_ && deviceInfoCache_.valid && deviceInfoCache_.generation == generation_) {
+            CopyMatchedInfos(deviceInfoCache_.infos, deviceInfos, matched);
+            return UsbErrCode::EDM_OK;
+        }
+    }
     if (Connect() != UsbErrCode::EDM_OK) {
         return UsbErrCode::EDM_ERR_CONNECTION_FAILED;
     }
     int32_t ret = EDM_OK;
-    int32_t proxyRet = proxy_->QueryDriverInfo(ret, driverInfos, true, driverUid);
+    uint64_t generation = 0;
+    if (!PrepareQueryCache(generation)) {
+        int32_t proxyRet = proxy_->QueryDeviceInfo(ret, deviceInfos, isByDeviceId, deviceId);
+        if (proxyRet != ERR_OK) {
+            return ProxyRetTranslate(proxyRet);
+        }
+        return static_cast<UsbErrCode>(ret);
+    }
+
+    std::vector<std::shared_ptr<DeviceInfoData>> allInfos;
+    int32_t proxyRet = proxy_->QueryDeviceInfo(ret, allInfos, false, 0);
     if (proxyRet != ERR_OK) {
         return ProxyRetTranslate(proxyRet);
     }
-    return static_cast<UsbErrCode>(ret);
+    if (ret != UsbErrCode::EDM_OK) {
+        return static_cast<UsbErrCode>(ret);
+    }
+    CopyMatchedInfos(allInfos, deviceInfos, matched);
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (cacheRegistered_ && generation == generation_) {
+        deviceInfoCache_.valid = true;
+        deviceInfoCache_.generation = generation;
+        deviceInfoCache_.infos = std::move(allInfos);
+    }
+    return UsbErrCode::EDM_OK;
 #else
+    (void)isByDeviceId;
+    (void)deviceId;
+    (void)deviceInfos;
     return static_cast<UsbErrCode>(SERVICE_EXCEPTION);
 #endif
 }
 
-UsbErrCode DriverExtMgrClient::NotifyUsbPeripheralFault(const std::string &domain, const std::string &faultName)
+UsbErrCode DriverExtMgrClient::QueryDriverInfoCached(bool isByDriverUid, const std::string &driverUid,
+    std::vector<std::shared_ptr<DriverInfoData>> &driverInfos)
 {
 #ifdef ENABLE_EXTERNAL_DEVICE_DDK_SERVICE
+    auto matched = [isByDriverUid, &driverUid](const DriverInfoData &info) {
+        return !isByDriverUid || info.driverUid == driverUid;
+    };
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        if (cacheRegistered_ && driverInfoCache_.valid && driverInfoCache_.generation == generation_) {
+            CopyMatchedInfos(driverInfoCache_.infos, driverInfos, matched);
+            return UsbErrCode::EDM_OK;
+        }
+    }
     if (Connect() != UsbErrCode::EDM_OK) {
         return UsbErrCode::EDM_ERR_CONNECTION_FAILED;
     }
-
     int32_t ret = EDM_OK;
-    int32_t proxyRet = proxy_->NotifyUsbPeripheralFault(domain, faultName);
+    uint64_t generation = 0;
+    if (!PrepareQueryCache(generation)) {
+        int32_t proxyRet = proxy_->QueryDriverInfo(ret, driverInfos, isByDriverUid, driverUid);
+        if (proxyRet != ERR_OK) {
+            return ProxyRetTranslate(proxyRet);
+        }
+        return static_cast<UsbErrCode>(ret);
+    }
+
+    std::vector<std::shared_ptr<DriverInfoData>> allInfos;
+    int32_t proxyRet = proxy_->QueryDriverInfo(ret, allInfos, false, "");
     if (proxyRet != ERR_OK) {
-        EDM_LOGE(MODULE_FRAMEWORK, "Usb peripheral fault notify failed.");
         return ProxyRetTranslate(proxyRet);
     }
-    return static_cast<UsbErrCode>(ret);
+    if (ret != UsbErrCode::EDM_OK) {
+        return static_cast<UsbErrCode>(ret);
+    }
+    CopyMatchedInfos(allInfos, driverInfos, matched);
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    if (cacheRegistered_ && generation == generation_) {
+        driverInfoCache_.valid = true;
+        driverInfoCache_.generation = generation;
+        driverInfoCache_.infos = std::move(allInfos);
+    }
+    return UsbErrCode::EDM_OK;
 #else
+    (void)isByDriverUid;
+    (void)driverUid;
+    (void)driverInfos;
     return static_cast<UsbErrCode>(SERVICE_EXCEPTION);
 #endif
 }
-
 } // namespace ExternalDeviceManager
 } // namespace OHOS
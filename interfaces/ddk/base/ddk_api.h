@@ -64,6 +64,21 @@ DDK_RetCode OH_DDK_CreateAshmem(const uint8_t *name, uint32_t size, DDK_Ashmem *
  */
 DDK_RetCode OH_DDK_MapAshmem(DDK_Ashmem *ashmem, const uint8_t ashmemMapType);
 
+/**
+ * @brief Maps the created shared memory to the user space with mapping options, for example to avoid page faults\n
+ * on the first access of a large buffer. Unmap the shared memory that is not required by using\n
+ * <b>OH_DDK_UnmapAshmem</b>.
+ *
+ * @param ashmem Pointer of the shared memory to map.
+ * @param ashmemMapType Protection permission value of the shared memory.
+ * @param mapFlags Bitwise OR of <b>DDK_MapFlag</b> values.
+ * @return Returns <b>DDK_SUCCESS</b> if the operation is successful; returns <b>DDK_FAILURE</b> if the pages\n
+ * cannot be locked; returns <b>DDK_INVALID_OPERATION</b> if <b>mapFlags</b> is not 0 and the mapping is not\n
+ * readable, in which case the shared memory is left unmapped; returns a negative value otherwise.
+ * @since 26.0.0
+ */
+DDK_RetCode OH_DDK_MapAshmemWithFlags(DDK_Ashmem *ashmem, const uint8_t ashmemMapType, uint32_t mapFlags);
+
 /**
  * @brief Unmaps shared memory.
  *
@@ -81,6 +96,65 @@ DDK_RetCode OH_DDK_UnmapAshmem(DDK_Ashmem *ashmem);
  * @since 12
  */
 DDK_RetCode OH_DDK_DestroyAshmem(DDK_Ashmem *ashmem);
+
+/**
+ * @brief Creates a shared memory pool and maps it to the user space. Buffers are then allocated from the pool by\n
+ * calling <b>OH_DDK_AllocAshmemBuffer</b> without creating or mapping new shared memory.\n
+ * Destroy the pool that is not required by calling <b>OH_DDK_DestroyAshmemPool</b>.
+ *
+ * @param name Pointer to the name of the shared memory to create.
+ * @param blockSize Allocation granularity of the pool. It is rounded up to a multiple of 64 bytes.
+ * @param blockCount Number of blocks in the pool.
+ * @param ashmemMapType Protection permission value of the shared memory. It must allow reading.
+ * @param pool Pointer to the pool created.
+ * @return Returns <b>DDK_SUCCESS</b> if the operation is successful; returns a negative value otherwise.
+ * @since 26.0.0
+ */
+DDK_RetCode OH_DDK_CreateAshmemPool(const uint8_t *name, uint32_t blockSize, uint32_t blockCount,
+    const uint8_t ashmemMapType, DDK_AshmemPool **pool);
+
+/**
+ * @brief Allocates a buffer from a shared memory pool. The buffer shares <b>ashmemFd</b>, <b>address</b> and\n
+ * <b>size</b> with the pool, and <b>offset</b> and <b>bufferLength</b> select the allocated part, so it can be\n
+ * passed to the DDK APIs that accept <b>DDK_Ashmem</b>. The allocation is lock-free.
+ *
+ * @param pool Pointer to the pool.
+ * @param size Size of the buffer. At most 64 blocks can be allocated at a time.
+ * @param buffer Pointer to the buffer allocated.
+ * @return Returns <b>DDK_SUCCESS</b> if the operation is successful; returns <b>DDK_FAILURE</b> if the pool has no\n
+ * free run that is large enough; returns a negative value otherwise.
+ * @since 26.0.0
+ */
+DDK_RetCode OH_DDK_AllocAshmemBuffer(DDK_AshmemPool *pool, uint32_t size, DDK_Ashmem **buffer);
+
+/**
+ * @brief Returns a buffer to the shared memory pool it was allocated from.
+ *
+ * @param pool Pointer to the pool.
+ * @param buffer Pointer to the buffer allocated by <b>OH_DDK_AllocAshmemBuffer</b>.
+ * @return Returns <b>DDK_SUCCESS</b> if the operation is successful; returns a negative value otherwise.
+ * @since 26.0.0
+ */
+DDK_RetCode OH_DDK_FreeAshmemBuffer(DDK_AshmemPool *pool, DDK_Ashmem *buffer);
+
+/**
+ * @brief Obtains the usage and fragmentation statistics of a shared memory pool.
+ *
+ * @param pool Pointer to the pool.
+ * @param stats Pointer to the statistics.
+ * @return Returns <b>DDK_SUCCESS</b> if the operation is successful; returns a negative value otherwise.
+ * @since 26.0.0
+ */
+DDK_RetCode OH_DDK_GetAshmemPoolStats(const DDK_AshmemPool *pool, DDK_AshmemPoolStats *stats);
+
+/**
+ * @brief Unmaps and destroys a shared memory pool. Buffers allocated from the pool become invalid.
+ *
+ * @param pool Pointer to the pool to destroy.
+ * @return Returns <b>DDK_SUCCESS</b> if the operation is successful; returns a negative value otherwise.
+ * @since 26.0.0
+ */
+DDK_RetCode OH_DDK_DestroyAshmemPool(DDK_AshmemPool *pool);
 #ifdef __cplusplus
 }
 /** @} */
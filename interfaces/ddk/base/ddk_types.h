@@ -66,6 +66,53 @@ typedef struct DDK_Ashmem {
     uint32_t transferredLength;
 } DDK_Ashmem;
 
+/**
+ * @brief Enumerates the options for mapping shared memory with <b>OH_DDK_MapAshmemWithFlags</b>.\n
+ * They can be combined with a bitwise OR.
+ *
+ * @since 26.0.0
+ */
+typedef enum {
+    /** Fault all pages in while mapping, so that the first access does not take page faults. */
+    DDK_MAP_FLAG_PREFAULT = 0x01,
+    /** Lock the pages in memory. The pages are faulted in as well. */
+    DDK_MAP_FLAG_LOCK = 0x02,
+    /** Request transparent huge pages. This is a hint and has no effect if the system does not support it. */
+    DDK_MAP_FLAG_HUGE_PAGE = 0x04
+} DDK_MapFlag;
+
+/**
+ * @brief Defines the shared memory pool created by using <b>OH_DDK_CreateAshmemPool</b>.\n
+ * All buffers allocated from a pool live in one shared memory region.
+ *
+ * @since 26.0.0
+ */
+typedef struct DDK_AshmemPool DDK_AshmemPool;
+
+/**
+ * @brief Defines the usage and fragmentation statistics of a shared memory pool.
+ *
+ * @since 26.0.0
+ */
+typedef struct DDK_AshmemPoolStats {
+    /** Size of a block. Buffer offsets are multiples of it. */
+    uint32_t blockSize;
+    /** Number of blocks in the pool. */
+    uint32_t blockCount;
+    /** Number of blocks held by allocated buffers. */
+    uint32_t usedBlocks;
+    /** Largest number of blocks that a single buffer can still be allocated with. */
+    uint32_t largestFreeBlocks;
+    /** Number of separate free block runs. A large value with a small <b>largestFreeBlocks</b>\n
+     * indicates fragmentation.
+     */
+    uint32_t freeRuns;
+    /** Number of successful allocations since the pool was created. */
+    uint64_t allocCount;
+    /** Number of allocations that failed because no free run was large enough. */
+    uint64_t allocFailures;
+} DDK_AshmemPoolStats;
+
 /**
  * @brief Enumerates the error codes used in the Base DDK.
  *
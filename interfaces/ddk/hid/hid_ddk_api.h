@@ -366,6 +366,128 @@ int32_t OH_Hid_GetReport(Hid_DeviceHandle *dev, Hid_ReportType reportType, uint8
  * @since 18
 */
 int32_t OH_Hid_GetReportDescriptor(Hid_DeviceHandle *dev, uint8_t *buf, uint32_t bufSize, uint32_t *bytesRead);
+
+/**
+ * @brief Switch the device to read event mode and return a pollable event fd.
+ * A receive thread queues incoming input reports, up to 256 of them, and the event fd becomes readable while reports\n
+ * or a read error are pending, so one thread can wait on several devices with poll or epoll. While the mode is\n
+ * active {@link OH_Hid_Read} and {@link OH_Hid_ReadTimeout} return queued reports without blocking, and\n
+ * {@link OH_Hid_ReadReports} drains many reports in one call. The event fd is owned by the device handle and must\n
+ * not be closed by the caller. If the mode is already active, the existing event fd is returned.
+ *
+ * @permission ohos.permission.ACCESS_DDK_HID
+ * @param dev Device operation handle.
+ * @param maxReportSize Size in bytes of the largest input report of the device, including the report ID byte.
+ * @param eventFd Event fd that signals pending reports.
+ * @return {@link HID_DDK_SUCCESS} if the operation is successful.
+ *         {@link HID_DDK_NO_PERM} permission check failed.
+ *         {@link HID_DDK_INVALID_PARAMETER} parameter check failed. Possible causes: 1.dev is null;\n
+ *             2.maxReportSize is 0; 3.maxReportSize is greater than HID_MAX_REPORT_BUFFER_SIZE; 4.eventFd is null.
+ *         {@link HID_DDK_INIT_ERROR} the DDK not init.
+ *         {@link HID_DDK_MEMORY_ERROR} failed to create the event fd.
+ *         {@link HID_DDK_INVALID_OPERATION} the operation is not supported.
+ * @since 26.0.0
+ */
+int32_t OH_Hid_StartReadEvent(Hid_DeviceHandle *dev, uint32_t maxReportSize, int32_t *eventFd);
+
+/**
+ * @brief Leave read event mode, close the event fd and discard queued reports.
+ * {@link OH_Hid_Close} leaves the mode implicitly.
+ *
+ * @permission ohos.permission.ACCESS_DDK_HID
+ * @param dev Device operation handle.
+ * @return {@link HID_DDK_SUCCESS} if the operation is successful.
+ *         {@link HID_DDK_NO_PERM} permission check failed.
+ *         {@link HID_DDK_INVALID_PARAMETER} parameter check failed. Possible causes: dev is null.
+ *         {@link HID_DDK_INVALID_OPERATION} read event mode is not active.
+ * @since 26.0.0
+ */
+int32_t OH_Hid_StopReadEvent(Hid_DeviceHandle *dev);
+
+/**
+ * @brief Drain queued input reports in one call. Reports are copied back to back into data and the size of\n
+ * each report is stored in reportSizes. Returns without blocking, with reportCount set to 0 if nothing is queued.
+ *
+ * @permission ohos.permission.ACCESS_DDK_HID
+ * @param dev Device operation handle in read event mode.
+ * @param data Buffer for the reports.
+ * @param bufSize Size of data in bytes.
+ * @param reportSizes Array receiving the size of each copied report.
+ * @param maxReports Number of entries of reportSizes.
+ * @param reportCount Number of copied reports.
+ * @return {@link HID_DDK_SUCCESS} if the operation is successful.
+ *         {@link HID_DDK_NO_PERM} permission check failed.
+ *         {@link HID_DDK_INVALID_PARAMETER} parameter check failed. Possible causes: 1.dev is null;\n
+ *             2.data is null; 3.bufSize is 0; 4.reportSizes is null; 5.maxReports is 0; 6.reportCount is null.
+ *         {@link HID_DDK_MEMORY_ERROR} data is too small for the next queued report.
+ *         {@link HID_DDK_IO_ERROR} reading from the device failed; queued reports have been drained.
+ *         {@link HID_DDK_SERVICE_ERROR} communication with the ddk service failed.
+ *         {@link HID_DDK_INVALID_OPERATION} read event mode is not active.
+ * @since 26.0.0
+ */
+int32_t OH_Hid_ReadReports(Hid_DeviceHandle *dev, uint8_t *data, uint32_t bufSize, uint32_t *reportSizes,
+    uint32_t maxReports, uint32_t *reportCount);
+
+/**
+ * @brief Parse a report descriptor into a compiled report layout.
+ * The layout is a flat table of all data fields of the descriptor, sorted by report type, report ID and bit offset.
+ * Constant padding is not listed. The descriptor only needs to be parsed once per device.
+ *
+ * @param descriptor Report descriptor, for example returned by {@link OH_Hid_GetReportDescriptor}.
+ * @param length Length of the descriptor in bytes.
+ * @param layout Created layout, release it with {@link OH_Hid_DestroyReportLayout}.
+ * @return {@link HID_DDK_SUCCESS} if the operation is successful.
+ *         {@link HID_DDK_INVALID_PARAMETER} parameter check failed. Possible causes: 1.descriptor is null;\n
+ *             2.length is 0; 3.length is greater than HID_MAX_REPORT_BUFFER_SIZE; 4.layout is null;\n
+ *             5.the descriptor is malformed.
+ *         {@link HID_DDK_MEMORY_ERROR} failed to allocate the layout.
+ * @since 26.0.0
+ */
+int32_t OH_Hid_CreateReportLayout(const uint8_t *descriptor, uint32_t length, Hid_ReportLayout **layout);
+
+/**
+ * @brief Get the field table of a compiled report layout.
+ *
+ * @param layout Report layout.
+ * @param fields Field table owned by the layout, valid until the layout is destroyed.
+ * @param count Number of fields in the table.
+ * @return {@link HID_DDK_SUCCESS} if the operation is successful.
+ *         {@link HID_DDK_INVALID_PARAMETER} parameter check failed. Possible causes: layout, fields or count is null.
+ * @since 26.0.0
+ */
+int32_t OH_Hid_GetReportFields(const Hid_ReportLayout *layout, const Hid_ReportField **fields, uint32_t *count);
+
+/**
+ * @brief Decode all fields of an input report in one pass.
+ * The fields of one report are contiguous in the field table; values[i] holds the value of field\n
+ * (*firstField + i). Signed fields are sign-extended.
+ *
+ * @param layout Report layout.
+ * @param report Input report as read from the device, starting with the report ID byte if the descriptor uses\n
+ *     report IDs.
+ * @param length Length of the report in bytes.
+ * @param values Buffer for the decoded values.
+ * @param valueCount Number of entries of values.
+ * @param firstField Index in the field table of the field decoded into values[0].
+ * @param decodedCount Number of decoded values.
+ * @return {@link HID_DDK_SUCCESS} if the operation is successful.
+ *         {@link HID_DDK_INVALID_PARAMETER} parameter check failed. Possible causes: 1.a pointer is null;\n
+ *             2.the report ID is not described by the layout; 3.the report is shorter than described.
+ *         {@link HID_DDK_MEMORY_ERROR} values is too small for the fields of the report.
+ * @since 26.0.0
+ */
+int32_t OH_Hid_DecodeInputReport(const Hid_ReportLayout *layout, const uint8_t *report, uint32_t length,
+    int32_t *values, uint32_t valueCount, uint32_t *firstField, uint32_t *decodedCount);
+
+/**
+ * @brief Destroy a compiled report layout.
+ *
+ * @param layout Report layout, set to null on return.
+ * @return {@link HID_DDK_SUCCESS} if the operation is successful.
+ *         {@link HID_DDK_INVALID_PARAMETER} parameter check failed. Possible causes: layout or *layout is null.
+ * @since 26.0.0
+ */
+int32_t OH_Hid_DestroyReportLayout(Hid_ReportLayout **layout);
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
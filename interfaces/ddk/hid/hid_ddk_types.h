@@ -662,6 +662,70 @@ typedef struct Hid_RawDevInfo {
     /** Product ID */
     uint16_t product;
 } Hid_RawDevInfo;
+
+/**
+ * @brief Opaque compiled report layout created from a report descriptor.
+ *
+ * @since 26.0.0
+ */
+typedef struct Hid_ReportLayout Hid_ReportLayout;
+
+/**
+ * @brief The field holds a constant value.
+ *
+ * @since 26.0.0
+ */
+#define HID_FIELD_FLAG_CONSTANT 0x01
+/**
+ * @brief The field is a variable; otherwise it is an array slot holding a usage index.
+ *
+ * @since 26.0.0
+ */
+#define HID_FIELD_FLAG_VARIABLE 0x02
+/**
+ * @brief The field reports relative values.
+ *
+ * @since 26.0.0
+ */
+#define HID_FIELD_FLAG_RELATIVE 0x04
+/**
+ * @brief The field has a null state outside the logical range.
+ *
+ * @since 26.0.0
+ */
+#define HID_FIELD_FLAG_NULL_STATE 0x40
+/**
+ * @brief The field value is sign-extended when decoded.
+ *
+ * @since 26.0.0
+ */
+#define HID_FIELD_FLAG_SIGNED 0x8000
+
+/**
+ * @brief Defines one field of a compiled report layout.
+ *
+ * @since 26.0.0
+ */
+typedef struct Hid_ReportField {
+    /** Report type, see {@link Hid_ReportType} */
+    uint8_t reportType;
+    /** Report ID, 0 if the descriptor does not use report IDs */
+    uint8_t reportId;
+    /** Combination of HID_FIELD_FLAG_* values */
+    uint16_t flags;
+    /** Usage page */
+    uint16_t usagePage;
+    /** Usage of a variable field, or the minimum usage of an array field */
+    uint16_t usage;
+    /** Bit offset of the field in the report buffer, counting the report ID byte if present */
+    uint32_t bitOffset;
+    /** Size of the field in bits, at most 32 */
+    uint32_t bitSize;
+    /** Logical minimum */
+    int32_t logicalMin;
+    /** Logical maximum */
+    int32_t logicalMax;
+} Hid_ReportField;
 #ifdef __cplusplus
 }
 /** @} */
@@ -235,6 +235,24 @@ int32_t OH_Usb_SendPipeRequestWithAshmem(const struct UsbRequestPipe *pipe, DDK_
  */
 int32_t OH_Usb_CreateDeviceMemMap(uint64_t deviceId, size_t size, UsbDeviceMemMap **devMmap);
 
+/**
+ * @brief Creates a buffer with mapping options, for example to fault in or lock a large streaming buffer before\n
+ * the transfer starts. To avoid resource leakage, destroy a buffer by calling <b>OH_Usb_DestroyDeviceMemMap</b>\n
+ * after use.
+ *
+ * @permission ohos.permission.ACCESS_DDK_USB
+ * @param deviceId ID of the device for which the buffer is to be created.
+ * @param size Buffer size.
+ * @param mapFlags Bitwise OR of <b>DDK_MapFlag</b> values.
+ * @param devMmap Data memory map, through which the created buffer is returned to the caller.
+ * @return {@link USB_DDK_SUCCESS} the operation is successful.
+ *         {@link USB_DDK_INVALID_PARAMETER} devMmap is null or mapFlags is invalid.
+ *         {@link USB_DDK_MEMORY_ERROR} the buffer cannot be mapped or its pages cannot be locked.
+ * @since 26.0.0
+ */
+int32_t OH_Usb_CreateDeviceMemMapWithFlags(uint64_t deviceId, size_t size, uint32_t mapFlags,
+    UsbDeviceMemMap **devMmap);
+
 /**
  * @brief Destroys a buffer. To avoid resource leakage, destroy a buffer in time after use.
  *
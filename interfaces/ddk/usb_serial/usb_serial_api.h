@@ -266,6 +266,47 @@ int32_t OH_UsbSerial_FlushInput(UsbSerial_Device *dev);
  * @since 16
  */
 int32_t OH_UsbSerial_FlushOutput(UsbSerial_Device *dev);
+
+/**
+ * @brief Switch the device to read event mode and return a pollable event fd.
+ * The event fd becomes readable when received data or a read error is pending, so one thread can wait on\n
+ * several devices with poll or epoll and then call {@link OH_UsbSerial_Read}, which returns the pending data\n
+ * without blocking. While the mode is active the read timeout is managed internally and\n
+ * {@link OH_UsbSerial_SetTimeout} is rejected. The event fd is owned by the device handle and must not be closed\n
+ * by the caller. If the mode is already active, the existing event fd is returned.
+ *
+ * @permission ohos.permission.ACCESS_DDK_USB_SERIAL
+ * @param dev Device handle.
+ * @param eventFd Event fd that signals pending read data.
+ * @return {@link USB_SERIAL_DDK_SUCCESS} the operation is successful.
+ *         {@link USB_SERIAL_DDK_NO_PERM} permission check failed.
+ *         {@link USB_SERIAL_DDK_INVALID_PARAMETER} parameter check failed. Possible causes: dev or eventFd is null.
+ *         {@link USB_SERIAL_DDK_INIT_ERROR} the ddk not init.
+ *         {@link USB_SERIAL_DDK_MEMORY_ERROR} failed to create the event fd.
+ *         {@link USB_SERIAL_DDK_SERVICE_ERROR} communication with the ddk service failed.
+ *         {@link USB_SERIAL_DDK_IO_ERROR} the ddk I/O error.
+ *         {@link USB_SERIAL_DDK_INVALID_OPERATION} invalid operation.
+ * @since 26.0.0
+ */
+int32_t OH_UsbSerial_StartReadEvent(UsbSerial_Device *dev, int32_t *eventFd);
+
+/**
+ * @brief Leave read event mode, close the event fd and discard data not yet read.
+ * The read timeout set by {@link OH_UsbSerial_SetTimeout} before the mode started is restored.\n
+ * {@link OH_UsbSerial_Close} leaves the mode implicitly.
+ *
+ * @permission ohos.permission.ACCESS_DDK_USB_SERIAL
+ * @param dev Device handle.
+ * @return {@link USB_SERIAL_DDK_SUCCESS} the operation is successful.
+ *         {@link USB_SERIAL_DDK_NO_PERM} permission check failed.
+ *         {@link USB_SERIAL_DDK_INVALID_PARAMETER} parameter check failed. Possible causes: dev is null.
+ *         {@link USB_SERIAL_DDK_INIT_ERROR} the ddk not init.
+ *         {@link USB_SERIAL_DDK_SERVICE_ERROR} communication with the ddk service failed.
+ *         {@link USB_SERIAL_DDK_IO_ERROR} the ddk I/O error.
+ *         {@link USB_SERIAL_DDK_INVALID_OPERATION} read event mode is not active.
+ * @since 26.0.0
+ */
+int32_t OH_UsbSerial_StopReadEvent(UsbSerial_Device *dev);
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
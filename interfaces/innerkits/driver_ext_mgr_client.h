@@ -15,10 +15,13 @@
 
 #ifndef DRIVER_EXTENSION_MANAGER_CLIENT_H
 #define DRIVER_EXTENSION_MANAGER_CLIENT_H
+#include <map>
 #include <singleton.h>
 
 #include "driver_ext_mgr_types.h"
+#include "idevice_subscribe_callback.h"
 #include "idriver_ext_mgr.h"
+#include "query_cache_callback_stub.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
@@ -37,10 +40,37 @@ public:
     UsbErrCode QueryDriverInfo(std::vector<std::shared_ptr<DriverInfoData>> &driverInfos);
     UsbErrCode QueryDriverInfo(const std::string &driverUid, std::vector<std::shared_ptr<DriverInfoData>> &driverInfos);
     UsbErrCode NotifyUsbPeripheralFault(const std::string &domain, const std::string &faultName);
+    // returns the attached devices and the sequence number of the last change they include,
+    // callback then receives every later change starting at sequence + 1
+    UsbErrCode SubscribeDeviceChanges(const sptr<IDeviceSubscribeCallback> &callback, uint64_t &sequence,
+        std::vector<std::shared_ptr<DeviceInfoData>> &deviceInfos);
+    UsbErrCode UnsubscribeDeviceChanges(const sptr<IDeviceSubscribeCallback> &callback);
 
 private:
     UsbErrCode Connect();
     void DisConnect(const wptr<IRemoteObject> &remote);
+    // returns true and the generation to tag a fresh result with when query results may be cached
+    bool PrepareQueryCache(uint64_t &generation);
+    void OnQueryInvalidated(uint64_t generation);
+    void ResetQueryCache();
+    UsbErrCode QueryDeviceInfoCached(bool isByDeviceId, uint64_t deviceId,
+        std::vector<std::shared_ptr<DeviceInfoData>> &deviceInfos);
+    UsbErrCode QueryDriverInfoCached(bool isByDriverUid, const std::string &driverUid,
+        std::vector<std::shared_ptr<DriverInfoData>> &driverInfos);
+
+    template <typename T>
+    struct QueryCacheEntry {
+        bool valid = false;
+        uint64_t generation = 0;
+        std::vector<std::shared_ptr<T>> infos;
+    };
+
+    class QueryCacheCallback : public QueryCacheCallbackStub {
+    public:
+        QueryCacheCallback() = default;
+        ~QueryCacheCallback() = default;
+        ErrCode OnQueryInvalidated(uint64_t generation) override;
+    };
 
     class DriverExtMgrDeathRecipient : public IRemoteObject::DeathRecipient {
     public:
@@ -55,6 +85,14 @@ private:
     std::mutex mutex_;
     sptr<IDriverExtMgr> proxy_ {nullptr};
     sptr<IRemoteObject::DeathRecipient> deathRecipient_ {nullptr};
+
+    // query results served locally while the service reports no change, see PrepareQueryCache
+    std::mutex cacheMutex_;
+    bool cacheRegistered_ = false;
+    uint64_t generation_ = 0;
+    sptr<IQueryCacheCallback> cacheCallback_ {nullptr};
+    QueryCacheEntry<DeviceInfoData> deviceInfoCache_;
+    QueryCacheEntry<DriverInfoData> driverInfoCache_;
 };
 } // namespace ExternalDeviceManager
 } // namespace OHOS
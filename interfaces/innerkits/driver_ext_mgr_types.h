@@ -102,6 +102,25 @@ public:
     std::vector<std::shared_ptr<USBInterfaceDesc>> interfaceDescList;
 };
 
+enum DeviceChangeType : uint32_t {
+    DEVICE_CHANGE_ADDED = 0,
+    DEVICE_CHANGE_REMOVED,
+};
+
+class DeviceChangeDelta : public Parcelable {
+public:
+    virtual ~DeviceChangeDelta() = default;
+    bool Marshalling(Parcel &parcel) const override;
+    static DeviceChangeDelta* Unmarshalling(Parcel &data);
+
+    // consecutive for all changes published by the service, so that a gap means lost deltas
+    uint64_t sequence = 0;
+    DeviceChangeType type = DEVICE_CHANGE_ADDED;
+    uint64_t deviceId = 0;
+    // only set for added devices of a bus that DeviceInfoData supports
+    std::shared_ptr<DeviceInfoData> deviceInfo;
+};
+
 class DriverInfoData : public Parcelable {
 public:
     virtual ~DriverInfoData() = default;
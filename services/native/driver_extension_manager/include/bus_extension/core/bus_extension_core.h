@@ -33,6 +33,7 @@ public:
     int32_t Init(std::shared_ptr<IDevChangeCallback> callback);
     int32_t Register(BusType busType, std::shared_ptr<IBusExtension> busExtension);
     std::shared_ptr<IBusExtension> GetBusExtensionByName(std::string busName);
+    std::shared_ptr<IBusExtension> GetBusExtensionByType(BusType busType);
     static BusType GetBusTypeByName(const std::string &busName);
     void LoadBusExtensionLibs();
     std::shared_ptr<IDriverChangeCallback> AcquireDriverChangeCallback(BusType busType);
@@ -53,11 +53,16 @@ public:
     void SetUsbDdk(sptr<V1_2::IUsbDdk> iUsbDdk);
     BusType GetBusType() override;
     shared_ptr<IDriverChangeCallback> AcquireDriverChangeCallback() override;
+    // one key per vid:pid pair the driver lists or its match rules fix, a driver with rules not fixing both
+    // has no keys
+    bool GetMatchKeys(const DeviceInfo &device, vector<string> &keys) override;
+    bool GetMatchKeys(const DriverInfo &driver, vector<string> &keys) override;
 
 private:
     sptr<UsbDevSubscriber> subScriber_ = nullptr;
     sptr<V1_2::IUsbDdk> iUsbDdk_ = nullptr;
     vector<uint16_t> ParseCommaStrToVectorUint16(const string &str);
+    static string MakeMatchKey(uint16_t vid, uint16_t pid);
 #ifdef EXTDEVMGR_USB_PASS_THROUGH
     sptr<IUsbHostInterface> usbInterface_ = nullptr;
 #else
@@ -75,6 +75,9 @@ private:
     void SetUsbDevInfoValue(const UsbDevDescLite &deviceDescriptor, shared_ptr<UsbDeviceInfo> &usbDevInfo,
         std::string snNum);
     int32_t GetUsbDeviceDescriptor(const UsbDev &usbDev, UsbDevDescLite &deviceDescriptor);
+    // one record per interface of a composite device, registered along with the device
+    void AddInterfaceInfos(const UsbDev &usbDev, const UsbDevDescLite &deviceDescriptor,
+        shared_ptr<UsbDeviceInfo> &usbDevInfo);
 };
 }
 }
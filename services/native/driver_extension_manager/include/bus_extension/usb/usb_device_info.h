@@ -21,6 +21,9 @@ namespace OHOS {
 namespace ExternalDeviceManager {
 class UsbDeviceInfo : public DeviceInfo {
 public:
+    static constexpr uint8_t USB_CLASS_PER_INTERFACE = 0x00;
+    static constexpr uint8_t USB_CLASS_MISC = 0xef;
+
     UsbDeviceInfo(uint32_t busDeviceId, const std::string &description = "")
         : DeviceInfo(busDeviceId, BusType::BUS_TYPE_USB, description) { }
     ~UsbDeviceInfo() = default;
@@ -35,6 +38,11 @@ public:
         return idProduct_;
     }
 
+    uint16_t GetBcdDevice() const
+    {
+        return bcdDevice_;
+    }
+
     uint8_t GetDeviceSubClass() const
     {
         return deviceSubClass_;
@@ -55,6 +63,13 @@ public:
         return snNum_;
     }
 
+    // interfaces of a composite device are bound on their own, the class of the device says so
+    bool IsComposite() const
+    {
+        return interfaceDescList_.size() > 1 &&
+            (deviceClass_ == USB_CLASS_PER_INTERFACE || deviceClass_ == USB_CLASS_MISC);
+    }
+
     std::vector<UsbInterfaceDescriptor> interfaceDescList_;
 
 private:
@@ -64,6 +79,7 @@ private:
     uint8_t  deviceClass_ = 0;
     uint16_t idVendor_ = 0;
     uint16_t idProduct_ = 0;
+    uint16_t bcdDevice_ = 0;
     uint8_t deviceSubClass_ = 0;
     uint8_t deviceProtocol_ = 0;
     std::string snNum_ = "";
@@ -15,8 +15,10 @@
 
 #ifndef USB_DRIVER_INFO_H
 #define USB_DRIVER_INFO_H
+#include <memory>
 #include <vector>
 #include "ibus_extension.h"
+#include "usb_match_rule.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
@@ -32,11 +34,24 @@ public:
     {
         return vids_;
     }
+    std::string GetMatchRules() const
+    {
+        return matchRules_;
+    }
+    // false if the rules do not parse, the driver then matches by its vid and pid lists only
+    bool SetMatchRules(const std::string &matchRules);
+    // compiled matchRules_, nullptr if there are none
+    std::shared_ptr<const UsbMatchRuleSet> GetMatchRuleSet() const
+    {
+        return ruleSet_;
+    }
 
 private:
     friend class UsbBusExtension;
     std::vector<uint16_t> pids_;
     std::vector<uint16_t> vids_;
+    std::string matchRules_;
+    std::shared_ptr<const UsbMatchRuleSet> ruleSet_;
 };
 }
 }
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_MATCH_RULE_H
+#define USB_MATCH_RULE_H
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "usb_device_info.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+enum class UsbMatchField : uint8_t {
+    VID = 0,
+    PID,
+    BCD_DEVICE,
+    CLASS,
+    SUBCLASS,
+    PROTOCOL,
+    // the interface fields of one rule have to hold for the same interface
+    IF_CLASS,
+    IF_SUBCLASS,
+    IF_PROTOCOL,
+    COUNT,
+};
+
+// which rules a device record is checked against
+enum class UsbMatchScope : uint8_t {
+    ANY = 0,
+    // the whole of a composite device, rules without interface fields
+    DEVICE,
+    // one interface of a composite device, rules with interface fields
+    INTERFACE,
+};
+
+// holds when (value & mask) is within [min, max]
+struct UsbFieldPredicate {
+    UsbMatchField field;
+    uint16_t min;
+    uint16_t max;
+    uint16_t mask;
+
+    bool IsExact() const
+    {
+        return mask == UINT16_MAX && min == max;
+    }
+    bool Test(uint16_t value) const
+    {
+        uint16_t masked = value & mask;
+        return masked >= min && masked <= max;
+    }
+};
+
+// Match rules of the "matchRules" metadata of a USB driver, a device matches if any rule holds:
+//     rules = rule *(";" rule)
+//     rule  = field "=" value *("," field "=" value)
+//     field = vid | pid | bcdDevice | class | subClass | protocol | ifClass | ifSubClass | ifProtocol
+//     value = "*" | num | num "-" num | num "/" mask
+// Numbers are hex like the vid and pid lists, "0x" is optional. "1200/ff00" holds for 0x1200 to 0x12ff.
+// The rules are compiled into buckets keyed by the device field most rules fix to one value, so a device
+// is only checked against the rules of its bucket and the rules not fixing that field.
+class UsbMatchRuleSet {
+public:
+    // a rule fixing vid with a pid range up to this wide still gets match keys
+    static constexpr uint32_t MAX_KEYED_PID_RANGE = 256;
+
+    // false if the text does not parse, the set is left empty then
+    bool Compile(const std::string &text);
+    bool Match(const UsbDeviceInfo &device, UsbMatchScope scope = UsbMatchScope::ANY) const;
+    bool Empty() const
+    {
+        return rules_.empty();
+    }
+    size_t Size() const
+    {
+        return rules_.size();
+    }
+    UsbMatchField GetHashField() const
+    {
+        return hashField_;
+    }
+    // the vid:pid pairs covering every rule, false if a rule does not fix them
+    bool GetVidPids(std::vector<std::pair<uint16_t, uint16_t>> &pairs) const;
+
+private:
+    struct CompiledRule {
+        uint32_t begin;
+        uint16_t deviceCount;
+        uint16_t interfaceCount;
+    };
+
+    static bool ParseRule(const std::string &text, std::vector<UsbFieldPredicate> &predicates);
+    static bool ParsePredicate(const std::string &text, UsbFieldPredicate &predicate);
+    static bool ParseField(const std::string &name, UsbMatchField &field);
+    static bool ParseNumber(const std::string &text, uint16_t limit, uint16_t &value);
+    static bool IsInterfaceField(UsbMatchField field);
+    static uint16_t GetFieldValue(const UsbDeviceInfo &device, UsbMatchField field);
+    static uint16_t GetFieldValue(const UsbInterfaceDescriptor &desc, UsbMatchField field);
+    static UsbMatchField SelectHashField(const std::vector<std::vector<UsbFieldPredicate>> &rules);
+    void AddRule(const std::vector<UsbFieldPredicate> &rule);
+    void CollectVidPids(const std::vector<std::vector<UsbFieldPredicate>> &rules);
+    bool MatchRule(const CompiledRule &rule, const UsbDeviceInfo &device, UsbMatchScope scope) const;
+
+    UsbMatchField hashField_ = UsbMatchField::COUNT;
+    // predicates of all rules back to back, device fields first, without the one the bucket stands for
+    std::vector<UsbFieldPredicate> predicates_;
+    std::vector<CompiledRule> rules_;
+    std::unordered_map<uint16_t, std::vector<uint32_t>> buckets_;
+    // rules not fixing the hash field
+    std::vector<uint32_t> unhashed_;
+    bool keyed_ = false;
+    std::vector<std::pair<uint16_t, uint16_t>> vidPids_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_MATCH_RULE_H
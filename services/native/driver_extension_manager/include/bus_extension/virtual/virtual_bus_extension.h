@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VIRTUAL_BUS_EXTENSION_H
+#define VIRTUAL_BUS_EXTENSION_H
+#include <mutex>
+#include <unordered_map>
+
+#include "ibus_extension.h"
+#include "virtual_device_info.h"
+#include "virtual_driver_info.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+// A loopback bus: devices are plugged and unplugged by calls or by a script instead of by hardware, so the
+// device manager can be driven without a USB stack. Its drivers list vids and pids like USB drivers do.
+class VirtualBusExtension : public IBusExtension {
+public:
+    // played when the bus comes up, if it exists, in builds with extdevmgr_virtual_bus_autoplay only
+    static constexpr const char *DEFAULT_SCRIPT_PATH = "/data/local/tmp/virtual_bus.script";
+
+    int32_t SetDevChangeCallback(shared_ptr<IDevChangeCallback> callback) override;
+    bool MatchDriver(const DriverInfo &driver, const DeviceInfo &device, const std::string &type = "") override;
+    shared_ptr<DriverInfoExt> ParseDriverInfo(const map<string, string> &metadata) override;
+    shared_ptr<DriverInfoExt> GetNewDriverInfoExtObject() override;
+    BusType GetBusType() override;
+    shared_ptr<IDriverChangeCallback> AcquireDriverChangeCallback() override;
+    bool GetMatchKeys(const DeviceInfo &device, vector<string> &keys) override;
+    bool GetMatchKeys(const DriverInfo &driver, vector<string> &keys) override;
+
+    // EDM_ERR_DEVICE_BUSY if a device of the same busDeviceId is attached
+    int32_t Attach(shared_ptr<VirtualDeviceInfo> device);
+    // EDM_ERR_INVALID_PARAM if no device of busDeviceId is attached
+    int32_t Detach(uint32_t busDeviceId);
+    size_t GetAttachedCount();
+    // A script has one event per line, empty lines and anything after "#" are skipped:
+    //     attach <busDeviceId> [vid=<hex>] [pid=<hex>] [class=<hex>] [name=<description>]
+    //     detach <busDeviceId>
+    // Returns the number of events played, -1 if a line does not parse, the lines before it are played then.
+    // An event the device manager refuses, like attaching a busDeviceId twice, is played all the same.
+    int32_t RunScript(const string &script);
+    int32_t LoadScript(const string &path);
+
+private:
+    // 1 if the line is an event, 0 if it has none, -1 if it does not parse
+    int32_t RunLine(const string &line);
+    int32_t AttachLocked(shared_ptr<VirtualDeviceInfo> device);
+    int32_t DetachLocked(uint32_t busDeviceId);
+    static bool ParseNumber(const string &text, uint32_t limit, uint32_t &value);
+    static string MakeMatchKey(uint16_t vid, uint16_t pid);
+
+    // the events of a bus come one at a time, like from the subscriber of a real one
+    mutex busMutex_;
+    shared_ptr<IDevChangeCallback> callback_;
+    unordered_map<uint32_t, shared_ptr<VirtualDeviceInfo>> attached_;
+};
+}
+}
+#endif
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VIRTUAL_DEVICE_INFO_H
+#define VIRTUAL_DEVICE_INFO_H
+#include "ibus_extension.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+// the synthetic descriptor of a device on the virtual bus
+class VirtualDeviceInfo : public DeviceInfo {
+public:
+    VirtualDeviceInfo(uint32_t busDeviceId, const std::string &description = "")
+        : DeviceInfo(busDeviceId, BusType::BUS_TYPE_VIRTUAL, description) { }
+    ~VirtualDeviceInfo() = default;
+
+    uint16_t GetVendorId() const
+    {
+        return vendorId_;
+    }
+
+    uint16_t GetProductId() const
+    {
+        return productId_;
+    }
+
+    uint8_t GetDeviceClass() const
+    {
+        return deviceClass_;
+    }
+
+    void SetVendorId(uint16_t vendorId)
+    {
+        vendorId_ = vendorId;
+    }
+
+    void SetProductId(uint16_t productId)
+    {
+        productId_ = productId;
+    }
+
+    void SetDeviceClass(uint8_t deviceClass)
+    {
+        deviceClass_ = deviceClass;
+    }
+
+private:
+    uint16_t vendorId_ = 0;
+    uint16_t productId_ = 0;
+    uint8_t deviceClass_ = 0;
+};
+}
+}
+#endif
@@ -22,8 +22,10 @@ namespace ExternalDeviceManager {
 class BundleUpdateCallback final : public IBundleUpdateCallback {
 public:
     BundleUpdateCallback() = default;
-    void OnBundlesUpdated(const std::string &bundleName) override;
+    void OnBundlesUpdated(const std::string &bundleName,
+        const std::vector<std::shared_ptr<DriverInfo>> &drivers) override;
     void OnBundlesReseted(const int32_t oldUserId) override;
+    void OnBundleChanged(const std::string &bundleName, const int32_t userId) override;
 };
 } // namespace ExternalDeviceManager
 } // namespace OHOS
@@ -15,6 +15,7 @@
 
 #ifndef DRIVER_EXTENSION_CONTROLLER_H
 #define DRIVER_EXTENSION_CONTROLLER_H
+#include <functional>
 #include <string>
 #include <memory>
 #include <map>
@@ -24,6 +25,8 @@
 namespace OHOS {
 namespace ExternalDeviceManager {
 class IDriverExtensionConnectCallback;
+struct DrvExtConnectionInfo;
+
 class DriverExtensionController {
     DECLARE_SINGLE_INSTANCE_BASE(DriverExtensionController);
 public:
@@ -34,7 +37,8 @@ public:
         const std::string& bundleName,
         const std::string& abilityName,
         std::shared_ptr<IDriverExtensionConnectCallback> callback,
-        uint32_t deviceId = 0
+        uint32_t deviceId = 0,
+        int32_t interfaceNumber = -1
     );
     int32_t DisconnectDriverExtension(
         const std::string& bundleName,
@@ -45,13 +49,33 @@ public:
     class DriverExtensionAbilityConnection;
 
 private:
+    // the ability manager calls, replaced by tests
+    using AbilityConnector = std::function<int32_t(const std::shared_ptr<DrvExtConnectionInfo> &info)>;
+    using AbilityStopper = std::function<int32_t(const std::string &bundleName, const std::string &abilityName,
+        int32_t userId)>;
+
     DriverExtensionController() = default;
+    static int32_t ConnectAbility(const std::shared_ptr<DrvExtConnectionInfo> &info);
+    static int32_t DisconnectAbility(const std::shared_ptr<DrvExtConnectionInfo> &info);
+    static int32_t StopAbility(const std::string &bundleName, const std::string &abilityName, int32_t userId);
+    static void NotifyConnectDone(const sptr<DriverExtensionAbilityConnection> &connection,
+        const sptr<IRemoteObject> &remote, int resultCode);
+    static void NotifyDisconnectDone(const sptr<DriverExtensionAbilityConnection> &connection, int resultCode);
+
+    AbilityConnector abilityConnector_ = ConnectAbility;
+    AbilityConnector abilityDisconnector_ = DisconnectAbility;
+    AbilityStopper abilityStopper_ = StopAbility;
 };
 
 struct DrvExtConnectionInfo {
+    // out of line, the connection type is only complete in the controller
+    DrvExtConnectionInfo();
+    ~DrvExtConnectionInfo();
     std::string bundleName_;
     std::string abilityName_;
     uint32_t deviceId_;
+    // the interface of a composite device the extension is bound to, -1 for the whole device
+    int32_t interfaceNumber_ = -1;
     sptr<DriverExtensionController::DriverExtensionAbilityConnection> connectInner_;
 };
 
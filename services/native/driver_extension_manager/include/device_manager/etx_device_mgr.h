@@ -16,20 +16,33 @@
 #ifndef DEVICE_MANAGER_ETX_DEVICE_MGR_H
 #define DEVICE_MANAGER_ETX_DEVICE_MGR_H
 
+#include <atomic>
+#include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include "device.h"
+#include "driver_ext_mgr_types.h"
 #include "ext_object.h"
 #include "idriver_change_callback.h"
 #include "single_instance.h"
 #include "timer.h"
+#include "unload_policy.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
 using namespace std;
+using DeviceChangeHandler =
+    std::function<void(uint64_t sequence, DeviceChangeType type, const shared_ptr<Device> &device)>;
+using QueryGenerationHandler = std::function<void(uint64_t generation)>;
+using AppProvisionFetcher =
+    std::function<int32_t(const std::string &bundleName, int32_t userId, std::string &appIdentifier)>;
+using DriverMatcher =
+    std::function<shared_ptr<DriverInfo>(shared_ptr<DeviceInfo> devInfo, const std::string &type)>;
+
 class ExtDeviceManager final {
     DECLARE_SINGLE_INSTANCE_BASE(ExtDeviceManager);
 
@@ -40,6 +53,14 @@ public:
     int32_t UnRegisterDevice(const shared_ptr<DeviceInfo> devInfo);
     vector<shared_ptr<DeviceInfo>> QueryDevice(const BusType busType);
     vector<shared_ptr<Device>> QueryAllDevices();
+    // takes the snapshot and runs onSnapshot without letting a device change in between, sequence is the
+    // sequence number of the last change included in the snapshot
+    vector<shared_ptr<Device>> QueryAllDevices(uint64_t &sequence, const std::function<void()> &onSnapshot);
+    // the handler is called with the device map locked, in sequence order
+    void SetDeviceChangeHandler(const DeviceChangeHandler &handler);
+    // the generation changes whenever a device or driver query could return something different
+    uint64_t GetQueryGeneration() const;
+    void SetQueryGenerationHandler(const QueryGenerationHandler &handler);
     vector<shared_ptr<Device>> QueryDevicesById(const uint64_t deviceId);
     int32_t ConnectDevice(uint64_t deviceId, uint32_t callingTokenId,
         const sptr<IDriverExtMgrCallback> &connectCallback);
@@ -50,28 +71,70 @@ public:
     void RemoveDeviceOfDeviceMap(shared_ptr<Device> device);
     std::unordered_set<uint64_t> DeleteBundlesOfBundleInfoMap(const std::string &bundleName = "");
     void MatchDriverInfos(std::unordered_set<uint64_t> deviceIds);
+    // re-matches the devices in deviceIds and the unbound devices that changedDrivers may match, which are
+    // the current drivers of one bundle
+    void MatchDriverInfos(const std::unordered_set<uint64_t> &deviceIds,
+        const vector<shared_ptr<DriverInfo>> &changedDrivers);
     void ClearMatchedDrivers(const int32_t userId);
     void SetDriverChangeCallback(shared_ptr<IDriverChangeCallback> &driverChangeCallback);
+    // drops the cached provision info of the bundle, called when it is installed, updated or removed
+    void InvalidateAppProvision(const std::string &bundleName, int32_t userId);
+    // decides how long the service stays loaded after the last device is gone
+    void SetUnloadPolicy(const std::shared_ptr<IUnloadPolicy> &policy);
+    UnloadPolicyStats GetUnloadPolicyStats();
 
 private:
     ExtDeviceManager() = default;
     void PrintMatchDriverMap();
+    int32_t RegisterOneDevice(shared_ptr<DeviceInfo> devInfo);
+    int32_t UnRegisterOneDevice(BusType type, uint64_t deviceId);
     int32_t AddDevIdOfBundleInfoMap(shared_ptr<Device> device, string &bundleInfo);
     int32_t RemoveDevIdOfBundleInfoMap(shared_ptr<Device> device, string &bundleInfo);
+    void EraseBundleInfo(const shared_ptr<Device> &device, const string &bundleInfo);
+    void MatchAllDevices(const std::unordered_set<uint64_t> &deviceIds);
+    void MatchDevice(const shared_ptr<Device> &device, bool unbind);
+    void AddMatchKeys(const shared_ptr<Device> &device);
+    void RemoveMatchKeys(uint64_t deviceId);
     void UpdateDriverInfo(const shared_ptr<Device> &device);
     void RemoveDriverInfo(const shared_ptr<Device> &device);
     std::shared_ptr<Device> QueryDeviceByDeviceID(uint64_t deviceId);
     void UnLoadSelf(void);
+    void PublishDeviceChange(DeviceChangeType type, const shared_ptr<Device> &device);
+    void BumpQueryGeneration();
     size_t GetTotalDeviceNum(void) const;
     int32_t CheckAccessPermission(const std::shared_ptr<DriverInfo> &driverInfo,
         const unordered_set<std::string> &accessibleAppIds) const;
+    int32_t GetAppIdentifier(const std::string &bundleName, int32_t userId, std::string &appIdentifier) const;
+    static int32_t QueryAppIdentifier(const std::string &bundleName, int32_t userId, std::string &appIdentifier);
+    static shared_ptr<DriverInfo> QueryMatchDriver(shared_ptr<DeviceInfo> devInfo, const std::string &type);
+    static std::shared_ptr<IUnloadPolicy> CreateUnloadPolicy();
     unordered_map<BusType, unordered_map<uint64_t, shared_ptr<Device>>> deviceMap_;
     unordered_map<string, unordered_set<uint64_t>> bundleMatchMap_; // driver matching table
+    // keys of bundleMatchMap_ by bundleName, guarded by bundleMatchMapMutex_
+    unordered_map<string, unordered_set<string>> bundleInfosOfBundle_;
+    // devices by the match keys of their bus extension, guarded by deviceMapMutex_
+    unordered_map<string, unordered_set<uint64_t>> matchKeyIndex_;
+    unordered_map<uint64_t, vector<string>> deviceMatchKeys_;
+    DriverMatcher driverMatcher_ = QueryMatchDriver;
     mutex deviceMapMutex_;
     mutex bundleMatchMapMutex_;
     Utils::Timer unloadSelftimer_ {"unLoadSelfTimer"};
     uint32_t unloadSelftimerId_ {UINT32_MAX};
+    // guarded by deviceMapMutex_
+    std::shared_ptr<IUnloadPolicy> unloadPolicy_ = CreateUnloadPolicy();
+    // set in OnStart before Init, and so before the bundle listeners, read only afterwards
     std::shared_ptr<IDriverChangeCallback> driverChangeCallback_ = nullptr;
+    uint64_t changeSequence_ {0};
+    DeviceChangeHandler deviceChangeHandler_ = nullptr;
+    std::atomic<uint64_t> queryGeneration_ {0};
+    mutex generationHandlerMutex_;
+    QueryGenerationHandler generationHandler_ = nullptr;
+    // appIdentifier of each driver bundle, keyed by bundleName and userId
+    mutable mutex provisionCacheMutex_;
+    mutable map<pair<string, int32_t>, string> provisionCache_;
+    // bumped by every invalidation so that a BMS answer fetched before it is not cached after it
+    uint64_t provisionEpoch_ {0};
+    AppProvisionFetcher provisionFetcher_ = QueryAppIdentifier;
 };
 } // namespace ExternalDeviceManager
 } // namespace OHOS
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DEVICE_MANAGER_UNLOAD_POLICY_H
+#define DEVICE_MANAGER_UNLOAD_POLICY_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+struct UnloadPolicyStats {
+    int64_t holdOffMs = 0;
+    // average time from the last device leaving to the next one arriving, over the reconnects that came in time
+    int64_t reconnectGapMs = 0;
+    // share of idle periods that ended with a reconnect within the longest hold-off
+    double reconnectRate = 0;
+    uint64_t idlePeriods = 0;
+    // loads that a device had to wait for
+    uint64_t coldStarts = 0;
+    // reconnects that came later than the fixed 30s hold-off would have waited
+    uint64_t coldStartsAvoided = 0;
+    uint64_t pressureUnloads = 0;
+};
+
+// Decides how long the service stays loaded once the last device is gone. Called with the device map locked.
+class IUnloadPolicy {
+public:
+    virtual ~IUnloadPolicy() = default;
+    virtual void OnDeviceAttached() = 0;
+    // the last device is gone, returns the hold-off in milliseconds
+    virtual int64_t OnIdle() = 0;
+    // the hold-off ran out and the service is about to unload
+    virtual void OnUnload() = 0;
+    virtual UnloadPolicyStats GetStats() = 0;
+};
+
+class FixedUnloadPolicy : public IUnloadPolicy {
+public:
+    explicit FixedUnloadPolicy(int64_t holdOffMs) : holdOffMs_(holdOffMs) {}
+    void OnDeviceAttached() override {}
+    int64_t OnIdle() override
+    {
+        return holdOffMs_;
+    }
+    void OnUnload() override {}
+    UnloadPolicyStats GetStats() override
+    {
+        UnloadPolicyStats stats;
+        stats.holdOffMs = holdOffMs_;
+        return stats;
+    }
+
+private:
+    int64_t holdOffMs_;
+};
+
+// Learns how soon devices come back after the last one left and holds the service that long, within
+// [MIN_HOLD_OFF_MS, MAX_HOLD_OFF_MS]. Reconnects rarely coming within MAX_HOLD_OFF_MS, or memory pressure,
+// bring the hold-off down to the minimum. The state is saved on unload together with the boot id, so the next
+// load of the same boot learns from the gap as well.
+class AdaptiveUnloadPolicy : public IUnloadPolicy {
+public:
+    // milliseconds since boot, time in suspend included, comparable across processes of one boot
+    using Clock = std::function<int64_t()>;
+    using PressureProbe = std::function<bool()>;
+    using StateLoader = std::function<bool(std::string &state)>;
+    using StateSaver = std::function<void(const std::string &state)>;
+    // identifies the boot the clock counts from, empty if unknown
+    using BootIdReader = std::function<std::string()>;
+
+    static constexpr int64_t DEFAULT_HOLD_OFF_MS = 30 * 1000;
+    static constexpr int64_t MIN_HOLD_OFF_MS = 5 * 1000;
+    static constexpr int64_t MAX_HOLD_OFF_MS = 5 * 60 * 1000;
+    static constexpr double GAP_WEIGHT = 0.3;
+    // the hold-off covers this many times the average gap
+    static constexpr double GAP_MARGIN = 1.5;
+    static constexpr double MIN_RECONNECT_RATE = 0.3;
+
+    AdaptiveUnloadPolicy();
+    AdaptiveUnloadPolicy(Clock clock, PressureProbe pressureProbe, StateLoader loader, StateSaver saver,
+        BootIdReader bootIdReader = ReadBootId);
+
+    void OnDeviceAttached() override;
+    int64_t OnIdle() override;
+    void OnUnload() override;
+    UnloadPolicyStats GetStats() override;
+
+    static int64_t BootTimeNowMs();
+    // reads /proc/sys/kernel/random/boot_id
+    static std::string ReadBootId();
+    // reads the "some" avg10 line of /proc/pressure/memory
+    static bool IsUnderMemoryPressure();
+
+private:
+    void RestoreLocked();
+    int64_t GetHoldOffLocked(bool underPressure) const;
+    std::string SerializeLocked() const;
+    std::string GetBootId() const;
+    bool Deserialize(const std::string &state, std::string &bootId);
+
+    Clock clock_;
+    PressureProbe pressureProbe_;
+    StateLoader loader_;
+    StateSaver saver_;
+    BootIdReader bootIdReader_;
+    std::mutex mutex_;
+    bool restored_ = false;
+    // when the last device left, -1 while devices are attached
+    int64_t idleSinceMs_ = -1;
+    // the idle period began in the process before this one
+    bool idleRestored_ = false;
+    double gapAverageMs_ = 0;
+    uint64_t gapSamples_ = 0;
+    double reconnectRate_ = 1.0;
+    int64_t holdOffMs_ = DEFAULT_HOLD_OFF_MS;
+    UnloadPolicyStats stats_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // DEVICE_MANAGER_UNLOAD_POLICY_H
@@ -17,13 +17,20 @@
 #define DRIVER_EXTENSION_MANAGER_H
 #include <singleton.h>
 #include <system_ability.h>
+#include <condition_variable>
+#include <deque>
 #include <future>
+#include <thread>
 
 #include "driver_ext_mgr_stub.h"
+#include "driver_ext_mgr_types.h"
 #include "event_config.h"
+#include "startup_graph.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
+class Device;
+
 class DriverExtMgr : public SystemAbility, public DriverExtMgrStub {
     DECLARE_SYSTEM_ABILITY(DriverExtMgr)
     DECLARE_DELAYED_SINGLETON(DriverExtMgr);
@@ -46,8 +53,39 @@ public:
     virtual ErrCode QueryDriverInfo(int32_t &errorCode, std::vector<std::shared_ptr<DriverInfoData>> &driverInfos,
         bool isByDriverUid = false, const std::string &driverUid = "") override;
     virtual ErrCode NotifyUsbPeripheralFault(const std::string &domain, const std::string &faultName) override;
+    virtual ErrCode SubscribeDeviceChanges(int32_t &errorCode, const sptr<IDeviceSubscribeCallback> &callback,
+        uint64_t &sequence, std::vector<std::shared_ptr<DeviceInfoData>> &deviceInfos) override;
+    virtual ErrCode UnsubscribeDeviceChanges(int32_t &errorCode,
+        const sptr<IDeviceSubscribeCallback> &callback) override;
+    virtual ErrCode RegisterQueryCacheCallback(int32_t &errorCode, const sptr<IQueryCacheCallback> &callback,
+        uint64_t &generation) override;
+    virtual ErrCode UnregisterQueryCacheCallback(int32_t &errorCode,
+        const sptr<IQueryCacheCallback> &callback) override;
 
 private:
+    class DeviceSubscriberDeathRecipient : public IRemoteObject::DeathRecipient {
+    public:
+        DeviceSubscriberDeathRecipient() = default;
+        ~DeviceSubscriberDeathRecipient() = default;
+        void OnRemoteDied(const wptr<IRemoteObject> &remote) override;
+    };
+
+    // a change and the subscribers it goes to, copied while the device map is locked
+    struct DeviceChangeNotice {
+        std::shared_ptr<DeviceChangeDelta> delta;
+        std::vector<sptr<IDeviceSubscribeCallback>> subscribers;
+    };
+
+    void OnDeviceChanged(uint64_t sequence, DeviceChangeType type, const std::shared_ptr<Device> &device);
+    void PostDeviceChangeNotice(DeviceChangeNotice &&notice);
+    void RunDeviceChangeNotices();
+    void StopDeviceChangeNotices();
+    bool EraseDeviceSubscriberLocked(const IRemoteObject *remote);
+    void OnQueryGenerationChanged(uint64_t generation);
+    void RemoveDeviceSubscriber(const IRemoteObject *remote);
+    bool EraseQueryCacheCallbackLocked(const IRemoteObject *remote);
+    const EventConfig &GetEventConfig();
+
     std::mutex connectCallbackMutex;
     std::mutex promiseMutex_;
     std::promise<int32_t> bmsPromise_;
@@ -61,6 +99,32 @@ private:
     bool cesPromiseUsed_ = false;
     std::map<uint64_t, std::vector<sptr<IDriverExtMgrCallback>>> connectCallbackMap;
     EventConfig eventConfig_;
+    std::once_flag eventConfigOnce_;
+    std::mutex startupMutex_;
+    std::vector<StartupPhaseTiming> startupTimings_;
+    std::vector<StartupPhaseTiming> lazyTimings_;
+    std::mutex subscriberMutex_;
+    struct DeviceSubscriberEntry {
+        sptr<IDeviceSubscribeCallback> callback;
+        uint32_t tokenId;
+    };
+    std::map<const IRemoteObject *, DeviceSubscriberEntry> deviceSubscribers_;
+    // subscribers per calling token, bounded like the query cache callbacks below
+    std::map<uint32_t, uint32_t> deviceSubscriberCounts_;
+    struct QueryCacheCallbackEntry {
+        sptr<IQueryCacheCallback> callback;
+        uint32_t tokenId;
+    };
+    std::map<const IRemoteObject *, QueryCacheCallbackEntry> queryCacheCallbacks_;
+    // registered callbacks per calling token, bounded so one caller cannot pin unbounded death recipients
+    std::map<uint32_t, uint32_t> queryCacheCallbackCounts_;
+    sptr<IRemoteObject::DeathRecipient> subscriberDeathRecipient_ = new DeviceSubscriberDeathRecipient();
+    // sent one at a time in sequence order by noticeThread_, outside the device map and subscriber locks
+    std::mutex noticeMutex_;
+    std::condition_variable noticeCv_;
+    std::deque<DeviceChangeNotice> notices_;
+    std::thread noticeThread_;
+    bool noticeStopping_ = false;
 };
 } // namespace ExternalDeviceManager
 } // namespace OHOS
@@ -16,7 +16,11 @@
 #ifndef DRIVER_REPORT_SYS_EVENT_H
 #define DRIVER_REPORT_SYS_EVENT_H
 
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <string>
+#include <thread>
 #include <vector>
 #include <mutex>
 #include <memory>
@@ -51,6 +55,8 @@ typedef struct ExtDevEvent {
     std::string versionCode;   // 驱动版本
     std::string vids;          // 驱动配置的vid
     std::string pids;          // 驱动配置的pid
+    std::vector<uint16_t> vidList; // 驱动配置的vid, 上报线程格式化后填入vids
+    std::vector<uint16_t> pidList; // 驱动配置的pid, 上报线程格式化后填入pids
     int32_t userId;            // 用户Id
     std::string bundleName;    // 驱动包名
     int32_t operatType;        // 操作类型
@@ -63,6 +69,69 @@ typedef struct ExtDevEvent {
           userId(0), operatType(operatType), interfaceName(std::move(interfaceName)), errCode(0) {}
 } ExtDevEvent;
 
+// Bounded multi-producer queue drained by a single writer thread. Producers only copy the event into the
+// queue; string formatting and HiSysEventWrite happen on the writer. The first event of a kind is written
+// at once, identical events following it within the coalesce window are folded into one more write that
+// carries their count.
+class ExtDevEventReporter {
+public:
+    using Writer = std::function<int32_t(const ExtDevEvent &event, uint32_t repeatCount)>;
+    static constexpr size_t DEFAULT_CAPACITY = 512;
+    static constexpr std::chrono::milliseconds DEFAULT_COALESCE_WINDOW {1000};
+
+    struct Stats {
+        uint64_t pushed = 0;
+        uint64_t written = 0;
+        uint64_t coalesced = 0;
+        uint64_t dropped = 0;
+    };
+
+    explicit ExtDevEventReporter(Writer writer, size_t capacity = DEFAULT_CAPACITY,
+        std::chrono::milliseconds coalesceWindow = DEFAULT_COALESCE_WINDOW);
+    ~ExtDevEventReporter();
+    ExtDevEventReporter(const ExtDevEventReporter &) = delete;
+    ExtDevEventReporter &operator=(const ExtDevEventReporter &) = delete;
+
+    // never blocks on the writer, returns false and counts the event as dropped when the queue is full
+    bool Push(ExtDevEvent &&event);
+    // returns once every event pushed before the call, and every pending repeat count, has been written
+    void Flush();
+    // flushes and joins the writer thread, the next Push starts it again
+    void Stop();
+    Stats GetStats() const;
+
+private:
+    struct PendingRepeat {
+        ExtDevEvent event;
+        uint32_t count = 0;
+        std::chrono::steady_clock::time_point deadline;
+    };
+    using Clock = std::chrono::steady_clock;
+
+    void StartLocked();
+    void Run();
+    void Coalesce(ExtDevEvent &event, Clock::time_point now);
+    void WriteExpired(Clock::time_point now, bool all);
+    void Write(ExtDevEvent &event, uint32_t repeatCount);
+
+    Writer writer_;
+    size_t capacity_;
+    std::chrono::milliseconds coalesceWindow_;
+    mutable std::mutex mutex_;
+    std::condition_variable queueCv_;
+    std::condition_variable flushCv_;
+    std::vector<ExtDevEvent> queue_;
+    std::thread thread_;
+    bool running_ = false;
+    bool stopping_ = false;
+    uint64_t flushRequested_ = 0;
+    uint64_t flushDone_ = 0;
+    Stats stats_;
+    // only touched by the writer thread
+    std::map<std::string, PendingRepeat> pending_;
+    uint64_t reportedDropped_ = 0;
+};
+
 class ExtDevReportSysEvent {
 public:
     enum class EventErrCode {
@@ -100,7 +169,15 @@ public:
     static void ParseToExtDevEvent(const std::shared_ptr<DeviceInfo> &deviceInfo,
         const std::shared_ptr<DriverInfo> &driverInfo, const std::shared_ptr<ExtDevEvent> &eventObj);
 
-    static std::string ParseIdVector(std::vector<uint16_t> ids);
+    static std::string ParseIdVector(const std::vector<uint16_t> &ids);
+
+    // writes out everything still queued and stops the writer thread, called when the SA stops
+    static void FlushExternalDeviceEvents();
+
+    static ExtDevEventReporter::Stats GetReportStats();
+
+    // the synchronous HiSysEventWrite behind the reporter
+    static int32_t WriteExternalDeviceEvent(const ExtDevEvent &extDevEvent, uint32_t repeatCount);
 };
 
 } // namespace ExternalDeviceManager
@@ -60,11 +60,19 @@ public:
     shared_ptr<DriverInfo> QueryMatchDriver(shared_ptr<DeviceInfo> devInfo, const std::string &type = "");
     int32_t QueryDriverInfo(vector<shared_ptr<DriverInfo>> &driverInfos,
         bool isByDriverUid = false, const std::string &driverUid = "");
+    // match keys of the bus extension, see IBusExtension::GetMatchKeys
+    bool GetMatchKeys(const DeviceInfo &devInfo, vector<string> &keys);
+    bool GetMatchKeys(const DriverInfo &driverInfo, vector<string> &keys);
+    // small values other modules keep in pkg.db across loads of the service
+    int32_t QueryPkgState(const std::string &stateKey, std::string &stateValue);
+    int32_t UpdatePkgState(const std::string &stateKey, const std::string &stateValue);
     int32_t RegisterOnBundleUpdate(PCALLBACKFUN pFun);
     int32_t RegisterBundleCallback(std::shared_ptr<IBundleUpdateCallback> callback);
     int32_t UnRegisterOnBundleUpdate();
     int32_t RegisterBundleStatusCallback();
     bool SubscribeOsAccountSwitch();
+    // stops the worker that forwards bundle changes to the device manager, called when the SA stops
+    void StopBundleTasks();
     ~DriverPkgManager();
 
 private:
@@ -17,6 +17,11 @@
 #define DRIVER_BUNDLE_STATUS_CALLBACK_H
 
 #include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <map>
 #include <iostream>
@@ -51,8 +56,59 @@ enum ON_BUNDLE_STATUS {
 
 typedef int32_t(*PCALLBACKFUN)(int, int, const string &, const string &);
 
+struct BundleTask {
+    enum Type {
+        BUNDLE_UPDATE,
+        BUNDLE_RESET,
+        BUNDLE_RECONCILE,
+    };
+    Type type;
+    std::string bundleName;
+    int32_t userId;
+};
+
+// Runs bundle tasks one at a time, in the order they were posted, on a single worker thread. An update that is
+// still waiting absorbs later updates of the same bundle, as long as no reset or reconcile was posted in between.
+class BundleTaskQueue {
+public:
+    using Handler = std::function<void(const BundleTask &task)>;
+
+    explicit BundleTaskQueue(Handler handler);
+    ~BundleTaskQueue();
+    BundleTaskQueue(const BundleTaskQueue &) = delete;
+    BundleTaskQueue &operator=(const BundleTaskQueue &) = delete;
+
+    bool PostUpdate(const std::string &bundleName);
+    bool PostReset(const int32_t userId);
+    bool PostReconcile(const int32_t userId);
+    // drops the waiting tasks and returns once the running one is done, later posts are refused
+    void Stop();
+    // returns once nothing is waiting or running
+    void WaitIdle();
+    uint64_t GetCoalescedCount();
+
+private:
+    bool Post(BundleTask &&task);
+    void Run();
+
+    Handler handler_;
+    std::mutex mutex_;
+    std::condition_variable taskCv_;
+    std::condition_variable idleCv_;
+    std::deque<std::pair<uint64_t, BundleTask>> tasks_;
+    // bundles with an update waiting after the last reset, and the sequence number of that update
+    std::unordered_map<std::string, uint64_t> waitingUpdates_;
+    uint64_t nextSeq_ = 0;
+    uint64_t coalesced_ = 0;
+    std::thread thread_;
+    bool busy_ = false;
+    bool stopped_ = false;
+};
+
 class DrvBundleStateCallback : public IBundleStatusCallback {
 public:
+    using DriverInfosFetcher = std::function<bool(int32_t userId, std::vector<ExtensionAbilityInfo> &driverInfos)>;
+
     DrvBundleStateCallback();
     DrvBundleStateCallback(shared_future<int32_t> bmsFuture, shared_future<int32_t> accountFuture,
         shared_future<int32_t> commEventFuture);
@@ -96,23 +152,48 @@ public:
 
     void ResetInitOnce();
     void ResetMatchedBundles(const int32_t userId);
+    void StopBundleTasks();
 
 private:
+    enum class FingerprintSave {
+        SAVED,
+        // a live hook ran since the rows were read, the saved rows may be missing its change
+        RACED,
+        FAILED,
+    };
+
     std::mutex bundleMgrMutex_;
     std::mutex initOnceMutex_;
     sptr<IBundleMgr> bundleMgr_ = nullptr;
     sptr<IRemoteObject::DeathRecipient> bmsDeathRecipient_ = nullptr;
     string stiching = "This is used for Name Stiching";
     bool initOnce = false;
+    // the bundle manager state pkg.db was last rebuilt from, lets a restarted service trust pkg.db
+    static constexpr const char *BMS_FINGERPRINT_KEY = "bmsDriverFingerprint";
+    DriverInfosFetcher driverInfosFetcher_ = [this](int32_t userId, std::vector<ExtensionAbilityInfo> &driverInfos) {
+        return QueryAllDriverInfos(userId, driverInfos);
+    };
+    // serializes the fingerprint a rebuild saves with the live hooks that make it stale
+    std::mutex fingerprintMutex_;
+    uint64_t liveChanges_ = 0;
 
     shared_future<int32_t> bmsFuture_;
     shared_future<int32_t> accountFuture_;
     shared_future<int32_t> commEventFuture_;
+    BundleTaskQueue taskQueue_ {[this](const BundleTask &task) { RunBundleTask(task); }};
 
     bool QueryDriverInfos(const std::string &bundleName, const int userId,
         std::vector<ExtensionAbilityInfo> &driverInfos);
+    bool QueryAllDriverInfos(int32_t userId, std::vector<ExtensionAbilityInfo> &driverInfos);
     bool UpdateToRdb(const std::vector<ExtensionAbilityInfo> &driverInfos, const std::string &bundleName = "",
         const std::string &interfaceName = "");
+    bool HasDriverSnapshot(int32_t userId);
+    void ReconcileDriverInfosAsync(int32_t userId);
+    bool ReconcileDriverInfos(int32_t userId);
+    uint64_t GetLiveChanges();
+    FingerprintSave SaveDriverFingerprint(const std::string &fingerprint, uint64_t liveChanges);
+    void InvalidateDriverFingerprint();
+    static std::string GetDriverFingerprint(int32_t userId, const std::vector<ExtensionAbilityInfo> &driverInfos);
     void ClearDriverInfo(DriverInfo &tmpDrvInfo);
     bool GetBundleMgrProxy();
     int32_t GetCurrentActiveUserId();
@@ -123,6 +204,10 @@ private:
     PkgInfoTable CreatePkgInfoTable(const ExtensionAbilityInfo &driverInfo, string driverInfoStr);
     bool IsCurrentUserId(const int userId);
     void OnBundleDrvRemoved(const std::string &bundleName, const std::string &interfaceName);
+    void NotifyBundleChanged(const std::string &bundleName, const int userId);
+    void PostBundleUpdate(const std::string &bundleName);
+    void RunBundleTask(const BundleTask &task);
+    void QueryBundleDrivers(const std::string &bundleName, std::vector<std::shared_ptr<DriverInfo>> &drivers);
     void ResetBundleMgr();
 };
 
@@ -16,15 +16,23 @@
 #ifndef IBUNDLE_UPDATE_CALLBACK_H
 #define IBUNDLE_UPDATE_CALLBACK_H
 
+#include <memory>
 #include <string>
+#include <vector>
+#include "ext_object.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
 class IBundleUpdateCallback {
 public:
     virtual ~IBundleUpdateCallback() = default;
-    virtual void OnBundlesUpdated(const std::string &bundleName) = 0;
+    // drivers are the current pkg.db rows of the bundle, empty when it was removed; an empty bundleName
+    // means that the whole table was rebuilt
+    virtual void OnBundlesUpdated(const std::string &bundleName,
+        const std::vector<std::shared_ptr<DriverInfo>> &drivers) = 0;
     virtual void OnBundlesReseted(const int32_t oldUserId) = 0;
+    // called synchronously from the bundle add, update and remove hooks
+    virtual void OnBundleChanged(const std::string &bundleName, const int32_t userId) = 0;
 };
 }
 }
@@ -32,6 +32,7 @@ static std::string PKG_DB_PATH = "/data/service/el1/public/pkg_service/";
 
 constexpr const char *PKG_DB_NAME = "pkg.db";
 constexpr const char *PKG_TABLE_NAME = "pkgInfoTable";
+constexpr const char *PKG_STATE_TABLE_NAME = "pkgStateTable";
 constexpr int32_t DATABASE_OPEN_VERSION = 1;
 constexpr int32_t DATABASE_NEW_VERSION = 2;
 
@@ -44,11 +45,16 @@ constexpr const char *CREATE_PKG_TABLE = "CREATE TABLE IF NOT EXISTS [pkgInfoTab
                                                "[bundleName] TEXT,"
                                                "[driverName] TEXT,"
                                                "[driverInfo] TEXT );";
+// since DATABASE_NEW_VERSION, key-value state kept next to the driver rows
+constexpr const char *CREATE_PKG_STATE_TABLE = "CREATE TABLE IF NOT EXISTS [pkgStateTable]("
+                                               "[stateKey] TEXT PRIMARY KEY, "
+                                               "[stateValue] TEXT );";
 
 class PkgDataBase {
 public:
     static std::shared_ptr<PkgDataBase> GetInstance();
     int64_t Insert(const OHOS::NativeRdb::ValuesBucket &insertValues);
+    int64_t Replace(const std::string &tableName, const OHOS::NativeRdb::ValuesBucket &values);
     int32_t Update(int32_t &changedRows, const OHOS::NativeRdb::ValuesBucket &values,
         const OHOS::NativeRdb::RdbPredicates &predicates);
     int32_t Update(int32_t &changedRows, const OHOS::NativeRdb::ValuesBucket &values, const std::string &whereClause,
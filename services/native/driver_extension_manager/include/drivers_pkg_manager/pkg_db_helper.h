@@ -51,6 +51,9 @@ public:
         bool &isUpdate, const std::string &bundleName);
     int32_t QueryAllSize(std::vector<std::string> &allBundleAbility);
     int32_t AddOrUpdatePkgInfo(const std::vector<PkgInfoTable> &pkgInfos, const std::string &bundleName = "");
+    /* state kept next to the driver rows, PKG_RDB_EMPTY if the key was never written */
+    int32_t QueryPkgState(const std::string &stateKey, std::string &stateValue);
+    int32_t UpdatePkgState(const std::string &stateKey, const std::string &stateValue);
 
 private:
     PkgDbHelper();
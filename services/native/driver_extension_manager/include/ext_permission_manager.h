@@ -16,11 +16,58 @@
 #ifndef DRIVER_PERMISSION_MANAGER_H
 #define DRIVER_PERMISSION_MANAGER_H
 
+#include <chrono>
 #include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
+
+#include "iremote_object.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
+// Bounded per-token cache of permission decisions. Entries expire after ttl and are dropped early when the
+// token's permission state changes or the calling process dies.
+class ExtPermissionCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t DEFAULT_MAX_TOKENS = 64;
+    static constexpr std::chrono::milliseconds DEFAULT_TTL {30000};
+
+    explicit ExtPermissionCache(size_t maxTokens = DEFAULT_MAX_TOKENS,
+        std::chrono::milliseconds ttl = DEFAULT_TTL);
+    ~ExtPermissionCache() = default;
+
+    // a decision is only stored if nothing was invalidated since epoch was read before querying it
+    uint64_t GetEpoch();
+    bool GetGrant(uint32_t tokenId, const std::string &permissionName, bool &granted);
+    void PutGrant(uint32_t tokenId, const std::string &permissionName, bool granted, uint64_t epoch);
+    bool GetValues(uint32_t tokenId, const std::string &permissionName,
+        std::unordered_set<std::string> &permissionValues);
+    void PutValues(uint32_t tokenId, const std::string &permissionName,
+        const std::unordered_set<std::string> &permissionValues, uint64_t epoch);
+    void Invalidate(uint32_t tokenId);
+    void Clear();
+    size_t Size();
+
+private:
+    struct TokenEntry {
+        Clock::time_point lastUse;
+        std::unordered_map<std::string, std::pair<Clock::time_point, bool>> grants;
+        std::unordered_map<std::string, std::pair<Clock::time_point, std::unordered_set<std::string>>> values;
+    };
+
+    TokenEntry &AcquireEntry(uint32_t tokenId, Clock::time_point now);
+
+    size_t maxTokens_;
+    std::chrono::milliseconds ttl_;
+    std::mutex mutex_;
+    uint64_t epoch_ = 0;
+    std::unordered_map<uint32_t, TokenEntry> tokens_;
+};
+
 class ExtPermissionManager {
 public:
     static bool VerifyPermission(std::string permissionName);
@@ -33,6 +80,17 @@ public:
 
     static bool GetPermissionValues(const std::string &permissionName,
         std::unordered_set<std::string> &permissionValues);
+
+    // caches decisions for the listed permissions, only once their state changes can be observed
+    static bool EnableCache(const std::vector<std::string> &permissions);
+
+    static void DisableCache();
+
+    // forgets the decisions of the calling token once the given remote object of that caller dies
+    static void WatchCaller(const sptr<IRemoteObject> &remote);
+
+    // stops watching a remote the caller has unregistered, it no longer says anything about the caller's life
+    static void UnwatchCaller(const sptr<IRemoteObject> &remote);
 };
 } // namespace ExternalDeviceManager
 } // namespace OHOS
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STARTUP_GRAPH_H
+#define STARTUP_GRAPH_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+struct StartupPhaseTiming {
+    std::string name;
+    // both in microseconds, the start relative to the beginning of the run
+    int64_t startUs;
+    int64_t durationUs;
+};
+
+// Startup steps and what each of them needs done first. Run starts every phase as soon as its dependencies
+// are done, so phases that do not depend on each other overlap.
+class StartupGraph {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Phase = std::function<void()>;
+
+    // dependencies must have been added before, which keeps the graph free of cycles
+    bool AddPhase(const std::string &name, const std::vector<std::string> &dependencies, Phase phase);
+    // returns once every phase is done, timings are in the order the phases were added
+    std::vector<StartupPhaseTiming> Run();
+
+private:
+    struct Node {
+        std::string name;
+        std::vector<size_t> dependencies;
+        Phase phase;
+    };
+
+    std::vector<Node> nodes_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // STARTUP_GRAPH_H
@@ -29,13 +29,15 @@ static constexpr const char *BUS_EXTENSION_SO_PATH = "/system/lib";
 static constexpr const char *HDI_SO_SUFFIX = ".z.so";
 static constexpr const char *HDI_SO_PREFIX = "lib";
 static constexpr const char *USB_BUS_EXTENSION = "driver_extension_usb_bus";
+static constexpr const char *VIRTUAL_BUS_EXTENSION = "driver_extension_virtual_bus";
 
 namespace OHOS {
 namespace ExternalDeviceManager {
 IMPLEMENT_SINGLE_INSTANCE(BusExtensionCore);
 
 std::unordered_map<std::string, BusType> BusExtensionCore::busTypeMap_ = {
-    {"usb", BusType::BUS_TYPE_USB}
+    {"usb", BusType::BUS_TYPE_USB},
+    {"virtual", BusType::BUS_TYPE_VIRTUAL}
 };
 
 BusExtensionCore::~BusExtensionCore()
@@ -58,6 +60,9 @@ void BusExtensionCore::LoadBusExtensionLibs()
             case BUS_TYPE_USB:
                 libPath << USB_BUS_EXTENSION;
                 break;
+            case BUS_TYPE_VIRTUAL:
+                libPath << VIRTUAL_BUS_EXTENSION;
+                break;
             default:
                 EDM_LOGE(MODULE_DEV_MGR, "invalid bus type");
                 continue;
@@ -65,7 +70,12 @@ void BusExtensionCore::LoadBusExtensionLibs()
         libPath << HDI_SO_SUFFIX;
         char realPath[PATH_MAX + 1] = {0};
         if (realpath(libPath.str().c_str(), realPath) == nullptr) {
-            EDM_LOGE(MODULE_DEV_MGR, "invalid so path %{public}s", realPath);
+            // the virtual bus is only installed on test images
+            if (i == BUS_TYPE_VIRTUAL) {
+                EDM_LOGD(MODULE_DEV_MGR, "no so at %{public}s, skip it", libPath.str().c_str());
+            } else {
+                EDM_LOGE(MODULE_DEV_MGR, "invalid so path %{public}s", libPath.str().c_str());
+            }
             continue;
         }
         void *handler = dlopen(realPath, RTLD_LAZY);
@@ -129,6 +139,16 @@ std::shared_ptr<IBusExtension> BusExtensionCore::GetBusExtensionByName(std::stri
     return busExtensions_[busType];
 }
 
+std::shared_ptr<IBusExtension> BusExtensionCore::GetBusExtensionByType(BusType busType)
+{
+    auto iterExtension = busExtensions_.find(busType);
+    if (iterExtension == busExtensions_.end()) {
+        EDM_LOGE(MODULE_DEV_MGR, "busType %{public}d bus extension not found", busType);
+        return nullptr;
+    }
+    return iterExtension->second;
+}
+
 std::shared_ptr<IDriverChangeCallback> BusExtensionCore::AcquireDriverChangeCallback(BusType busType)
 {
     auto iterExtension = busExtensions_.find(busType);
@@ -163,19 +163,65 @@ bool UsbBusExtension::MatchDriver(const DriverInfo &driver, const DeviceInfo &de
         EDM_LOGE(MODULE_BUS_USB,  "static_cast error, the usbDriverInfo or usbDeviceInfo is nullptr");
         return false;
     }
-    string usbDrvInfoStr;
-    const_cast<UsbDriverInfo*>(usbDriverInfo)->Serialize(usbDrvInfoStr);
-    auto vidFind = find(usbDriverInfo->vids_.begin(), usbDriverInfo->vids_.end(), usbDeviceInfo->idVendor_);
-    if (vidFind == usbDriverInfo->vids_.end()) {
-        EDM_LOGI(MODULE_BUS_USB,  "vid not match\n");
+    // the vid and pid lists bind the whole device, an interface is only bound by rules on interface fields
+    bool isInterface = usbDeviceInfo->GetInterfaceNumber() >= 0;
+    bool listed = !isInterface &&
+        find(usbDriverInfo->vids_.begin(), usbDriverInfo->vids_.end(), usbDeviceInfo->idVendor_) !=
+        usbDriverInfo->vids_.end() &&
+        find(usbDriverInfo->pids_.begin(), usbDriverInfo->pids_.end(), usbDeviceInfo->idProduct_) !=
+        usbDriverInfo->pids_.end();
+    if (listed) {
+        EDM_LOGI(MODULE_BUS_USB,  "Driver and Device match sucess\n");
+        return true;
+    }
+    UsbMatchScope scope = isInterface ? UsbMatchScope::INTERFACE :
+        (usbDeviceInfo->IsComposite() ? UsbMatchScope::DEVICE : UsbMatchScope::ANY);
+    if (usbDriverInfo->ruleSet_ != nullptr && usbDriverInfo->ruleSet_->Match(*usbDeviceInfo, scope)) {
+        EDM_LOGI(MODULE_BUS_USB,  "Driver and Device match sucess by match rules\n");
+        return true;
+    }
+    EDM_LOGI(MODULE_BUS_USB,  "vid or pid not match\n");
+    return false;
+}
+
+string UsbBusExtension::MakeMatchKey(uint16_t vid, uint16_t pid)
+{
+    return "usb:" + to_string(vid) + ":" + to_string(pid);
+}
+
+bool UsbBusExtension::GetMatchKeys(const DeviceInfo &device, vector<string> &keys)
+{
+    if (device.GetBusType() != BusType::BUS_TYPE_USB) {
+        return false;
+    }
+    const UsbDeviceInfo *usbDeviceInfo = static_cast<const UsbDeviceInfo *>(&device);
+    keys.emplace_back(MakeMatchKey(usbDeviceInfo->idVendor_, usbDeviceInfo->idProduct_));
+    return true;
+}
+
+bool UsbBusExtension::GetMatchKeys(const DriverInfo &driver, vector<string> &keys)
+{
+    if (LowerStr(driver.GetBusName()) != "usb") {
+        return false;
+    }
+    const UsbDriverInfo *usbDriverInfo = static_cast<const UsbDriverInfo *>(driver.GetInfoExt().get());
+    if (usbDriverInfo == nullptr) {
         return false;
     }
-    auto pidFind = find(usbDriverInfo->pids_.begin(), usbDriverInfo->pids_.end(), usbDeviceInfo->idProduct_);
-    if (pidFind == usbDriverInfo->pids_.end()) {
-        EDM_LOGI(MODULE_BUS_USB,  "pid not match\n");
+    vector<pair<uint16_t, uint16_t>> vidPids;
+    if (usbDriverInfo->ruleSet_ != nullptr && !usbDriverInfo->ruleSet_->GetVidPids(vidPids)) {
+        // a rule on class or interface fields can match a device of any vid:pid
         return false;
     }
-    EDM_LOGI(MODULE_BUS_USB,  "Driver and Device match sucess\n");
+    keys.reserve(keys.size() + usbDriverInfo->vids_.size() * usbDriverInfo->pids_.size() + vidPids.size());
+    for (uint16_t vid : usbDriverInfo->vids_) {
+        for (uint16_t pid : usbDriverInfo->pids_) {
+            keys.emplace_back(MakeMatchKey(vid, pid));
+        }
+    }
+    for (const auto &vidPid : vidPids) {
+        keys.emplace_back(MakeMatchKey(vidPid.first, vidPid.second));
+    }
     return true;
 }
 
@@ -191,6 +237,8 @@ shared_ptr<DriverInfoExt> UsbBusExtension::ParseDriverInfo(const map<string, str
             usbDriverInfo->pids_ = this->ParseCommaStrToVectorUint16(meta.second);
         } else if (LowerStr(meta.first) == "vid") {
             usbDriverInfo->vids_ = this->ParseCommaStrToVectorUint16(meta.second);
+        } else if (LowerStr(meta.first) == "matchrules" && !usbDriverInfo->SetMatchRules(meta.second)) {
+            EDM_LOGE(MODULE_BUS_USB,  "ignore invalid matchRules: %{public}s", meta.second.c_str());
         }
     }
     return usbDriverInfo;
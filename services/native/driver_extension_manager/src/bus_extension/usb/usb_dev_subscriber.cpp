@@ -21,6 +21,7 @@
 #include <cwchar>
 #include <algorithm>
 #include "driver_report_sys_event.h"
+#include "edm_trace.h"
 namespace OHOS {
 namespace ExternalDeviceManager {
 using namespace std;
@@ -48,6 +49,19 @@ static string ToDeviceDesc(const UsbDev& usbDev, const UsbDevDescLite& desc)
     return string(buffer);
 }
 
+static string ToInterfaceDesc(const UsbDev& usbDev, const UsbDevDescLite& desc,
+    const UsbInterfaceDescriptor& interfaceDesc)
+{
+    char buffer[MAX_DEV_ID_SIZE];
+    auto ret = sprintf_s(buffer, sizeof(buffer), "&IF_%02X&ICLASS_%02X", interfaceDesc.bInterfaceNumber,
+        interfaceDesc.bInterfaceClass);
+    if (ret < 0) {
+        EDM_LOGE(MODULE_BUS_USB,  "ToInterfaceDesc sprintf_s error. ret = %{public}d", ret);
+        return string();
+    }
+    return ToDeviceDesc(usbDev, desc) + buffer;
+}
+
 static uint32_t ToBusDeivceId(const UsbDev& usbDev)
 {
     uint32_t devId = (usbDev.busNum << SHIFT_16) + usbDev.devAddr;
@@ -61,18 +75,7 @@ static uint64_t ToDdkDeviceId(const UsbDev& usbDev)
 
 static uint64_t ToExtDevId(const UsbDev& usbDev)
 {
-    union DevInfo {
-        uint64_t deviceId;
-        struct {
-            BusType busType;
-            uint32_t busDeviceId;
-        } devBusInfo;
-    } devInfo;
-
-    devInfo.devBusInfo.busType = BusType::BUS_TYPE_USB;
-    devInfo.devBusInfo.busDeviceId = ToBusDeivceId(usbDev);
-
-    return devInfo.deviceId;
+    return UsbDeviceInfo(ToBusDeivceId(usbDev)).GetDeviceId();
 }
 
 #ifdef EXTDEVMGR_USB_PASS_THROUGH
@@ -157,6 +160,7 @@ int32_t UsbDevSubscriber::GetUsbDeviceDescriptor(const UsbDev &usbDev, UsbDevDes
 
 int32_t UsbDevSubscriber::OnDeviceConnect(const UsbDev &usbDev)
 {
+    EdmTraceScope trace(TRACE_USB_DEVICE_CONNECT, ToExtDevId(usbDev));
     std::shared_ptr<ExtDevEvent> extDevEvent = std::make_shared<ExtDevEvent>(__func__, GET_DEVICE_INFO,
         ToExtDevId(usbDev));
     int32_t ret = 0;
@@ -199,6 +203,9 @@ int32_t UsbDevSubscriber::OnDeviceConnect(const UsbDev &usbDev)
             ExtDevReportSysEvent::EventErrCode::GET_INTERFACE_DESCRIPTOR_FAILED);
         return ret;
     }
+    if (usbDevInfo->IsComposite()) {
+        AddInterfaceInfos(usbDev, deviceDescriptor, usbDevInfo);
+    }
     ExtDevReportSysEvent::ReportExternalDeviceEvent(extDevEvent, ExtDevReportSysEvent::EventErrCode::SUCCESS);
     (void)this->iusb_->CloseDevice(usbDev);
     if (this->callback_ != nullptr) {
@@ -207,6 +214,21 @@ int32_t UsbDevSubscriber::OnDeviceConnect(const UsbDev &usbDev)
     return EDM_OK;
 };
 
+void UsbDevSubscriber::AddInterfaceInfos(const UsbDev &usbDev, const UsbDevDescLite &deviceDescriptor,
+    shared_ptr<UsbDeviceInfo> &usbDevInfo)
+{
+    for (const auto &interfaceDesc : usbDevInfo->interfaceDescList_) {
+        auto interfaceInfo = make_shared<UsbDeviceInfo>(ToBusDeivceId(usbDev),
+            ToInterfaceDesc(usbDev, deviceDescriptor, interfaceDesc));
+        SetUsbDevInfoValue(deviceDescriptor, interfaceInfo, usbDevInfo->snNum_);
+        interfaceInfo->SetInterfaceNumber(interfaceDesc.bInterfaceNumber);
+        interfaceInfo->interfaceDescList_.push_back(interfaceDesc);
+        usbDevInfo->interfaceInfos_.push_back(interfaceInfo);
+    }
+    EDM_LOGI(MODULE_BUS_USB, "composite device %{public}s has %{public}zu interfaces",
+        usbDevInfo->GetDeviceDescription().c_str(), usbDevInfo->interfaceInfos_.size());
+}
+
 int32_t UsbDevSubscriber::OnDeviceDisconnect(const UsbDev &usbDev)
 {
     EDM_LOGD(MODULE_BUS_USB,  "OnDeviceDisconnect enter");
@@ -289,6 +311,7 @@ void UsbDevSubscriber::SetUsbDevInfoValue(const UsbDevDescLite &deviceDescriptor
     usbDevInfo->bcdUSB_ = deviceDescriptor.bcdUSB;
     usbDevInfo->idProduct_ = deviceDescriptor.idProduct;
     usbDevInfo->idVendor_ = deviceDescriptor.idVendor;
+    usbDevInfo->bcdDevice_ = deviceDescriptor.bcdDevice;
     usbDevInfo->deviceClass_ = deviceDescriptor.bDeviceClass;
     usbDevInfo->deviceSubClass_ = deviceDescriptor.bDeviceSubClass;
     usbDevInfo->deviceProtocol_ = deviceDescriptor.bDeviceProtocol;
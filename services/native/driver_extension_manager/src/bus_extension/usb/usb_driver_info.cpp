@@ -76,6 +76,22 @@ static bool GetObjectItem(const cJSON *jsonObj, const string &key, vector<uint16
     return true;
 }
 
+bool UsbDriverInfo::SetMatchRules(const string &matchRules)
+{
+    matchRules_.clear();
+    ruleSet_ = nullptr;
+    if (matchRules.empty()) {
+        return true;
+    }
+    auto ruleSet = std::make_shared<UsbMatchRuleSet>();
+    if (!ruleSet->Compile(matchRules)) {
+        return false;
+    }
+    matchRules_ = matchRules;
+    ruleSet_ = ruleSet;
+    return true;
+}
+
 int32_t UsbDriverInfo::Serialize(string &driverStr)
 {
     cJSON* jsonRoot = cJSON_CreateObject();
@@ -89,6 +105,11 @@ int32_t UsbDriverInfo::Serialize(string &driverStr)
         cJSON_Delete(jsonRoot);
         return EDM_ERR_JSON_OBJ_ERR;
     }
+    if (!matchRules_.empty() && !cJSON_AddStringToObject(jsonRoot, "matchRules", matchRules_.c_str())) {
+        EDM_LOGE(MODULE_BUS_USB,  "Add matchRules to jsonRoot error");
+        cJSON_Delete(jsonRoot);
+        return EDM_ERR_JSON_OBJ_ERR;
+    }
     char *tempStr = cJSON_PrintUnformatted(jsonRoot);
     driverStr = tempStr;
     cJSON_free(tempStr);
@@ -120,6 +141,19 @@ int32_t UsbDriverInfo::UnSerialize(const string &driverStr)
         return EDM_ERR_JSON_OBJ_ERR;
     }
 
+    // optional, drivers written before match rules existed have none
+    cJSON* rules = cJSON_GetObjectItem(jsonObj, "matchRules");
+    if (rules != nullptr && !cJSON_IsString(rules)) {
+        EDM_LOGE(MODULE_BUS_USB,  "json member type error, matchRules type is : %{public}d", rules->type);
+        cJSON_Delete(jsonObj);
+        return EDM_ERR_JSON_OBJ_ERR;
+    }
+    if (!SetMatchRules(rules != nullptr ? rules->valuestring : "")) {
+        EDM_LOGE(MODULE_BUS_USB,  "json member matchRules error");
+        cJSON_Delete(jsonObj);
+        return EDM_ERR_JSON_OBJ_ERR;
+    }
+
     EDM_LOGD(MODULE_BUS_USB,  "member type check sucess");
     this->pids_ = pids_;
     this->vids_ = vids_;
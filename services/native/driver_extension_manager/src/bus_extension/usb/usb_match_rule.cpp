@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "usb_match_rule.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "hilog_wrapper.h"
+#include "string_ex.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr uint16_t BYTE_LIMIT = UINT8_MAX;
+constexpr size_t MAX_HEX_DIGITS = 4;
+constexpr size_t HEX_PREFIX_LEN = 2;
+constexpr int HEX_BASE = 16;
+constexpr int HEX_LETTER_OFFSET = 10;
+// beyond this a change of the driver simply re-matches all devices
+constexpr size_t MAX_MATCH_KEYS = 4096;
+
+const std::pair<const char *, UsbMatchField> FIELD_NAMES[] = {
+    {"vid", UsbMatchField::VID},
+    {"pid", UsbMatchField::PID},
+    {"bcddevice", UsbMatchField::BCD_DEVICE},
+    {"class", UsbMatchField::CLASS},
+    {"subclass", UsbMatchField::SUBCLASS},
+    {"protocol", UsbMatchField::PROTOCOL},
+    {"ifclass", UsbMatchField::IF_CLASS},
+    {"ifsubclass", UsbMatchField::IF_SUBCLASS},
+    {"ifprotocol", UsbMatchField::IF_PROTOCOL},
+};
+
+std::vector<std::string> Split(const std::string &text, char delimiter)
+{
+    std::vector<std::string> parts;
+    size_t begin = 0;
+    while (true) {
+        size_t end = text.find(delimiter, begin);
+        parts.emplace_back(TrimStr(text.substr(begin, end == std::string::npos ? std::string::npos : end - begin)));
+        if (end == std::string::npos) {
+            return parts;
+        }
+        begin = end + 1;
+    }
+}
+} // namespace
+
+bool UsbMatchRuleSet::Compile(const std::string &text)
+{
+    hashField_ = UsbMatchField::COUNT;
+    predicates_.clear();
+    rules_.clear();
+    buckets_.clear();
+    unhashed_.clear();
+    vidPids_.clear();
+    keyed_ = false;
+
+    std::vector<std::vector<UsbFieldPredicate>> rules;
+    for (const auto &ruleText : Split(text, ';')) {
+        if (ruleText.empty()) {
+            continue;
+        }
+        std::vector<UsbFieldPredicate> rule;
+        if (!ParseRule(ruleText, rule)) {
+            EDM_LOGE(MODULE_BUS_USB, "invalid match rule: %{public}s", ruleText.c_str());
+            return false;
+        }
+        rules.emplace_back(std::move(rule));
+    }
+    hashField_ = SelectHashField(rules);
+    for (const auto &rule : rules) {
+        AddRule(rule);
+    }
+    CollectVidPids(rules);
+    EDM_LOGD(MODULE_BUS_USB, "%{public}zu match rules, %{public}zu buckets, %{public}zu unhashed", rules_.size(),
+        buckets_.size(), unhashed_.size());
+    return true;
+}
+
+bool UsbMatchRuleSet::Match(const UsbDeviceInfo &device, UsbMatchScope scope) const
+{
+    if (hashField_ != UsbMatchField::COUNT) {
+        auto bucket = buckets_.find(GetFieldValue(device, hashField_));
+        if (bucket != buckets_.end()) {
+            for (uint32_t index : bucket->second) {
+                if (MatchRule(rules_[index], device, scope)) {
+                    return true;
+                }
+            }
+        }
+    }
+    for (uint32_t index : unhashed_) {
+        if (MatchRule(rules_[index], device, scope)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UsbMatchRuleSet::GetVidPids(std::vector<std::pair<uint16_t, uint16_t>> &pairs) const
+{
+    if (!keyed_) {
+        return false;
+    }
+    pairs.insert(pairs.end(), vidPids_.begin(), vidPids_.end());
+    return true;
+}
+
+bool UsbMatchRuleSet::ParseRule(const std::string &text, std::vector<UsbFieldPredicate> &predicates)
+{
+    for (const auto &predicateText : Split(text, ',')) {
+        UsbFieldPredicate predicate;
+        if (!ParsePredicate(predicateText, predicate)) {
+            return false;
+        }
+        // a wildcard holds for every value
+        if (predicate.mask != 0) {
+            predicates.push_back(predicate);
+        }
+    }
+    return predicates.size() <= UINT16_MAX;
+}
+
+bool UsbMatchRuleSet::ParsePredicate(const std::string &text, UsbFieldPredicate &predicate)
+{
+    size_t pos = text.find('=');
+    if (pos == std::string::npos || !ParseField(TrimStr(text.substr(0, pos)), predicate.field)) {
+        return false;
+    }
+    uint16_t limit = (predicate.field == UsbMatchField::VID || predicate.field == UsbMatchField::PID ||
+        predicate.field == UsbMatchField::BCD_DEVICE) ? UINT16_MAX : BYTE_LIMIT;
+    std::string value = TrimStr(text.substr(pos + 1));
+    if (value == "*") {
+        predicate.min = 0;
+        predicate.max = 0;
+        predicate.mask = 0;
+        return true;
+    }
+    predicate.mask = UINT16_MAX;
+    if ((pos = value.find('-')) != std::string::npos) {
+        return ParseNumber(value.substr(0, pos), limit, predicate.min) &&
+            ParseNumber(value.substr(pos + 1), limit, predicate.max) && predicate.min <= predicate.max;
+    }
+    if ((pos = value.find('/')) != std::string::npos) {
+        if (!ParseNumber(value.substr(0, pos), limit, predicate.min) ||
+            !ParseNumber(value.substr(pos + 1), limit, predicate.mask) || predicate.mask == 0) {
+            return false;
+        }
+        predicate.min &= predicate.mask;
+        predicate.max = predicate.min;
+        return true;
+    }
+    if (!ParseNumber(value, limit, predicate.min)) {
+        return false;
+    }
+    predicate.max = predicate.min;
+    return true;
+}
+
+bool UsbMatchRuleSet::ParseField(const std::string &name, UsbMatchField &field)
+{
+    std::string lower = LowerStr(name);
+    for (const auto &fieldName : FIELD_NAMES) {
+        if (lower == fieldName.first) {
+            field = fieldName.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UsbMatchRuleSet::ParseNumber(const std::string &text, uint16_t limit, uint16_t &value)
+{
+    std::string digits = TrimStr(text);
+    if (digits.size() > 1 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+        digits = digits.substr(HEX_PREFIX_LEN);
+    }
+    if (digits.empty() || digits.size() > MAX_HEX_DIGITS) {
+        return false;
+    }
+    uint32_t result = 0;
+    for (char c : digits) {
+        int digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + HEX_LETTER_OFFSET;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + HEX_LETTER_OFFSET;
+        } else {
+            return false;
+        }
+        result = result * HEX_BASE + static_cast<uint32_t>(digit);
+    }
+    if (result > limit) {
+        return false;
+    }
+    value = static_cast<uint16_t>(result);
+    return true;
+}
+
+bool UsbMatchRuleSet::IsInterfaceField(UsbMatchField field)
+{
+    return field == UsbMatchField::IF_CLASS || field == UsbMatchField::IF_SUBCLASS ||
+        field == UsbMatchField::IF_PROTOCOL;
+}
+
+uint16_t UsbMatchRuleSet::GetFieldValue(const UsbDeviceInfo &device, UsbMatchField field)
+{
+    switch (field) {
+        case UsbMatchField::VID:
+            return device.GetVendorId();
+        case UsbMatchField::PID:
+            return device.GetProductId();
+        case UsbMatchField::BCD_DEVICE:
+            return device.GetBcdDevice();
+        case UsbMatchField::CLASS:
+            return device.GetDeviceClass();
+        case UsbMatchField::SUBCLASS:
+            return device.GetDeviceSubClass();
+        case UsbMatchField::PROTOCOL:
+            return device.GetDeviceProtocol();
+        default:
+            return 0;
+    }
+}
+
+uint16_t UsbMatchRuleSet::GetFieldValue(const UsbInterfaceDescriptor &desc, UsbMatchField field)
+{
+    switch (field) {
+        case UsbMatchField::IF_CLASS:
+            return desc.bInterfaceClass;
+        case UsbMatchField::IF_SUBCLASS:
+            return desc.bInterfaceSubClass;
+        case UsbMatchField::IF_PROTOCOL:
+            return desc.bInterfaceProtocol;
+        default:
+            return 0;
+    }
+}
+
+UsbMatchField UsbMatchRuleSet::SelectHashField(const std::vector<std::vector<UsbFieldPredicate>> &rules)
+{
+    UsbMatchField best = UsbMatchField::COUNT;
+    size_t bestRules = 0;
+    size_t bestValues = 0;
+    for (uint8_t i = 0; i < static_cast<uint8_t>(UsbMatchField::IF_CLASS); i++) {
+        UsbMatchField field = static_cast<UsbMatchField>(i);
+        size_t fixedRules = 0;
+        std::unordered_set<uint16_t> values;
+        for (const auto &rule : rules) {
+            auto pos = std::find_if(rule.begin(), rule.end(), [field](const UsbFieldPredicate &predicate) {
+                return predicate.field == field && predicate.IsExact();
+            });
+            if (pos != rule.end()) {
+                fixedRules++;
+                values.insert(pos->min);
+            }
+        }
+        // the field fixed by the most rules leaves the fewest unhashed, more values make smaller buckets
+        if (fixedRules > bestRules || (fixedRules == bestRules && fixedRules > 0 && values.size() > bestValues)) {
+            best = field;
+            bestRules = fixedRules;
+            bestValues = values.size();
+        }
+    }
+    return best;
+}
+
+void UsbMatchRuleSet::AddRule(const std::vector<UsbFieldPredicate> &rule)
+{
+    uint32_t index = static_cast<uint32_t>(rules_.size());
+    CompiledRule compiled = {static_cast<uint32_t>(predicates_.size()), 0, 0};
+    bool hashed = false;
+    for (const auto &predicate : rule) {
+        if (!hashed && predicate.field == hashField_ && predicate.IsExact()) {
+            buckets_[predicate.min].push_back(index);
+            hashed = true;
+        } else if (!IsInterfaceField(predicate.field)) {
+            predicates_.push_back(predicate);
+            compiled.deviceCount++;
+        }
+    }
+    for (const auto &predicate : rule) {
+        if (IsInterfaceField(predicate.field)) {
+            predicates_.push_back(predicate);
+            compiled.interfaceCount++;
+        }
+    }
+    if (!hashed) {
+        unhashed_.push_back(index);
+    }
+    rules_.push_back(compiled);
+}
+
+void UsbMatchRuleSet::CollectVidPids(const std::vector<std::vector<UsbFieldPredicate>> &rules)
+{
+    std::vector<std::pair<uint16_t, uint16_t>> pairs;
+    for (const auto &rule : rules) {
+        auto vidPos = std::find_if(rule.begin(), rule.end(), [](const UsbFieldPredicate &predicate) {
+            return predicate.field == UsbMatchField::VID && predicate.IsExact();
+        });
+        if (vidPos == rule.end()) {
+            return;
+        }
+        uint16_t vid = vidPos->min;
+        uint32_t pidMin = 0;
+        uint32_t pidMax = UINT16_MAX;
+        bool vidHolds = true;
+        for (const auto &predicate : rule) {
+            if (predicate.field == UsbMatchField::VID) {
+                vidHolds = vidHolds && predicate.Test(vid);
+            } else if (predicate.field == UsbMatchField::PID) {
+                if (predicate.mask != UINT16_MAX) {
+                    return;
+                }
+                pidMin = std::max<uint32_t>(pidMin, predicate.min);
+                pidMax = std::min<uint32_t>(pidMax, predicate.max);
+            }
+        }
+        if (!vidHolds || pidMin > pidMax) {
+            // never holds, nothing to key
+            continue;
+        }
+        if (pidMax - pidMin + 1 > MAX_KEYED_PID_RANGE || pairs.size() + pidMax - pidMin + 1 > MAX_MATCH_KEYS) {
+            return;
+        }
+        for (uint32_t pid = pidMin; pid <= pidMax; pid++) {
+            pairs.emplace_back(vid, static_cast<uint16_t>(pid));
+        }
+    }
+    keyed_ = true;
+    vidPids_ = std::move(pairs);
+}
+
+bool UsbMatchRuleSet::MatchRule(const CompiledRule &rule, const UsbDeviceInfo &device, UsbMatchScope scope) const
+{
+    if ((scope == UsbMatchScope::DEVICE && rule.interfaceCount != 0) ||
+        (scope == UsbMatchScope::INTERFACE && rule.interfaceCount == 0)) {
+        return false;
+    }
+    const UsbFieldPredicate *predicate = predicates_.data() + rule.begin;
+    for (uint16_t i = 0; i < rule.deviceCount; i++, predicate++) {
+        if (!predicate->Test(GetFieldValue(device, predicate->field))) {
+            return false;
+        }
+    }
+    if (rule.interfaceCount == 0) {
+        return true;
+    }
+    for (const auto &desc : device.interfaceDescList_) {
+        bool holds = true;
+        for (uint16_t i = 0; i < rule.interfaceCount && holds; i++) {
+            holds = predicate[i].Test(GetFieldValue(desc, predicate[i].field));
+        }
+        if (holds) {
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
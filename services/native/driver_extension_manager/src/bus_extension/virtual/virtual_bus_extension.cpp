@@ -0,0 +1,300 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+#include "string_ex.h"
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "bus_extension_core.h"
+#include "virtual_bus_extension.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+
+static constexpr const char *VIRTUAL_BUS_NAME = "virtual";
+static constexpr int HEX_BASE = 16;
+
+BusType VirtualBusExtension::GetBusType()
+{
+    return BusType::BUS_TYPE_VIRTUAL;
+}
+
+shared_ptr<IDriverChangeCallback> VirtualBusExtension::AcquireDriverChangeCallback()
+{
+    // there is no DDK behind the bus to tell about drivers
+    return nullptr;
+}
+
+int32_t VirtualBusExtension::SetDevChangeCallback(shared_ptr<IDevChangeCallback> callback)
+{
+    {
+        lock_guard<mutex> lock(busMutex_);
+        callback_ = callback;
+        // devices attached before anyone listened are reported now, like a real bus enumerates at start
+        for (const auto &[_, device] : attached_) {
+            if (callback_ != nullptr) {
+                (void)callback_->OnDeviceAdd(device);
+            }
+        }
+    }
+#ifdef EXTDEVMGR_VIRTUAL_BUS_AUTOPLAY
+    if (access(DEFAULT_SCRIPT_PATH, F_OK) == 0 && LoadScript(DEFAULT_SCRIPT_PATH) < 0) {
+        EDM_LOGE(MODULE_BUS_VIRTUAL, "play %{public}s failed", DEFAULT_SCRIPT_PATH);
+    }
+#endif // EXTDEVMGR_VIRTUAL_BUS_AUTOPLAY
+    return EDM_OK;
+}
+
+int32_t VirtualBusExtension::Attach(shared_ptr<VirtualDeviceInfo> device)
+{
+    lock_guard<mutex> lock(busMutex_);
+    return AttachLocked(device);
+}
+
+int32_t VirtualBusExtension::AttachLocked(shared_ptr<VirtualDeviceInfo> device)
+{
+    if (device == nullptr) {
+        return EDM_ERR_INVALID_PARAM;
+    }
+    if (!attached_.emplace(device->GetBusDevId(), device).second) {
+        EDM_LOGE(MODULE_BUS_VIRTUAL, "busDeviceId %{public}u is attached already", device->GetBusDevId());
+        return EDM_ERR_DEVICE_BUSY;
+    }
+    EDM_LOGD(MODULE_BUS_VIRTUAL, "attach busDeviceId %{public}u, %{public}04x:%{public}04x", device->GetBusDevId(),
+        device->GetVendorId(), device->GetProductId());
+    return callback_ != nullptr ? callback_->OnDeviceAdd(device) : EDM_OK;
+}
+
+int32_t VirtualBusExtension::Detach(uint32_t busDeviceId)
+{
+    lock_guard<mutex> lock(busMutex_);
+    return DetachLocked(busDeviceId);
+}
+
+int32_t VirtualBusExtension::DetachLocked(uint32_t busDeviceId)
+{
+    auto iter = attached_.find(busDeviceId);
+    if (iter == attached_.end()) {
+        EDM_LOGE(MODULE_BUS_VIRTUAL, "busDeviceId %{public}u is not attached", busDeviceId);
+        return EDM_ERR_INVALID_PARAM;
+    }
+    shared_ptr<VirtualDeviceInfo> device = iter->second;
+    attached_.erase(iter);
+    EDM_LOGD(MODULE_BUS_VIRTUAL, "detach busDeviceId %{public}u", busDeviceId);
+    return callback_ != nullptr ? callback_->OnDeviceRemove(device) : EDM_OK;
+}
+
+size_t VirtualBusExtension::GetAttachedCount()
+{
+    lock_guard<mutex> lock(busMutex_);
+    return attached_.size();
+}
+
+bool VirtualBusExtension::ParseNumber(const string &text, uint32_t limit, uint32_t &value)
+{
+    string digits = text;
+    if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+        digits = digits.substr(2);
+    }
+    if (digits.empty() || digits.size() > sizeof(uint32_t) * 2 ||
+        !all_of(digits.begin(), digits.end(), [](char c) { return isxdigit(static_cast<unsigned char>(c)); })) {
+        return false;
+    }
+    unsigned long number = stoul(digits, nullptr, HEX_BASE);
+    if (number > limit) {
+        return false;
+    }
+    value = static_cast<uint32_t>(number);
+    return true;
+}
+
+int32_t VirtualBusExtension::RunLine(const string &line)
+{
+    istringstream tokens(line.substr(0, line.find('#')));
+    string event;
+    if (!(tokens >> event)) {
+        return 0;
+    }
+    string busDeviceIdText;
+    uint32_t busDeviceId = 0;
+    if (!(tokens >> busDeviceIdText) || !ParseNumber(busDeviceIdText, UINT32_MAX, busDeviceId)) {
+        return -1;
+    }
+    if (event == "detach") {
+        string rest;
+        if (tokens >> rest) {
+            return -1;
+        }
+        (void)DetachLocked(busDeviceId);
+        return 1;
+    }
+    if (event != "attach") {
+        return -1;
+    }
+    string name;
+    uint32_t vid = 0;
+    uint32_t pid = 0;
+    uint32_t deviceClass = 0;
+    string field;
+    while (tokens >> field) {
+        size_t pos = field.find('=');
+        if (pos == string::npos) {
+            return -1;
+        }
+        string key = LowerStr(field.substr(0, pos));
+        string text = field.substr(pos + 1);
+        bool parsed = false;
+        if (key == "name") {
+            name = text;
+            parsed = true;
+        } else if (key == "vid") {
+            parsed = ParseNumber(text, UINT16_MAX, vid);
+        } else if (key == "pid") {
+            parsed = ParseNumber(text, UINT16_MAX, pid);
+        } else if (key == "class") {
+            parsed = ParseNumber(text, UINT8_MAX, deviceClass);
+        }
+        if (!parsed) {
+            return -1;
+        }
+    }
+    auto device = make_shared<VirtualDeviceInfo>(busDeviceId, name);
+    device->SetVendorId(static_cast<uint16_t>(vid));
+    device->SetProductId(static_cast<uint16_t>(pid));
+    device->SetDeviceClass(static_cast<uint8_t>(deviceClass));
+    // a device the manager refuses is still an event of the script
+    (void)AttachLocked(device);
+    return 1;
+}
+
+int32_t VirtualBusExtension::RunScript(const string &script)
+{
+    lock_guard<mutex> lock(busMutex_);
+    istringstream lines(script);
+    string line;
+    int32_t played = 0;
+    uint32_t lineNo = 0;
+    while (getline(lines, line)) {
+        lineNo++;
+        int32_t ret = RunLine(line);
+        if (ret < 0) {
+            EDM_LOGE(MODULE_BUS_VIRTUAL, "script line %{public}u does not parse: %{public}s", lineNo, line.c_str());
+            return -1;
+        }
+        played += ret;
+    }
+    return played;
+}
+
+int32_t VirtualBusExtension::LoadScript(const string &path)
+{
+    ifstream file(path);
+    if (!file.is_open()) {
+        EDM_LOGE(MODULE_BUS_VIRTUAL, "open %{public}s failed", path.c_str());
+        return -1;
+    }
+    stringstream script;
+    script << file.rdbuf();
+    return RunScript(script.str());
+}
+
+bool VirtualBusExtension::MatchDriver(const DriverInfo &driver, const DeviceInfo &device, const std::string &type)
+{
+    if (LowerStr(driver.GetBusName()) != VIRTUAL_BUS_NAME || device.GetBusType() != BusType::BUS_TYPE_VIRTUAL) {
+        return false;
+    }
+    const VirtualDriverInfo *driverInfo = static_cast<const VirtualDriverInfo *>(driver.GetInfoExt().get());
+    if (driverInfo == nullptr) {
+        return false;
+    }
+    const VirtualDeviceInfo &deviceInfo = static_cast<const VirtualDeviceInfo &>(device);
+    return find(driverInfo->vids_.begin(), driverInfo->vids_.end(), deviceInfo.GetVendorId()) !=
+        driverInfo->vids_.end() &&
+        find(driverInfo->pids_.begin(), driverInfo->pids_.end(), deviceInfo.GetProductId()) !=
+        driverInfo->pids_.end();
+}
+
+string VirtualBusExtension::MakeMatchKey(uint16_t vid, uint16_t pid)
+{
+    return string(VIRTUAL_BUS_NAME) + ":" + to_string(vid) + ":" + to_string(pid);
+}
+
+bool VirtualBusExtension::GetMatchKeys(const DeviceInfo &device, vector<string> &keys)
+{
+    if (device.GetBusType() != BusType::BUS_TYPE_VIRTUAL) {
+        return false;
+    }
+    const VirtualDeviceInfo &deviceInfo = static_cast<const VirtualDeviceInfo &>(device);
+    keys.emplace_back(MakeMatchKey(deviceInfo.GetVendorId(), deviceInfo.GetProductId()));
+    return true;
+}
+
+bool VirtualBusExtension::GetMatchKeys(const DriverInfo &driver, vector<string> &keys)
+{
+    if (LowerStr(driver.GetBusName()) != VIRTUAL_BUS_NAME) {
+        return false;
+    }
+    const VirtualDriverInfo *driverInfo = static_cast<const VirtualDriverInfo *>(driver.GetInfoExt().get());
+    if (driverInfo == nullptr) {
+        return false;
+    }
+    for (uint16_t vid : driverInfo->vids_) {
+        for (uint16_t pid : driverInfo->pids_) {
+            keys.emplace_back(MakeMatchKey(vid, pid));
+        }
+    }
+    return true;
+}
+
+shared_ptr<DriverInfoExt> VirtualBusExtension::ParseDriverInfo(const map<string, string> &metadata)
+{
+    shared_ptr<VirtualDriverInfo> driverInfo = make_shared<VirtualDriverInfo>();
+    for (const auto &meta : metadata) {
+        string key = LowerStr(meta.first);
+        if (key != "vid" && key != "pid") {
+            continue;
+        }
+        vector<uint16_t> &ids = key == "vid" ? driverInfo->vids_ : driverInfo->pids_;
+        stringstream ss(meta.second);
+        string item;
+        while (getline(ss, item, ',')) {
+            uint32_t value = 0;
+            if (!ParseNumber(item, UINT16_MAX, value)) {
+                EDM_LOGW(MODULE_BUS_VIRTUAL, "ignore invalid %{public}s: %{public}s", key.c_str(), item.c_str());
+                continue;
+            }
+            ids.push_back(static_cast<uint16_t>(value));
+        }
+    }
+    return driverInfo;
+}
+
+shared_ptr<DriverInfoExt> VirtualBusExtension::GetNewDriverInfoExtObject()
+{
+    return make_shared<VirtualDriverInfo>();
+}
+
+__attribute__ ((constructor)) static void RegBusExtension()
+{
+    EDM_LOGI(MODULE_COMMON, "installing VirtualBusExtension");
+    RegisterBusExtension<VirtualBusExtension>(BusType::BUS_TYPE_VIRTUAL);
+}
+}
+}
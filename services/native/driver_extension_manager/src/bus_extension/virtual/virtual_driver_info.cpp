@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hilog_wrapper.h"
+#include "edm_errors.h"
+#include "virtual_driver_info.h"
+#include "cJSON.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+
+static bool SetArrayToObj(cJSON *obj, const string &key, const vector<uint16_t> &arr)
+{
+    cJSON* array = cJSON_CreateArray();
+    if (!array) {
+        EDM_LOGE(MODULE_BUS_VIRTUAL, "Create %{public}s error", key.c_str());
+        return false;
+    }
+    for (const auto item : arr) {
+        if (!cJSON_AddItemToArray(array, cJSON_CreateNumber(static_cast<double>(item)))) {
+            EDM_LOGE(MODULE_BUS_VIRTUAL, "AddItemToArray error, key:%{public}s", key.c_str());
+            cJSON_Delete(array);
+            return false;
+        }
+    }
+    if (!cJSON_AddItemToObject(obj, key.c_str(), array)) {
+        EDM_LOGE(MODULE_BUS_VIRTUAL, "Add %{public}s to jsonRoot error", key.c_str());
+        cJSON_Delete(array);
+        return false;
+    }
+    return true;
+}
+
+static bool GetObjectItem(const cJSON *jsonObj, const string &key, vector<uint16_t> &array)
+{
+    cJSON* item = cJSON_GetObjectItem(jsonObj, key.c_str());
+    if (!item || item->type != cJSON_Array) {
+        EDM_LOGE(MODULE_BUS_VIRTUAL, "json member error, need array member: %{public}s", key.c_str());
+        return false;
+    }
+    for (int i = 0; i < cJSON_GetArraySize(item); i++) {
+        cJSON* it = cJSON_GetArrayItem(item, i);
+        if (!it || it->type != cJSON_Number) {
+            EDM_LOGE(MODULE_BUS_VIRTUAL, "json %{public}s item error", key.c_str());
+            return false;
+        }
+        array.push_back(static_cast<uint16_t>(it->valuedouble));
+    }
+    return true;
+}
+
+int32_t VirtualDriverInfo::Serialize(string &driverStr)
+{
+    cJSON* jsonRoot = cJSON_CreateObject();
+    if (!jsonRoot) {
+        EDM_LOGE(MODULE_BUS_VIRTUAL, "Create jsonRoot error");
+        return EDM_ERR_JSON_OBJ_ERR;
+    }
+    if (!SetArrayToObj(jsonRoot, "pids", pids_) || !SetArrayToObj(jsonRoot, "vids", vids_)) {
+        cJSON_Delete(jsonRoot);
+        return EDM_ERR_JSON_OBJ_ERR;
+    }
+    char *tempStr = cJSON_PrintUnformatted(jsonRoot);
+    driverStr = tempStr;
+    cJSON_free(tempStr);
+    cJSON_Delete(jsonRoot);
+    return EDM_OK;
+}
+
+int32_t VirtualDriverInfo::UnSerialize(const string &driverStr)
+{
+    cJSON* jsonObj = cJSON_Parse(driverStr.c_str());
+    if (!jsonObj) {
+        EDM_LOGE(MODULE_BUS_VIRTUAL, "UnSeiralize error, parse json string error, str is : %{public}s",
+            driverStr.c_str());
+        return EDM_ERR_JSON_PARSE_FAIL;
+    }
+    vector<uint16_t> vids;
+    vector<uint16_t> pids;
+    if (!GetObjectItem(jsonObj, "pids", pids) || !GetObjectItem(jsonObj, "vids", vids)) {
+        cJSON_Delete(jsonObj);
+        return EDM_ERR_JSON_OBJ_ERR;
+    }
+    pids_ = pids;
+    vids_ = vids;
+    cJSON_Delete(jsonObj);
+    return EDM_OK;
+}
+}
+}
@@ -18,15 +18,25 @@
 
 namespace OHOS {
 namespace ExternalDeviceManager {
-void BundleUpdateCallback::OnBundlesUpdated(const std::string &bundleName)
+void BundleUpdateCallback::OnBundlesUpdated(const std::string &bundleName,
+    const std::vector<std::shared_ptr<DriverInfo>> &drivers)
 {
     auto deviceIds = ExtDeviceManager::GetInstance().DeleteBundlesOfBundleInfoMap(bundleName);
-    ExtDeviceManager::GetInstance().MatchDriverInfos(deviceIds);
+    if (bundleName.empty()) {
+        ExtDeviceManager::GetInstance().MatchDriverInfos(deviceIds);
+        return;
+    }
+    ExtDeviceManager::GetInstance().MatchDriverInfos(deviceIds, drivers);
 }
 
 void BundleUpdateCallback::OnBundlesReseted(const int32_t oldUserId)
 {
     ExtDeviceManager::GetInstance().ClearMatchedDrivers(oldUserId);
 }
+
+void BundleUpdateCallback::OnBundleChanged(const std::string &bundleName, const int32_t userId)
+{
+    ExtDeviceManager::GetInstance().InvalidateAppProvision(bundleName, userId);
+}
 } // namespace ExternalDeviceManager
 } // namespace OHOS
\ No newline at end of file
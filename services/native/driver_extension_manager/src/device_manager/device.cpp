@@ -20,6 +20,7 @@
 #include "device.h"
 #include "etx_device_mgr.h"
 #include "driver_report_sys_event.h"
+#include "edm_trace.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
@@ -62,13 +63,17 @@ int32_t Device::Connect()
 {
     EDM_LOGI(MODULE_DEV_MGR, "%{public}s enter", __func__);
     std::lock_guard<std::recursive_mutex> lock(deviceMutex_);
+    uint64_t deviceId = GetDeviceInfo()->GetDeviceId();
+    EdmTraceScope trace(TRACE_DEVICE_CONNECT, deviceId);
     uint32_t busDevId = GetDeviceInfo()->GetBusDevId();
     std::string bundleInfo = GetBundleInfo();
     std::string bundleName = Device::GetBundleName(bundleInfo);
     std::string abilityName = Device::GetAbilityName(bundleInfo);
     AddDrvExtConnNotify();
+    // ends when the ability manager calls back, see DrvExtConnNotify::OnConnectDone
+    EdmTraceAsyncBegin(TRACE_BIND_DRIVER, deviceId);
     int32_t ret = DriverExtensionController::GetInstance().ConnectDriverExtension(
-        bundleName, abilityName, connectNofitier_, busDevId);
+        bundleName, abilityName, connectNofitier_, busDevId, GetDeviceInfo()->GetInterfaceNumber());
     // RESOLVE_ABILITY_ERR maybe due to bms is not ready in the boot process, sleep 100ms and try again
     int retry = 0;
     const int retryTimes = 30;
@@ -84,11 +89,12 @@ int32_t Device::Connect()
             connectNofitier_->ClearDrvExtConnectionInfo();
         }
         ret = DriverExtensionController::GetInstance().ConnectDriverExtension(
-            bundleName, abilityName, connectNofitier_, busDevId);
+            bundleName, abilityName, connectNofitier_, busDevId, GetDeviceInfo()->GetInterfaceNumber());
         retry++;
     }
     if (ret != UsbErrCode::EDM_OK) {
         EDM_LOGE(MODULE_DEV_MGR, "failed to connect driver extension");
+        EdmTraceAsyncEnd(TRACE_BIND_DRIVER, deviceId);
     }
     return ret;
 }
@@ -128,10 +134,14 @@ int32_t Device::Connect(const sptr<IDriverExtMgrCallback> &connectCallback, uint
     AddDrvExtConnNotify();
     boundCallerInfos_[callingTokenId] = CallerInfo{false};
     uint32_t busDevId = GetDeviceInfo()->GetBusDevId();
+    uint64_t deviceId = GetDeviceInfo()->GetDeviceId();
+    EdmTraceScope trace(TRACE_DEVICE_CONNECT, deviceId);
+    EdmTraceAsyncBegin(TRACE_BIND_DRIVER, deviceId);
     ret = DriverExtensionController::GetInstance().ConnectDriverExtension(
-        bundleName, abilityName, connectNofitier_, busDevId);
+        bundleName, abilityName, connectNofitier_, busDevId, GetDeviceInfo()->GetInterfaceNumber());
     if (ret != UsbErrCode::EDM_OK) {
         EDM_LOGE(MODULE_DEV_MGR, "failed to connect driver extension");
+        EdmTraceAsyncEnd(TRACE_BIND_DRIVER, deviceId);
         UnregisterDrvExtMgrCallback(connectCallback);
         boundCallerInfos_.erase(callingTokenId);
     }
@@ -199,18 +209,23 @@ void Device::OnDisconnect(int resultCode)
         EDM_LOGE(MODULE_DEV_MGR, "failed to disconnect driver extension %{public}d", resultCode);
     }
 
-    std::lock_guard<std::recursive_mutex> lock(deviceMutex_);
-    drvExtRemote_ = nullptr;
-    if (connectNofitier_ != nullptr) {
-        connectNofitier_->ClearDrvExtConnectionInfo();
-    }
-    for (auto &callback : callbacks_) {
-        callback->OnUnBind(GetDeviceInfo()->GetDeviceId(), {static_cast<UsbErrCode>(resultCode), ""});
-        callback->OnDisconnect(GetDeviceInfo()->GetDeviceId(), {static_cast<UsbErrCode>(resultCode), ""});
+    bool unRegisted = false;
+    {
+        std::lock_guard<std::recursive_mutex> lock(deviceMutex_);
+        drvExtRemote_ = nullptr;
+        if (connectNofitier_ != nullptr) {
+            connectNofitier_->ClearDrvExtConnectionInfo();
+        }
+        for (auto &callback : callbacks_) {
+            callback->OnUnBind(GetDeviceInfo()->GetDeviceId(), {static_cast<UsbErrCode>(resultCode), ""});
+            callback->OnDisconnect(GetDeviceInfo()->GetDeviceId(), {static_cast<UsbErrCode>(resultCode), ""});
+        }
+        ClearBoundCallerInfos();
+        callbacks_.clear();
+        unRegisted = IsUnRegisted();
     }
-    ClearBoundCallerInfos();
-    callbacks_.clear();
-    if (IsUnRegisted()) {
+    // not under deviceMutex_, registering a device takes the device map lock first and the device lock second
+    if (unRegisted) {
         ExtDeviceManager::GetInstance().RemoveDeviceOfDeviceMap(shared_from_this());
     }
     std::string bundleInfo = GetBundleInfo();
@@ -302,6 +317,7 @@ int32_t DrvExtConnNotify::OnConnectDone(const sptr<IRemoteObject> &remote, int r
     }
 
     device->OnConnect(remote, resultCode);
+    EdmTraceAsyncEnd(TRACE_BIND_DRIVER, device->GetDeviceInfo()->GetDeviceId());
     return UsbErrCode::EDM_OK;
 }
 
@@ -13,11 +13,13 @@
  * limitations under the License.
  */
 
+#include <mutex>
 #include "ability_manager_client.h"
 #include "hilog_wrapper.h"
 #include "ability_connect_callback_stub.h"
 #include "edm_errors.h"
 #include "driver_extension_controller.h"
+#include "edm_trace.h"
 namespace OHOS {
 namespace ExternalDeviceManager {
 using namespace std;
@@ -33,11 +35,7 @@ public:
         EDM_LOGI(MODULE_EA_MGR,
             "OnAbilityConnectDone, bundle = %{public}s, ability = %{public}s, resultCode = %{public}d",
             element.GetBundleName().c_str(), element.GetAbilityName().c_str(), resultCode);
-        remoteObject_ = remoteObject;
-        auto cb = callback_.lock();
-        if (cb != nullptr) {
-            cb->OnConnectDone(remoteObject, resultCode);
-        }
+        DriverExtensionController::NotifyConnectDone(this, remoteObject, resultCode);
     }
     void OnAbilityDisconnectDone(
         const OHOS::AppExecFwk::ElementName &element, int resultCode) override
@@ -45,30 +43,100 @@ public:
         EDM_LOGI(MODULE_EA_MGR,
             "OnAbilityDisconnectDone, bundle = %{public}s,ability = %{public}s, resultCode = %{public}d",
             element.GetBundleName().c_str(), element.GetAbilityName().c_str(), resultCode);
-        remoteObject_ = nullptr;
-        auto cb = callback_.lock();
-        if (cb != nullptr) {
-            cb->OnDisconnectDone(resultCode);
-        }
+        DriverExtensionController::NotifyDisconnectDone(this, resultCode);
     }
+    sptr<IRemoteObject> GetRemoteObject()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return remoteObject_;
+    }
+    void SetRemoteObject(const sptr<IRemoteObject> &remote)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        remoteObject_ = remote;
+    }
+    std::shared_ptr<IDriverExtensionConnectCallback> GetCallback()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return callback_.lock();
+    }
+    void SetCallback(const std::shared_ptr<IDriverExtensionConnectCallback> &callback)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        callback_ = callback;
+    }
+
+private:
+    // written by the ability manager threads and read by the device manager
+    std::mutex mutex_;
     std::weak_ptr<IDriverExtensionConnectCallback> callback_;
     sptr<IRemoteObject> remoteObject_;
 };
 
+DrvExtConnectionInfo::DrvExtConnectionInfo() = default;
+DrvExtConnectionInfo::~DrvExtConnectionInfo() = default;
+
 sptr<IRemoteObject> IDriverExtensionConnectCallback::GetRemoteObj()
 {
-    return info_->connectInner_->remoteObject_;
+    return info_->connectInner_->GetRemoteObject();
 }
 
 bool IDriverExtensionConnectCallback::IsConnectDone()
 {
-    return info_->connectInner_->remoteObject_ != nullptr;
+    return info_->connectInner_->GetRemoteObject() != nullptr;
+}
+
+void DriverExtensionController::NotifyConnectDone(const sptr<DriverExtensionAbilityConnection> &connection,
+    const sptr<IRemoteObject> &remote, int resultCode)
+{
+    connection->SetRemoteObject(remote);
+    auto cb = connection->GetCallback();
+    if (cb != nullptr) {
+        cb->OnConnectDone(remote, resultCode);
+    }
+}
+
+void DriverExtensionController::NotifyDisconnectDone(const sptr<DriverExtensionAbilityConnection> &connection,
+    int resultCode)
+{
+    connection->SetRemoteObject(nullptr);
+    auto cb = connection->GetCallback();
+    if (cb != nullptr) {
+        cb->OnDisconnectDone(resultCode);
+    }
+}
+
+int32_t DriverExtensionController::ConnectAbility(const std::shared_ptr<DrvExtConnectionInfo> &info)
+{
+    auto abmc = AAFwk::AbilityManagerClient::GetInstance();
+    if (abmc == nullptr) {
+        EDM_LOGE(MODULE_EA_MGR, "Get AMC Instance failed");
+        return EDM_ERR_INVALID_OBJECT;
+    }
+    AAFwk::Want want;
+    want.SetElementName(info->bundleName_, info->abilityName_);
+    want.SetParam("deviceId", static_cast<int>(info->deviceId_));
+    if (info->interfaceNumber_ >= 0) {
+        want.SetParam("interfaceNumber", info->interfaceNumber_);
+    }
+    return abmc->ConnectAbility(want, info->connectInner_, -1);
+}
+
+int32_t DriverExtensionController::DisconnectAbility(const std::shared_ptr<DrvExtConnectionInfo> &info)
+{
+    auto abmc = AAFwk::AbilityManagerClient::GetInstance();
+    if (abmc == nullptr) {
+        EDM_LOGE(MODULE_EA_MGR, "Get AMC Instance failed");
+        return EDM_ERR_INVALID_OBJECT;
+    }
+    return abmc->DisconnectAbility(info->connectInner_);
 }
 
 int32_t DriverExtensionController::StartDriverExtension(
     const std::string& bundleName,
     const std::string& abilityName)
 {
+    EdmTraceScope trace(TRACE_START_DRIVER_EXTENSION);
     EDM_LOGI(MODULE_EA_MGR, "Begin to start DriverExtension, bundle:%{public}s, ability:%{public}s", \
         bundleName.c_str(), abilityName.c_str());
     auto abmc = AAFwk::AbilityManagerClient::GetInstance();
@@ -95,6 +163,12 @@ int32_t DriverExtensionController::StopDriverExtension(
 {
     EDM_LOGI(MODULE_EA_MGR, "Begin to stop DriverExtension, bundle:%{public}s, ability:%{public}s", \
         bundleName.c_str(), abilityName.c_str());
+    return abilityStopper_(bundleName, abilityName, userId);
+}
+
+int32_t DriverExtensionController::StopAbility(const std::string &bundleName, const std::string &abilityName,
+    int32_t userId)
+{
     auto abmc = AAFwk::AbilityManagerClient::GetInstance();
     if (abmc == nullptr) {
         EDM_LOGE(MODULE_EA_MGR, "Get AMC Instance failed");
@@ -114,9 +188,11 @@ int32_t DriverExtensionController::ConnectDriverExtension(
     const std::string& bundleName,
     const std::string& abilityName,
     std::shared_ptr<IDriverExtensionConnectCallback> callback,
-    uint32_t deviceId
+    uint32_t deviceId,
+    int32_t interfaceNumber
 )
 {
+    EdmTraceScope trace(TRACE_CONNECT_DRIVER_EXTENSION);
     EDM_LOGI(MODULE_EA_MGR, "Begin to Connect DriverExtension, bundle:%{public}s, ability:%{public}s", \
         bundleName.c_str(), abilityName.c_str());
     if (callback == nullptr) {
@@ -132,17 +208,10 @@ int32_t DriverExtensionController::ConnectDriverExtension(
     callback->info_->bundleName_ = bundleName;
     callback->info_->abilityName_ = abilityName;
     callback->info_->deviceId_ = deviceId;
+    callback->info_->interfaceNumber_ = interfaceNumber;
     callback->info_->connectInner_ = new DriverExtensionAbilityConnection();
-    callback->info_->connectInner_->callback_ = callback;
-    auto abmc = AAFwk::AbilityManagerClient::GetInstance();
-    if (abmc == nullptr) {
-        EDM_LOGE(MODULE_EA_MGR, "Get AMC Instance failed");
-        return EDM_ERR_INVALID_OBJECT;
-    }
-    AAFwk::Want want;
-    want.SetElementName(bundleName, abilityName);
-    want.SetParam("deviceId", static_cast<int>(deviceId));
-    auto ret = abmc->ConnectAbility(want, callback->info_->connectInner_, -1);
+    callback->info_->connectInner_->SetCallback(callback);
+    auto ret = abilityConnector_(callback->info_);
     if (ret != 0) {
         EDM_LOGE(MODULE_EA_MGR, "ConnectExtensionAbility failed %{public}d", ret);
         return ret;
@@ -174,12 +243,7 @@ int32_t DriverExtensionController::DisconnectDriverExtension(
         EDM_LOGE(MODULE_EA_MGR, "bundleName, abilityName, or deviceId not match info in callback");
         return EDM_ERR_INVALID_OBJECT;
     }
-    auto abmc = AAFwk::AbilityManagerClient::GetInstance();
-    if (abmc == nullptr) {
-        EDM_LOGE(MODULE_EA_MGR, "Get AMC Instance failed");
-        return EDM_ERR_INVALID_OBJECT;
-    }
-    auto ret = abmc->DisconnectAbility(callback->info_->connectInner_);
+    auto ret = abilityDisconnector_(callback->info_);
     if (ret != 0) {
         EDM_LOGE(MODULE_EA_MGR, "DisconnectExtensionAbility failed %{public}d", ret);
         return ret;
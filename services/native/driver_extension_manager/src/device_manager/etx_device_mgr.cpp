@@ -26,10 +26,11 @@
 #include "bundlemgr/bundle_mgr_proxy.h"
 #include "bundlemgr/bundle_mgr_interface.h"
 #include "driver_report_sys_event.h"
+#include "edm_trace.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
-constexpr uint32_t UNLOAD_SA_TIMER_INTERVAL = 30 * 1000;
+constexpr const char *UNLOAD_POLICY_STATE_KEY = "unloadPolicyState";
 std::string Device::stiching_ = "-";
 IMPLEMENT_SINGLE_INSTANCE(ExtDeviceManager);
 
@@ -81,6 +82,9 @@ int32_t ExtDeviceManager::AddDevIdOfBundleInfoMap(shared_ptr<Device> device, str
         unordered_set<uint64_t> tmpSet;
         tmpSet.emplace(deviceId);
         bundleMatchMap_.emplace(bundleInfo, tmpSet);
+        auto driverInfo = device->GetDriverInfo();
+        bundleInfosOfBundle_[driverInfo != nullptr ? driverInfo->GetBundleName() : Device::GetBundleName(bundleInfo)]
+            .emplace(bundleInfo);
         EDM_LOGI(MODULE_DEV_MGR, "bundleMap emplace New driver, add deviceId %{public}016" PRIX64 "", deviceId);
     } else {
         auto pairRet = pos->second.emplace(deviceId);
@@ -140,7 +144,7 @@ int32_t ExtDeviceManager::RemoveDevIdOfBundleInfoMap(shared_ptr<Device> device,
     }
 
     EDM_LOGD(MODULE_DEV_MGR, "bundleMap remove bundleInfo[%{public}s]", bundleInfo.c_str());
-    bundleMatchMap_.erase(pos);
+    EraseBundleInfo(device, bundleInfo);
 
     // stop ability and destory sa
     int32_t ret = device->Disconnect(false);
@@ -156,6 +160,23 @@ int32_t ExtDeviceManager::RemoveDevIdOfBundleInfoMap(shared_ptr<Device> device,
     return EDM_OK;
 }
 
+void ExtDeviceManager::EraseBundleInfo(const shared_ptr<Device> &device, const string &bundleInfo)
+{
+    // Please do not add lock. The caller holds bundleMatchMapMutex_.
+    bundleMatchMap_.erase(bundleInfo);
+    auto driverInfo = device->GetDriverInfo();
+    // a bundle name may contain the stiching character itself, so splitting bundleInfo is only the fallback
+    auto pos = bundleInfosOfBundle_.find(
+        driverInfo != nullptr ? driverInfo->GetBundleName() : Device::GetBundleName(bundleInfo));
+    if (pos == bundleInfosOfBundle_.end()) {
+        return;
+    }
+    pos->second.erase(bundleInfo);
+    if (pos->second.empty()) {
+        bundleInfosOfBundle_.erase(pos);
+    }
+}
+
 void ExtDeviceManager::UpdateDriverInfo(const shared_ptr<Device> &device)
 {
     if (device == nullptr) {
@@ -197,6 +218,7 @@ void ExtDeviceManager::RemoveDriverInfo(const shared_ptr<Device> &device)
 
     driverChangeCallback_->OnDriverRemoved(driverInfo);
     device->RemoveDriverInfo();
+    BumpQueryGeneration();
 }
 
 void ExtDeviceManager::RemoveDeviceOfDeviceMap(shared_ptr<Device> device)
@@ -214,7 +236,9 @@ void ExtDeviceManager::RemoveDeviceOfDeviceMap(shared_ptr<Device> device)
     if (deviceMap_.find(type) != deviceMap_.end()) {
         unordered_map<uint64_t, shared_ptr<Device>> &map = deviceMap_[type];
         map.erase(deviceId);
+        RemoveMatchKeys(deviceId);
         EDM_LOGI(MODULE_DEV_MGR, "success RemoveDeviceOfDeviceMap, deviceId:%{public}016" PRIx64 "", deviceId);
+        BumpQueryGeneration();
     }
 }
 
@@ -225,52 +249,152 @@ std::unordered_set<uint64_t> ExtDeviceManager::DeleteBundlesOfBundleInfoMap(cons
     lock_guard<mutex> lock(bundleMatchMapMutex_);
     if (bundleName.empty()) {
         bundleMatchMap_.clear();
-    } else {
-        std::string startStr = bundleName + Device::GetStiching();
-        for (auto iter = bundleMatchMap_.begin(); iter != bundleMatchMap_.end();) {
-            if (iter->first.size() >= startStr.size() &&
-                startStr.compare(iter->first.substr(0, startStr.size())) == 0) {
-                deviceIds.insert(iter->second.begin(), iter->second.end());
-                iter = bundleMatchMap_.erase(iter);
-            } else {
-                iter++;
-            }
+        bundleInfosOfBundle_.clear();
+        return deviceIds;
+    }
+    auto pos = bundleInfosOfBundle_.find(bundleName);
+    if (pos == bundleInfosOfBundle_.end()) {
+        return deviceIds;
+    }
+    for (const auto &bundleInfo : pos->second) {
+        auto iter = bundleMatchMap_.find(bundleInfo);
+        if (iter != bundleMatchMap_.end()) {
+            deviceIds.insert(iter->second.begin(), iter->second.end());
+            bundleMatchMap_.erase(iter);
         }
     }
+    bundleInfosOfBundle_.erase(pos);
     return deviceIds;
 }
 
+shared_ptr<DriverInfo> ExtDeviceManager::QueryMatchDriver(shared_ptr<DeviceInfo> devInfo, const std::string &type)
+{
+    EdmTraceScope trace(TRACE_QUERY_MATCH_DRIVER, devInfo->GetDeviceId());
+    return DriverPkgManager::GetInstance().QueryMatchDriver(devInfo, type);
+}
+
+void ExtDeviceManager::MatchDevice(const shared_ptr<Device> &device, bool unbind)
+{
+    // Please do not add lock. This will be called in the MatchDriverInfos.
+    uint64_t deviceId = device->GetDeviceInfo()->GetDeviceId();
+    if (unbind) {
+        device->RemoveBundleInfo();
+        device->ClearDrvExtRemote();
+        RemoveDriverInfo(device);
+    }
+    if (device->IsUnRegisted() || device->GetDrvExtRemote() != nullptr) {
+        return;
+    }
+    auto matchedDriverInfo = driverMatcher_(device->GetDeviceInfo(), "[BUNDLE_UPDATE]");
+    if (matchedDriverInfo == nullptr) {
+        EDM_LOGD(MODULE_DEV_MGR, "deviceId[%{public}016" PRIX64 "], not find driver", deviceId);
+        return;
+    }
+    std::string bundleInfo = matchedDriverInfo->GetBundleName() + Device::GetStiching() +
+        matchedDriverInfo->GetDriverName();
+    EDM_LOGI(MODULE_DEV_MGR, "MatchDriverInfo success, bundleInfo: %{public}s", bundleInfo.c_str());
+    device->AddBundleInfo(bundleInfo, matchedDriverInfo);
+    int32_t ret = AddDevIdOfBundleInfoMap(device, bundleInfo);
+    if (ret != EDM_OK) {
+        EDM_LOGD(MODULE_DEV_MGR,
+            "deviceId[%{public}016" PRIX64 "] AddDevIdOfBundleInfoMap failed, ret=%{public}d", deviceId, ret);
+    }
+}
+
+void ExtDeviceManager::MatchAllDevices(const std::unordered_set<uint64_t> &deviceIds)
+{
+    // Please do not add lock. This will be called in the MatchDriverInfos.
+    for (auto &m : deviceMap_) {
+        for (auto &[deviceId, device] : m.second) {
+            MatchDevice(device, deviceIds.find(deviceId) != deviceIds.end());
+        }
+    }
+}
+
 void ExtDeviceManager::MatchDriverInfos(std::unordered_set<uint64_t> deviceIds)
 {
     EDM_LOGI(MODULE_DEV_MGR, "MatchDriverInfos enter");
     lock_guard<mutex> lock(deviceMapMutex_);
-    for (auto &m : deviceMap_) {
-        for (auto &[deviceId, device] : m.second) {
-            if (deviceIds.find(deviceId) != deviceIds.end()) {
-                device->RemoveBundleInfo();
-                device->ClearDrvExtRemote();
-                RemoveDriverInfo(device);
-            }
-            if (device->IsUnRegisted() || device->GetDrvExtRemote() != nullptr) {
-                continue;
-            }
-            auto matchedDriverInfo = DriverPkgManager::GetInstance().QueryMatchDriver(device->GetDeviceInfo(),
-                "[BUNDLE_UPDATE]");
-            if (matchedDriverInfo == nullptr) {
-                EDM_LOGD(MODULE_DEV_MGR, "deviceId[%{public}016" PRIX64 "], not find driver", deviceId);
-                continue;
-            }
-            std::string bundleInfo = matchedDriverInfo->GetBundleName() + Device::GetStiching() +
-                matchedDriverInfo->GetDriverName();
-            EDM_LOGI(MODULE_DEV_MGR, "MatchDriverInfo success, bundleInfo: %{public}s", bundleInfo.c_str());
-            device->AddBundleInfo(bundleInfo, matchedDriverInfo);
-            int32_t ret = AddDevIdOfBundleInfoMap(device, bundleInfo);
-            if (ret != EDM_OK) {
-                EDM_LOGD(MODULE_DEV_MGR,
-                    "deviceId[%{public}016" PRIX64 "] AddDevIdOfBundleInfoMap failed, ret=%{public}d", deviceId, ret);
+    MatchAllDevices(deviceIds);
+    // reached after every pkg.db update, the driver list itself may have changed
+    BumpQueryGeneration();
+}
+
+void ExtDeviceManager::MatchDriverInfos(const std::unordered_set<uint64_t> &deviceIds,
+    const vector<shared_ptr<DriverInfo>> &changedDrivers)
+{
+    EDM_LOGI(MODULE_DEV_MGR, "MatchDriverInfos enter, %{public}zu devices unbound, %{public}zu drivers changed",
+        deviceIds.size(), changedDrivers.size());
+    lock_guard<mutex> lock(deviceMapMutex_);
+    // An updated bundle is written to pkg.db after all other rows, so its drivers never take precedence over
+    // a driver that is already bound: only the unbound devices sharing a match key with them can change.
+    std::unordered_set<uint64_t> candidates = deviceIds;
+    for (const auto &driverInfo : changedDrivers) {
+        if (driverInfo == nullptr) {
+            continue;
+        }
+        vector<string> keys;
+        if (!DriverPkgManager::GetInstance().GetMatchKeys(*driverInfo, keys)) {
+            EDM_LOGI(MODULE_DEV_MGR, "driver[%{public}s] has no match keys, match all devices",
+                driverInfo->GetDriverName().c_str());
+            MatchAllDevices(deviceIds);
+            BumpQueryGeneration();
+            return;
+        }
+        for (const auto &key : keys) {
+            auto pos = matchKeyIndex_.find(key);
+            if (pos != matchKeyIndex_.end()) {
+                candidates.insert(pos->second.begin(), pos->second.end());
             }
         }
     }
+    for (uint64_t deviceId : candidates) {
+        auto device = QueryDeviceByDeviceID(deviceId);
+        if (device == nullptr) {
+            continue;
+        }
+        bool unbind = deviceIds.find(deviceId) != deviceIds.end();
+        if (!unbind && device->HasDriver()) {
+            continue;
+        }
+        MatchDevice(device, unbind);
+    }
+    BumpQueryGeneration();
+}
+
+void ExtDeviceManager::AddMatchKeys(const shared_ptr<Device> &device)
+{
+    // Please do not add lock. This will be called in the RegisterDevice.
+    auto deviceInfo = device->GetDeviceInfo();
+    vector<string> keys;
+    if (!DriverPkgManager::GetInstance().GetMatchKeys(*deviceInfo, keys)) {
+        return;
+    }
+    uint64_t deviceId = deviceInfo->GetDeviceId();
+    for (const auto &key : keys) {
+        matchKeyIndex_[key].emplace(deviceId);
+    }
+    deviceMatchKeys_[deviceId] = std::move(keys);
+}
+
+void ExtDeviceManager::RemoveMatchKeys(uint64_t deviceId)
+{
+    // Please do not add lock. This will be called in the UnRegisterDevice and RemoveDeviceOfDeviceMap.
+    auto pos = deviceMatchKeys_.find(deviceId);
+    if (pos == deviceMatchKeys_.end()) {
+        return;
+    }
+    for (const auto &key : pos->second) {
+        auto indexPos = matchKeyIndex_.find(key);
+        if (indexPos == matchKeyIndex_.end()) {
+            continue;
+        }
+        indexPos->second.erase(deviceId);
+        if (indexPos->second.empty()) {
+            matchKeyIndex_.erase(indexPos);
+        }
+    }
+    deviceMatchKeys_.erase(pos);
 }
 
 void ExtDeviceManager::ClearMatchedDrivers(const int32_t userId)
@@ -301,7 +425,7 @@ void ExtDeviceManager::ClearMatchedDrivers(const int32_t userId)
             if (ret != EDM_OK) {
                 EDM_LOGE(MODULE_DEV_MGR, "StopDriverExtension failed, ret=%{public}d", ret);
             }
-            bundleMatchMap_.erase(bundleInfo);
+            EraseBundleInfo(device, bundleInfo);
             device->RemoveBundleInfo();
             device->ClearDrvExtRemote();
             RemoveDriverInfo(device);
@@ -309,14 +433,31 @@ void ExtDeviceManager::ClearMatchedDrivers(const int32_t userId)
     }
     lock_guard<mutex> lock(bundleMatchMapMutex_);
     bundleMatchMap_.clear();
+    bundleInfosOfBundle_.clear();
+    BumpQueryGeneration();
 }
 
 int32_t ExtDeviceManager::RegisterDevice(shared_ptr<DeviceInfo> devInfo)
 {
+    lock_guard<mutex> lock(deviceMapMutex_);
+    int32_t ret = RegisterOneDevice(devInfo);
+    // each interface of a composite device is matched and bound on its own
+    for (const auto &interfaceInfo : devInfo->GetInterfaceInfos()) {
+        if (RegisterOneDevice(interfaceInfo) != EDM_OK) {
+            EDM_LOGE(MODULE_DEV_MGR, "register interface %{public}d of %{public}016" PRIx64 " failed",
+                interfaceInfo->GetInterfaceNumber(), devInfo->GetDeviceId());
+        }
+    }
+    return ret;
+}
+
+int32_t ExtDeviceManager::RegisterOneDevice(shared_ptr<DeviceInfo> devInfo)
+{
+    // Please do not add lock. This will be called in the RegisterDevice.
     BusType type = devInfo->GetBusType();
     uint64_t deviceId = devInfo->GetDeviceId();
+    EdmTraceScope trace(TRACE_REGISTER_DEVICE, deviceId);
     shared_ptr<Device> device;
-    lock_guard<mutex> lock(deviceMapMutex_);
     if (deviceMap_.find(type) != deviceMap_.end()) {
         unordered_map<uint64_t, shared_ptr<Device>> &map = deviceMap_[type];
         if (map.find(deviceId) != map.end() && map[deviceId] != nullptr) {
@@ -338,19 +479,23 @@ int32_t ExtDeviceManager::RegisterDevice(shared_ptr<DeviceInfo> devInfo)
     if (device == nullptr) {
         device = make_shared<Device>(devInfo);
         deviceMap_[type].emplace(deviceId, device);
+        AddMatchKeys(device);
+        PublishDeviceChange(DeviceChangeType::DEVICE_CHANGE_ADDED, device);
         EDM_LOGI(MODULE_DEV_MGR, "successfully registered device, deviceId = %{public}016" PRIx64 "", deviceId);
     }
     // driver match
     std::string bundleInfo = device->GetBundleInfo();
     // if device does not have a matching driver, match driver here
     if (bundleInfo.empty()) {
-        auto matchedDriverInfo = DriverPkgManager::GetInstance().QueryMatchDriver(devInfo, "[DEVICE_ADD]");
+        auto matchedDriverInfo = driverMatcher_(devInfo, "[DEVICE_ADD]");
         if (matchedDriverInfo != nullptr) {
             bundleInfo = matchedDriverInfo->GetBundleName() + Device::GetStiching() +
                 matchedDriverInfo->GetDriverName();
             device->AddBundleInfo(bundleInfo, matchedDriverInfo);
         }
     }
+    BumpQueryGeneration();
+    unloadPolicy_->OnDeviceAttached();
     unloadSelftimer_.Unregister(unloadSelftimerId_);
 
     // match driver failed, waitting to install driver package
@@ -376,22 +521,53 @@ int32_t ExtDeviceManager::UnRegisterDevice(const shared_ptr<DeviceInfo> devInfo)
 {
     BusType type = devInfo->GetBusType();
     uint64_t deviceId = devInfo->GetDeviceId();
+    lock_guard<mutex> lock(deviceMapMutex_);
+    // the bus only reports the device, its interfaces are known from when it was registered
+    vector<uint64_t> interfaceIds;
+    bool registered = false;
+    auto typeIter = deviceMap_.find(type);
+    if (typeIter != deviceMap_.end()) {
+        auto devIter = typeIter->second.find(deviceId);
+        registered = devIter != typeIter->second.end();
+        if (registered && devIter->second != nullptr &&
+            devIter->second->GetDeviceInfo() != nullptr) {
+            for (const auto &interfaceInfo : devIter->second->GetDeviceInfo()->GetInterfaceInfos()) {
+                interfaceIds.push_back(interfaceInfo->GetDeviceId());
+            }
+        }
+    }
+    for (uint64_t interfaceId : interfaceIds) {
+        (void)UnRegisterOneDevice(type, interfaceId);
+    }
+    int32_t ret = UnRegisterOneDevice(type, deviceId);
+    if (registered) {
+        UnLoadSelf();
+    }
+    return ret;
+}
+
+int32_t ExtDeviceManager::UnRegisterOneDevice(BusType type, uint64_t deviceId)
+{
+    // Please do not add lock. This will be called in the UnRegisterDevice.
     shared_ptr<Device> device;
     string bundleInfo;
 
-    lock_guard<mutex> lock(deviceMapMutex_);
     if (deviceMap_.find(type) != deviceMap_.end()) {
         unordered_map<uint64_t, shared_ptr<Device>> &map = deviceMap_[type];
         if (map.find(deviceId) != map.end()) {
             device = map[deviceId];
             bundleInfo = map[deviceId]->GetBundleInfo();
+            if (device != nullptr && !device->IsUnRegisted()) {
+                PublishDeviceChange(DeviceChangeType::DEVICE_CHANGE_REMOVED, device);
+            }
             if (device != nullptr && device->GetDrvExtRemote() != nullptr) {
                 device->UnRegist();
             } else {
                 map.erase(deviceId);
+                RemoveMatchKeys(deviceId);
             }
             EDM_LOGI(MODULE_DEV_MGR, "successfully unregistered device, deviceId is %{public}016" PRIx64 "", deviceId);
-            UnLoadSelf();
+            BumpQueryGeneration();
         }
     }
 
@@ -450,6 +626,67 @@ vector<shared_ptr<Device>> ExtDeviceManager::QueryAllDevices()
     return devices;
 }
 
+vector<shared_ptr<Device>> ExtDeviceManager::QueryAllDevices(uint64_t &sequence,
+    const std::function<void()> &onSnapshot)
+{
+    vector<shared_ptr<Device>> devices;
+    lock_guard<mutex> lock(deviceMapMutex_);
+
+    for (auto &m : deviceMap_) {
+        for (auto &[_, device] : m.second) {
+            if (device != nullptr && !device->IsUnRegisted()) {
+                devices.emplace_back(device);
+            }
+        }
+    }
+    sequence = changeSequence_;
+    if (onSnapshot != nullptr) {
+        onSnapshot();
+    }
+
+    return devices;
+}
+
+void ExtDeviceManager::SetDeviceChangeHandler(const DeviceChangeHandler &handler)
+{
+    lock_guard<mutex> lock(deviceMapMutex_);
+    deviceChangeHandler_ = handler;
+}
+
+void ExtDeviceManager::PublishDeviceChange(DeviceChangeType type, const shared_ptr<Device> &device)
+{
+    // Please do not add lock. This will be called in the RegisterDevice and UnRegisterDevice.
+    // interface records of composite devices are not in the device list apps see, and take no sequence number
+    if (device->GetDeviceInfo() != nullptr && device->GetDeviceInfo()->GetInterfaceNumber() >= 0) {
+        return;
+    }
+    changeSequence_++;
+    if (deviceChangeHandler_ != nullptr) {
+        deviceChangeHandler_(changeSequence_, type, device);
+    }
+}
+
+uint64_t ExtDeviceManager::GetQueryGeneration() const
+{
+    return queryGeneration_.load(std::memory_order_acquire);
+}
+
+void ExtDeviceManager::SetQueryGenerationHandler(const QueryGenerationHandler &handler)
+{
+    lock_guard<mutex> lock(generationHandlerMutex_);
+    generationHandler_ = handler;
+}
+
+void ExtDeviceManager::BumpQueryGeneration()
+{
+    // called after the change is made, so a reader that sees the new generation also sees the change
+    uint64_t generation = queryGeneration_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    lock_guard<mutex> lock(generationHandlerMutex_);
+    if (generationHandler_ != nullptr) {
+        generationHandler_(generation);
+    }
+}
+
 vector<shared_ptr<Device>> ExtDeviceManager::QueryDevicesById(const uint64_t deviceId)
 {
     vector<shared_ptr<Device>> devices;
@@ -496,7 +733,8 @@ void ExtDeviceManager::UnLoadSelf(void)
         return;
     }
 
-    auto task = []() {
+    int64_t holdOffMs = unloadPolicy_->OnIdle();
+    auto task = [policy = unloadPolicy_]() {
         auto samgrProxy = SystemAbilityManagerClient::GetInstance().GetSystemAbilityManager();
         if (samgrProxy == nullptr) {
             EDM_LOGE(MODULE_DEV_MGR, "get samgr failed");
@@ -509,17 +747,52 @@ void ExtDeviceManager::UnLoadSelf(void)
             return;
         }
 
+        policy->OnUnload();
+
         auto ret = samgrProxy->UnloadSystemAbility(HDF_EXTERNAL_DEVICE_MANAGER_SA_ID);
         if (ret != EDM_OK) {
             EDM_LOGE(MODULE_DEV_MGR, "unload failed");
         }
     };
-    unloadSelftimerId_ = unloadSelftimer_.Register(task, UNLOAD_SA_TIMER_INTERVAL, true);
+    EDM_LOGI(MODULE_DEV_MGR, "unload in %{public}" PRId64 "ms", holdOffMs);
+    unloadSelftimerId_ = unloadSelftimer_.Register(task, static_cast<uint32_t>(holdOffMs), true);
+}
+
+std::shared_ptr<IUnloadPolicy> ExtDeviceManager::CreateUnloadPolicy()
+{
+    auto loader = [](std::string &state) {
+        return DriverPkgManager::GetInstance().QueryPkgState(UNLOAD_POLICY_STATE_KEY, state) == EDM_OK;
+    };
+    auto saver = [](const std::string &state) {
+        DriverPkgManager::GetInstance().UpdatePkgState(UNLOAD_POLICY_STATE_KEY, state);
+    };
+    return std::make_shared<AdaptiveUnloadPolicy>(AdaptiveUnloadPolicy::BootTimeNowMs,
+        AdaptiveUnloadPolicy::IsUnderMemoryPressure, loader, saver);
+}
+
+void ExtDeviceManager::SetUnloadPolicy(const std::shared_ptr<IUnloadPolicy> &policy)
+{
+    if (policy == nullptr) {
+        EDM_LOGE(MODULE_DEV_MGR, "unload policy is null");
+        return;
+    }
+    lock_guard<mutex> lock(deviceMapMutex_);
+    unloadPolicy_ = policy;
+}
+
+UnloadPolicyStats ExtDeviceManager::GetUnloadPolicyStats()
+{
+    std::shared_ptr<IUnloadPolicy> policy;
+    {
+        lock_guard<mutex> lock(deviceMapMutex_);
+        policy = unloadPolicy_;
+    }
+    return policy->GetStats();
 }
 
 std::shared_ptr<Device> ExtDeviceManager::QueryDeviceByDeviceID(uint64_t deviceId)
 {
-    BusType busType = *reinterpret_cast<BusType *>(&deviceId);
+    BusType busType = DeviceInfo::GetBusTypeByDeviceId(deviceId);
     EDM_LOGI(MODULE_DEV_MGR, "the busType: %{public}d", static_cast<uint32_t>(busType));
     auto deviceMapIter = deviceMap_.find(busType);
     if (deviceMapIter == deviceMap_.end()) {
@@ -659,6 +932,54 @@ int32_t ExtDeviceManager::CheckAccessPermission(const std::shared_ptr<DriverInfo
         return EDM_ERR_SERVICE_NOT_ALLOW_ACCESS;
     }
 
+    std::string bundleName = driverInfo->GetBundleName();
+    std::string appIdentifier;
+    int32_t ret = GetAppIdentifier(bundleName, driverInfo->GetUserId(), appIdentifier);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+
+    auto driverIter = accessibleAppIds.find(appIdentifier);
+    if (driverIter == accessibleAppIds.end()) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s does not exist in ohos.permission.ACCESS_DDK_DRIVERS configuration",
+            bundleName.c_str());
+        return EDM_ERR_NO_PERM;
+    }
+    return EDM_OK;
+}
+
+int32_t ExtDeviceManager::GetAppIdentifier(const std::string &bundleName, int32_t userId,
+    std::string &appIdentifier) const
+{
+    auto key = std::make_pair(bundleName, userId);
+    uint64_t epoch = 0;
+    AppProvisionFetcher fetcher = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(provisionCacheMutex_);
+        auto iter = provisionCache_.find(key);
+        if (iter != provisionCache_.end()) {
+            appIdentifier = iter->second;
+            return EDM_OK;
+        }
+        epoch = provisionEpoch_;
+        fetcher = provisionFetcher_;
+    }
+
+    // BMS is called without the lock held, a concurrent miss on the same bundle just asks twice
+    int32_t ret = fetcher(bundleName, userId, appIdentifier);
+    if (ret != EDM_OK) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(provisionCacheMutex_);
+    if (epoch == provisionEpoch_) {
+        provisionCache_[key] = appIdentifier;
+    }
+    return EDM_OK;
+}
+
+int32_t ExtDeviceManager::QueryAppIdentifier(const std::string &bundleName, int32_t userId,
+    std::string &appIdentifier)
+{
     auto samgrProxy = SystemAbilityManagerClient::GetInstance().GetSystemAbilityManager();
     if (samgrProxy == nullptr) {
         EDM_LOGE(MODULE_DEV_MGR, "Failed to get system ability mgr.");
@@ -675,22 +996,21 @@ int32_t ExtDeviceManager::CheckAccessPermission(const std::shared_ptr<DriverInfo
         return EDM_NOK;
     }
 
-    std::string bundleName = driverInfo->GetBundleName();
-    int32_t userId = driverInfo->GetUserId();
     OHOS::AppExecFwk::AppProvisionInfo info;
     ErrCode ret = bundleManager->GetAppProvisionInfo(bundleName, userId, info);
     if (ret != ERR_OK) {
         EDM_LOGE(MODULE_DEV_MGR, "Failed to get app provision info, ret=%{public}d", ret);
         return EDM_ERR_NO_PERM;
     }
-
-    auto driverIter = accessibleAppIds.find(info.appIdentifier);
-    if (driverIter == accessibleAppIds.end()) {
-        EDM_LOGE(MODULE_DEV_MGR, "%{public}s does not exist in ohos.permission.ACCESS_DDK_DRIVERS configuration",
-            bundleName.c_str());
-        return EDM_ERR_NO_PERM;
-    }
+    appIdentifier = info.appIdentifier;
     return EDM_OK;
 }
+
+void ExtDeviceManager::InvalidateAppProvision(const std::string &bundleName, int32_t userId)
+{
+    std::lock_guard<std::mutex> lock(provisionCacheMutex_);
+    provisionEpoch_++;
+    provisionCache_.erase(std::make_pair(bundleName, userId));
+}
 } // namespace ExternalDeviceManager
 } // namespace OHOS
\ No newline at end of file
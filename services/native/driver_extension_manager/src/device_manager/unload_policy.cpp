@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "unload_policy.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <time.h>
+
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+constexpr const char *MEMORY_PRESSURE_PATH = "/proc/pressure/memory";
+constexpr const char *BOOT_ID_PATH = "/proc/sys/kernel/random/boot_id";
+// stands for an unknown boot id in the saved state, it matches no boot
+constexpr const char *UNKNOWN_BOOT_ID = "-";
+// percentage of the last 10s in which some task stalled on memory
+constexpr double MEMORY_PRESSURE_AVG10 = 10.0;
+constexpr uint32_t UNLOAD_STATE_VERSION = 2;
+constexpr int64_t MS_PER_SECOND = 1000;
+constexpr int64_t NS_PER_MS = 1000 * 1000;
+
+AdaptiveUnloadPolicy::AdaptiveUnloadPolicy()
+    : AdaptiveUnloadPolicy(BootTimeNowMs, IsUnderMemoryPressure, nullptr, nullptr)
+{
+}
+
+AdaptiveUnloadPolicy::AdaptiveUnloadPolicy(Clock clock, PressureProbe pressureProbe, StateLoader loader,
+    StateSaver saver, BootIdReader bootIdReader)
+    : clock_(std::move(clock)), pressureProbe_(std::move(pressureProbe)), loader_(std::move(loader)),
+    saver_(std::move(saver)), bootIdReader_(std::move(bootIdReader))
+{
+    stats_.holdOffMs = holdOffMs_;
+}
+
+int64_t AdaptiveUnloadPolicy::BootTimeNowMs()
+{
+    // unlike steady_clock it keeps counting in suspend, a device plugged back after a night is a long gap
+    struct timespec now = {};
+    if (clock_gettime(CLOCK_BOOTTIME, &now) != 0) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    return static_cast<int64_t>(now.tv_sec) * MS_PER_SECOND + now.tv_nsec / NS_PER_MS;
+}
+
+std::string AdaptiveUnloadPolicy::ReadBootId()
+{
+    std::ifstream file(BOOT_ID_PATH);
+    std::string bootId;
+    if (!(file >> bootId)) {
+        return "";
+    }
+    return bootId;
+}
+
+bool AdaptiveUnloadPolicy::IsUnderMemoryPressure()
+{
+    std::ifstream file(MEMORY_PRESSURE_PATH);
+    std::string kind;
+    std::string avg10;
+    // some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+    if (!(file >> kind >> avg10) || kind != "some" || avg10.compare(0, sizeof("avg10=") - 1, "avg10=") != 0) {
+        return false;
+    }
+    char *end = nullptr;
+    const char *value = avg10.c_str() + sizeof("avg10=") - 1;
+    double stalled = strtod(value, &end);
+    return end != value && stalled >= MEMORY_PRESSURE_AVG10;
+}
+
+void AdaptiveUnloadPolicy::OnDeviceAttached()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    RestoreLocked();
+    if (idleSinceMs_ < 0) {
+        return;
+    }
+    int64_t gapMs = std::max<int64_t>(clock_() - idleSinceMs_, 0);
+    idleSinceMs_ = -1;
+    if (gapMs > MAX_HOLD_OFF_MS) {
+        reconnectRate_ *= 1 - GAP_WEIGHT;
+    } else {
+        gapAverageMs_ = gapSamples_ == 0 ? gapMs : GAP_WEIGHT * gapMs + (1 - GAP_WEIGHT) * gapAverageMs_;
+        gapSamples_++;
+        reconnectRate_ = GAP_WEIGHT + (1 - GAP_WEIGHT) * reconnectRate_;
+    }
+    // still loaded and later than the fixed timer would have waited
+    if (!idleRestored_ && gapMs <= holdOffMs_ && gapMs > DEFAULT_HOLD_OFF_MS) {
+        stats_.coldStartsAvoided++;
+    }
+    idleRestored_ = false;
+}
+
+int64_t AdaptiveUnloadPolicy::OnIdle()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    RestoreLocked();
+    idleSinceMs_ = clock_();
+    idleRestored_ = false;
+    stats_.idlePeriods++;
+    bool underPressure = pressureProbe_ != nullptr && pressureProbe_();
+    if (underPressure) {
+        stats_.pressureUnloads++;
+    }
+    holdOffMs_ = GetHoldOffLocked(underPressure);
+    stats_.holdOffMs = holdOffMs_;
+    return holdOffMs_;
+}
+
+void AdaptiveUnloadPolicy::OnUnload()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    EDM_LOGI(MODULE_DEV_MGR, "unload after %{public}" PRId64 "ms, reconnect gap %{public}.0fms, cold starts "
+        "%{public}" PRIu64 ", avoided %{public}" PRIu64 "", holdOffMs_, gapAverageMs_, stats_.coldStarts,
+        stats_.coldStartsAvoided);
+    if (saver_ != nullptr) {
+        saver_(SerializeLocked());
+    }
+}
+
+UnloadPolicyStats AdaptiveUnloadPolicy::GetStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    UnloadPolicyStats stats = stats_;
+    stats.reconnectGapMs = static_cast<int64_t>(gapAverageMs_);
+    stats.reconnectRate = reconnectRate_;
+    return stats;
+}
+
+int64_t AdaptiveUnloadPolicy::GetHoldOffLocked(bool underPressure) const
+{
+    if (underPressure) {
+        return MIN_HOLD_OFF_MS;
+    }
+    if (gapSamples_ == 0) {
+        return DEFAULT_HOLD_OFF_MS;
+    }
+    if (reconnectRate_ < MIN_RECONNECT_RATE) {
+        // waiting is unlikely to pay off
+        return MIN_HOLD_OFF_MS;
+    }
+    int64_t holdOffMs = static_cast<int64_t>(GAP_MARGIN * gapAverageMs_);
+    return std::clamp(holdOffMs, MIN_HOLD_OFF_MS, MAX_HOLD_OFF_MS);
+}
+
+void AdaptiveUnloadPolicy::RestoreLocked()
+{
+    if (restored_) {
+        return;
+    }
+    restored_ = true;
+    std::string state;
+    std::string savedBootId;
+    if (loader_ == nullptr || !loader_(state) || state.empty() || !Deserialize(state, savedBootId)) {
+        return;
+    }
+    // a device arriving now ends the idle period the last process unloaded in
+    if (idleSinceMs_ >= 0 && savedBootId == GetBootId() && idleSinceMs_ <= clock_()) {
+        idleRestored_ = true;
+        stats_.coldStarts++;
+    } else {
+        // saved before a reboot, the clock started over
+        idleSinceMs_ = -1;
+    }
+}
+
+std::string AdaptiveUnloadPolicy::SerializeLocked() const
+{
+    std::ostringstream state;
+    state << UNLOAD_STATE_VERSION << " " << GetBootId() << " " << idleSinceMs_ << " " << gapAverageMs_ << " " <<
+        gapSamples_ << " " << reconnectRate_ << " " << stats_.idlePeriods << " " << stats_.coldStarts << " " <<
+        stats_.coldStartsAvoided << " " << stats_.pressureUnloads;
+    return state.str();
+}
+
+std::string AdaptiveUnloadPolicy::GetBootId() const
+{
+    std::string bootId = bootIdReader_ != nullptr ? bootIdReader_() : "";
+    return bootId.empty() ? UNKNOWN_BOOT_ID : bootId;
+}
+
+bool AdaptiveUnloadPolicy::Deserialize(const std::string &state, std::string &bootId)
+{
+    std::istringstream stream(state);
+    uint32_t version = 0;
+    int64_t idleSinceMs = -1;
+    double gapAverageMs = 0;
+    uint64_t gapSamples = 0;
+    double reconnectRate = 0;
+    UnloadPolicyStats stats;
+    if (!(stream >> version) || version != UNLOAD_STATE_VERSION) {
+        EDM_LOGW(MODULE_DEV_MGR, "unload policy state version mismatch");
+        return false;
+    }
+    if (!(stream >> bootId >> idleSinceMs >> gapAverageMs >> gapSamples >> reconnectRate >> stats.idlePeriods >>
+        stats.coldStarts >> stats.coldStartsAvoided >> stats.pressureUnloads)) {
+        EDM_LOGW(MODULE_DEV_MGR, "unload policy state is malformed");
+        return false;
+    }
+    idleSinceMs_ = idleSinceMs;
+    gapAverageMs_ = std::max(gapAverageMs, 0.0);
+    gapSamples_ = gapSamples;
+    reconnectRate_ = std::clamp(reconnectRate, 0.0, 1.0);
+    stats.holdOffMs = holdOffMs_;
+    stats_ = stats;
+    return true;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -15,18 +15,26 @@
 
 #include "driver_ext_mgr.h"
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <pthread.h>
+
 #include "bus_extension_core.h"
 #include "dev_change_callback.h"
 #include "driver_extension_controller.h"
 #include "driver_pkg_manager.h"
+#include "driver_report_sys_event.h"
 #include "edm_errors.h"
 #include "etx_device_mgr.h"
 #include "event_config.h"
+#include "ext_dev_api_histogram.h"
 #include "ext_permission_manager.h"
 #include "hilog_wrapper.h"
 #include "idriver_change_callback.h"
 #include "iservice_registry.h"
 #include "notification_peripheral.h"
+#include "startup_graph.h"
 #include "system_ability_definition.h"
 #include "usb_device_info.h"
 #include "usb_driver_info.h"
@@ -37,52 +45,133 @@ const bool G_REGISTER_RESULT =
     SystemAbility::MakeAndRegisterAbility(DelayedSingleton<DriverExtMgr>::GetInstance().get());
 static const std::string PERMISSION_NAME = "ohos.permission.ACCESS_EXTENSIONAL_DEVICE_DRIVER";
 static const std::string ACCESS_DDK_DRIVERS_PERMISSION = "ohos.permission.ACCESS_DDK_DRIVERS";
+// a client process registers one callback, the margin covers several clients sharing a token
+constexpr uint32_t MAX_QUERY_CACHE_CALLBACKS_PER_TOKEN = 8;
+constexpr uint32_t MAX_DEVICE_SUBSCRIBERS_PER_TOKEN = 8;
+constexpr const char *DEVICE_NOTICE_TASK_NAME = "EDM_devNotice";
 
 DriverExtMgr::DriverExtMgr() : SystemAbility(HDF_EXTERNAL_DEVICE_MANAGER_SA_ID, true) {}
-DriverExtMgr::~DriverExtMgr() {}
+DriverExtMgr::~DriverExtMgr()
+{
+    StopDeviceChangeNotices();
+}
 
 void DriverExtMgr::OnStart()
 {
-    int32_t ret;
     EDM_LOGI(MODULE_SERVICE, "hdf_ext_devmgr OnStart");
-    BusExtensionCore::GetInstance().LoadBusExtensionLibs();
-    std::shared_ptr<IDriverChangeCallback> driverChangeCallback =
-        BusExtensionCore::GetInstance().AcquireDriverChangeCallback(BUS_TYPE_USB);
-    ExtDeviceManager::GetInstance().SetDriverChangeCallback(driverChangeCallback);
-    ret = DriverPkgManager::GetInstance().Init(bmsFuture_, accountFuture_, commEventFuture_);
-    AddSystemAbilityListener(SUBSYS_ACCOUNT_SYS_ABILITY_ID_BEGIN);
-    AddSystemAbilityListener(BUNDLE_MGR_SERVICE_SYS_ABILITY_ID);
-    AddSystemAbilityListener(COMMON_EVENT_SERVICE_ID);
-    if (ret != EDM_OK) {
-        EDM_LOGE(MODULE_SERVICE, "DriverPkgManager Init failed %{public}d", ret);
-    }
-    ret = ExtDeviceManager::GetInstance().Init();
-    if (ret != EDM_OK) {
-        EDM_LOGE(MODULE_SERVICE, "ExtDeviceManager Init failed %{public}d", ret);
-    }
-    std::shared_ptr<DevChangeCallback> callback = std::make_shared<DevChangeCallback>();
-    ret = BusExtensionCore::GetInstance().Init(callback);
-    if (ret != EDM_OK) {
-        EDM_LOGE(MODULE_SERVICE, "BusExtensionCore Init failed %{public}d", ret);
-    }
-    if (!Publish(AsObject())) {
-        EDM_LOGE(MODULE_DEV_MGR, "OnStart register to system ability manager failed.");
-        return;
-    }
-    eventConfig_ = EventConfig::GetInstance();
-    if (!eventConfig_.ParseJsonFile()) {
-        EDM_LOGE(MODULE_SERVICE, "ParseJsonFile failed");
-    }
+    StartupGraph graph;
+    graph.AddPhase("LoadBusExtensionLibs", {}, []() {
+        BusExtensionCore::GetInstance().LoadBusExtensionLibs();
+    });
+    graph.AddPhase("EnablePermissionCache", {}, []() {
+        if (!ExtPermissionManager::EnableCache({ PERMISSION_NAME, ACCESS_DDK_DRIVERS_PERMISSION })) {
+            EDM_LOGW(MODULE_SERVICE, "permission cache disabled");
+        }
+    });
+    graph.AddPhase("DriverPkgManagerInit", {}, [this]() {
+        int32_t ret = DriverPkgManager::GetInstance().Init(bmsFuture_, accountFuture_, commEventFuture_);
+        if (ret != EDM_OK) {
+            EDM_LOGE(MODULE_SERVICE, "DriverPkgManager Init failed %{public}d", ret);
+        }
+    });
+    // a driver matched from Init on is reported through the driver change callback, it is set before
+    graph.AddPhase("ExtDeviceManagerInit", {"DriverPkgManagerInit", "SetDriverChangeCallback"}, [this]() {
+        ExtDeviceManager::GetInstance().SetDeviceChangeHandler(
+            [this](uint64_t sequence, DeviceChangeType type, const std::shared_ptr<Device> &device) {
+                OnDeviceChanged(sequence, type, device);
+            });
+        ExtDeviceManager::GetInstance().SetQueryGenerationHandler([this](uint64_t generation) {
+            OnQueryGenerationChanged(generation);
+        });
+        int32_t ret = ExtDeviceManager::GetInstance().Init();
+        if (ret != EDM_OK) {
+            EDM_LOGE(MODULE_SERVICE, "ExtDeviceManager Init failed %{public}d", ret);
+        }
+    });
+    graph.AddPhase("SetDriverChangeCallback", {"LoadBusExtensionLibs"}, []() {
+        std::shared_ptr<IDriverChangeCallback> driverChangeCallback =
+            BusExtensionCore::GetInstance().AcquireDriverChangeCallback(BUS_TYPE_USB);
+        ExtDeviceManager::GetInstance().SetDriverChangeCallback(driverChangeCallback);
+    });
+    // the bundle and account callbacks parse driver metadata through the bus extensions
+    graph.AddPhase("AddSystemAbilityListener", {"LoadBusExtensionLibs", "ExtDeviceManagerInit"}, [this]() {
+        AddSystemAbilityListener(SUBSYS_ACCOUNT_SYS_ABILITY_ID_BEGIN);
+        AddSystemAbilityListener(BUNDLE_MGR_SERVICE_SYS_ABILITY_ID);
+        AddSystemAbilityListener(COMMON_EVENT_SERVICE_ID);
+    });
+    // devices are reported from here on
+    graph.AddPhase("BusExtensionCoreInit", {"ExtDeviceManagerInit", "SetDriverChangeCallback"}, []() {
+        std::shared_ptr<DevChangeCallback> callback = std::make_shared<DevChangeCallback>();
+        int32_t ret = BusExtensionCore::GetInstance().Init(callback);
+        if (ret != EDM_OK) {
+            EDM_LOGE(MODULE_SERVICE, "BusExtensionCore Init failed %{public}d", ret);
+        }
+    });
+    graph.AddPhase("Publish", {"AddSystemAbilityListener", "BusExtensionCoreInit", "EnablePermissionCache"},
+        [this]() {
+            if (!Publish(AsObject())) {
+                EDM_LOGE(MODULE_DEV_MGR, "OnStart register to system ability manager failed.");
+            }
+        });
+    auto timings = graph.Run();
+    std::lock_guard<std::mutex> lock(startupMutex_);
+    startupTimings_ = std::move(timings);
 }
 
 void DriverExtMgr::OnStop()
 {
     EDM_LOGI(MODULE_SERVICE, "hdf_ext_devmgr OnStop");
+    ExtDeviceManager::GetInstance().SetDeviceChangeHandler(nullptr);
+    ExtDeviceManager::GetInstance().SetQueryGenerationHandler(nullptr);
+    StopDeviceChangeNotices();
+    ExtPermissionManager::DisableCache();
+    DriverPkgManager::GetInstance().StopBundleTasks();
+    ExtDevReportSysEvent::FlushExternalDeviceEvents();
 }
 
 int DriverExtMgr::Dump(int fd, const std::vector<std::u16string> &args)
 {
-    return 0;
+    if (fd < 0) {
+        EDM_LOGE(MODULE_SERVICE, "Dump invalid fd %{public}d", fd);
+        return EDM_ERR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(startupMutex_);
+    dprintf(fd, "startup phases, in microseconds since OnStart:\n");
+    int64_t total = 0;
+    for (const auto &timing : startupTimings_) {
+        dprintf(fd, "  %-26s start %8" PRId64 "  duration %8" PRId64 "\n", timing.name.c_str(), timing.startUs,
+            timing.durationUs);
+        total = std::max(total, timing.startUs + timing.durationUs);
+    }
+    dprintf(fd, "  %-26s %8" PRId64 "\n", "total", total);
+    // initialized on first use, their cost falls on that call instead of on OnStart
+    for (const auto &timing : lazyTimings_) {
+        dprintf(fd, "  %-26s duration %8" PRId64 " (first use)\n", timing.name.c_str(), timing.durationUs);
+    }
+    UnloadPolicyStats unload = ExtDeviceManager::GetInstance().GetUnloadPolicyStats();
+    dprintf(fd, "unload policy:\n");
+    dprintf(fd, "  hold-off %" PRId64 "ms, reconnect gap %" PRId64 "ms, reconnect rate %.2f\n", unload.holdOffMs,
+        unload.reconnectGapMs, unload.reconnectRate);
+    dprintf(fd, "  idle periods %" PRIu64 ", cold starts %" PRIu64 ", avoided %" PRIu64 ", under memory pressure %"
+        PRIu64 "\n", unload.idlePeriods, unload.coldStarts, unload.coldStartsAvoided, unload.pressureUnloads);
+    ExtDevApiHistogram::Dump(fd);
+    return EDM_OK;
+}
+
+const EventConfig &DriverExtMgr::GetEventConfig()
+{
+    std::call_once(eventConfigOnce_, [this]() {
+        auto start = StartupGraph::Clock::now();
+        eventConfig_ = EventConfig::GetInstance();
+        if (!eventConfig_.ParseJsonFile()) {
+            EDM_LOGE(MODULE_SERVICE, "ParseJsonFile failed");
+        }
+        int64_t durationUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            StartupGraph::Clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(startupMutex_);
+        lazyTimings_.push_back({"EventConfigParse", 0, durationUs});
+    });
+    return eventConfig_;
 }
 
 void DriverExtMgr::OnAddSystemAbility(int32_t systemAbilityId, const std::string &deviceId)
@@ -124,6 +213,7 @@ void DriverExtMgr::OnAddSystemAbility(int32_t systemAbilityId, const std::string
 ErrCode DriverExtMgr::QueryDevice(int32_t &errorCode, uint32_t busType,
     std::vector<std::shared_ptr<DeviceData>> &devices)
 {
+    EXT_DEV_API_TIMER();
     if (!ExtPermissionManager::VerifyPermission(PERMISSION_NAME)) {
         EDM_LOGE(MODULE_DEV_MGR, "%{public}s no permission", __func__);
         errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_NO_PERM);
@@ -139,6 +229,9 @@ ErrCode DriverExtMgr::QueryDevice(int32_t &errorCode, uint32_t busType,
     std::vector<std::shared_ptr<DeviceInfo>> deviceInfos =
         ExtDeviceManager::GetInstance().QueryDevice(static_cast<BusType>(busType));
     for (const auto &deviceInfo : deviceInfos) {
+        if (deviceInfo->GetInterfaceNumber() >= 0) {
+            continue;
+        }
         switch (deviceInfo->GetBusType()) {
             case BusType::BUS_TYPE_USB: {
                 std::shared_ptr<UsbDeviceInfo> usbDeviceInfo = std::static_pointer_cast<UsbDeviceInfo>(deviceInfo);
@@ -163,6 +256,7 @@ ErrCode DriverExtMgr::QueryDevice(int32_t &errorCode, uint32_t busType,
 ErrCode DriverExtMgr::BindDevice(int32_t &errorCode, uint64_t deviceId,
     const sptr<IDriverExtMgrCallback> &connectCallback)
 {
+    EXT_DEV_API_TIMER();
     EDM_LOGI(MODULE_DEV_MGR, "%{public}s enter", __func__);
     if (!ExtPermissionManager::VerifyPermission(PERMISSION_NAME)) {
         EDM_LOGE(MODULE_DEV_MGR, "%{public}s no permission", __func__);
@@ -171,6 +265,9 @@ ErrCode DriverExtMgr::BindDevice(int32_t &errorCode, uint64_t deviceId,
     }
 
     uint32_t callingTokenId = ExtPermissionManager::GetCallingTokenID();
+    if (connectCallback != nullptr) {
+        ExtPermissionManager::WatchCaller(connectCallback->AsObject());
+    }
     UsbErrCode ret = static_cast<UsbErrCode>(ExtDeviceManager::GetInstance().ConnectDevice(deviceId, callingTokenId,
         connectCallback));
     if (ret == UsbErrCode::EDM_OK) {
@@ -183,6 +280,7 @@ ErrCode DriverExtMgr::BindDevice(int32_t &errorCode, uint64_t deviceId,
 
 ErrCode DriverExtMgr::UnBindDevice(int32_t &errorCode, uint64_t deviceId)
 {
+    EXT_DEV_API_TIMER();
     EDM_LOGD(MODULE_DEV_MGR, "%{public}s enter", __func__);
     if (!ExtPermissionManager::VerifyPermission(PERMISSION_NAME)) {
         EDM_LOGE(MODULE_DEV_MGR, "%{public}s no permission", __func__);
@@ -199,6 +297,7 @@ ErrCode DriverExtMgr::UnBindDevice(int32_t &errorCode, uint64_t deviceId)
 ErrCode DriverExtMgr::BindDriverWithDeviceId(int32_t &errorCode, uint64_t deviceId,
     const sptr<IDriverExtMgrCallback> &connectCallback)
 {
+    EXT_DEV_API_TIMER();
     EDM_LOGI(MODULE_DEV_MGR, "%{public}s enter", __func__);
     if (!ExtPermissionManager::VerifyPermission(ACCESS_DDK_DRIVERS_PERMISSION)) {
         EDM_LOGE(MODULE_DEV_MGR, "%{public}s no permission", __func__);
@@ -213,6 +312,9 @@ ErrCode DriverExtMgr::BindDriverWithDeviceId(int32_t &errorCode, uint64_t device
         errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_NO_PERM);
         return static_cast<int32_t>(UsbErrCode::EDM_OK);
     }
+    if (connectCallback != nullptr) {
+        ExtPermissionManager::WatchCaller(connectCallback->AsObject());
+    }
     errorCode = static_cast<int32_t>(ExtDeviceManager::GetInstance().ConnectDriverWithDeviceId(deviceId, callingTokenId,
         accessibleAppIds, connectCallback));
     return static_cast<int32_t>(UsbErrCode::EDM_OK);
@@ -220,6 +322,7 @@ ErrCode DriverExtMgr::BindDriverWithDeviceId(int32_t &errorCode, uint64_t device
 
 ErrCode DriverExtMgr::UnBindDriverWithDeviceId(int32_t &errorCode, uint64_t deviceId)
 {
+    EXT_DEV_API_TIMER();
     EDM_LOGD(MODULE_DEV_MGR, "%{public}s enter", __func__);
     if (!ExtPermissionManager::VerifyPermission(ACCESS_DDK_DRIVERS_PERMISSION)) {
         EDM_LOGE(MODULE_DEV_MGR, "%{public}s no permission", __func__);
@@ -241,6 +344,10 @@ static std::shared_ptr<DeviceInfoData> ParseToDeviceInfoData(const std::shared_p
         return nullptr;
     }
     auto deviceInfo = device->GetDeviceInfo();
+    // the interfaces of a composite device are matched and bound inside the service, apps only see whole devices
+    if (deviceInfo->GetInterfaceNumber() >= 0) {
+        return nullptr;
+    }
     auto busType = deviceInfo->GetBusType();
     if (busType <= BusType::BUS_TYPE_INVALID || busType >= BusType::BUS_TYPE_MAX) {
         EDM_LOGD(MODULE_DEV_MGR, "invalid busType:%{public}u", busType);
@@ -322,6 +429,7 @@ static std::shared_ptr<DriverInfoData> ParseToDriverInfoData(const std::shared_p
 ErrCode DriverExtMgr::QueryDeviceInfo(int32_t &errorCode, std::vector<std::shared_ptr<DeviceInfoData>> &deviceInfos,
     bool isByDeviceId, const uint64_t deviceId)
 {
+    EXT_DEV_API_TIMER();
     EDM_LOGD(MODULE_DEV_MGR, "%{public}s enter", __func__);
     if (!ExtPermissionManager::IsSystemApp()) {
         EDM_LOGE(MODULE_DEV_MGR, "%{public}s none system app", __func__);
@@ -355,6 +463,7 @@ ErrCode DriverExtMgr::QueryDeviceInfo(int32_t &errorCode, std::vector<std::share
 ErrCode DriverExtMgr::QueryDriverInfo(int32_t &errorCode, std::vector<std::shared_ptr<DriverInfoData>> &driverInfos,
     bool isByDriverUid, const std::string &driverUid)
 {
+    EXT_DEV_API_TIMER();
     if (!ExtPermissionManager::IsSystemApp()) {
         EDM_LOGE(MODULE_DEV_MGR, "%{public}s none system app", __func__);
         errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_NOT_SYSTEM_APP);
@@ -388,6 +497,7 @@ ErrCode DriverExtMgr::QueryDriverInfo(int32_t &errorCode, std::vector<std::share
 
 ErrCode DriverExtMgr::NotifyUsbPeripheralFault(const std::string &domain, const std::string &faultName)
 {
+    EXT_DEV_API_TIMER();
     if (!ExtPermissionManager::IsSa()) {
         EDM_LOGE(MODULE_DEV_MGR, "%{public}s not a sa", __func__);
         return static_cast<int32_t>(UsbErrCode::EDM_ERR_NO_PERM);
@@ -401,7 +511,7 @@ ErrCode DriverExtMgr::NotifyUsbPeripheralFault(const std::string &domain, const
     EDM_LOGI(MODULE_SERVICE, "HandleFaultEvent domain = %{public}s, faultName = %{public}s", domain.c_str(),
         faultName.c_str());
 
-    auto faultInfo = eventConfig_.GetFaultInfo(domain, faultName);
+    auto faultInfo = GetEventConfig().GetFaultInfo(domain, faultName);
     if (faultInfo.faultName.empty() || faultInfo.type.empty() || faultInfo.title.empty()|| faultInfo.msg.empty()) {
         EDM_LOGE(MODULE_SERVICE, "GetFaultInfo failed");
         return static_cast<int32_t>(UsbErrCode::EDM_ERR_INVALID_PARAM);
@@ -413,5 +523,322 @@ ErrCode DriverExtMgr::NotifyUsbPeripheralFault(const std::string &domain, const
     }
     return static_cast<int32_t>(UsbErrCode::EDM_OK);
 }
+
+ErrCode DriverExtMgr::SubscribeDeviceChanges(int32_t &errorCode, const sptr<IDeviceSubscribeCallback> &callback,
+    uint64_t &sequence, std::vector<std::shared_ptr<DeviceInfoData>> &deviceInfos)
+{
+    EXT_DEV_API_TIMER();
+    EDM_LOGD(MODULE_DEV_MGR, "%{public}s enter", __func__);
+    if (!ExtPermissionManager::IsSystemApp()) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s none system app", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_NOT_SYSTEM_APP);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    if (!ExtPermissionManager::VerifyPermission(PERMISSION_NAME)) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s no permission", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_NO_PERM);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    if (callback == nullptr || callback->AsObject() == nullptr) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s invalid callback", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_INVALID_PARAM);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    sptr<IRemoteObject> remote = callback->AsObject();
+    uint32_t tokenId = ExtPermissionManager::GetCallingTokenID();
+    bool added = false;
+    bool tooMany = false;
+    // the subscriber is added together with the snapshot, so the first delta it gets is sequence + 1
+    vector<shared_ptr<Device>> devices = ExtDeviceManager::GetInstance().QueryAllDevices(sequence, [&]() {
+        std::lock_guard<std::mutex> lock(subscriberMutex_);
+        if (deviceSubscribers_.count(remote.GetRefPtr()) != 0) {
+            return;
+        }
+        uint32_t &count = deviceSubscriberCounts_[tokenId];
+        if (count >= MAX_DEVICE_SUBSCRIBERS_PER_TOKEN) {
+            tooMany = true;
+            return;
+        }
+        deviceSubscribers_.emplace(remote.GetRefPtr(), DeviceSubscriberEntry { callback, tokenId });
+        count++;
+        added = true;
+    });
+    if (tooMany) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s too many subscribers of token", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_OUT_OF_RANGE);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+    if (added && remote->IsProxyObject() && !remote->AddDeathRecipient(subscriberDeathRecipient_)) {
+        EDM_LOGW(MODULE_DEV_MGR, "%{public}s failed to add death recipient", __func__);
+    }
+    ExtPermissionManager::WatchCaller(remote);
+
+    for (const auto &device : devices) {
+        auto tempDeviceInfo = ParseToDeviceInfoData(device);
+        if (tempDeviceInfo != nullptr) {
+            deviceInfos.push_back(tempDeviceInfo);
+        }
+    }
+    EDM_LOGI(MODULE_DEV_MGR, "device subscriber added, sequence: %{public}" PRIu64 "", sequence);
+    errorCode = static_cast<int32_t>(UsbErrCode::EDM_OK);
+    return static_cast<int32_t>(UsbErrCode::EDM_OK);
+}
+
+ErrCode DriverExtMgr::UnsubscribeDeviceChanges(int32_t &errorCode, const sptr<IDeviceSubscribeCallback> &callback)
+{
+    EXT_DEV_API_TIMER();
+    EDM_LOGD(MODULE_DEV_MGR, "%{public}s enter", __func__);
+    if (!ExtPermissionManager::IsSystemApp()) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s none system app", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_NOT_SYSTEM_APP);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    if (!ExtPermissionManager::VerifyPermission(PERMISSION_NAME)) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s no permission", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_NO_PERM);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    if (callback == nullptr || callback->AsObject() == nullptr) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s invalid callback", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_INVALID_PARAM);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    sptr<IRemoteObject> remote = callback->AsObject();
+    {
+        std::lock_guard<std::mutex> lock(subscriberMutex_);
+        if (!EraseDeviceSubscriberLocked(remote.GetRefPtr())) {
+            EDM_LOGE(MODULE_DEV_MGR, "%{public}s callback is not subscribed", __func__);
+            errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_INVALID_PARAM);
+            return static_cast<int32_t>(UsbErrCode::EDM_OK);
+        }
+    }
+    if (remote->IsProxyObject()) {
+        remote->RemoveDeathRecipient(subscriberDeathRecipient_);
+    }
+    ExtPermissionManager::UnwatchCaller(remote);
+    errorCode = static_cast<int32_t>(UsbErrCode::EDM_OK);
+    return static_cast<int32_t>(UsbErrCode::EDM_OK);
+}
+
+void DriverExtMgr::OnDeviceChanged(uint64_t sequence, DeviceChangeType type, const std::shared_ptr<Device> &device)
+{
+    DeviceChangeNotice notice;
+    {
+        std::lock_guard<std::mutex> lock(subscriberMutex_);
+        if (deviceSubscribers_.empty() || device == nullptr || device->GetDeviceInfo() == nullptr) {
+            return;
+        }
+        notice.subscribers.reserve(deviceSubscribers_.size());
+        for (auto &[_, entry] : deviceSubscribers_) {
+            notice.subscribers.push_back(entry.callback);
+        }
+    }
+
+    notice.delta = std::make_shared<DeviceChangeDelta>();
+    notice.delta->sequence = sequence;
+    notice.delta->type = type;
+    notice.delta->deviceId = device->GetDeviceInfo()->GetDeviceId();
+    if (type == DeviceChangeType::DEVICE_CHANGE_ADDED) {
+        notice.delta->deviceInfo = ParseToDeviceInfoData(device);
+    }
+    // queued in sequence order because the device map is locked by the caller
+    PostDeviceChangeNotice(std::move(notice));
+}
+
+void DriverExtMgr::PostDeviceChangeNotice(DeviceChangeNotice &&notice)
+{
+    std::lock_guard<std::mutex> lock(noticeMutex_);
+    if (noticeStopping_) {
+        return;
+    }
+    notices_.push_back(std::move(notice));
+    if (!noticeThread_.joinable()) {
+        noticeThread_ = std::thread([this]() { RunDeviceChangeNotices(); });
+        pthread_setname_np(noticeThread_.native_handle(), DEVICE_NOTICE_TASK_NAME);
+    }
+    noticeCv_.notify_one();
+}
+
+void DriverExtMgr::RunDeviceChangeNotices()
+{
+    std::unique_lock<std::mutex> lock(noticeMutex_);
+    while (true) {
+        noticeCv_.wait(lock, [this]() { return !notices_.empty() || noticeStopping_; });
+        if (notices_.empty()) {
+            return;
+        }
+        DeviceChangeNotice notice = std::move(notices_.front());
+        notices_.pop_front();
+        lock.unlock();
+        // oneway calls, a subscriber that is slow to read does not hold up the device map
+        std::vector<std::shared_ptr<DeviceChangeDelta>> deltas = { notice.delta };
+        for (auto &subscriber : notice.subscribers) {
+            subscriber->OnDeviceChanged(deltas);
+        }
+        lock.lock();
+    }
+}
+
+void DriverExtMgr::StopDeviceChangeNotices()
+{
+    std::thread sender;
+    {
+        std::lock_guard<std::mutex> lock(noticeMutex_);
+        noticeStopping_ = true;
+        sender = std::move(noticeThread_);
+    }
+    noticeCv_.notify_one();
+    // the sender sends what is queued before it exits
+    if (sender.joinable()) {
+        sender.join();
+    }
+    std::lock_guard<std::mutex> lock(noticeMutex_);
+    noticeStopping_ = false;
+}
+
+ErrCode DriverExtMgr::RegisterQueryCacheCallback(int32_t &errorCode, const sptr<IQueryCacheCallback> &callback,
+    uint64_t &generation)
+{
+    EXT_DEV_API_TIMER();
+    EDM_LOGD(MODULE_DEV_MGR, "%{public}s enter", __func__);
+    if (!ExtPermissionManager::IsSystemApp()) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s none system app", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_NOT_SYSTEM_APP);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    if (!ExtPermissionManager::VerifyPermission(PERMISSION_NAME)) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s no permission", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_NO_PERM);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    if (callback == nullptr || callback->AsObject() == nullptr) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s invalid callback", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_INVALID_PARAM);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    sptr<IRemoteObject> remote = callback->AsObject();
+    uint32_t tokenId = ExtPermissionManager::GetCallingTokenID();
+    bool added = false;
+    {
+        std::lock_guard<std::mutex> lock(subscriberMutex_);
+        if (queryCacheCallbacks_.count(remote.GetRefPtr()) == 0) {
+            uint32_t &count = queryCacheCallbackCounts_[tokenId];
+            if (count >= MAX_QUERY_CACHE_CALLBACKS_PER_TOKEN) {
+                EDM_LOGE(MODULE_DEV_MGR, "%{public}s too many callbacks of token", __func__);
+                errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_OUT_OF_RANGE);
+                return static_cast<int32_t>(UsbErrCode::EDM_OK);
+            }
+            queryCacheCallbacks_.emplace(remote.GetRefPtr(), QueryCacheCallbackEntry { callback, tokenId });
+            count++;
+            added = true;
+        }
+        // read after the callback is in place, so no later generation can be missed
+        generation = ExtDeviceManager::GetInstance().GetQueryGeneration();
+    }
+    if (added && remote->IsProxyObject() && !remote->AddDeathRecipient(subscriberDeathRecipient_)) {
+        EDM_LOGW(MODULE_DEV_MGR, "%{public}s failed to add death recipient", __func__);
+    }
+    errorCode = static_cast<int32_t>(UsbErrCode::EDM_OK);
+    return static_cast<int32_t>(UsbErrCode::EDM_OK);
+}
+
+ErrCode DriverExtMgr::UnregisterQueryCacheCallback(int32_t &errorCode, const sptr<IQueryCacheCallback> &callback)
+{
+    EXT_DEV_API_TIMER();
+    EDM_LOGD(MODULE_DEV_MGR, "%{public}s enter", __func__);
+    if (!ExtPermissionManager::IsSystemApp()) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s none system app", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_NOT_SYSTEM_APP);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    if (!ExtPermissionManager::VerifyPermission(PERMISSION_NAME)) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s no permission", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_NO_PERM);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    if (callback == nullptr || callback->AsObject() == nullptr) {
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s invalid callback", __func__);
+        errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_INVALID_PARAM);
+        return static_cast<int32_t>(UsbErrCode::EDM_OK);
+    }
+
+    sptr<IRemoteObject> remote = callback->AsObject();
+    {
+        std::lock_guard<std::mutex> lock(subscriberMutex_);
+        if (!EraseQueryCacheCallbackLocked(remote.GetRefPtr())) {
+            EDM_LOGE(MODULE_DEV_MGR, "%{public}s callback is not registered", __func__);
+            errorCode = static_cast<int32_t>(UsbErrCode::EDM_ERR_INVALID_PARAM);
+            return static_cast<int32_t>(UsbErrCode::EDM_OK);
+        }
+    }
+    if (remote->IsProxyObject()) {
+        remote->RemoveDeathRecipient(subscriberDeathRecipient_);
+    }
+    errorCode = static_cast<int32_t>(UsbErrCode::EDM_OK);
+    return static_cast<int32_t>(UsbErrCode::EDM_OK);
+}
+
+void DriverExtMgr::OnQueryGenerationChanged(uint64_t generation)
+{
+    std::lock_guard<std::mutex> lock(subscriberMutex_);
+    for (auto &[_, entry] : queryCacheCallbacks_) {
+        entry.callback->OnQueryInvalidated(generation);
+    }
+}
+
+bool DriverExtMgr::EraseDeviceSubscriberLocked(const IRemoteObject *remote)
+{
+    auto iter = deviceSubscribers_.find(remote);
+    if (iter == deviceSubscribers_.end()) {
+        return false;
+    }
+    auto count = deviceSubscriberCounts_.find(iter->second.tokenId);
+    if (count != deviceSubscriberCounts_.end() && --count->second == 0) {
+        deviceSubscriberCounts_.erase(count);
+    }
+    deviceSubscribers_.erase(iter);
+    return true;
+}
+
+bool DriverExtMgr::EraseQueryCacheCallbackLocked(const IRemoteObject *remote)
+{
+    auto iter = queryCacheCallbacks_.find(remote);
+    if (iter == queryCacheCallbacks_.end()) {
+        return false;
+    }
+    auto count = queryCacheCallbackCounts_.find(iter->second.tokenId);
+    if (count != queryCacheCallbackCounts_.end() && --count->second == 0) {
+        queryCacheCallbackCounts_.erase(count);
+    }
+    queryCacheCallbacks_.erase(iter);
+    return true;
+}
+
+void DriverExtMgr::RemoveDeviceSubscriber(const IRemoteObject *remote)
+{
+    std::lock_guard<std::mutex> lock(subscriberMutex_);
+    if (EraseDeviceSubscriberLocked(remote)) {
+        EDM_LOGI(MODULE_DEV_MGR, "device subscriber died, removed");
+    }
+    if (EraseQueryCacheCallbackLocked(remote)) {
+        EDM_LOGI(MODULE_DEV_MGR, "query cache callback died, removed");
+    }
+}
+
+void DriverExtMgr::DeviceSubscriberDeathRecipient::OnRemoteDied(const wptr<IRemoteObject> &remote)
+{
+    DelayedSingleton<DriverExtMgr>::GetInstance()->RemoveDeviceSubscriber(remote.GetRefPtr());
+}
 } // namespace ExternalDeviceManager
 } // namespace OHOS
@@ -272,9 +272,71 @@ DeviceInfoData* DeviceInfoData::Unmarshalling(Parcel &data)
     return deviceInfoData;
 }
 
+bool DeviceChangeDelta::Marshalling(Parcel &parcel) const
+{
+    if (!parcel.WriteUint64(sequence)) {
+        EDM_LOGE(MODULE_DEV_MGR, "failed to write sequence");
+        return false;
+    }
+
+    if (!parcel.WriteUint32(static_cast<uint32_t>(type))) {
+        EDM_LOGE(MODULE_DEV_MGR, "failed to write type");
+        return false;
+    }
+
+    if (!parcel.WriteUint64(deviceId)) {
+        EDM_LOGE(MODULE_DEV_MGR, "failed to write deviceId");
+        return false;
+    }
+
+    if (!parcel.WriteBool(deviceInfo != nullptr)) {
+        EDM_LOGE(MODULE_DEV_MGR, "failed to write deviceInfo flag");
+        return false;
+    }
+
+    if (deviceInfo != nullptr && !deviceInfo->Marshalling(parcel)) {
+        return false;
+    }
+    return true;
+}
+
+DeviceChangeDelta* DeviceChangeDelta::Unmarshalling(Parcel &data)
+{
+    DeviceChangeDelta *delta = new (std::nothrow) DeviceChangeDelta;
+    if (delta == nullptr) {
+        EDM_LOGE(MODULE_DEV_MGR, "failed to create DeviceChangeDelta");
+        return nullptr;
+    }
+
+    uint32_t type = 0;
+    bool hasDeviceInfo = false;
+    if (!data.ReadUint64(delta->sequence) || !data.ReadUint32(type) || !data.ReadUint64(delta->deviceId) ||
+        !data.ReadBool(hasDeviceInfo)) {
+        EDM_LOGE(MODULE_DEV_MGR, "failed to read DeviceChangeDelta");
+        delete delta;
+        return nullptr;
+    }
+
+    if (type > DeviceChangeType::DEVICE_CHANGE_REMOVED) {
+        EDM_LOGE(MODULE_DEV_MGR, "invalid change type:%{public}u", type);
+        delete delta;
+        return nullptr;
+    }
+    delta->type = static_cast<DeviceChangeType>(type);
+
+    if (hasDeviceInfo) {
+        delta->deviceInfo.reset(DeviceInfoData::Unmarshalling(data));
+        if (delta->deviceInfo == nullptr) {
+            delete delta;
+            return nullptr;
+        }
+    }
+    return delta;
+}
+
 BusType DeviceInfoData::GetBusTypeByDeviceId(uint64_t deviceId)
 {
-    return static_cast<BusType>(deviceId & 0x00000000FFFFFFF);
+    return DeviceInfo::GetBusTypeByDeviceId(deviceId);
 }
 
 USBDeviceInfoData* USBDeviceInfoData::Unmarshalling(Parcel &data)
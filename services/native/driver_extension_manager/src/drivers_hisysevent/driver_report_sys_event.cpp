@@ -14,6 +14,9 @@
  */
 
 #include "driver_report_sys_event.h"
+#include <algorithm>
+#include <cinttypes>
+#include <pthread.h>
 #include "hilog_wrapper.h"
 #include "hisysevent.h"
 #include "edm_errors.h"
@@ -26,7 +29,32 @@ using namespace OHOS::HiviewDFX;
 
 namespace OHOS {
 namespace ExternalDeviceManager {
-constexpr int32_t LAST_FIVE = 5;
+constexpr size_t LAST_FIVE = 5;
+constexpr size_t MAX_ID_DIGITS = 5;
+constexpr const char *SYS_EVENT_TASK_NAME = "EDM_sysEvent";
+
+namespace {
+// identical events share a key, the message and error code included
+std::string MakeEventKey(const ExtDevEvent &event)
+{
+    constexpr char sep = '\x1f';
+    std::string key;
+    key.reserve(event.driverUid.size() + event.bundleName.size() + event.interfaceName.size() +
+        event.message.size() + event.vids.size() + event.pids.size() + 128);
+    for (int64_t value : {static_cast<int64_t>(event.operatType), static_cast<int64_t>(event.errCode),
+        static_cast<int64_t>(event.deviceClass), static_cast<int64_t>(event.deviceSubClass),
+        static_cast<int64_t>(event.deviceProtocol), static_cast<int64_t>(event.vendorId),
+        static_cast<int64_t>(event.productId), static_cast<int64_t>(event.userId)}) {
+        key.append(std::to_string(value)).push_back(sep);
+    }
+    key.append(std::to_string(event.deviceId)).push_back(sep);
+    for (const std::string *value : {&event.snNum, &event.driverUid, &event.driverName, &event.versionCode,
+        &event.vids, &event.pids, &event.bundleName, &event.interfaceName, &event.message}) {
+        key.append(*value).push_back(sep);
+    }
+    return key;
+}
+} // namespace
 
 const std::map<ExtDevReportSysEvent::EventErrCode, std::string> ExtDevReportSysEvent::ErrMsgs = {
     {ExtDevReportSysEvent::EventErrCode::SUCCESS, "Success"},
@@ -59,36 +87,229 @@ const std::map<ExtDevReportSysEvent::EventErrCode, std::string> ExtDevReportSysE
         "No matching driver found for the device"}
 };
 
+ExtDevEventReporter::ExtDevEventReporter(Writer writer, size_t capacity, std::chrono::milliseconds coalesceWindow)
+    : writer_(std::move(writer)), capacity_(capacity), coalesceWindow_(coalesceWindow)
+{
+    queue_.reserve(capacity_);
+}
+
+ExtDevEventReporter::~ExtDevEventReporter()
+{
+    Stop();
+}
+
+bool ExtDevEventReporter::Push(ExtDevEvent &&event)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (queue_.size() >= capacity_) {
+        stats_.dropped++;
+        return false;
+    }
+    queue_.emplace_back(std::move(event));
+    stats_.pushed++;
+    if (!running_) {
+        StartLocked();
+    }
+    queueCv_.notify_one();
+    return true;
+}
+
+void ExtDevEventReporter::StartLocked()
+{
+    running_ = true;
+    thread_ = std::thread([this]() { Run(); });
+    pthread_setname_np(thread_.native_handle(), SYS_EVENT_TASK_NAME);
+}
+
+void ExtDevEventReporter::Flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!running_) {
+        return;
+    }
+    uint64_t ticket = ++flushRequested_;
+    queueCv_.notify_one();
+    flushCv_.wait(lock, [this, ticket]() { return flushDone_ >= ticket || !running_; });
+}
+
+void ExtDevEventReporter::Stop()
+{
+    std::thread writerThread;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_ || stopping_) {
+            return;
+        }
+        stopping_ = true;
+        writerThread = std::move(thread_);
+    }
+    queueCv_.notify_one();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+    stopping_ = false;
+    flushCv_.notify_all();
+    if (!queue_.empty()) {
+        // pushed after the writer had drained the queue for the last time
+        StartLocked();
+    }
+}
+
+ExtDevEventReporter::Stats ExtDevEventReporter::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void ExtDevEventReporter::Run()
+{
+    std::vector<ExtDevEvent> batch;
+    batch.reserve(capacity_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        auto ready = [this]() { return !queue_.empty() || stopping_ || flushRequested_ > flushDone_; };
+        if (pending_.empty()) {
+            queueCv_.wait(lock, ready);
+        } else {
+            Clock::time_point next = Clock::time_point::max();
+            for (const auto &item : pending_) {
+                next = std::min(next, item.second.deadline);
+            }
+            queueCv_.wait_until(lock, next, ready);
+        }
+        batch.swap(queue_);
+        uint64_t flushTicket = flushRequested_;
+        bool stop = stopping_;
+        uint64_t dropped = stats_.dropped;
+        lock.unlock();
+
+        if (dropped != reportedDropped_) {
+            EDM_LOGW(MODULE_PKG_MGR, "sys event queue full, %{public}" PRIu64 " events dropped",
+                dropped - reportedDropped_);
+            reportedDropped_ = dropped;
+        }
+        Clock::time_point now = Clock::now();
+        for (auto &event : batch) {
+            Coalesce(event, now);
+        }
+        batch.clear();
+        WriteExpired(now, stop || flushTicket > flushDone_);
+
+        lock.lock();
+        if (flushTicket > flushDone_) {
+            flushDone_ = flushTicket;
+            flushCv_.notify_all();
+        }
+        if (stop && queue_.empty()) {
+            break;
+        }
+    }
+}
+
+void ExtDevEventReporter::Coalesce(ExtDevEvent &event, Clock::time_point now)
+{
+    if (event.vids.empty() && !event.vidList.empty()) {
+        event.vids = ExtDevReportSysEvent::ParseIdVector(event.vidList);
+    }
+    if (event.pids.empty() && !event.pidList.empty()) {
+        event.pids = ExtDevReportSysEvent::ParseIdVector(event.pidList);
+    }
+    if (event.snNum.length() > LAST_FIVE) {
+        event.snNum = event.snNum.substr(event.snNum.length() - LAST_FIVE);
+    } else {
+        event.snNum.clear();
+    }
+
+    std::string key = MakeEventKey(event);
+    auto iter = pending_.find(key);
+    if (iter != pending_.end() && now < iter->second.deadline) {
+        iter->second.count++;
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.coalesced++;
+        return;
+    }
+    if (iter != pending_.end()) {
+        if (iter->second.count > 0) {
+            Write(iter->second.event, iter->second.count);
+        }
+        pending_.erase(iter);
+    }
+    Write(event, 1);
+    pending_.emplace(std::move(key), PendingRepeat {std::move(event), 0, now + coalesceWindow_});
+}
+
+void ExtDevEventReporter::WriteExpired(Clock::time_point now, bool all)
+{
+    for (auto iter = pending_.begin(); iter != pending_.end();) {
+        if (!all && now < iter->second.deadline) {
+            ++iter;
+            continue;
+        }
+        if (iter->second.count > 0) {
+            Write(iter->second.event, iter->second.count);
+        }
+        iter = pending_.erase(iter);
+    }
+}
+
+void ExtDevEventReporter::Write(ExtDevEvent &event, uint32_t repeatCount)
+{
+    if (writer_ != nullptr) {
+        (void)writer_(event, repeatCount);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.written++;
+}
+
+static ExtDevEventReporter &GetReporter()
+{
+    static ExtDevEventReporter reporter(ExtDevReportSysEvent::WriteExternalDeviceEvent);
+    return reporter;
+}
+
 void ExtDevReportSysEvent::ReportExternalDeviceEvent(const std::shared_ptr<ExtDevEvent> &extDevEvent)
 {
-    EDM_LOGI(MODULE_PKG_MGR, "report external device event");
     if (extDevEvent == nullptr) {
         EDM_LOGI(MODULE_PKG_MGR, "%{public}s, extDevEvent is null", __func__);
         return;
     }
-    std::string snNum = "";
-    if (extDevEvent->snNum.length() > LAST_FIVE) {
-        snNum = extDevEvent->snNum.substr(extDevEvent->snNum.length() - LAST_FIVE);
-    }
+    // callers keep reusing their event object, so the queue gets a copy
+    ExtDevEvent event = *extDevEvent;
+    (void)GetReporter().Push(std::move(event));
+}
 
+int32_t ExtDevReportSysEvent::WriteExternalDeviceEvent(const ExtDevEvent &extDevEvent, uint32_t repeatCount)
+{
     int32_t hiRet = HiSysEventWrite(HiSysEvent::Domain::EXTERNAL_DEVICE, "EXT_DEVICE_EVENT",
-        HiSysEvent::EventType::STATISTIC, "DEVICE_CLASS", extDevEvent->deviceClass, "DEVICE_SUBCLASS",
-        extDevEvent->deviceSubClass, "DEVICE_PROTOCOL", extDevEvent->deviceProtocol, "SN_NUM", snNum,
-        "VENDOR_ID", extDevEvent->vendorId, "PRODUCT_ID", extDevEvent->productId,
-        "DEVICE_ID", extDevEvent->deviceId, "DRIVER_UID", extDevEvent->driverUid, "DRIVER_NAME",
-        extDevEvent->driverName, "VERSION_CODE", extDevEvent->versionCode, "VIDS", extDevEvent->vids,
-        "PIDS", extDevEvent->pids, "USER_ID", extDevEvent->userId, "BUNDLE_NAME", extDevEvent->bundleName,
-        "OPERAT_TYPE", extDevEvent->operatType, "INTERFACE_NAME", extDevEvent->interfaceName, "MESSAGE",
-        extDevEvent->message, "ERR_CODE", extDevEvent->errCode);
+        HiSysEvent::EventType::STATISTIC, "DEVICE_CLASS", extDevEvent.deviceClass, "DEVICE_SUBCLASS",
+        extDevEvent.deviceSubClass, "DEVICE_PROTOCOL", extDevEvent.deviceProtocol, "SN_NUM", extDevEvent.snNum,
+        "VENDOR_ID", extDevEvent.vendorId, "PRODUCT_ID", extDevEvent.productId,
+        "DEVICE_ID", extDevEvent.deviceId, "DRIVER_UID", extDevEvent.driverUid, "DRIVER_NAME",
+        extDevEvent.driverName, "VERSION_CODE", extDevEvent.versionCode, "VIDS", extDevEvent.vids,
+        "PIDS", extDevEvent.pids, "USER_ID", extDevEvent.userId, "BUNDLE_NAME", extDevEvent.bundleName,
+        "OPERAT_TYPE", extDevEvent.operatType, "INTERFACE_NAME", extDevEvent.interfaceName, "MESSAGE",
+        extDevEvent.message, "ERR_CODE", extDevEvent.errCode, "REPEAT_COUNT", repeatCount);
     if (hiRet != EDM_OK) {
         EDM_LOGI(MODULE_PKG_MGR, "HiSysEventWrite ret: %{public}d", hiRet);
     }
+    return hiRet;
+}
+
+void ExtDevReportSysEvent::FlushExternalDeviceEvents()
+{
+    GetReporter().Stop();
+}
+
+ExtDevEventReporter::Stats ExtDevReportSysEvent::GetReportStats()
+{
+    return GetReporter().GetStats();
 }
 
 void ExtDevReportSysEvent::ReportExternalDeviceEvent(const std::shared_ptr<ExtDevEvent> &extDevEvent,
     const ExtDevReportSysEvent::EventErrCode errCode)
 {
-    EDM_LOGI(MODULE_PKG_MGR, "report external device event with error code");
     if (extDevEvent == nullptr) {
         EDM_LOGI(MODULE_PKG_MGR, "%{public}s, extDevEvent is null", __func__);
         return;
@@ -136,8 +357,9 @@ void ExtDevReportSysEvent::ParseToExtDevEvent(const std::shared_ptr<DriverInfo>
                 std::static_pointer_cast<UsbDriverInfo>(driverInfo->GetInfoExt());
             std::vector<uint16_t> productIds = usbDriverInfo->GetProductIds();
             std::vector<uint16_t> vendorIds = usbDriverInfo->GetVendorIds();
-            eventObj->vids = ParseIdVector(vendorIds);
-            eventObj->pids = ParseIdVector(productIds);
+            // formatted by the writer thread
+            eventObj->vidList = std::move(vendorIds);
+            eventObj->pidList = std::move(productIds);
             eventObj->driverUid = driverInfo->GetDriverUid();
             eventObj->userId = driverInfo->GetUserId();
             eventObj->driverName = driverInfo->GetDriverName();
@@ -157,22 +379,15 @@ void ExtDevReportSysEvent::ParseToExtDevEvent(const std::shared_ptr<DeviceInfo>
     ExtDevReportSysEvent::ParseToExtDevEvent(driverInfo, eventObj);
 }
 
-std::string ExtDevReportSysEvent::ParseIdVector(std::vector<uint16_t> ids)
+std::string ExtDevReportSysEvent::ParseIdVector(const std::vector<uint16_t> &ids)
 {
-    if (ids.size() < 1) {
-        return "";
-    }
-    std::string str = "";
-    auto it = ids.begin();
-    for (uint16_t id : ids) {
-        if (it + 1 == ids.end()) {
-            std::string copy = std::to_string(id);
-            str.append(copy);
-        } else {
-            std::string copy = std::to_string(id);
-            str.append(copy);
-            str.append(",");
+    std::string str;
+    str.reserve(ids.size() * (MAX_ID_DIGITS + 1));
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (i != 0) {
+            str.push_back(',');
         }
+        str.append(std::to_string(ids[i]));
     }
     return str;
 }
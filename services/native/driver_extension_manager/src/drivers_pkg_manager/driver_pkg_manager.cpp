@@ -111,6 +111,14 @@ bool DriverPkgManager::SubscribeOsAccountSwitch()
     return true;
 }
 
+void DriverPkgManager::StopBundleTasks()
+{
+    if (bundleStateCallback_ == nullptr) {
+        return;
+    }
+    bundleStateCallback_->StopBundleTasks();
+}
+
 shared_ptr<DriverInfo> DriverPkgManager::QueryMatchDriver(shared_ptr<DeviceInfo> devInfo, const std::string &type)
 {
     EDM_LOGI(MODULE_PKG_MGR, "Enter QueryMatchDriver %{public}s", type.c_str());
@@ -191,6 +199,37 @@ int32_t DriverPkgManager::QueryDriverInfo(vector<shared_ptr<DriverInfo>> &driver
     return EDM_OK;
 }
 
+bool DriverPkgManager::GetMatchKeys(const DeviceInfo &devInfo, vector<string> &keys)
+{
+    auto extInstance = BusExtensionCore::GetInstance().GetBusExtensionByType(devInfo.GetBusType());
+    return extInstance != nullptr && extInstance->GetMatchKeys(devInfo, keys);
+}
+
+bool DriverPkgManager::GetMatchKeys(const DriverInfo &driverInfo, vector<string> &keys)
+{
+    auto extInstance = BusExtensionCore::GetInstance().GetBusExtensionByName(driverInfo.GetBusName());
+    return extInstance != nullptr && extInstance->GetMatchKeys(driverInfo, keys);
+}
+
+int32_t DriverPkgManager::QueryPkgState(const std::string &stateKey, std::string &stateValue)
+{
+    int32_t ret = PkgDbHelper::GetInstance()->QueryPkgState(stateKey, stateValue);
+    if (ret != PKG_OK) {
+        EDM_LOGD(MODULE_PKG_MGR, "no state for %{public}s: %{public}d", stateKey.c_str(), ret);
+        return EDM_NOK;
+    }
+    return EDM_OK;
+}
+
+int32_t DriverPkgManager::UpdatePkgState(const std::string &stateKey, const std::string &stateValue)
+{
+    if (PkgDbHelper::GetInstance()->UpdatePkgState(stateKey, stateValue) != PKG_OK) {
+        EDM_LOGE(MODULE_PKG_MGR, "failed to save state for %{public}s", stateKey.c_str());
+        return EDM_NOK;
+    }
+    return EDM_OK;
+}
+
 int32_t DriverPkgManager::RegisterBundleStatusCallback()
 {
     EDM_LOGI(MODULE_PKG_MGR, "RegisterBundleStatusCallback start");
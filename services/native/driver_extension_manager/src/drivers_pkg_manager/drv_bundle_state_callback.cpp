@@ -30,6 +30,9 @@
 #include "hitrace_meter.h"
 #include "bus_extension_core.h"
 #include "accesstoken_kit.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
 #include <unordered_map>
 #include <pthread.h>
 #include <thread>
@@ -52,9 +55,11 @@ const string DRV_INFO_DESC = "description";
 const string DRV_INFO_LAUNCHONBIND = "launchonbind";
 const string DRV_INFO_ALLOW_ACCESSED = "ohos.permission.ACCESS_DDK_ALLOWED";
 
-static constexpr const char *BUNDLE_RESET_TASK_NAME = "DRIVER_INFO_RESET";
 static constexpr const char *BUNDLE_UPDATE_TASK_NAME = "DRIVER_INFO_UPDATE";
 static constexpr const char *GET_DRIVERINFO_TASK_NAME = "GET_DRIVERINFO_ASYNC";
+static constexpr const char *STALE_FINGERPRINT = "stale";
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
 
 std::string DrvBundleStateCallback::GetBundleSize(const std::string &bundleName)
 {
@@ -169,6 +174,121 @@ PkgInfoTable DrvBundleStateCallback::CreatePkgInfoTable(const ExtensionAbilityIn
     return pkgInfo;
 }
 
+BundleTaskQueue::BundleTaskQueue(Handler handler) : handler_(std::move(handler))
+{
+}
+
+BundleTaskQueue::~BundleTaskQueue()
+{
+    Stop();
+}
+
+bool BundleTaskQueue::PostUpdate(const std::string &bundleName)
+{
+    return Post({BundleTask::BUNDLE_UPDATE, bundleName, 0});
+}
+
+bool BundleTaskQueue::PostReset(const int32_t userId)
+{
+    return Post({BundleTask::BUNDLE_RESET, "", userId});
+}
+
+bool BundleTaskQueue::PostReconcile(const int32_t userId)
+{
+    return Post({BundleTask::BUNDLE_RECONCILE, "", userId});
+}
+
+bool BundleTaskQueue::Post(BundleTask &&task)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) {
+        return false;
+    }
+    if (task.type != BundleTask::BUNDLE_UPDATE) {
+        // updates posted after the reset must run after it, so none of them may merge into an earlier one
+        waitingUpdates_.clear();
+    } else if (waitingUpdates_.count(task.bundleName) != 0) {
+        // the waiting update reads the package table when it runs, so it covers this change too
+        coalesced_++;
+        return true;
+    } else {
+        waitingUpdates_[task.bundleName] = nextSeq_;
+    }
+    tasks_.emplace_back(nextSeq_++, std::move(task));
+    if (!thread_.joinable()) {
+        thread_ = std::thread([this]() { Run(); });
+        pthread_setname_np(thread_.native_handle(), BUNDLE_UPDATE_TASK_NAME);
+    }
+    taskCv_.notify_one();
+    return true;
+}
+
+void BundleTaskQueue::Run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        taskCv_.wait(lock, [this]() { return !tasks_.empty() || stopped_; });
+        if (stopped_) {
+            break;
+        }
+        auto [seq, task] = std::move(tasks_.front());
+        tasks_.pop_front();
+        auto iter = waitingUpdates_.find(task.bundleName);
+        if (task.type == BundleTask::BUNDLE_UPDATE && iter != waitingUpdates_.end() && iter->second == seq) {
+            // from now on a new update of the bundle has to run again
+            waitingUpdates_.erase(iter);
+        }
+        busy_ = true;
+        lock.unlock();
+        if (handler_ != nullptr) {
+            handler_(task);
+        }
+        lock.lock();
+        busy_ = false;
+        if (tasks_.empty()) {
+            idleCv_.notify_all();
+        }
+    }
+    busy_ = false;
+    idleCv_.notify_all();
+}
+
+void BundleTaskQueue::Stop()
+{
+    std::thread worker;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopped_) {
+            return;
+        }
+        stopped_ = true;
+        if (!tasks_.empty()) {
+            EDM_LOGI(MODULE_PKG_MGR, "BundleTaskQueue stopped, %{public}zu tasks dropped", tasks_.size());
+        }
+        tasks_.clear();
+        waitingUpdates_.clear();
+        worker = std::move(thread_);
+    }
+    taskCv_.notify_all();
+    if (worker.joinable() && worker.get_id() != std::this_thread::get_id()) {
+        worker.join();
+    } else if (worker.joinable()) {
+        worker.detach();
+    }
+}
+
+void BundleTaskQueue::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCv_.wait(lock, [this]() { return (tasks_.empty() && !busy_) || stopped_; });
+}
+
+uint64_t BundleTaskQueue::GetCoalescedCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return coalesced_;
+}
+
 DrvBundleStateCallback::DrvBundleStateCallback()
 {
     stiching.clear();
@@ -185,7 +305,7 @@ DrvBundleStateCallback::DrvBundleStateCallback(shared_future<int32_t> bmsFuture,
 
 DrvBundleStateCallback::~DrvBundleStateCallback()
 {
-    return;
+    taskQueue_.Stop();
 };
 
 void DrvBundleStateCallback::PrintTest()
@@ -216,9 +336,11 @@ void DrvBundleStateCallback::OnBundleAdded(const std::string &bundleName, const
 {
     EDM_LOGI(MODULE_PKG_MGR, "OnBundleAdded");
     StartTrace(LABEL, "OnBundleAdded");
+    NotifyBundleChanged(bundleName, userId);
     if (!IsCurrentUserId(userId)) {
         return;
     }
+    InvalidateDriverFingerprint();
     std::vector<ExtensionAbilityInfo> driverInfos;
     if (!QueryDriverInfos(bundleName, userId, driverInfos)) {
         auto extDevEvent = std::make_shared<ExtDevEvent>(__func__, DRIVER_PACKAGE_DATA_REFRESH);
@@ -246,9 +368,11 @@ void DrvBundleStateCallback::OnBundleUpdated(const std::string &bundleName, cons
 {
     EDM_LOGI(MODULE_PKG_MGR, "OnBundleUpdated");
     StartTrace(LABEL, "OnBundleUpdated");
+    NotifyBundleChanged(bundleName, userId);
     if (!IsCurrentUserId(userId)) {
         return;
     }
+    InvalidateDriverFingerprint();
     std::vector<ExtensionAbilityInfo> driverInfos;
     if (!QueryDriverInfos(bundleName, userId, driverInfos)) {
         auto extDevEvent = std::make_shared<ExtDevEvent>(__func__, DRIVER_PACKAGE_DATA_REFRESH);
@@ -282,13 +406,23 @@ void DrvBundleStateCallback::OnBundleRemoved(const std::string &bundleName, cons
 {
     EDM_LOGI(MODULE_PKG_MGR, "OnBundleRemoved");
     StartTrace(LABEL, "OnBundleRemoved");
+    NotifyBundleChanged(bundleName, userId);
     if (!IsCurrentUserId(userId)) {
         return;
     }
+    InvalidateDriverFingerprint();
     OnBundleDrvRemoved(bundleName, __func__);
     FinishTrace(LABEL);
 }
 
+void DrvBundleStateCallback::NotifyBundleChanged(const std::string &bundleName, const int userId)
+{
+    // synchronous, so that no bind after this hook can see what the bundle was before the change
+    if (bundleUpdateCallback_ != nullptr) {
+        bundleUpdateCallback_->OnBundleChanged(bundleName, userId);
+    }
+}
+
 sptr<IRemoteObject> DrvBundleStateCallback::AsObject()
 {
     return nullptr;
@@ -306,11 +440,71 @@ void DrvBundleStateCallback::ResetMatchedBundles(const int32_t userId)
         EDM_LOGE(MODULE_PKG_MGR, "DrvBundleStateCallback::ResetMatchedBundles bundleUpdateCallback_ is null");
         return;
     }
-    std::thread taskThread([userId, this]() {
-        bundleUpdateCallback_->OnBundlesReseted(userId);
-    });
-    pthread_setname_np(taskThread.native_handle(), BUNDLE_RESET_TASK_NAME);
-    taskThread.detach();
+    if (!taskQueue_.PostReset(userId)) {
+        EDM_LOGE(MODULE_PKG_MGR, "DrvBundleStateCallback::ResetMatchedBundles task queue is stopped");
+    }
+}
+
+void DrvBundleStateCallback::StopBundleTasks()
+{
+    taskQueue_.Stop();
+}
+
+void DrvBundleStateCallback::PostBundleUpdate(const std::string &bundleName)
+{
+    if (bundleUpdateCallback_ == nullptr) {
+        return;
+    }
+    if (!taskQueue_.PostUpdate(bundleName)) {
+        EDM_LOGE(MODULE_PKG_MGR, "PostBundleUpdate task queue is stopped, bundleName:%{public}s", bundleName.c_str());
+    }
+}
+
+void DrvBundleStateCallback::RunBundleTask(const BundleTask &task)
+{
+    if (task.type == BundleTask::BUNDLE_RECONCILE) {
+        if (bmsFuture_.valid()) {
+            bmsFuture_.wait();
+        }
+        if (!ReconcileDriverInfos(task.userId)) {
+            EDM_LOGE(MODULE_PKG_MGR, "ReconcileDriverInfos failed");
+        }
+        return;
+    }
+    if (bundleUpdateCallback_ == nullptr) {
+        EDM_LOGE(MODULE_PKG_MGR, "RunBundleTask bundleUpdateCallback_ is nullptr");
+        return;
+    }
+    if (task.type == BundleTask::BUNDLE_RESET) {
+        bundleUpdateCallback_->OnBundlesReseted(task.userId);
+        return;
+    }
+    // read when the task runs rather than when it is posted, so a coalesced update carries the latest rows
+    std::vector<std::shared_ptr<DriverInfo>> drivers;
+    if (!task.bundleName.empty()) {
+        QueryBundleDrivers(task.bundleName, drivers);
+    }
+    bundleUpdateCallback_->OnBundlesUpdated(task.bundleName, drivers);
+}
+
+void DrvBundleStateCallback::QueryBundleDrivers(const std::string &bundleName,
+    std::vector<std::shared_ptr<DriverInfo>> &drivers)
+{
+    std::vector<PkgInfoTable> pkgInfos;
+    if (PkgDbHelper::GetInstance()->QueryPkgInfos(bundleName, pkgInfos) < 0) {
+        EDM_LOGE(MODULE_PKG_MGR, "QueryBundleDrivers failed, bundleName:%{public}s", bundleName.c_str());
+        return;
+    }
+    for (const auto &pkgInfo : pkgInfos) {
+        auto driverInfo = std::make_shared<DriverInfo>(pkgInfo.bundleName, pkgInfo.driverName, pkgInfo.driverUid,
+            pkgInfo.userId);
+        // kept even if it does not parse, it then has no match keys and the device manager tries every device
+        if (driverInfo->UnSerialize(pkgInfo.driverInfo) != EDM_OK) {
+            EDM_LOGE(MODULE_PKG_MGR, "QueryBundleDrivers UnSerialize failed, driverName:%{public}s",
+                pkgInfo.driverName.c_str());
+        }
+        drivers.push_back(driverInfo);
+    }
 }
 
 bool DrvBundleStateCallback::GetAllDriverInfos()
@@ -321,29 +515,172 @@ bool DrvBundleStateCallback::GetAllDriverInfos()
         return true;
     }
     
-    std::vector<ExtensionAbilityInfo> driverInfos;
     int32_t userId = GetCurrentActiveUserId();
     if (userId == Constants::INVALID_USERID) {
         EDM_LOGI(MODULE_PKG_MGR, "GetCurrentActiveUserId userId is invalid");
         return false;
     }
+    if (HasDriverSnapshot(userId)) {
+        // pkg.db was rebuilt for this user before, bundle changes seen since then are in it as well
+        EDM_LOGI(MODULE_PKG_MGR, "GetAllDriverInfos uses pkg.db, userId:%{public}d", userId);
+        initOnce = true;
+        ReconcileDriverInfosAsync(userId);
+        return true;
+    }
+    uint64_t liveChanges = GetLiveChanges();
+    std::vector<ExtensionAbilityInfo> driverInfos;
+    if (!driverInfosFetcher_(userId, driverInfos)) {
+        return false;
+    }
+    if (!UpdateToRdb(driverInfos, "", __func__)) {
+        EDM_LOGE(MODULE_PKG_MGR, "UpdateToRdb failed");
+        return false;
+    }
+    FingerprintSave saved = SaveDriverFingerprint(GetDriverFingerprint(userId, driverInfos), liveChanges);
+    if (saved == FingerprintSave::RACED) {
+        EDM_LOGI(MODULE_PKG_MGR, "GetAllDriverInfos raced with a bundle change, check again");
+        ReconcileDriverInfosAsync(userId);
+    } else if (saved == FingerprintSave::FAILED) {
+        // the next load rebuilds pkg.db from the bundle manager again
+        EDM_LOGE(MODULE_PKG_MGR, "GetAllDriverInfos save fingerprint failed");
+    }
+    initOnce = true;
+    return true;
+}
+
+bool DrvBundleStateCallback::QueryAllDriverInfos(int32_t userId, std::vector<ExtensionAbilityInfo> &driverInfos)
+{
     EDM_LOGI(MODULE_PKG_MGR, "QueryExtensionAbilityInfos userId:%{public}d", userId);
-    bundleMgrMutex_.lock();
+    std::lock_guard<std::mutex> lock(bundleMgrMutex_);
     if (!GetBundleMgrProxy()) {
         EDM_LOGE(MODULE_PKG_MGR, "%{public}s: failed to GetBundleMgrProxy", __func__);
-        bundleMgrMutex_.unlock();
         return false;
     }
     bundleMgr_->QueryExtensionAbilityInfos(ExtensionAbilityType::DRIVER, userId, driverInfos);
-    bundleMgrMutex_.unlock();
+    return true;
+}
+
+bool DrvBundleStateCallback::HasDriverSnapshot(int32_t userId)
+{
+    std::string fingerprint;
+    if (PkgDbHelper::GetInstance()->QueryPkgState(BMS_FINGERPRINT_KEY, fingerprint) != PKG_OK) {
+        return false;
+    }
+    std::string userPrefix = std::to_string(userId) + ":";
+    return fingerprint.compare(0, userPrefix.size(), userPrefix) == 0;
+}
+
+void DrvBundleStateCallback::ReconcileDriverInfosAsync(int32_t userId)
+{
+    // on the bundle task queue, so the rebuild and the updates it posts stay in order with the other bundle tasks
+    if (!taskQueue_.PostReconcile(userId)) {
+        EDM_LOGE(MODULE_PKG_MGR, "ReconcileDriverInfosAsync task queue is stopped");
+    }
+}
+
+bool DrvBundleStateCallback::ReconcileDriverInfos(int32_t userId)
+{
+    uint64_t liveChanges = GetLiveChanges();
+    std::vector<ExtensionAbilityInfo> driverInfos;
+    if (!driverInfosFetcher_(userId, driverInfos)) {
+        return false;
+    }
+    std::string fingerprint = GetDriverFingerprint(userId, driverInfos);
+    std::string savedFingerprint;
+    std::shared_ptr<PkgDbHelper> helper = PkgDbHelper::GetInstance();
+    if (helper->QueryPkgState(BMS_FINGERPRINT_KEY, savedFingerprint) == PKG_OK && savedFingerprint == fingerprint) {
+        EDM_LOGI(MODULE_PKG_MGR, "ReconcileDriverInfos driver packages unchanged");
+        return true;
+    }
+    // changed while the service was not running, rebuild and match every device again
+    EDM_LOGI(MODULE_PKG_MGR, "ReconcileDriverInfos driver packages changed, userId:%{public}d", userId);
     if (!UpdateToRdb(driverInfos, "", __func__)) {
         EDM_LOGE(MODULE_PKG_MGR, "UpdateToRdb failed");
         return false;
     }
-    initOnce = true;
+    FingerprintSave saved = SaveDriverFingerprint(fingerprint, liveChanges);
+    if (saved == FingerprintSave::RACED) {
+        // a live hook may have been overwritten by the rows read before it, read the bundle manager again
+        EDM_LOGI(MODULE_PKG_MGR, "ReconcileDriverInfos raced with a bundle change, check again");
+        ReconcileDriverInfosAsync(userId);
+    } else if (saved == FingerprintSave::FAILED) {
+        // pkg.db is up to date, only the next load has to rebuild it again
+        EDM_LOGE(MODULE_PKG_MGR, "ReconcileDriverInfos save fingerprint failed");
+    }
     return true;
 }
 
+uint64_t DrvBundleStateCallback::GetLiveChanges()
+{
+    std::lock_guard<std::mutex> lock(fingerprintMutex_);
+    return liveChanges_;
+}
+
+DrvBundleStateCallback::FingerprintSave DrvBundleStateCallback::SaveDriverFingerprint(const std::string &fingerprint,
+    uint64_t liveChanges)
+{
+    std::lock_guard<std::mutex> lock(fingerprintMutex_);
+    if (liveChanges != liveChanges_) {
+        return FingerprintSave::RACED;
+    }
+    if (PkgDbHelper::GetInstance()->UpdatePkgState(BMS_FINGERPRINT_KEY, fingerprint) != PKG_OK) {
+        return FingerprintSave::FAILED;
+    }
+    return FingerprintSave::SAVED;
+}
+
+void DrvBundleStateCallback::InvalidateDriverFingerprint()
+{
+    std::lock_guard<std::mutex> lock(fingerprintMutex_);
+    liveChanges_++;
+    std::shared_ptr<PkgDbHelper> helper = PkgDbHelper::GetInstance();
+    std::string fingerprint;
+    if (helper->QueryPkgState(BMS_FINGERPRINT_KEY, fingerprint) != PKG_OK) {
+        return;
+    }
+    size_t userEnd = fingerprint.find(':');
+    if (userEnd == std::string::npos || fingerprint.compare(userEnd + 1, std::string::npos, STALE_FINGERPRINT) == 0) {
+        return;
+    }
+    // pkg.db still holds this user's drivers and is used at the next load, but the check then has to rebuild it
+    if (helper->UpdatePkgState(BMS_FINGERPRINT_KEY, fingerprint.substr(0, userEnd + 1) + STALE_FINGERPRINT) !=
+        PKG_OK) {
+        EDM_LOGE(MODULE_PKG_MGR, "InvalidateDriverFingerprint failed");
+    }
+}
+
+std::string DrvBundleStateCallback::GetDriverFingerprint(int32_t userId,
+    const std::vector<ExtensionAbilityInfo> &driverInfos)
+{
+    // what ParseToPkgInfoTables and CreatePkgInfoTable read, in an order that does not depend on the bundle manager
+    std::vector<std::string> entries;
+    for (const auto &driverInfo : driverInfos) {
+        if (driverInfo.type != ExtensionAbilityType::DRIVER) {
+            continue;
+        }
+        std::string entry = driverInfo.bundleName + "\n" + driverInfo.name + "\n" +
+            std::to_string(driverInfo.applicationInfo.accessTokenId) + "\n" + driverInfo.applicationInfo.versionName +
+            "\n" + std::to_string(driverInfo.applicationInfo.versionCode);
+        for (const auto &meta : driverInfo.metadata) {
+            entry.append("\n").append(meta.name).append("=").append(meta.value);
+        }
+        entries.push_back(std::move(entry));
+    }
+    std::sort(entries.begin(), entries.end());
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (const auto &entry : entries) {
+        // the terminating zero separates the entries
+        for (size_t i = 0; i <= entry.size(); i++) {
+            hash ^= static_cast<uint8_t>(entry.c_str()[i]);
+            hash *= FNV_PRIME;
+        }
+    }
+    std::ostringstream fingerprint;
+    fingerprint << userId << ":" << entries.size() << ":" << std::hex << std::setw(sizeof(hash) * 2) <<
+        std::setfill('0') << hash;
+    return fingerprint.str();
+}
+
 void DrvBundleStateCallback::GetAllDriverInfosAsync()
 {
     EDM_LOGI(MODULE_PKG_MGR, "GetAllDriverInfosAsync enter");
@@ -466,17 +803,7 @@ bool DrvBundleStateCallback::UpdateToRdb(const std::vector<ExtensionAbilityInfo>
     }
     ReportPkgsEvent(driverObjs, interfaceName, ExtDevReportSysEvent::EventErrCode::SUCCESS);
 
-    if (bundleUpdateCallback_ != nullptr) {
-        std::thread taskThread([bundleName, this]() {
-            if (bundleUpdateCallback_ == nullptr) {
-                EDM_LOGE(MODULE_PKG_MGR, "UpdateToRdb bundleUpdateCallback_ is nullptr");
-                return;
-            }
-            bundleUpdateCallback_->OnBundlesUpdated(bundleName);
-        });
-        pthread_setname_np(taskThread.native_handle(), BUNDLE_UPDATE_TASK_NAME);
-        taskThread.detach();
-    }
+    PostBundleUpdate(bundleName);
     return true;
 }
 
@@ -540,17 +867,7 @@ void DrvBundleStateCallback::OnBundleDrvRemoved(const std::string &bundleName, c
         return;
     }
     ReportPkgsDelEvent(pkgInfos, interfaceName, ExtDevReportSysEvent::EventErrCode::SUCCESS);
-    if (bundleUpdateCallback_ != nullptr) {
-        std::thread taskThread([bundleName, this]() {
-            if (bundleUpdateCallback_ == nullptr) {
-                EDM_LOGE(MODULE_PKG_MGR, "OnBundleDrvRemoved bundleUpdateCallback_ is nullptr");
-                return;
-            }
-            bundleUpdateCallback_->OnBundlesUpdated(bundleName);
-        });
-        pthread_setname_np(taskThread.native_handle(), BUNDLE_UPDATE_TASK_NAME);
-        taskThread.detach();
-    }
+    PostBundleUpdate(bundleName);
 }
 
 void DrvBundleStateCallback::ResetBundleMgr()
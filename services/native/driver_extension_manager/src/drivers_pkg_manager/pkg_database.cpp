@@ -31,7 +31,7 @@ bool PkgDataBase::InitDB()
     OHOS::NativeRdb::RdbStoreConfig config(rightDatabaseName);
     config.SetSecurityLevel(NativeRdb::SecurityLevel::S1);
     PkgDataBaseCallBack sqliteOpenHelperCallback;
-    store_ = OHOS::NativeRdb::RdbHelper::GetRdbStore(config, DATABASE_OPEN_VERSION, sqliteOpenHelperCallback, errCode);
+    store_ = OHOS::NativeRdb::RdbHelper::GetRdbStore(config, DATABASE_NEW_VERSION, sqliteOpenHelperCallback, errCode);
     if (errCode != OHOS::NativeRdb::E_OK) {
         EDM_LOGE(MODULE_PKG_MGR, "GetRdbStore errCode :%{public}d", errCode);
         return false;
@@ -109,6 +109,21 @@ int64_t PkgDataBase::Insert(const OHOS::NativeRdb::ValuesBucket &insertValues)
     return outRowId;
 }
 
+int64_t PkgDataBase::Replace(const std::string &tableName, const OHOS::NativeRdb::ValuesBucket &values)
+{
+    if (store_ == nullptr) {
+        EDM_LOGE(MODULE_PKG_MGR, "Replace store_ is nullptr");
+        return PKG_RDB_NO_INIT;
+    }
+    int64_t outRowId = 0;
+    int32_t ret = store_->Replace(outRowId, tableName, values);
+    if (ret != OHOS::NativeRdb::E_OK) {
+        EDM_LOGE(MODULE_PKG_MGR, "Replace ret :%{public}d", ret);
+        return PKG_RDB_EXECUTE_FAILTURE;
+    }
+    return outRowId;
+}
+
 int32_t PkgDataBase::Update(
     int32_t &changedRows, const OHOS::NativeRdb::ValuesBucket &values, const OHOS::NativeRdb::RdbPredicates &predicates)
 {
@@ -172,16 +187,27 @@ int32_t PkgDataBaseCallBack::OnCreate(OHOS::NativeRdb::RdbStore &store)
         EDM_LOGE(MODULE_PKG_MGR, "OnCreate failed: %{public}d", ret);
         return PKG_RDB_EXECUTE_FAILTURE;
     }
+    sql = CREATE_PKG_STATE_TABLE;
+    ret = store.ExecuteSql(sql);
+    if (ret != OHOS::NativeRdb::E_OK) {
+        EDM_LOGE(MODULE_PKG_MGR, "OnCreate state table failed: %{public}d", ret);
+        return PKG_RDB_EXECUTE_FAILTURE;
+    }
     EDM_LOGI(MODULE_PKG_MGR, "DB OnCreate Done: %{public}d", ret);
     return PKG_OK;
 }
 
 int32_t PkgDataBaseCallBack::OnUpgrade(OHOS::NativeRdb::RdbStore &store, int32_t oldVersion, int32_t newVersion)
 {
-    EDM_LOGI(MODULE_PKG_MGR, "DB OnUpgrade Enter");
-    (void)store;
-    (void)oldVersion;
-    (void)newVersion;
+    EDM_LOGI(MODULE_PKG_MGR, "DB OnUpgrade Enter, %{public}d -> %{public}d", oldVersion, newVersion);
+    if (oldVersion < DATABASE_NEW_VERSION) {
+        std::string sql = CREATE_PKG_STATE_TABLE;
+        int32_t ret = store.ExecuteSql(sql);
+        if (ret != OHOS::NativeRdb::E_OK) {
+            EDM_LOGE(MODULE_PKG_MGR, "OnUpgrade state table failed: %{public}d", ret);
+            return PKG_RDB_EXECUTE_FAILTURE;
+        }
+    }
     return PKG_OK;
 }
 
@@ -15,6 +15,7 @@
 
 #include "pkg_db_helper.h"
 #include "bundle_installer_interface.h"
+#include "edm_trace.h"
 #include "hilog_wrapper.h"
 #include "pkg_database.h"
 
@@ -125,6 +126,39 @@ int32_t PkgDbHelper::AddOrUpdatePkgInfo(const std::vector<PkgInfoTable> &pkgInfo
     return ret;
 }
 
+int32_t PkgDbHelper::QueryPkgState(const std::string &stateKey, std::string &stateValue)
+{
+    std::lock_guard<std::mutex> guard(databaseMutex_);
+    std::vector<std::string> columns = {"stateValue"};
+    RdbPredicates rdbPredicates(PKG_STATE_TABLE_NAME);
+    rdbPredicates.EqualTo("stateKey", stateKey);
+    std::vector<std::string> stateValues;
+    int32_t ret = QueryAndGetResultColumnValues(rdbPredicates, columns, "stateValue", stateValues);
+    if (ret < PKG_OK) {
+        EDM_LOGE(MODULE_PKG_MGR, "QueryPkgState error: %{public}d", ret);
+        return ret;
+    }
+    if (stateValues.empty()) {
+        return PKG_RDB_EMPTY;
+    }
+    stateValue = stateValues.front();
+    return PKG_OK;
+}
+
+int32_t PkgDbHelper::UpdatePkgState(const std::string &stateKey, const std::string &stateValue)
+{
+    std::lock_guard<std::mutex> guard(databaseMutex_);
+    ValuesBucket values;
+    values.PutString("stateKey", stateKey);
+    values.PutString("stateValue", stateValue);
+    int64_t ret = rightDatabase_->Replace(PKG_STATE_TABLE_NAME, values);
+    if (ret < PKG_OK) {
+        EDM_LOGE(MODULE_PKG_MGR, "UpdatePkgState error: %{public}" PRId64 "", ret);
+        return static_cast<int32_t>(ret);
+    }
+    return PKG_OK;
+}
+
 int32_t PkgDbHelper::AddOrUpdateRightRecord(
     const std::string & bundleName, const std::string & bundleAbility, const std::string &driverInfo)
 {
@@ -267,6 +301,7 @@ static bool ParseToPkgInfos(const std::shared_ptr<ResultSet> &resultSet, std::ve
 int32_t PkgDbHelper::QueryPkgInfos(const std::string &whereKey, const std::string &whereValue,
     std::vector<PkgInfoTable> &pkgInfos)
 {
+    EdmTraceScope trace(TRACE_PKG_DB_QUERY);
     std::lock_guard<std::mutex> guard(databaseMutex_);
     std::vector<std::string> columns = { "driverUid", "userId", "bundleName", "driverName", "driverInfo" };
     RdbPredicates rdbPredicates(PKG_TABLE_NAME);
@@ -320,6 +355,7 @@ int32_t PkgDbHelper::QueryAllSize(std::vector<std::string> &allBundleAbility)
 int32_t PkgDbHelper::QueryAndGetResultColumnValues(const RdbPredicates &rdbPredicates,
     const std::vector<std::string> &columns, const std::string &columnName, std::vector<std::string> &columnValues)
 {
+    EdmTraceScope trace(TRACE_PKG_DB_QUERY);
     int32_t ret = rightDatabase_->BeginTransaction();
     if (ret < PKG_OK) {
         EDM_LOGE(MODULE_PKG_MGR, "BeginTransaction error: %{public}d", ret);
@@ -14,18 +14,211 @@
  */
 #include "ext_permission_manager.h"
 
+#include <map>
 #include <sstream>
 
 #include "accesstoken_kit.h"
 #include "cJSON.h"
 #include "hilog_wrapper.h"
 #include "ipc_skeleton.h"
+#include "perm_state_change_callback_customize.h"
 #include "tokenid_kit.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
 using namespace OHOS::Security::AccessToken;
 
+namespace {
+// callers that never die keep their slot, the ttl still bounds how stale their entries get
+constexpr size_t MAX_WATCHED_CALLERS = 256;
+
+class PermStateChangeCallback : public PermStateChangeCallbackCustomize {
+public:
+    explicit PermStateChangeCallback(const PermStateChangeScope &scope) : PermStateChangeCallbackCustomize(scope) {}
+    void OnChange(const PermStateChangeInfo &result) override;
+};
+
+class CallerDeathRecipient : public IRemoteObject::DeathRecipient {
+public:
+    explicit CallerDeathRecipient(uint32_t tokenId) : tokenId_(tokenId) {}
+    void OnRemoteDied(const wptr<IRemoteObject> &remote) override;
+
+private:
+    uint32_t tokenId_;
+};
+
+// orders watched callers by object, the raw pointer overloads let a dying remote be found without a new reference
+struct RemoteLess {
+    using is_transparent = void;
+    bool operator()(const sptr<IRemoteObject> &lhs, const sptr<IRemoteObject> &rhs) const
+    {
+        return lhs.GetRefPtr() < rhs.GetRefPtr();
+    }
+    bool operator()(const sptr<IRemoteObject> &lhs, const IRemoteObject *rhs) const
+    {
+        return lhs.GetRefPtr() < rhs;
+    }
+    bool operator()(const IRemoteObject *lhs, const sptr<IRemoteObject> &rhs) const
+    {
+        return lhs < rhs.GetRefPtr();
+    }
+};
+
+// the key holds the remote, so its address cannot be reused by another caller while it is watched
+using WatchedCallers = std::map<sptr<IRemoteObject>, sptr<IRemoteObject::DeathRecipient>, RemoteLess>;
+
+struct PermissionCacheState {
+    ExtPermissionCache cache;
+    std::mutex mutex;
+    bool enabled = false;
+    std::unordered_set<std::string> permissions;
+    std::shared_ptr<PermStateChangeCallback> permStateCallback;
+    WatchedCallers watchedCallers;
+};
+
+PermissionCacheState &GetCacheState()
+{
+    static PermissionCacheState state;
+    return state;
+}
+
+bool IsCacheable(const std::string &permissionName)
+{
+    PermissionCacheState &state = GetCacheState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    return state.enabled && state.permissions.count(permissionName) != 0;
+}
+
+void PermStateChangeCallback::OnChange(const PermStateChangeInfo &result)
+{
+    EDM_LOGI(MODULE_DEV_MGR, "permission state changed, type: %{public}d", result.permStateChangeType);
+    GetCacheState().cache.Invalidate(result.tokenID);
+}
+
+void CallerDeathRecipient::OnRemoteDied(const wptr<IRemoteObject> &remote)
+{
+    PermissionCacheState &state = GetCacheState();
+    state.cache.Invalidate(tokenId_);
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto iter = state.watchedCallers.find(remote.GetRefPtr());
+    if (iter != state.watchedCallers.end()) {
+        state.watchedCallers.erase(iter);
+    }
+}
+
+void RemoveDeathRecipients(const WatchedCallers &callers)
+{
+    for (const auto &[remote, recipient] : callers) {
+        remote->RemoveDeathRecipient(recipient);
+    }
+}
+} // namespace
+
+ExtPermissionCache::ExtPermissionCache(size_t maxTokens, std::chrono::milliseconds ttl)
+    : maxTokens_(maxTokens), ttl_(ttl)
+{
+}
+
+uint64_t ExtPermissionCache::GetEpoch()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return epoch_;
+}
+
+bool ExtPermissionCache::GetGrant(uint32_t tokenId, const std::string &permissionName, bool &granted)
+{
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto token = tokens_.find(tokenId);
+    if (token == tokens_.end()) {
+        return false;
+    }
+    auto grant = token->second.grants.find(permissionName);
+    if (grant == token->second.grants.end() || grant->second.first <= now) {
+        return false;
+    }
+    token->second.lastUse = now;
+    granted = grant->second.second;
+    return true;
+}
+
+void ExtPermissionCache::PutGrant(uint32_t tokenId, const std::string &permissionName, bool granted, uint64_t epoch)
+{
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (epoch != epoch_) {
+        return;
+    }
+    AcquireEntry(tokenId, now).grants[permissionName] = { now + ttl_, granted };
+}
+
+bool ExtPermissionCache::GetValues(uint32_t tokenId, const std::string &permissionName,
+    std::unordered_set<std::string> &permissionValues)
+{
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto token = tokens_.find(tokenId);
+    if (token == tokens_.end()) {
+        return false;
+    }
+    auto values = token->second.values.find(permissionName);
+    if (values == token->second.values.end() || values->second.first <= now) {
+        return false;
+    }
+    token->second.lastUse = now;
+    permissionValues.insert(values->second.second.begin(), values->second.second.end());
+    return true;
+}
+
+void ExtPermissionCache::PutValues(uint32_t tokenId, const std::string &permissionName,
+    const std::unordered_set<std::string> &permissionValues, uint64_t epoch)
+{
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (epoch != epoch_) {
+        return;
+    }
+    AcquireEntry(tokenId, now).values[permissionName] = { now + ttl_, permissionValues };
+}
+
+void ExtPermissionCache::Invalidate(uint32_t tokenId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    epoch_++;
+    tokens_.erase(tokenId);
+}
+
+void ExtPermissionCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    epoch_++;
+    tokens_.clear();
+}
+
+size_t ExtPermissionCache::Size()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tokens_.size();
+}
+
+ExtPermissionCache::TokenEntry &ExtPermissionCache::AcquireEntry(uint32_t tokenId, Clock::time_point now)
+{
+    auto token = tokens_.find(tokenId);
+    if (token == tokens_.end() && maxTokens_ > 0 && tokens_.size() >= maxTokens_) {
+        // few tokens call this service, a linear scan for the least recently used one is cheap enough
+        auto victim = tokens_.begin();
+        for (auto it = tokens_.begin(); it != tokens_.end(); ++it) {
+            if (it->second.lastUse < victim->second.lastUse) {
+                victim = it;
+            }
+        }
+        tokens_.erase(victim);
+    }
+    TokenEntry &entry = tokens_[tokenId];
+    entry.lastUse = now;
+    return entry;
+}
+
 static std::string Trim(const std::string& str)
 {
     if (str.empty()) {
@@ -43,12 +236,22 @@ static std::string Trim(const std::string& str)
 bool ExtPermissionManager::VerifyPermission(std::string permissionName)
 {
     AccessTokenID callerToken = IPCSkeleton::GetCallingTokenID();
+    bool cacheable = IsCacheable(permissionName);
+    ExtPermissionCache &cache = GetCacheState().cache;
+    bool granted = false;
+    if (cacheable && cache.GetGrant(callerToken, permissionName, granted)) {
+        return granted;
+    }
+    uint64_t epoch = cacheable ? cache.GetEpoch() : 0;
     int result = AccessTokenKit::VerifyAccessToken(callerToken, permissionName);
-    if (result == PERMISSION_GRANTED) {
+    granted = (result == PERMISSION_GRANTED);
+    if (cacheable) {
+        cache.PutGrant(callerToken, permissionName, granted, epoch);
+    }
+    if (granted) {
         EDM_LOGI(MODULE_DEV_MGR, "%{public}s VerifyAccessToken: %{public}d", __func__, result);
-        return true;
     }
-    return false;
+    return granted;
 }
 
 bool ExtPermissionManager::IsSystemApp()
@@ -79,6 +282,12 @@ bool ExtPermissionManager::GetPermissionValues(const std::string &permissionName
 {
     std::string appIds;
     AccessTokenID callerToken = IPCSkeleton::GetCallingTokenID();
+    bool cacheable = IsCacheable(permissionName);
+    ExtPermissionCache &cache = GetCacheState().cache;
+    if (cacheable && cache.GetValues(callerToken, permissionName, permissionValues)) {
+        return !permissionValues.empty();
+    }
+    uint64_t epoch = cacheable ? cache.GetEpoch() : 0;
     int32_t ret = AccessTokenKit::GetReqPermissionByName(callerToken, permissionName, appIds);
     if (ret != 0 || appIds.empty()) {
         EDM_LOGE(MODULE_DEV_MGR, "%{public}s GetReqPermissionByName: %{public}d", __func__, ret);
@@ -103,7 +312,93 @@ bool ExtPermissionManager::GetPermissionValues(const std::string &permissionName
         permissionValues.insert(Trim(appId));
     }
     cJSON_Delete(jsonObj);
+    if (cacheable) {
+        cache.PutValues(callerToken, permissionName, permissionValues, epoch);
+    }
     return !permissionValues.empty();
 }
+
+bool ExtPermissionManager::EnableCache(const std::vector<std::string> &permissions)
+{
+    PermissionCacheState &state = GetCacheState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.enabled) {
+        return true;
+    }
+    PermStateChangeScope scope;
+    scope.permList = permissions;
+    auto callback = std::make_shared<PermStateChangeCallback>(scope);
+    int32_t ret = AccessTokenKit::RegisterPermStateChangeCallback(callback);
+    if (ret != 0) {
+        // without change notifications a revoked permission would stay granted until the ttl expires
+        EDM_LOGE(MODULE_DEV_MGR, "%{public}s RegisterPermStateChangeCallback: %{public}d", __func__, ret);
+        return false;
+    }
+    state.permStateCallback = callback;
+    state.permissions = std::unordered_set<std::string>(permissions.begin(), permissions.end());
+    state.cache.Clear();
+    state.enabled = true;
+    return true;
+}
+
+void ExtPermissionManager::DisableCache()
+{
+    PermissionCacheState &state = GetCacheState();
+    WatchedCallers callers;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!state.enabled) {
+            return;
+        }
+        int32_t ret = AccessTokenKit::UnRegisterPermStateChangeCallback(state.permStateCallback);
+        if (ret != 0) {
+            EDM_LOGW(MODULE_DEV_MGR, "%{public}s UnRegisterPermStateChangeCallback: %{public}d", __func__, ret);
+        }
+        state.permStateCallback = nullptr;
+        state.permissions.clear();
+        state.cache.Clear();
+        state.enabled = false;
+        callers.swap(state.watchedCallers);
+    }
+    // outside the lock, a death notification running meanwhile takes it too
+    RemoveDeathRecipients(callers);
+}
+
+void ExtPermissionManager::WatchCaller(const sptr<IRemoteObject> &remote)
+{
+    if (remote == nullptr || !remote->IsProxyObject()) {
+        return;
+    }
+    PermissionCacheState &state = GetCacheState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.enabled || state.watchedCallers.size() >= MAX_WATCHED_CALLERS ||
+        state.watchedCallers.count(remote) != 0) {
+        return;
+    }
+    sptr<IRemoteObject::DeathRecipient> recipient = new (std::nothrow) CallerDeathRecipient(GetCallingTokenID());
+    if (recipient == nullptr || !remote->AddDeathRecipient(recipient)) {
+        EDM_LOGW(MODULE_DEV_MGR, "%{public}s failed to watch the caller", __func__);
+        return;
+    }
+    state.watchedCallers.emplace(remote, recipient);
+}
+
+void ExtPermissionManager::UnwatchCaller(const sptr<IRemoteObject> &remote)
+{
+    if (remote == nullptr) {
+        return;
+    }
+    PermissionCacheState &state = GetCacheState();
+    WatchedCallers callers;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto iter = state.watchedCallers.find(remote);
+        if (iter == state.watchedCallers.end()) {
+            return;
+        }
+        callers.insert(state.watchedCallers.extract(iter));
+    }
+    RemoveDeathRecipients(callers);
+}
 } // namespace ExternalDeviceManager
 } // namespace OHOS
\ No newline at end of file
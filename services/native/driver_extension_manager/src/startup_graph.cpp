@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "startup_graph.h"
+
+#include <algorithm>
+#include <future>
+
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+bool StartupGraph::AddPhase(const std::string &name, const std::vector<std::string> &dependencies, Phase phase)
+{
+    Node node {name, {}, std::move(phase)};
+    for (const auto &dependency : dependencies) {
+        auto it = std::find_if(nodes_.begin(), nodes_.end(), [&dependency](const Node &added) {
+            return added.name == dependency;
+        });
+        if (it == nodes_.end()) {
+            EDM_LOGE(MODULE_SERVICE, "startup phase %{public}s depends on unknown phase %{public}s", name.c_str(),
+                dependency.c_str());
+            return false;
+        }
+        node.dependencies.push_back(static_cast<size_t>(it - nodes_.begin()));
+    }
+    nodes_.push_back(std::move(node));
+    return true;
+}
+
+std::vector<StartupPhaseTiming> StartupGraph::Run()
+{
+    std::vector<StartupPhaseTiming> timings(nodes_.size());
+    std::vector<std::shared_future<void>> done;
+    done.reserve(nodes_.size());
+    Clock::time_point begin = Clock::now();
+    for (size_t i = 0; i < nodes_.size(); i++) {
+        // a phase only waits for phases added before it, whose futures already exist
+        std::vector<std::shared_future<void>> waitFor;
+        for (size_t dependency : nodes_[i].dependencies) {
+            waitFor.push_back(done[dependency]);
+        }
+        done.push_back(std::async(std::launch::async, [this, i, begin, waitFor, &timings]() {
+            for (const auto &dependency : waitFor) {
+                dependency.wait();
+            }
+            Clock::time_point start = Clock::now();
+            if (nodes_[i].phase != nullptr) {
+                nodes_[i].phase();
+            }
+            Clock::time_point end = Clock::now();
+            timings[i] = {nodes_[i].name,
+                std::chrono::duration_cast<std::chrono::microseconds>(start - begin).count(),
+                std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()};
+        }).share());
+    }
+    for (const auto &phase : done) {
+        phase.wait();
+    }
+    return timings;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+// Results are printed as JSON unless a format is given on the command line, so the output of two builds can be
+// compared with tools/compare.py of google benchmark.
+int main(int argc, char **argv)
+{
+    static char jsonFormat[] = "--benchmark_format=json";
+    std::vector<char *> args(argv, argv + argc);
+    bool hasFormat = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--benchmark_format", strlen("--benchmark_format")) == 0) {
+            hasFormat = true;
+        }
+    }
+    if (!hasFormat) {
+        args.push_back(jsonFormat);
+    }
+    int benchArgc = static_cast<int>(args.size());
+    benchmark::Initialize(&benchArgc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(benchArgc, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
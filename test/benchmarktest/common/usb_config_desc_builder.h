@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef USB_CONFIG_DESC_BUILDER_H
+#define USB_CONFIG_DESC_BUILDER_H
+
+#include <cstdint>
+#include <vector>
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+// A raw configuration descriptor as a device reports it: interfaceNum interfaces with altNum settings each, every
+// setting with a class specific descriptor and a bulk in and a bulk out endpoint.
+inline std::vector<uint8_t> MakeUsbConfigDescriptor(uint8_t interfaceNum, uint8_t altNum)
+{
+    constexpr uint8_t configSize = 9;
+    constexpr uint8_t interfaceSize = 9;
+    constexpr uint8_t classSpecificSize = 5;
+    constexpr uint8_t endpointSize = 7;
+    constexpr uint8_t byteBits = 8;
+    constexpr uint16_t maxPacketSize = 512;
+    std::vector<uint8_t> desc = {configSize, 0x02, 0, 0, interfaceNum, 1, 0, 0x80, 50};
+    for (uint8_t interface = 0; interface < interfaceNum; ++interface) {
+        for (uint8_t alt = 0; alt < altNum; ++alt) {
+            desc.insert(desc.end(), {interfaceSize, 0x04, interface, alt, 2, 0xff, 0, 0, 0});
+            desc.insert(desc.end(), {classSpecificSize, 0x24, 0, 0x10, 0x01});
+            for (uint8_t endpoint : {static_cast<uint8_t>(0x81 + interface), static_cast<uint8_t>(0x01 + interface)}) {
+                desc.insert(desc.end(), {endpointSize, 0x05, endpoint, 0x02, maxPacketSize & 0xff,
+                    maxPacketSize >> byteBits, 0});
+            }
+        }
+    }
+    desc[2] = static_cast<uint8_t>(desc.size() & 0xff);
+    desc[3] = static_cast<uint8_t>(desc.size() >> byteBits);
+    return desc;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // USB_CONFIG_DESC_BUILDER_H
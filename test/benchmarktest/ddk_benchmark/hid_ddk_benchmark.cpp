@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "hid_ddk_api.h"
+#include "hid_ddk_types.h"
+#include "v1_1/ihid_ddk.h"
+
+using namespace std;
+using namespace OHOS::HDI::Input::Ddk::V1_1;
+namespace HidV1_0 = OHOS::HDI::Input::Ddk::V1_0;
+
+void SetDdk(OHOS::sptr<IHidDdk> &);
+
+namespace {
+constexpr uint64_t BENCH_DEVICE_ID = 0x100000001;
+constexpr int32_t BENCH_TIMEOUT = 1000;
+
+// A device whose reports are always ready, everything written to it is taken at once.
+// The fake_hdi FakeHidDdk queues every report and keeps the emitted items, the benchmark would time that too.
+class FakeHidDdk : public IHidDdk {
+public:
+    int32_t CreateDevice(const HidV1_0::Hid_Device &hidDevice, const HidV1_0::Hid_EventProperties &hidEventProperties,
+        uint32_t &deviceId) override
+    {
+        deviceId = 0;
+        return HDF_SUCCESS;
+    }
+    int32_t EmitEvent(uint32_t deviceId, const vector<HidV1_0::Hid_EmitItem> &items) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t DestroyDevice(uint32_t deviceId) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Init() override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Release() override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Open(uint64_t deviceId, uint8_t interfaceIndex, HidDeviceHandle &dev) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Close(const HidDeviceHandle &dev) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Write(const HidDeviceHandle &dev, const vector<uint8_t> &data, uint32_t &bytesWritten) override
+    {
+        bytesWritten = static_cast<uint32_t>(data.size());
+        return HDF_SUCCESS;
+    }
+    int32_t ReadTimeout(const HidDeviceHandle &dev, vector<uint8_t> &data, uint32_t buffSize, int32_t timeout,
+        uint32_t &bytesRead) override
+    {
+        bytesRead = static_cast<uint32_t>(data.size());
+        return HDF_SUCCESS;
+    }
+    int32_t SetNonBlocking(const HidDeviceHandle &dev, int32_t nonBlock) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t GetRawInfo(const HidDeviceHandle &dev, HidRawDevInfo &rawDevInfo) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t GetRawName(const HidDeviceHandle &dev, vector<uint8_t> &data, uint32_t buffSize) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t GetPhysicalAddress(const HidDeviceHandle &dev, vector<uint8_t> &data, uint32_t buffSize) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t GetRawUniqueId(const HidDeviceHandle &dev, vector<uint8_t> &data, uint32_t buffSize) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t SendReport(const HidDeviceHandle &dev, HidReportType reportType, const vector<uint8_t> &data) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t GetReport(const HidDeviceHandle &dev, HidReportType reportType, uint8_t reportNumber,
+        vector<uint8_t> &data, uint32_t buffSize) override
+    {
+        data.resize(buffSize);
+        return HDF_SUCCESS;
+    }
+    int32_t GetReportDescriptor(const HidDeviceHandle &dev, vector<uint8_t> &buf, uint32_t buffSize,
+        uint32_t &bytesRead) override
+    {
+        bytesRead = 0;
+        return HDF_SUCCESS;
+    }
+};
+
+class HidDdkFixture : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State &state) override
+    {
+        auto ddk = OHOS::sptr<IHidDdk>(new FakeHidDdk());
+        SetDdk(ddk);
+        ready_ = OH_Hid_Open(BENCH_DEVICE_ID, 0, &dev_) == HID_DDK_SUCCESS;
+    }
+    void TearDown(const benchmark::State &state) override
+    {
+        if (dev_ != nullptr) {
+            (void)OH_Hid_Close(&dev_);
+        }
+        OHOS::sptr<IHidDdk> ddk = nullptr;
+        SetDdk(ddk);
+    }
+
+protected:
+    Hid_DeviceHandle *dev_ = nullptr;
+    bool ready_ = false;
+};
+
+// a key press and its sync, as a virtual keyboard emits it
+BENCHMARK_DEFINE_F(HidDdkFixture, EmitEvent)(benchmark::State &state)
+{
+    Hid_EmitItem items[] = {{HID_EV_KEY, HID_KEY_A, 1}, {HID_EV_SYN, HID_SYN_REPORT, 0}};
+    for (auto _ : state) {
+        if (OH_Hid_EmitEvent(0, items, sizeof(items) / sizeof(items[0])) != HID_DDK_SUCCESS) {
+            state.SkipWithError("OH_Hid_EmitEvent failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * (sizeof(items) / sizeof(items[0])));
+}
+BENCHMARK_REGISTER_F(HidDdkFixture, EmitEvent);
+
+BENCHMARK_DEFINE_F(HidDdkFixture, Write)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("open device failed");
+        return;
+    }
+    vector<uint8_t> data(state.range(0));
+    for (auto _ : state) {
+        uint32_t bytesWritten = 0;
+        if (OH_Hid_Write(dev_, data.data(), static_cast<uint32_t>(data.size()), &bytesWritten) != HID_DDK_SUCCESS) {
+            state.SkipWithError("OH_Hid_Write failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(HidDdkFixture, Write)->ArgName("bytes")->Arg(8)->Arg(64)->Arg(4096);
+
+BENCHMARK_DEFINE_F(HidDdkFixture, ReadTimeout)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("open device failed");
+        return;
+    }
+    vector<uint8_t> data(state.range(0));
+    for (auto _ : state) {
+        uint32_t bytesRead = 0;
+        if (OH_Hid_ReadTimeout(dev_, data.data(), static_cast<uint32_t>(data.size()), BENCH_TIMEOUT, &bytesRead) !=
+            HID_DDK_SUCCESS) {
+            state.SkipWithError("OH_Hid_ReadTimeout failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(HidDdkFixture, ReadTimeout)->ArgName("bytes")->Arg(8)->Arg(64)->Arg(4096);
+
+BENCHMARK_DEFINE_F(HidDdkFixture, SendReport)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("open device failed");
+        return;
+    }
+    vector<uint8_t> data(state.range(0));
+    for (auto _ : state) {
+        if (OH_Hid_SendReport(dev_, HID_OUTPUT_REPORT, data.data(), static_cast<uint32_t>(data.size())) !=
+            HID_DDK_SUCCESS) {
+            state.SkipWithError("OH_Hid_SendReport failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(HidDdkFixture, SendReport)->ArgName("bytes")->Arg(8)->Arg(64)->Arg(4096);
+} // namespace
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/mman.h>
+#include <benchmark/benchmark.h>
+#include "scsi_peripheral_api.h"
+#include "scsi_peripheral_types.h"
+#include "v1_0/iscsi_peripheral_ddk.h"
+
+using namespace OHOS::HDI::Usb::ScsiDdk::V1_0;
+
+void SetDdk(OHOS::sptr<IScsiPeripheralDdk> &);
+
+namespace {
+constexpr uint64_t BENCH_DEVICE_ID = 0x100000001;
+constexpr uint32_t BENCH_BLOCK_SIZE = 512;
+constexpr uint32_t BENCH_MAX_BLOCKS = 2048;
+constexpr uint16_t BENCH_INQUIRY_LENGTH = 96;
+constexpr uint32_t BENCH_TIMEOUT = 1000;
+constexpr uint8_t BENCH_READ10_OPCODE = 0x28;
+constexpr uint8_t BENCH_CDB_LENGTH = 10;
+constexpr int8_t BENCH_DXFER_FROM_DEV = -3; // SG_DXFER_FROM_DEV
+
+// A disk that finishes every command at once, the data buffers are never touched.
+// The disk of fake_hdi copies each block in and out of its store and builds sense data, so it is not used here.
+class FakeScsiPeripheralDdk : public IScsiPeripheralDdk {
+public:
+    int32_t Init() override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Release() override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Open(uint64_t deviceId, uint8_t interfaceIndex, ScsiPeripheralDevice &dev, int &memMapFd) override
+    {
+        dev.devFd = 0;
+        dev.memMapFd = memfd_create("scsi_ddk_benchmark", MFD_CLOEXEC);
+        dev.lbLength = BENCH_BLOCK_SIZE;
+        memMapFd = dev.memMapFd;
+        return memMapFd < 0 ? HDF_FAILURE : HDF_SUCCESS;
+    }
+    int32_t Close(const ScsiPeripheralDevice &dev) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t ReadCapacity10(const ScsiPeripheralDevice &dev, const ScsiPeripheralReadCapacityRequest &request,
+        ScsiPeripheralCapacityInfo &capacityInfo, ScsiPeripheralResponse &response) override
+    {
+        capacityInfo.lbAddress = 0;
+        capacityInfo.lbLength = BENCH_BLOCK_SIZE;
+        return HDF_SUCCESS;
+    }
+    int32_t TestUnitReady(const ScsiPeripheralDevice &dev, const ScsiPeripheralTestUnitReadyRequest &request,
+        ScsiPeripheralResponse &response) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Inquiry(const ScsiPeripheralDevice &dev, const ScsiPeripheralInquiryRequest &request,
+        ScsiPeripheralInquiryInfo &inquiryInfo, ScsiPeripheralResponse &response) override
+    {
+        response.transferredLength = request.allocationLength;
+        return HDF_SUCCESS;
+    }
+    int32_t RequestSense(const ScsiPeripheralDevice &dev, const ScsiPeripheralRequestSenseRequest &request,
+        ScsiPeripheralResponse &response) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Read10(const ScsiPeripheralDevice &dev, const ScsiPeripheralIORequest &request,
+        ScsiPeripheralResponse &response) override
+    {
+        response.transferredLength = static_cast<int32_t>(request.transferLength * BENCH_BLOCK_SIZE);
+        return HDF_SUCCESS;
+    }
+    int32_t Write10(const ScsiPeripheralDevice &dev, const ScsiPeripheralIORequest &request,
+        ScsiPeripheralResponse &response) override
+    {
+        response.transferredLength = static_cast<int32_t>(request.transferLength * BENCH_BLOCK_SIZE);
+        return HDF_SUCCESS;
+    }
+    int32_t Verify10(const ScsiPeripheralDevice &dev, const ScsiPeripheralVerifyRequest &request,
+        ScsiPeripheralResponse &response) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t SendRequestByCDB(const ScsiPeripheralDevice &dev, const ScsiPeripheralRequest &request,
+        ScsiPeripheralResponse &response) override
+    {
+        response.transferredLength = static_cast<int32_t>(request.memMapSize);
+        return HDF_SUCCESS;
+    }
+};
+
+// an opened device with a shared buffer large enough for the biggest transfer
+class ScsiDdkFixture : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State &state) override
+    {
+        auto ddk = OHOS::sptr<IScsiPeripheralDdk>(new FakeScsiPeripheralDdk());
+        SetDdk(ddk);
+        ready_ = OH_ScsiPeripheral_Open(BENCH_DEVICE_ID, 0, &dev_) == SCSIPERIPHERAL_DDK_SUCCESS &&
+            OH_ScsiPeripheral_CreateDeviceMemMap(dev_, BENCH_MAX_BLOCKS * BENCH_BLOCK_SIZE, &devMmap_) ==
+            SCSIPERIPHERAL_DDK_SUCCESS;
+    }
+    void TearDown(const benchmark::State &state) override
+    {
+        if (devMmap_ != nullptr) {
+            (void)OH_ScsiPeripheral_DestroyDeviceMemMap(devMmap_);
+            devMmap_ = nullptr;
+        }
+        if (dev_ != nullptr) {
+            (void)OH_ScsiPeripheral_Close(&dev_);
+        }
+        OHOS::sptr<IScsiPeripheralDdk> ddk = nullptr;
+        SetDdk(ddk);
+    }
+
+protected:
+    ScsiPeripheral_Device *dev_ = nullptr;
+    ScsiPeripheral_DeviceMemMap *devMmap_ = nullptr;
+    bool ready_ = false;
+};
+
+BENCHMARK_DEFINE_F(ScsiDdkFixture, TestUnitReady)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("open device failed");
+        return;
+    }
+    ScsiPeripheral_TestUnitReadyRequest request = {0, BENCH_TIMEOUT};
+    ScsiPeripheral_Response response = {{0}};
+    for (auto _ : state) {
+        if (OH_ScsiPeripheral_TestUnitReady(dev_, &request, &response) != SCSIPERIPHERAL_DDK_SUCCESS) {
+            state.SkipWithError("OH_ScsiPeripheral_TestUnitReady failed");
+            break;
+        }
+    }
+}
+BENCHMARK_REGISTER_F(ScsiDdkFixture, TestUnitReady);
+
+BENCHMARK_DEFINE_F(ScsiDdkFixture, Inquiry)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("open device failed");
+        return;
+    }
+    ScsiPeripheral_InquiryRequest request = {0, BENCH_INQUIRY_LENGTH, 0, 0, BENCH_TIMEOUT};
+    ScsiPeripheral_InquiryInfo inquiryInfo = {0};
+    inquiryInfo.data = devMmap_;
+    ScsiPeripheral_Response response = {{0}};
+    for (auto _ : state) {
+        if (OH_ScsiPeripheral_Inquiry(dev_, &request, &inquiryInfo, &response) != SCSIPERIPHERAL_DDK_SUCCESS) {
+            state.SkipWithError("OH_ScsiPeripheral_Inquiry failed");
+            break;
+        }
+    }
+}
+BENCHMARK_REGISTER_F(ScsiDdkFixture, Inquiry);
+
+BENCHMARK_DEFINE_F(ScsiDdkFixture, Read10)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("open device failed");
+        return;
+    }
+    ScsiPeripheral_IORequest request = {0, static_cast<uint16_t>(state.range(0)), 0, 0, 0, devMmap_, BENCH_TIMEOUT};
+    ScsiPeripheral_Response response = {{0}};
+    for (auto _ : state) {
+        if (OH_ScsiPeripheral_Read10(dev_, &request, &response) != SCSIPERIPHERAL_DDK_SUCCESS) {
+            state.SkipWithError("OH_ScsiPeripheral_Read10 failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0) * BENCH_BLOCK_SIZE);
+}
+BENCHMARK_REGISTER_F(ScsiDdkFixture, Read10)->ArgName("blocks")->Arg(1)->Arg(64)->Arg(BENCH_MAX_BLOCKS);
+
+BENCHMARK_DEFINE_F(ScsiDdkFixture, Write10)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("open device failed");
+        return;
+    }
+    ScsiPeripheral_IORequest request = {0, static_cast<uint16_t>(state.range(0)), 0, 0, 0, devMmap_, BENCH_TIMEOUT};
+    ScsiPeripheral_Response response = {{0}};
+    for (auto _ : state) {
+        if (OH_ScsiPeripheral_Write10(dev_, &request, &response) != SCSIPERIPHERAL_DDK_SUCCESS) {
+            state.SkipWithError("OH_ScsiPeripheral_Write10 failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0) * BENCH_BLOCK_SIZE);
+}
+BENCHMARK_REGISTER_F(ScsiDdkFixture, Write10)->ArgName("blocks")->Arg(1)->Arg(64)->Arg(BENCH_MAX_BLOCKS);
+
+// the command moves the whole shared buffer
+BENCHMARK_DEFINE_F(ScsiDdkFixture, SendRequestByCdb)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("open device failed");
+        return;
+    }
+    ScsiPeripheral_Request request = {
+        {BENCH_READ10_OPCODE}, BENCH_CDB_LENGTH, BENCH_DXFER_FROM_DEV, devMmap_, BENCH_TIMEOUT};
+    ScsiPeripheral_Response response = {{0}};
+    for (auto _ : state) {
+        if (OH_ScsiPeripheral_SendRequestByCdb(dev_, &request, &response) != SCSIPERIPHERAL_DDK_SUCCESS) {
+            state.SkipWithError("OH_ScsiPeripheral_SendRequestByCdb failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(devMmap_->size));
+}
+BENCHMARK_REGISTER_F(ScsiDdkFixture, SendRequestByCdb);
+} // namespace
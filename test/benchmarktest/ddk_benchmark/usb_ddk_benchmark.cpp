@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <sys/mman.h>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "ddk_api.h"
+#include "usb_config_desc_builder.h"
+#include "usb_ddk_api.h"
+#include "usb_ddk_types.h"
+#include "v1_2/iusb_ddk.h"
+
+using namespace std;
+namespace UsbDdkHdi = OHOS::HDI::Usb::Ddk::V1_2;
+
+void SetDdk(OHOS::sptr<UsbDdkHdi::IUsbDdk> &);
+
+namespace {
+constexpr uint64_t BENCH_DEVICE_ID = 0x100000001;
+constexpr uint64_t BENCH_INTERFACE_HANDLE = 1;
+constexpr uint8_t BENCH_INTERFACE_NUM = 4;
+constexpr uint8_t BENCH_ENDPOINT = 0x81;
+constexpr uint32_t BENCH_TIMEOUT = 1000;
+
+// Answers every request at once and moves no data, what is left is the cost of the DDK around the HDI call.
+// Not the FakeUsbDdk of test/unittest/fake_hdi: even without latency it counts each call in a map under a lock
+// and copies transfers through its pipe queues, which would be measured as DDK time.
+class FakeUsbDdk : public UsbDdkHdi::IUsbDdk {
+public:
+    int32_t Init() override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Release() override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t GetDeviceDescriptor(uint64_t deviceId, UsbDdkHdi::UsbDeviceDescriptor &desc) override
+    {
+        desc = {};
+        return HDF_SUCCESS;
+    }
+    int32_t GetConfigDescriptor(uint64_t deviceId, uint8_t configIndex, vector<uint8_t> &configDesc) override
+    {
+        configDesc = configDesc_;
+        return HDF_SUCCESS;
+    }
+    int32_t ClaimInterface(uint64_t deviceId, uint8_t interfaceIndex, uint64_t &interfaceHandle) override
+    {
+        interfaceHandle = BENCH_INTERFACE_HANDLE;
+        return HDF_SUCCESS;
+    }
+    int32_t ReleaseInterface(uint64_t interfaceHandle) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t SelectInterfaceSetting(uint64_t interfaceHandle, uint8_t settingIndex) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t GetCurrentInterfaceSetting(uint64_t interfaceHandle, uint8_t &settingIndex) override
+    {
+        settingIndex = 0;
+        return HDF_SUCCESS;
+    }
+    int32_t SendControlReadRequest(uint64_t interfaceHandle, const UsbDdkHdi::UsbControlRequestSetup &setup,
+        uint32_t timeout, vector<uint8_t> &data) override
+    {
+        data.resize(setup.length);
+        return HDF_SUCCESS;
+    }
+    int32_t SendControlWriteRequest(uint64_t interfaceHandle, const UsbDdkHdi::UsbControlRequestSetup &setup,
+        uint32_t timeout, const vector<uint8_t> &data) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t SendPipeRequest(const UsbDdkHdi::UsbRequestPipe &pipe, uint32_t size, uint32_t offset, uint32_t length,
+        uint32_t &transferedLength) override
+    {
+        transferedLength = length;
+        return HDF_SUCCESS;
+    }
+    int32_t GetDeviceMemMapFd(uint64_t deviceId, int &fd) override
+    {
+        fd = memfd_create("usb_ddk_benchmark", MFD_CLOEXEC);
+        return fd < 0 ? HDF_FAILURE : HDF_SUCCESS;
+    }
+    int32_t SendPipeRequestWithAshmem(const UsbDdkHdi::UsbRequestPipe &pipe, const UsbDdkHdi::UsbAshmem &ashmem,
+        uint32_t &transferredLength) override
+    {
+        transferredLength = ashmem.bufferLength;
+        return HDF_SUCCESS;
+    }
+    int32_t GetDevices(vector<uint64_t> &deviceIds) override
+    {
+        deviceIds = {BENCH_DEVICE_ID};
+        return HDF_SUCCESS;
+    }
+    int32_t UpdateDriverInfo(const UsbDdkHdi::DriverAbilityInfo &driverInfo) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t RemoveDriverInfo(const string &driverUid) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t ControlTransfer(uint64_t deviceId, const UsbDdkHdi::UsbControlRequestSetup &setupPacket, uint32_t timeout,
+        vector<uint8_t> &data, uint32_t &transferredLength) override
+    {
+        transferredLength = static_cast<uint32_t>(data.size());
+        return HDF_SUCCESS;
+    }
+    int32_t GetNonRootHubs(vector<uint64_t> &nonRootHubIds) override
+    {
+        nonRootHubIds.clear();
+        return HDF_SUCCESS;
+    }
+
+private:
+    vector<uint8_t> configDesc_ = OHOS::ExternalDeviceManager::MakeUsbConfigDescriptor(BENCH_INTERFACE_NUM, 1);
+};
+
+class UsbDdkFixture : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State &state) override
+    {
+        auto ddk = OHOS::sptr<UsbDdkHdi::IUsbDdk>(new FakeUsbDdk());
+        SetDdk(ddk);
+    }
+    void TearDown(const benchmark::State &state) override
+    {
+        OHOS::sptr<UsbDdkHdi::IUsbDdk> ddk = nullptr;
+        SetDdk(ddk);
+    }
+};
+
+BENCHMARK_DEFINE_F(UsbDdkFixture, GetConfigDescriptor)(benchmark::State &state)
+{
+    for (auto _ : state) {
+        UsbDdkConfigDescriptor *config = nullptr;
+        if (OH_Usb_GetConfigDescriptor(BENCH_DEVICE_ID, 1, &config) != USB_DDK_SUCCESS) {
+            state.SkipWithError("OH_Usb_GetConfigDescriptor failed");
+            break;
+        }
+        OH_Usb_FreeConfigDescriptor(config);
+    }
+}
+BENCHMARK_REGISTER_F(UsbDdkFixture, GetConfigDescriptor);
+
+BENCHMARK_DEFINE_F(UsbDdkFixture, SendControlReadRequest)(benchmark::State &state)
+{
+    UsbControlRequestSetup setup = {0x80, 0x06, 0x0100, 0, static_cast<uint16_t>(state.range(0))};
+    vector<uint8_t> data(state.range(0));
+    for (auto _ : state) {
+        uint32_t dataLen = static_cast<uint32_t>(data.size());
+        if (OH_Usb_SendControlReadRequest(BENCH_INTERFACE_HANDLE, &setup, BENCH_TIMEOUT, data.data(), &dataLen) !=
+            USB_DDK_SUCCESS) {
+            state.SkipWithError("OH_Usb_SendControlReadRequest failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(UsbDdkFixture, SendControlReadRequest)->ArgName("bytes")->Arg(18)->Arg(255)->Arg(4096);
+
+BENCHMARK_DEFINE_F(UsbDdkFixture, SendControlWriteRequest)(benchmark::State &state)
+{
+    UsbControlRequestSetup setup = {0x21, 0x09, 0x0200, 0, static_cast<uint16_t>(state.range(0))};
+    vector<uint8_t> data(state.range(0));
+    for (auto _ : state) {
+        if (OH_Usb_SendControlWriteRequest(BENCH_INTERFACE_HANDLE, &setup, BENCH_TIMEOUT, data.data(),
+            static_cast<uint32_t>(data.size())) != USB_DDK_SUCCESS) {
+            state.SkipWithError("OH_Usb_SendControlWriteRequest failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(UsbDdkFixture, SendControlWriteRequest)->ArgName("bytes")->Arg(18)->Arg(255)->Arg(4096);
+
+BENCHMARK_DEFINE_F(UsbDdkFixture, ControlTransfer)(benchmark::State &state)
+{
+    UsbControlRequestSetup setup = {0x80, 0x06, 0x0100, 0, static_cast<uint16_t>(state.range(0))};
+    vector<uint8_t> data(state.range(0));
+    for (auto _ : state) {
+        if (OH_Usb_ControlTransfer(BENCH_DEVICE_ID, &setup, data.data(), BENCH_TIMEOUT) < USB_DDK_SUCCESS) {
+            state.SkipWithError("OH_Usb_ControlTransfer failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(UsbDdkFixture, ControlTransfer)->ArgName("bytes")->Arg(18)->Arg(255)->Arg(4096);
+
+BENCHMARK_DEFINE_F(UsbDdkFixture, SendPipeRequest)(benchmark::State &state)
+{
+    UsbDeviceMemMap *devMmap = nullptr;
+    if (OH_Usb_CreateDeviceMemMap(BENCH_DEVICE_ID, state.range(0), &devMmap) != USB_DDK_SUCCESS) {
+        state.SkipWithError("OH_Usb_CreateDeviceMemMap failed");
+        return;
+    }
+    UsbRequestPipe pipe = {BENCH_INTERFACE_HANDLE, BENCH_TIMEOUT, BENCH_ENDPOINT};
+    for (auto _ : state) {
+        if (OH_Usb_SendPipeRequest(&pipe, devMmap) != USB_DDK_SUCCESS) {
+            state.SkipWithError("OH_Usb_SendPipeRequest failed");
+            break;
+        }
+    }
+    OH_Usb_DestroyDeviceMemMap(devMmap);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(UsbDdkFixture, SendPipeRequest)->ArgName("bytes")->Arg(64)->Arg(16384)->Arg(1 << 20);
+
+BENCHMARK_DEFINE_F(UsbDdkFixture, SendPipeRequestWithAshmem)(benchmark::State &state)
+{
+    const uint8_t name[] = "UsbDdkBenchmark";
+    DDK_Ashmem *ashmem = nullptr;
+    if (OH_DDK_CreateAshmem(name, static_cast<uint32_t>(state.range(0)), &ashmem) != DDK_SUCCESS ||
+        OH_DDK_MapAshmem(ashmem, PROT_READ | PROT_WRITE) != DDK_SUCCESS) {
+        (void)OH_DDK_DestroyAshmem(ashmem);
+        state.SkipWithError("create ashmem failed");
+        return;
+    }
+    UsbRequestPipe pipe = {BENCH_INTERFACE_HANDLE, BENCH_TIMEOUT, BENCH_ENDPOINT};
+    for (auto _ : state) {
+        if (OH_Usb_SendPipeRequestWithAshmem(&pipe, ashmem) != USB_DDK_SUCCESS) {
+            state.SkipWithError("OH_Usb_SendPipeRequestWithAshmem failed");
+            break;
+        }
+    }
+    (void)OH_DDK_DestroyAshmem(ashmem);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(UsbDdkFixture, SendPipeRequestWithAshmem)->ArgName("bytes")->Arg(64)->Arg(16384)->Arg(1 << 20);
+} // namespace
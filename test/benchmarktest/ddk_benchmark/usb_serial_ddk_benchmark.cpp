@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "usb_serial_api.h"
+#include "v1_0/iusb_serial_ddk.h"
+
+using namespace std;
+using namespace OHOS::HDI::Usb::UsbSerialDdk::V1_0;
+
+void SetDdk(OHOS::sptr<IUsbSerialDdk> &);
+
+namespace {
+constexpr uint64_t BENCH_DEVICE_ID = 0x100000001;
+
+// A port that always has a full buffer to read and takes every write at once.
+// The fake_hdi port serves reads from a buffer under a lock and waits out read timeouts, not wanted in the times.
+class FakeUsbSerialDdk : public IUsbSerialDdk {
+public:
+    int32_t Init() override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Release() override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Open(uint64_t deviceId, uint64_t interfaceIndex, UsbSerialDeviceHandle &dev) override
+    {
+        dev.fd = 0;
+        return HDF_SUCCESS;
+    }
+    int32_t Close(const UsbSerialDeviceHandle &dev) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Read(const UsbSerialDeviceHandle &dev, uint32_t bufferSize, vector<uint8_t> &buff) override
+    {
+        buff.resize(bufferSize);
+        return HDF_SUCCESS;
+    }
+    int32_t Write(const UsbSerialDeviceHandle &dev, const vector<uint8_t> &buff, uint32_t &bytesWritten) override
+    {
+        bytesWritten = static_cast<uint32_t>(buff.size());
+        return HDF_SUCCESS;
+    }
+    int32_t SetBaudRate(const UsbSerialDeviceHandle &dev, uint32_t baudRate) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t SetParams(const UsbSerialDeviceHandle &dev, const UsbSerialParams &params) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t SetTimeout(const UsbSerialDeviceHandle &dev, int32_t timeout) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t SetFlowControl(const UsbSerialDeviceHandle &dev, UsbSerialFlowControl flowControl) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t Flush(const UsbSerialDeviceHandle &dev) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t FlushInput(const UsbSerialDeviceHandle &dev) override
+    {
+        return HDF_SUCCESS;
+    }
+    int32_t FlushOutput(const UsbSerialDeviceHandle &dev) override
+    {
+        return HDF_SUCCESS;
+    }
+};
+
+class UsbSerialDdkFixture : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State &state) override
+    {
+        auto ddk = OHOS::sptr<IUsbSerialDdk>(new FakeUsbSerialDdk());
+        SetDdk(ddk);
+        ready_ = OH_UsbSerial_Open(BENCH_DEVICE_ID, 0, &dev_) == USB_SERIAL_DDK_SUCCESS;
+    }
+    void TearDown(const benchmark::State &state) override
+    {
+        if (dev_ != nullptr) {
+            (void)OH_UsbSerial_Close(&dev_);
+        }
+        OHOS::sptr<IUsbSerialDdk> ddk = nullptr;
+        SetDdk(ddk);
+    }
+
+protected:
+    UsbSerial_Device *dev_ = nullptr;
+    bool ready_ = false;
+};
+
+BENCHMARK_DEFINE_F(UsbSerialDdkFixture, Read)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("open device failed");
+        return;
+    }
+    vector<uint8_t> buff(state.range(0));
+    for (auto _ : state) {
+        uint32_t bytesRead = 0;
+        if (OH_UsbSerial_Read(dev_, buff.data(), static_cast<uint32_t>(buff.size()), &bytesRead) !=
+            USB_SERIAL_DDK_SUCCESS) {
+            state.SkipWithError("OH_UsbSerial_Read failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(UsbSerialDdkFixture, Read)->ArgName("bytes")->Arg(1)->Arg(64)->Arg(4096);
+
+BENCHMARK_DEFINE_F(UsbSerialDdkFixture, Write)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("open device failed");
+        return;
+    }
+    vector<uint8_t> buff(state.range(0));
+    for (auto _ : state) {
+        uint32_t bytesWritten = 0;
+        if (OH_UsbSerial_Write(dev_, buff.data(), static_cast<uint32_t>(buff.size()), &bytesWritten) !=
+            USB_SERIAL_DDK_SUCCESS) {
+            state.SkipWithError("OH_UsbSerial_Write failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(UsbSerialDdkFixture, Write)->ArgName("bytes")->Arg(1)->Arg(64)->Arg(4096);
+} // namespace
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "edm_errors.h"
+#define private public
+#include "ibus_extension.h"
+#include "usb_driver_info.h"
+#undef private
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+
+// the driverInfo column of pkg.db, as written when a driver package with idNum vids and pids is installed
+static string MakeDriverInfoStr(int64_t idNum, bool withRules)
+{
+    auto usbDriverInfo = make_shared<UsbDriverInfo>();
+    for (int64_t i = 0; i < idNum; ++i) {
+        usbDriverInfo->vids_.push_back(static_cast<uint16_t>(0x1000 + i));
+        usbDriverInfo->pids_.push_back(static_cast<uint16_t>(0x2000 + i));
+    }
+    if (withRules) {
+        (void)usbDriverInfo->SetMatchRules("vid=0x1234,pid=0x0100-0x01ff;ifClass=0x03,ifSubClass=0x01");
+    }
+    DriverInfo driverInfo("benchBundle", "benchDriver");
+    driverInfo.bus_ = "usb";
+    driverInfo.vendor_ = "benchVendor";
+    driverInfo.version_ = "1.0.0";
+    driverInfo.driverSize_ = "1024";
+    driverInfo.description_ = "driver of the driver info benchmark";
+    driverInfo.driverInfoExt_ = usbDriverInfo;
+    string driverInfoStr;
+    (void)driverInfo.Serialize(driverInfoStr);
+    return driverInfoStr;
+}
+
+// runs for every driver of pkg.db each time a device is matched
+static void BM_DriverInfoUnSerialize(benchmark::State &state)
+{
+    string driverInfoStr = MakeDriverInfoStr(state.range(0), state.range(1) != 0);
+    for (auto _ : state) {
+        DriverInfo driverInfo;
+        if (driverInfo.UnSerialize(driverInfoStr) != EDM_OK) {
+            state.SkipWithError("UnSerialize failed");
+            break;
+        }
+        benchmark::DoNotOptimize(driverInfo.driverInfoExt_);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(driverInfoStr.size()));
+}
+BENCHMARK(BM_DriverInfoUnSerialize)->ArgNames({"ids", "rules"})->ArgsProduct({{1, 8, 64}, {0, 1}});
+
+static void BM_DriverInfoSerialize(benchmark::State &state)
+{
+    DriverInfo driverInfo;
+    (void)driverInfo.UnSerialize(MakeDriverInfoStr(state.range(0), false));
+    for (auto _ : state) {
+        string driverInfoStr;
+        (void)driverInfo.Serialize(driverInfoStr);
+        benchmark::DoNotOptimize(driverInfoStr);
+    }
+}
+BENCHMARK(BM_DriverInfoSerialize)->ArgName("ids")->Arg(1)->Arg(8)->Arg(64);
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "edm_errors.h"
+#define private public
+#include "etx_device_mgr.h"
+#include "virtual_bus_extension.h"
+#undef private
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+
+constexpr uint16_t BENCH_VID = 0x5a5a;
+constexpr uint64_t BENCH_DEVICE_ID_BASE = 0x10000;
+
+static shared_ptr<VirtualDeviceInfo> MakeVirtualDevice(uint64_t busDeviceId)
+{
+    auto device = make_shared<VirtualDeviceInfo>(busDeviceId);
+    device->SetVendorId(BENCH_VID);
+    device->SetProductId(1);
+    return device;
+}
+
+// The device manager holds state.range(0) virtual devices which no driver is installed for, so registering a
+// device ends at the match and no driver extension is ever connected.
+class ExtDeviceManagerFixture : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State &state) override
+    {
+        ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+        extMgr.deviceMap_.clear();
+        extMgr.matchKeyIndex_.clear();
+        extMgr.deviceMatchKeys_.clear();
+        extMgr.driverMatcher_ = [](shared_ptr<DeviceInfo>, const std::string &) -> shared_ptr<DriverInfo> {
+            return nullptr;
+        };
+        devices_.clear();
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            devices_.push_back(MakeVirtualDevice(static_cast<uint64_t>(i) + 1));
+            (void)extMgr.RegisterDevice(devices_.back());
+        }
+    }
+
+    void TearDown(const benchmark::State &state) override
+    {
+        ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+        lock_guard<mutex> lock(extMgr.deviceMapMutex_);
+        extMgr.deviceMap_.clear();
+        extMgr.matchKeyIndex_.clear();
+        extMgr.deviceMatchKeys_.clear();
+        extMgr.driverMatcher_ = ExtDeviceManager::QueryMatchDriver;
+        devices_.clear();
+    }
+
+protected:
+    vector<shared_ptr<VirtualDeviceInfo>> devices_;
+};
+
+// a device plugged in and pulled out again, without its driver
+BENCHMARK_DEFINE_F(ExtDeviceManagerFixture, RegisterUnRegister)(benchmark::State &state)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    uint64_t busDeviceId = BENCH_DEVICE_ID_BASE;
+    for (auto _ : state) {
+        auto device = MakeVirtualDevice(busDeviceId++);
+        if (extMgr.RegisterDevice(device) != EDM_OK || extMgr.UnRegisterDevice(device) != EDM_OK) {
+            state.SkipWithError("register or unregister failed");
+            break;
+        }
+    }
+}
+BENCHMARK_REGISTER_F(ExtDeviceManagerFixture, RegisterUnRegister)->ArgName("devices")->Arg(16)->Arg(1024);
+
+// what QueryDevices of the client is served from
+BENCHMARK_DEFINE_F(ExtDeviceManagerFixture, QueryDevice)(benchmark::State &state)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    for (auto _ : state) {
+        auto devices = extMgr.QueryDevice(BusType::BUS_TYPE_VIRTUAL);
+        if (devices.size() != devices_.size()) {
+            state.SkipWithError("unexpected device number");
+            break;
+        }
+        benchmark::DoNotOptimize(devices);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK_REGISTER_F(ExtDeviceManagerFixture, QueryDevice)->ArgName("devices")->Arg(16)->Arg(1024);
+
+// every bind and unbind of a driver looks its device up by id
+BENCHMARK_DEFINE_F(ExtDeviceManagerFixture, QueryDevicesById)(benchmark::State &state)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    uint64_t deviceId = devices_.back()->GetDeviceId();
+    for (auto _ : state) {
+        auto devices = extMgr.QueryDevicesById(deviceId);
+        if (devices.size() != 1) {
+            state.SkipWithError("device not found");
+            break;
+        }
+        benchmark::DoNotOptimize(devices);
+    }
+}
+BENCHMARK_REGISTER_F(ExtDeviceManagerFixture, QueryDevicesById)->ArgName("devices")->Arg(16)->Arg(1024);
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "hilog_wrapper.h"
+#include "pkg_db_helper.h"
+#include "pkg_tables.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+
+constexpr int64_t BENCH_USER_ID = 100;
+static const string BENCH_BUNDLE_NAME = "com.ext.devmgr.benchmark";
+static const string BENCH_DRIVER_INFO = "{\"bus\":\"usb\",\"vendor\":\"benchVendor\",\"version\":\"1.0.0\","
+    "\"ext_info\":\"{\\\"vids\\\":[4096,4097,4098,4099],\\\"pids\\\":[256,257,258,259]}\"}";
+
+// pkg.db holds state.range(0) drivers of the benchmark bundle on top of what is installed on the device
+class PkgDbHelperFixture : public benchmark::Fixture {
+public:
+    void SetUp(const benchmark::State &state) override
+    {
+        helper_ = PkgDbHelper::GetInstance();
+        vector<PkgInfoTable> pkgInfos;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            string driverName = "benchDriver" + to_string(i);
+            PkgInfoTable pkgInfo;
+            pkgInfo.driverUid = BENCH_BUNDLE_NAME + "-" + driverName;
+            pkgInfo.bundleAbility = BENCH_BUNDLE_NAME + "-" + driverName;
+            pkgInfo.userId = BENCH_USER_ID;
+            pkgInfo.appIndex = 0;
+            pkgInfo.bundleName = BENCH_BUNDLE_NAME;
+            pkgInfo.driverName = driverName;
+            pkgInfo.driverInfo = BENCH_DRIVER_INFO;
+            pkgInfos.push_back(pkgInfo);
+        }
+        lastDriverUid_ = pkgInfos.empty() ? "" : pkgInfos.back().driverUid;
+        ready_ = helper_->AddOrUpdatePkgInfo(pkgInfos, BENCH_BUNDLE_NAME) == PKG_OK;
+    }
+
+    void TearDown(const benchmark::State &state) override
+    {
+        (void)helper_->DeleteRightRecord(BENCH_BUNDLE_NAME);
+    }
+
+protected:
+    shared_ptr<PkgDbHelper> helper_;
+    string lastDriverUid_;
+    bool ready_ = false;
+};
+
+// every driver, as matching a new device does
+BENCHMARK_DEFINE_F(PkgDbHelperFixture, QueryPkgInfosAll)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("fill pkg.db failed");
+        return;
+    }
+    for (auto _ : state) {
+        vector<PkgInfoTable> pkgInfos;
+        if (helper_->QueryPkgInfos(pkgInfos) < PKG_OK) {
+            state.SkipWithError("QueryPkgInfos failed");
+            break;
+        }
+        benchmark::DoNotOptimize(pkgInfos);
+    }
+}
+BENCHMARK_REGISTER_F(PkgDbHelperFixture, QueryPkgInfosAll)->ArgName("drivers")->Arg(16)->Arg(256);
+
+// the drivers of one bundle, as a bundle update does
+BENCHMARK_DEFINE_F(PkgDbHelperFixture, QueryPkgInfosByBundle)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("fill pkg.db failed");
+        return;
+    }
+    for (auto _ : state) {
+        vector<PkgInfoTable> pkgInfos;
+        if (helper_->QueryPkgInfos(BENCH_BUNDLE_NAME, pkgInfos) < PKG_OK) {
+            state.SkipWithError("QueryPkgInfos failed");
+            break;
+        }
+        benchmark::DoNotOptimize(pkgInfos);
+    }
+}
+BENCHMARK_REGISTER_F(PkgDbHelperFixture, QueryPkgInfosByBundle)->ArgName("drivers")->Arg(16)->Arg(256);
+
+// one driver, as binding a device to its driver does
+BENCHMARK_DEFINE_F(PkgDbHelperFixture, QueryPkgInfosByDriverUid)(benchmark::State &state)
+{
+    if (!ready_) {
+        state.SkipWithError("fill pkg.db failed");
+        return;
+    }
+    for (auto _ : state) {
+        vector<PkgInfoTable> pkgInfos;
+        if (helper_->QueryPkgInfos(pkgInfos, true, lastDriverUid_) < PKG_OK) {
+            state.SkipWithError("QueryPkgInfos failed");
+            break;
+        }
+        benchmark::DoNotOptimize(pkgInfos);
+    }
+}
+BENCHMARK_REGISTER_F(PkgDbHelperFixture, QueryPkgInfosByDriverUid)->ArgName("drivers")->Arg(16)->Arg(256);
+} // namespace ExternalDeviceManager
+} // namespace OHOS
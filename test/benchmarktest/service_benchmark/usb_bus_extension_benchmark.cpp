@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "edm_errors.h"
+#include "usb_config_desc_builder.h"
+#include "usb_config_desc_parser.h"
+#define private public
+#include "ibus_extension.h"
+#include "usb_bus_extension.h"
+#include "usb_device_info.h"
+#include "usb_driver_info.h"
+#undef private
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+
+constexpr uint16_t BENCH_VID_BASE = 0x1000;
+constexpr uint16_t BENCH_PID = 0x0100;
+constexpr int64_t BENCH_IDS_PER_DRIVER = 4;
+
+// match rules take hex numbers only
+static string ToHex(uint32_t value)
+{
+    char text[8] = {0};
+    (void)snprintf(text, sizeof(text), "0x%04x", value);
+    return text;
+}
+
+// drivers listing BENCH_IDS_PER_DRIVER vids each, or accepting them by a match rule
+static vector<shared_ptr<DriverInfo>> MakeUsbDrivers(int64_t driverNum, bool byRules)
+{
+    vector<shared_ptr<DriverInfo>> drivers;
+    for (int64_t i = 0; i < driverNum; ++i) {
+        auto usbDriverInfo = make_shared<UsbDriverInfo>();
+        uint16_t firstVid = static_cast<uint16_t>(BENCH_VID_BASE + i * BENCH_IDS_PER_DRIVER);
+        if (byRules) {
+            (void)usbDriverInfo->SetMatchRules("vid=" + ToHex(firstVid) + "-" +
+                ToHex(firstVid + BENCH_IDS_PER_DRIVER - 1) + ",pid=" + ToHex(BENCH_PID));
+        } else {
+            for (int64_t j = 0; j < BENCH_IDS_PER_DRIVER; ++j) {
+                usbDriverInfo->vids_.push_back(static_cast<uint16_t>(firstVid + j));
+                usbDriverInfo->pids_.push_back(static_cast<uint16_t>(BENCH_PID + j));
+            }
+        }
+        auto driverInfo = make_shared<DriverInfo>("benchBundle" + to_string(i), "benchDriver");
+        driverInfo->bus_ = "usb";
+        driverInfo->busType_ = BusType::BUS_TYPE_USB;
+        driverInfo->driverInfoExt_ = usbDriverInfo;
+        drivers.push_back(driverInfo);
+    }
+    return drivers;
+}
+
+// Walks the installed drivers the way QueryMatchDriver does for a new device. The device is served by the last
+// driver, or by none, so every driver is looked at.
+static void BM_UsbBusExtensionMatchDriver(benchmark::State &state)
+{
+    int64_t driverNum = state.range(0);
+    bool byRules = state.range(1) != 0;
+    bool hit = state.range(2) != 0;
+    auto drivers = MakeUsbDrivers(driverNum, byRules);
+    UsbDeviceInfo device(0);
+    device.devInfo_.devBusInfo.busType = BusType::BUS_TYPE_USB;
+    device.idVendor_ = hit ? static_cast<uint16_t>(BENCH_VID_BASE + (driverNum - 1) * BENCH_IDS_PER_DRIVER) : 0xffff;
+    device.idProduct_ = BENCH_PID;
+    UsbBusExtension usbBus;
+    for (auto _ : state) {
+        shared_ptr<DriverInfo> matched;
+        for (const auto &driver : drivers) {
+            if (usbBus.MatchDriver(*driver, device)) {
+                matched = driver;
+                break;
+            }
+        }
+        if ((matched != nullptr) != hit) {
+            state.SkipWithError("unexpected match result");
+            break;
+        }
+        benchmark::DoNotOptimize(matched);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * driverNum);
+}
+BENCHMARK(BM_UsbBusExtensionMatchDriver)
+    ->ArgNames({"drivers", "rules", "hit"})
+    ->ArgsProduct({{16, 256}, {0, 1}, {0, 1}});
+
+// every attached device is parsed once by the usb bus and again by each OH_Usb_GetConfigDescriptor
+static void BM_ParseUsbConfigDescriptor(benchmark::State &state)
+{
+    vector<uint8_t> desc = MakeUsbConfigDescriptor(static_cast<uint8_t>(state.range(0)),
+        static_cast<uint8_t>(state.range(1)));
+    for (auto _ : state) {
+        UsbDdkConfigDescriptor *config = nullptr;
+        if (ParseUsbConfigDescriptor(desc, &config) != EDM_OK) {
+            state.SkipWithError("ParseUsbConfigDescriptor failed");
+            break;
+        }
+        FreeUsbConfigDescriptor(config);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(desc.size()));
+}
+BENCHMARK(BM_ParseUsbConfigDescriptor)->ArgNames({"interfaces", "alts"})->ArgsProduct({{1, 4, 16}, {1, 4}});
+} // namespace ExternalDeviceManager
+} // namespace OHOS
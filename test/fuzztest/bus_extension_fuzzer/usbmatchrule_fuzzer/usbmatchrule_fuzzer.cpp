@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "cstdlib"
+#include "iostream"
+#include "string"
+#include "hilog_wrapper.h"
+#define private public
+#include "usb_device_info.h"
+#include "usb_driver_info.h"
+#include "usb_match_rule.h"
+#undef private
+#include "usbmatchrule_fuzzer.h"
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+
+// vid, pid and bcdDevice, the three class bytes of the device and of one interface
+constexpr size_t DEVICE_BYTES = 12;
+
+static uint16_t ReadUint16(const uint8_t *data)
+{
+    return static_cast<uint16_t>((data[0] << 8) | data[1]);
+}
+
+bool CompileAndMatchFuzzer(const uint8_t *data, size_t size)
+{
+    if (size < DEVICE_BYTES) {
+        return false;
+    }
+    UsbDeviceInfo device(0);
+    size_t pos = 0;
+    device.idVendor_ = ReadUint16(data + pos);
+    pos += sizeof(uint16_t);
+    device.idProduct_ = ReadUint16(data + pos);
+    pos += sizeof(uint16_t);
+    device.bcdDevice_ = ReadUint16(data + pos);
+    pos += sizeof(uint16_t);
+    device.deviceClass_ = data[pos++];
+    device.deviceSubClass_ = data[pos++];
+    device.deviceProtocol_ = data[pos++];
+    UsbInterfaceDescriptor desc {};
+    desc.bInterfaceClass = data[pos++];
+    desc.bInterfaceSubClass = data[pos++];
+    desc.bInterfaceProtocol = data[pos++];
+    device.interfaceDescList_.push_back(desc);
+
+    UsbMatchRuleSet rules;
+    if (!rules.Compile(string(reinterpret_cast<const char *>(data + pos), size - pos))) {
+        return false;
+    }
+    rules.Match(device);
+    vector<pair<uint16_t, uint16_t>> pairs;
+    if (rules.GetVidPids(pairs)) {
+        // every device matching a keyed rule set has one of its vid:pid pairs
+        bool unkeyed = rules.Match(device);
+        for (const auto &vidPid : pairs) {
+            unkeyed = unkeyed && !(vidPid.first == device.idVendor_ && vidPid.second == device.idProduct_);
+        }
+        if (unkeyed) {
+            EDM_LOGE(MODULE_BUS_USB, "device %{public}04x:%{public}04x matched without a key", device.idVendor_,
+                device.idProduct_);
+            abort();
+        }
+    }
+    return true;
+}
+
+bool DriverInfoRoundTripFuzzer(const uint8_t *data, size_t size)
+{
+    UsbDriverInfo usbDrvInfo;
+    if (!usbDrvInfo.SetMatchRules(string(reinterpret_cast<const char *>(data), size))) {
+        return false;
+    }
+    string drvInfoStr;
+    if (usbDrvInfo.Serialize(drvInfoStr) != 0) {
+        return false;
+    }
+    UsbDriverInfo newUsbDrvInfo;
+    newUsbDrvInfo.UnSerialize(drvInfoStr);
+    return true;
+}
+
+using TestFuncDef = bool (*)(const uint8_t *data, size_t size);
+
+TestFuncDef g_allTestFunc[] = {
+    CompileAndMatchFuzzer,
+    DriverInfoRoundTripFuzzer,
+};
+
+bool DoSomethingInterestingWithMyAPI(const uint8_t *rawData, size_t size)
+{
+    if (size < sizeof(int)) {
+        return false;
+    }
+    const int index = *(static_cast<const uint8_t *>(rawData));
+    rawData += sizeof(int);
+    size -= sizeof(int);
+    int funcCount = sizeof(g_allTestFunc) / sizeof(g_allTestFunc[0]);
+
+    auto func = g_allTestFunc[index % funcCount];
+    if (func != nullptr) {
+        auto ret = func(rawData, size);
+        return ret;
+    }
+    return false;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    OHOS::ExternalDeviceManager::DoSomethingInterestingWithMyAPI(data, size);
+    return 0;
+}
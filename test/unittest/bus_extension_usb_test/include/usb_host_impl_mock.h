@@ -49,6 +49,8 @@ constexpr int32_t RETVAL_INVALID = -1;
 constexpr int32_t BUS_NUM_ERR = 8;
 constexpr int32_t DEV_ADDR_ERR = 8;
 constexpr int32_t DEV_ADDR_INTERFACE_ERR = 9;
+// an audio, HID and CDC data function behind one address
+constexpr int32_t DEV_ADDR_COMPOSITE = 10;
 
 class UsbHostImplMock : public IUsbHostInterface {
 public:
@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <gtest/gtest.h>
 #include "json/json.h"
 #include "hilog_wrapper.h"
@@ -124,5 +125,82 @@ HWTEST_F(UsbBusExtensionTest, MatchDriverTest, TestSize.Level1)
     isMatched = usbBus->MatchDriver(*drvInfo, *deviceInfo);
     ASSERT_EQ(isMatched, false);
 }
+
+HWTEST_F(UsbBusExtensionTest, GetMatchKeysTest, TestSize.Level1)
+{
+    auto usbDrvInfo = make_shared<UsbDriverInfo>();
+    usbDrvInfo->pids_ = {0x1234, 0x5678};
+    usbDrvInfo->vids_ = {0x1111, 0x2222};
+    auto drvInfo = make_shared<DriverInfo>();
+    drvInfo->bus_ = "USB";
+    drvInfo->driverInfoExt_ = usbDrvInfo;
+    auto usbBus = make_shared<UsbBusExtension>();
+    vector<string> driverKeys;
+    ASSERT_TRUE(usbBus->GetMatchKeys(*drvInfo, driverKeys));
+    ASSERT_EQ(driverKeys.size(), usbDrvInfo->vids_.size() * usbDrvInfo->pids_.size());
+
+    // a device shares a key with the driver exactly when MatchDriver accepts it
+    auto deviceInfo = make_shared<UsbDeviceInfo>(0);
+    for (uint16_t vid : {0x1111, 0x2222, 0x9999}) {
+        for (uint16_t pid : {0x1234, 0x5678, 0x9999}) {
+            deviceInfo->idVendor_ = vid;
+            deviceInfo->idProduct_ = pid;
+            vector<string> deviceKeys;
+            ASSERT_TRUE(usbBus->GetMatchKeys(*deviceInfo, deviceKeys));
+            ASSERT_EQ(deviceKeys.size(), 1U);
+            bool shared = find(driverKeys.begin(), driverKeys.end(), deviceKeys[0]) != driverKeys.end();
+            ASSERT_EQ(shared, usbBus->MatchDriver(*drvInfo, *deviceInfo));
+        }
+    }
+
+    drvInfo->bus_ = "HDMI";
+    driverKeys.clear();
+    ASSERT_FALSE(usbBus->GetMatchKeys(*drvInfo, driverKeys));
+    deviceInfo->devInfo_.devBusInfo.busType = BusType::BUS_TYPE_INVALID;
+    vector<string> deviceKeys;
+    ASSERT_FALSE(usbBus->GetMatchKeys(*deviceInfo, deviceKeys));
+}
+
+HWTEST_F(UsbBusExtensionTest, MatchDriverByRulesTest, TestSize.Level1)
+{
+    auto usbBus = make_shared<UsbBusExtension>();
+    map<string, string> metadata = g_testMetaDatas;
+    metadata["matchRules"] = "vid=0x3333,pid=0x0100-0x0103;ifClass=0x03,ifProtocol=0x02";
+    auto drvInfo = make_shared<DriverInfo>();
+    drvInfo->bus_ = "USB";
+    drvInfo->driverInfoExt_ = usbBus->ParseDriverInfo(metadata);
+    ASSERT_NE(drvInfo->driverInfoExt_, nullptr);
+
+    auto deviceInfo = make_shared<UsbDeviceInfo>(0);
+    deviceInfo->devInfo_.devBusInfo.busType = BusType::BUS_TYPE_USB;
+    deviceInfo->idVendor_ = 0x3333;
+    deviceInfo->idProduct_ = 0x0102;
+    ASSERT_TRUE(usbBus->MatchDriver(*drvInfo, *deviceInfo));
+    deviceInfo->idProduct_ = 0x0104;
+    ASSERT_FALSE(usbBus->MatchDriver(*drvInfo, *deviceInfo));
+    UsbInterfaceDescriptor desc {};
+    desc.bInterfaceClass = 0x03;
+    desc.bInterfaceProtocol = 0x02;
+    deviceInfo->interfaceDescList_.push_back(desc);
+    ASSERT_TRUE(usbBus->MatchDriver(*drvInfo, *deviceInfo));
+    // the vid and pid lists still match on their own
+    deviceInfo->interfaceDescList_.clear();
+    deviceInfo->idVendor_ = 0x1111;
+    deviceInfo->idProduct_ = 0x5678;
+    ASSERT_TRUE(usbBus->MatchDriver(*drvInfo, *deviceInfo));
+
+    // a mouse can have any vid:pid
+    vector<string> driverKeys;
+    ASSERT_FALSE(usbBus->GetMatchKeys(*drvInfo, driverKeys));
+    metadata["matchRules"] = "vid=0x3333,pid=0x0100-0x0103";
+    drvInfo->driverInfoExt_ = usbBus->ParseDriverInfo(metadata);
+    ASSERT_TRUE(usbBus->GetMatchKeys(*drvInfo, driverKeys));
+    ASSERT_EQ(driverKeys.size(), 2U * 2U + 4U);
+
+    metadata["matchRules"] = "vid=0x3333,pid";
+    auto usbDrvInfo = static_pointer_cast<UsbDriverInfo>(usbBus->ParseDriverInfo(metadata));
+    ASSERT_EQ(usbDrvInfo->GetMatchRuleSet(), nullptr);
+    ASSERT_EQ(usbDrvInfo->vids_.size(), 2U);
+}
 }
 }
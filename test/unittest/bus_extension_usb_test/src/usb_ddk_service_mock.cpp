@@ -22,16 +22,26 @@ using namespace OHOS::HDI::Usb::Ddk::V1_2;
 constexpr int32_t DEV_ADDR_INTERFACE_ERR = 9;
 constexpr uint64_t BUS_NUM_OK = 6;
 constexpr int32_t SHIFT_32 = 16;
+constexpr uint64_t DEV_ADDR_COMPOSITE = 10;
+constexpr uint64_t DDK_BUS_SHIFT = 32;
 std::vector<uint8_t> g_configDescBuf {
     9, 2, 59, 0, 2, 1, 0, 160, 250, 9, 4, 0, 0, 1, 3, 1, 1, 0, 9, 33, 17, 1, 0, 1, 34, 67, 0, 7, 5, 129, 3, 8, 0, 1, 9,
     4, 1, 0, 1, 3, 0, 0, 0, 9, 33, 17, 1, 0, 1, 34, 102, 0, 7, 5, 130, 3, 16, 0, 1
 };
+// interface 0 audio control, 1 HID boot keyboard, 2 CDC data, no endpoints
+std::vector<uint8_t> g_compositeConfigDescBuf {
+    9, 2, 36, 0, 3, 1, 0, 128, 50, 9, 4, 0, 0, 0, 1, 1, 0, 0, 9, 4, 1, 0, 0, 3, 1, 1, 0, 9, 4, 2, 0, 0, 10, 0, 0, 0
+};
 
 int32_t UsbDdkServiceMock::GetConfigDescriptor(uint64_t deviceId, uint8_t configIndex, std::vector<uint8_t> &configDesc)
 {
     if (deviceId == ((BUS_NUM_OK << SHIFT_32) + DEV_ADDR_INTERFACE_ERR)) {
         return HDF_DEV_ERR_NO_DEVICE;
     }
+    if (deviceId == ((BUS_NUM_OK << DDK_BUS_SHIFT) + DEV_ADDR_COMPOSITE)) {
+        configDesc = g_compositeConfigDescBuf;
+        return HDF_SUCCESS;
+    }
     configDesc = g_configDescBuf;
     return HDF_SUCCESS;
 }
@@ -76,6 +76,26 @@ HWTEST_F(UsbDriverInfoTest, SerializeThenUnSerializeTest, TestSize.Level1)
     ASSERT_EQ(newUsbDriverInfo->vids_[1], 2222);
 }
 
+HWTEST_F(UsbDriverInfoTest, MatchRulesSerializeTest, TestSize.Level1)
+{
+    UsbDriverInfo usbDrvInfo;
+    ASSERT_TRUE(usbDrvInfo.SetMatchRules("vid=0x1234,pid=0x0100-0x01ff;ifClass=0x03"));
+    string drvInfoStr;
+    ASSERT_EQ(usbDrvInfo.Serialize(drvInfoStr), 0);
+
+    UsbDriverInfo newUsbDrvInfo;
+    ASSERT_EQ(newUsbDrvInfo.UnSerialize(drvInfoStr), 0);
+    ASSERT_EQ(newUsbDrvInfo.GetMatchRules(), usbDrvInfo.GetMatchRules());
+    ASSERT_NE(newUsbDrvInfo.GetMatchRuleSet(), nullptr);
+    ASSERT_EQ(newUsbDrvInfo.GetMatchRuleSet()->Size(), 2U);
+
+    // written before match rules existed
+    ASSERT_EQ(newUsbDrvInfo.UnSerialize("{\"pids\":[1],\"vids\":[2]}"), 0);
+    ASSERT_EQ(newUsbDrvInfo.GetMatchRuleSet(), nullptr);
+    ASSERT_NE(newUsbDrvInfo.UnSerialize("{\"pids\":[1],\"vids\":[2],\"matchRules\":\"vid=\"}"), 0);
+    ASSERT_NE(newUsbDrvInfo.UnSerialize("{\"pids\":[1],\"vids\":[2],\"matchRules\":1}"), 0);
+}
+
 HWTEST_F(UsbDriverInfoTest, UnSerializeErrorTest, TestSize.Level1)
 {
     int ret = 0;
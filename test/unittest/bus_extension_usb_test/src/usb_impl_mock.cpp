@@ -51,7 +51,8 @@ int32_t UsbImplMock::GetRawDescriptor(const UsbDev &dev, std::vector<uint8_t> &d
         && (DEV_ADDR_OK_2 != dev.devAddr)\
         && (DEV_ADDR_OK_ERR_DESC != dev.devAddr)\
         && (DEV_ADDR_OK_NULL_DESC != dev.devAddr)\
-        && (DEV_ADDR_INTERFACE_ERR != dev.devAddr)) {
+        && (DEV_ADDR_INTERFACE_ERR != dev.devAddr)\
+        && (DEV_ADDR_COMPOSITE != dev.devAddr)) {
         return HDF_DEV_ERR_NO_DEVICE;
     }
     if (dev.devAddr == DEV_ADDR_OK_ERR_DESC) {
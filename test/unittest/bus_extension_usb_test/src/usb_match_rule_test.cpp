@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "hilog_wrapper.h"
+#define private public
+#include "usb_device_info.h"
+#include "usb_match_rule.h"
+#undef private
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+using namespace testing::ext;
+
+class UsbMatchRuleTest : public testing::Test {
+public:
+    void SetUp() override {}
+    void TearDown() override {}
+
+    static UsbDeviceInfo MakeDevice(uint16_t vid, uint16_t pid, uint16_t bcdDevice = 0x0100)
+    {
+        UsbDeviceInfo device(0);
+        device.idVendor_ = vid;
+        device.idProduct_ = pid;
+        device.bcdDevice_ = bcdDevice;
+        return device;
+    }
+
+    static void AddInterface(UsbDeviceInfo &device, uint8_t ifClass, uint8_t ifSubClass, uint8_t ifProtocol)
+    {
+        UsbInterfaceDescriptor desc {};
+        desc.bInterfaceNumber = static_cast<uint8_t>(device.interfaceDescList_.size());
+        desc.bInterfaceClass = ifClass;
+        desc.bInterfaceSubClass = ifSubClass;
+        desc.bInterfaceProtocol = ifProtocol;
+        device.interfaceDescList_.push_back(desc);
+    }
+};
+
+HWTEST_F(UsbMatchRuleTest, CompileTest, TestSize.Level1)
+{
+    UsbMatchRuleSet rules;
+    ASSERT_TRUE(rules.Compile("vid=0x1234, pid=0x0100-0x01ff; VID=5678,PID=1200/ff00;class=*"));
+    ASSERT_EQ(rules.Size(), 3U);
+    ASSERT_TRUE(rules.Compile(" ; ;"));
+    ASSERT_TRUE(rules.Empty());
+
+    const vector<string> invalid = {
+        "vid",
+        "vid=",
+        "serial=0x1",
+        "vid=0x12345",
+        "vid=0xg1",
+        "class=0x100",
+        "pid=0x20-0x10",
+        "pid=0x1200/0",
+        "vid=0x1234;pid",
+    };
+    for (const auto &text : invalid) {
+        ASSERT_FALSE(rules.Compile(text)) << text;
+        ASSERT_TRUE(rules.Empty()) << text;
+    }
+}
+
+HWTEST_F(UsbMatchRuleTest, MatchFieldsTest, TestSize.Level1)
+{
+    UsbMatchRuleSet rules;
+    ASSERT_TRUE(rules.Compile("vid=0x1234,pid=0x0100-0x01ff,bcdDevice=0x0200-0xffff;vid=0x5678,pid=0x1200/0xff00"));
+    ASSERT_TRUE(rules.Match(MakeDevice(0x1234, 0x0150, 0x0210)));
+    // firmware revision out of range
+    ASSERT_FALSE(rules.Match(MakeDevice(0x1234, 0x0150, 0x0100)));
+    ASSERT_FALSE(rules.Match(MakeDevice(0x1234, 0x0200, 0x0210)));
+    ASSERT_TRUE(rules.Match(MakeDevice(0x5678, 0x12ab)));
+    ASSERT_FALSE(rules.Match(MakeDevice(0x5678, 0x13ab)));
+    ASSERT_FALSE(rules.Match(MakeDevice(0x9999, 0x0150, 0x0210)));
+
+    ASSERT_TRUE(rules.Compile("class=0x02,subClass=0x02,protocol=*"));
+    auto device = MakeDevice(0x9999, 0x0001);
+    device.deviceClass_ = 0x02;
+    device.deviceSubClass_ = 0x02;
+    device.deviceProtocol_ = 0x01;
+    ASSERT_TRUE(rules.Match(device));
+    device.deviceSubClass_ = 0x03;
+    ASSERT_FALSE(rules.Match(device));
+}
+
+HWTEST_F(UsbMatchRuleTest, MatchInterfaceTest, TestSize.Level1)
+{
+    UsbMatchRuleSet rules;
+    ASSERT_TRUE(rules.Compile("ifClass=0x03,ifSubClass=0x01,ifProtocol=0x02"));
+    auto device = MakeDevice(0x1111, 0x2222);
+    ASSERT_FALSE(rules.Match(device));
+    // the fields are spread over two interfaces, none of them is a boot mouse
+    AddInterface(device, 0x03, 0x01, 0x01);
+    AddInterface(device, 0x03, 0x00, 0x02);
+    ASSERT_FALSE(rules.Match(device));
+    AddInterface(device, 0x03, 0x01, 0x02);
+    ASSERT_TRUE(rules.Match(device));
+}
+
+HWTEST_F(UsbMatchRuleTest, MatchScopeTest, TestSize.Level1)
+{
+    UsbMatchRuleSet rules;
+    ASSERT_TRUE(rules.Compile("vid=0x1111;ifClass=0x03"));
+    auto device = MakeDevice(0x1111, 0x2222);
+    AddInterface(device, 0x03, 0x01, 0x01);
+    ASSERT_TRUE(rules.Match(device, UsbMatchScope::DEVICE));
+    ASSERT_TRUE(rules.Match(device, UsbMatchScope::INTERFACE));
+    device.idVendor_ = 0x3333;
+    // the HID function of a composite device is bound on its own, not through the whole device
+    ASSERT_FALSE(rules.Match(device, UsbMatchScope::DEVICE));
+    ASSERT_TRUE(rules.Match(device, UsbMatchScope::INTERFACE));
+    ASSERT_TRUE(rules.Match(device));
+    device.interfaceDescList_.clear();
+    device.idVendor_ = 0x1111;
+    ASSERT_FALSE(rules.Match(device, UsbMatchScope::INTERFACE));
+}
+
+HWTEST_F(UsbMatchRuleTest, HashFieldTest, TestSize.Level1)
+{
+    UsbMatchRuleSet rules;
+    ASSERT_TRUE(rules.Compile("vid=0x1111,pid=1;vid=0x2222,pid=2;vid=0x3333,pid=2;ifClass=0xff"));
+    // pid is fixed by as many rules, but vid spreads them over more buckets
+    ASSERT_EQ(rules.GetHashField(), UsbMatchField::VID);
+    ASSERT_EQ(rules.unhashed_.size(), 1U);
+    ASSERT_TRUE(rules.Match(MakeDevice(0x3333, 2)));
+    ASSERT_FALSE(rules.Match(MakeDevice(0x3333, 1)));
+    auto device = MakeDevice(0x4444, 4);
+    AddInterface(device, 0xff, 0, 0);
+    ASSERT_TRUE(rules.Match(device));
+
+    ASSERT_TRUE(rules.Compile("pid=0x10-0x20"));
+    ASSERT_EQ(rules.GetHashField(), UsbMatchField::COUNT);
+    ASSERT_TRUE(rules.Match(MakeDevice(0x4444, 0x15)));
+}
+
+HWTEST_F(UsbMatchRuleTest, GetVidPidsTest, TestSize.Level1)
+{
+    UsbMatchRuleSet rules;
+    vector<pair<uint16_t, uint16_t>> pairs;
+    ASSERT_TRUE(rules.Compile("vid=0x1234,pid=0x10-0x13;vid=0x5678,pid=0x20"));
+    ASSERT_TRUE(rules.GetVidPids(pairs));
+    ASSERT_EQ(pairs.size(), 5U);
+    ASSERT_EQ(pairs.back().first, 0x5678);
+    ASSERT_EQ(pairs.back().second, 0x20);
+
+    // any of these can match devices of more vid:pid pairs than are worth keying
+    for (const string text : {"vid=0x1234", "vid=0x1234,pid=0x1200/0xff00", "vid=0x1234,pid=0-0xffff", "class=3"}) {
+        ASSERT_TRUE(rules.Compile(text));
+        pairs.clear();
+        ASSERT_FALSE(rules.GetVidPids(pairs)) << text;
+    }
+}
+
+HWTEST_F(UsbMatchRuleTest, TenThousandRulesBenchmark, TestSize.Level1)
+{
+    // a vendor with a hundred product lines of a hundred models each, plus some class rules
+    const uint32_t vendors = 100;
+    const uint32_t productsPerVendor = 100;
+    const uint16_t vidBase = 0x1000;
+    string text;
+    vector<string> ruleTexts;
+    for (uint32_t v = 0; v < vendors; v++) {
+        for (uint32_t p = 0; p < productsPerVendor; p++) {
+            char rule[64];
+            uint32_t pid = p * 0x10;
+            int len = snprintf(rule, sizeof(rule), "vid=%x,pid=%x-%x,bcdDevice=100-1ff", vidBase + v, pid, pid + 0x7);
+            ASSERT_GT(len, 0);
+            ruleTexts.emplace_back(rule);
+        }
+    }
+    ruleTexts.emplace_back("class=0xe0,subClass=0x01");
+    ruleTexts.emplace_back("ifClass=0x0a,ifSubClass=0x00");
+    for (const auto &rule : ruleTexts) {
+        text += rule + ";";
+    }
+
+    UsbMatchRuleSet rules;
+    auto begin = chrono::steady_clock::now();
+    ASSERT_TRUE(rules.Compile(text));
+    auto compileUs = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - begin).count();
+    ASSERT_EQ(rules.Size(), vendors * productsPerVendor + 2);
+
+    // the same rules checked one by one, the way vid and pid lists are
+    vector<UsbMatchRuleSet> linear(ruleTexts.size());
+    for (size_t i = 0; i < ruleTexts.size(); i++) {
+        ASSERT_TRUE(linear[i].Compile(ruleTexts[i]));
+    }
+
+    mt19937 random(0);
+    vector<UsbDeviceInfo> devices;
+    const uint32_t probes = 1000;
+    for (uint32_t i = 0; i < probes; i++) {
+        // half of them belong to one of the vendors
+        uint16_t vid = static_cast<uint16_t>(vidBase + random() % (vendors * 2));
+        uint16_t pid = static_cast<uint16_t>(random() % (productsPerVendor * 0x10));
+        devices.push_back(MakeDevice(vid, pid, static_cast<uint16_t>(0x100 + random() % 0x200)));
+        AddInterface(devices.back(), static_cast<uint8_t>(random() % 0x10), 0, 0);
+    }
+
+    uint32_t matched = 0;
+    begin = chrono::steady_clock::now();
+    for (const auto &device : devices) {
+        matched += rules.Match(device) ? 1 : 0;
+    }
+    auto compiledNs = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+
+    uint32_t linearMatched = 0;
+    begin = chrono::steady_clock::now();
+    for (const auto &device : devices) {
+        for (const auto &rule : linear) {
+            if (rule.Match(device)) {
+                linearMatched++;
+                break;
+            }
+        }
+    }
+    auto linearNs = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+
+    cout << ruleTexts.size() << " rules compiled in " << compileUs << " us, match " << compiledNs / probes
+        << " ns per device, linear scan " << linearNs / probes << " ns, " << matched << "/" << probes
+        << " matched" << endl;
+    ASSERT_EQ(matched, linearMatched);
+    ASSERT_GT(matched, 0U);
+    ASSERT_LT(compiledNs, linearNs);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -25,6 +25,7 @@
 #define private public
 #include "ibus_extension.h"
 #include "usb_bus_extension.h"
+#include "usb_device_info.h"
 #undef private
 namespace OHOS {
 namespace ExternalDeviceManager {
@@ -189,6 +190,54 @@ HWTEST_F(UsbSubscriberTest, UsbDevCallbackErrorTest1, TestSize.Level1)
     EXPECT_EQ(ret, 0);
 }
 
+HWTEST_F(UsbSubscriberTest, CompositeDeviceTest, TestSize.Level1)
+{
+    auto testCb = make_shared<TestDevChangeCallback>();
+    usbBusExt->SetDevChangeCallback(testCb);
+    USBDeviceInfo info = {ACT_DEVUP, BUS_NUM_OK, DEV_ADDR_COMPOSITE};
+    auto ret = mockUsb->SubscriberDeviceEvent(info);
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(testCb->devInfoMap.size(), (size_t)1);
+
+    auto device = static_pointer_cast<UsbDeviceInfo>(testCb->devInfoMap.begin()->second);
+    ASSERT_TRUE(device->IsComposite());
+    ASSERT_EQ(device->GetInterfaceNumber(), -1);
+    ASSERT_EQ(device->interfaceDescList_.size(), (size_t)3);
+    const auto &interfaceInfos = device->GetInterfaceInfos();
+    ASSERT_EQ(interfaceInfos.size(), (size_t)3);
+    const uint8_t interfaceClasses[] = {0x01, 0x03, 0x0a};
+    for (size_t i = 0; i < interfaceInfos.size(); i++) {
+        auto interfaceInfo = static_pointer_cast<UsbDeviceInfo>(interfaceInfos[i]);
+        ASSERT_EQ(interfaceInfo->GetInterfaceNumber(), static_cast<int32_t>(i));
+        ASSERT_EQ(interfaceInfo->GetParentDeviceId(), device->GetDeviceId());
+        ASSERT_NE(interfaceInfo->GetDeviceId(), device->GetDeviceId());
+        ASSERT_EQ(interfaceInfo->GetBusType(), BusType::BUS_TYPE_USB);
+        ASSERT_EQ(interfaceInfo->GetBusDevId(), device->GetBusDevId());
+        ASSERT_EQ(interfaceInfo->GetVendorId(), device->GetVendorId());
+        ASSERT_FALSE(interfaceInfo->IsComposite());
+        ASSERT_EQ(interfaceInfo->interfaceDescList_.size(), (size_t)1);
+        ASSERT_EQ(interfaceInfo->interfaceDescList_[0].bInterfaceClass, interfaceClasses[i]);
+        ASSERT_NE(interfaceInfo->GetDeviceDescription().find("&IF_0" + to_string(i)), string::npos);
+    }
+
+    // the vid and pid lists bind the whole device, the interface rule binds the keyboard function only
+    auto drvInfo = make_shared<DriverInfo>();
+    drvInfo->bus_ = "USB";
+    drvInfo->driverInfoExt_ = usbBusExt->ParseDriverInfo({{"vid", "0x2207"}, {"pid", "0x0018"},
+        {"matchRules", "ifClass=0x03,ifSubClass=0x01,ifProtocol=0x01"}});
+    ASSERT_TRUE(usbBusExt->MatchDriver(*drvInfo, *device));
+    ASSERT_FALSE(usbBusExt->MatchDriver(*drvInfo, *interfaceInfos[0]));
+    ASSERT_TRUE(usbBusExt->MatchDriver(*drvInfo, *interfaceInfos[1]));
+    ASSERT_FALSE(usbBusExt->MatchDriver(*drvInfo, *interfaceInfos[2]));
+    drvInfo->driverInfoExt_ = usbBusExt->ParseDriverInfo({{"matchRules", "ifClass=0x03"}});
+    ASSERT_FALSE(usbBusExt->MatchDriver(*drvInfo, *device));
+
+    info.status = ACT_DEVDOWN;
+    ret = mockUsb->SubscriberDeviceEvent(info);
+    ASSERT_EQ(ret, 0);
+    ASSERT_EQ(testCb->devInfoMap.size(), (size_t)0);
+}
+
 #ifndef EXTDEVMGR_USB_PASS_THROUGH
 HWTEST_F(UsbSubscriberTest, PortChangEeventTest, TestSize.Level1)
 {
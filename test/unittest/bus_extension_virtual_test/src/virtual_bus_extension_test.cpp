@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fstream>
+#include <gtest/gtest.h>
+#include <vector>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#define private public
+#include "ibus_extension.h"
+#include "bus_extension_core.h"
+#include "virtual_bus_extension.h"
+#include "virtual_device_info.h"
+#include "virtual_driver_info.h"
+#undef private
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+using namespace testing::ext;
+
+class VirtualBusExtensionTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_BUS_VIRTUAL, "VirtualBusExtensionTest SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_BUS_VIRTUAL, "VirtualBusExtensionTest TearDown");
+    }
+};
+
+class RecordingDevChangeCallback : public IDevChangeCallback {
+public:
+    int32_t OnDeviceAdd(std::shared_ptr<DeviceInfo> device) override
+    {
+        events_.push_back("add " + to_string(device->GetBusDevId()));
+        return EDM_OK;
+    }
+    int32_t OnDeviceRemove(std::shared_ptr<DeviceInfo> device) override
+    {
+        events_.push_back("remove " + to_string(device->GetBusDevId()));
+        return EDM_OK;
+    }
+    vector<string> events_;
+};
+
+static shared_ptr<VirtualDeviceInfo> MakeDevice(uint32_t busDeviceId, uint16_t vid, uint16_t pid)
+{
+    auto device = make_shared<VirtualDeviceInfo>(busDeviceId);
+    device->SetVendorId(vid);
+    device->SetProductId(pid);
+    return device;
+}
+
+HWTEST_F(VirtualBusExtensionTest, RegisterTest, TestSize.Level1)
+{
+    // registered by the library itself when it is loaded
+    BusExtensionCore &core = BusExtensionCore::GetInstance();
+    ASSERT_NE(core.GetBusExtensionByName("virtual"), nullptr);
+    ASSERT_EQ(core.GetBusExtensionByType(BusType::BUS_TYPE_VIRTUAL)->GetBusType(), BusType::BUS_TYPE_VIRTUAL);
+    ASSERT_EQ(BusExtensionCore::GetBusTypeByName("Virtual"), BusType::BUS_TYPE_VIRTUAL);
+}
+
+HWTEST_F(VirtualBusExtensionTest, ParseDriverInfoAndMatchTest, TestSize.Level1)
+{
+    auto bus = make_shared<VirtualBusExtension>();
+    const map<string, string> metadata = {{"bus", "virtual"}, {"vid", "0x1111,2222,zz"}, {"pid", "0x10"}};
+    auto driverInfoExt = bus->ParseDriverInfo(metadata);
+    ASSERT_NE(driverInfoExt, nullptr);
+    auto virtualDriverInfo = static_pointer_cast<VirtualDriverInfo>(driverInfoExt);
+    ASSERT_EQ(virtualDriverInfo->GetVendorIds(), vector<uint16_t>({0x1111, 0x2222}));
+    ASSERT_EQ(virtualDriverInfo->GetProductIds(), vector<uint16_t>({0x10}));
+
+    DriverInfo driver("virtualBundle", "virtualDriver");
+    driver.bus_ = "virtual";
+    driver.driverInfoExt_ = driverInfoExt;
+    ASSERT_TRUE(bus->MatchDriver(driver, *MakeDevice(1, 0x2222, 0x10)));
+    ASSERT_FALSE(bus->MatchDriver(driver, *MakeDevice(1, 0x2222, 0x11)));
+    ASSERT_FALSE(bus->MatchDriver(driver, DeviceInfo(1, BusType::BUS_TYPE_USB)));
+    driver.bus_ = "usb";
+    ASSERT_FALSE(bus->MatchDriver(driver, *MakeDevice(1, 0x2222, 0x10)));
+
+    driver.bus_ = "virtual";
+    vector<string> driverKeys;
+    ASSERT_TRUE(bus->GetMatchKeys(driver, driverKeys));
+    ASSERT_EQ(driverKeys.size(), 2U);
+    vector<string> deviceKeys;
+    ASSERT_TRUE(bus->GetMatchKeys(*MakeDevice(1, 0x2222, 0x10), deviceKeys));
+    ASSERT_EQ(deviceKeys, vector<string>({driverKeys[1]}));
+}
+
+HWTEST_F(VirtualBusExtensionTest, SerializeThenUnSerializeTest, TestSize.Level1)
+{
+    auto virtualDriverInfo = make_shared<VirtualDriverInfo>();
+    virtualDriverInfo->vids_ = {0x1111};
+    virtualDriverInfo->pids_ = {0x10, 0x20};
+    DriverInfo driver("virtualBundle", "virtualDriver");
+    driver.bus_ = "virtual";
+    driver.driverInfoExt_ = virtualDriverInfo;
+    string driverStr;
+    ASSERT_EQ(driver.Serialize(driverStr), EDM_OK);
+
+    DriverInfo newDriver;
+    ASSERT_EQ(newDriver.UnSerialize(driverStr), EDM_OK);
+    ASSERT_EQ(newDriver.GetBusType(), BusType::BUS_TYPE_VIRTUAL);
+    auto newVirtualDriverInfo = static_pointer_cast<VirtualDriverInfo>(newDriver.GetInfoExt());
+    ASSERT_EQ(newVirtualDriverInfo->GetVendorIds(), virtualDriverInfo->vids_);
+    ASSERT_EQ(newVirtualDriverInfo->GetProductIds(), virtualDriverInfo->pids_);
+    ASSERT_NE(newVirtualDriverInfo->UnSerialize("{\"vids\":[1]}"), EDM_OK);
+}
+
+HWTEST_F(VirtualBusExtensionTest, AttachDetachTest, TestSize.Level1)
+{
+    auto bus = make_shared<VirtualBusExtension>();
+    // plugged in before anyone listens, reported when the callback is set
+    ASSERT_EQ(bus->Attach(MakeDevice(1, 0x1111, 0x10)), EDM_OK);
+    auto callback = make_shared<RecordingDevChangeCallback>();
+    ASSERT_EQ(bus->SetDevChangeCallback(callback), EDM_OK);
+    ASSERT_EQ(callback->events_, vector<string>({"add 1"}));
+
+    ASSERT_EQ(bus->Attach(MakeDevice(2, 0x1111, 0x10)), EDM_OK);
+    ASSERT_EQ(bus->Attach(MakeDevice(2, 0x1111, 0x20)), EDM_ERR_DEVICE_BUSY);
+    ASSERT_EQ(bus->Attach(nullptr), EDM_ERR_INVALID_PARAM);
+    ASSERT_EQ(bus->GetAttachedCount(), 2U);
+    ASSERT_EQ(bus->Detach(1), EDM_OK);
+    ASSERT_EQ(bus->Detach(1), EDM_ERR_INVALID_PARAM);
+    ASSERT_EQ(callback->events_, vector<string>({"add 1", "add 2", "remove 1"}));
+    ASSERT_EQ(bus->GetAttachedCount(), 1U);
+}
+
+HWTEST_F(VirtualBusExtensionTest, RunScriptTest, TestSize.Level1)
+{
+    auto bus = make_shared<VirtualBusExtension>();
+    auto callback = make_shared<RecordingDevChangeCallback>();
+    ASSERT_EQ(bus->SetDevChangeCallback(callback), EDM_OK);
+    callback->events_.clear();
+    const string script =
+        "# a keyboard comes and goes\n"
+        "attach 0x10 vid=0x1111 pid=22 class=3 name=keyboard\n"
+        "\n"
+        "  detach 10   # same device\n"
+        "detach 10\n"
+        "attach 11\n";
+    ASSERT_EQ(bus->RunScript(script), 4);
+    ASSERT_EQ(callback->events_, vector<string>({"add 16", "remove 16", "add 17"}));
+    ASSERT_EQ(bus->attached_[0x11]->GetVendorId(), 0);
+
+    const vector<string> invalid = {
+        "plug 1",
+        "attach",
+        "attach 1 vid=0x10000",
+        "attach 1 class=0x100",
+        "attach 1 serial=1",
+        "attach 1 vid",
+        "detach 1 vid=1",
+    };
+    for (const auto &line : invalid) {
+        ASSERT_EQ(bus->RunScript(line), -1) << line;
+    }
+    // the lines before the bad one are played
+    ASSERT_EQ(bus->RunScript("attach 12 vid=1 pid=2 name=mouse\nbogus\nattach 13"), -1);
+    ASSERT_EQ(bus->attached_[0x12]->GetDeviceDescription(), "mouse");
+    ASSERT_EQ(bus->attached_.count(0x13), 0U);
+}
+
+HWTEST_F(VirtualBusExtensionTest, LoadScriptTest, TestSize.Level1)
+{
+    const string path = "/data/local/tmp/virtual_bus_extension_test.script";
+    {
+        ofstream file(path);
+        ASSERT_TRUE(file.is_open());
+        file << "attach 1 vid=1 pid=1\nattach 2 vid=1 pid=2\ndetach 1\n";
+    }
+    auto bus = make_shared<VirtualBusExtension>();
+    ASSERT_EQ(bus->LoadScript(path), 3);
+    ASSERT_EQ(bus->GetAttachedCount(), 1U);
+    remove(path.c_str());
+    ASSERT_EQ(bus->LoadScript(path), -1);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
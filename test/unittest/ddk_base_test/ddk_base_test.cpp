@@ -13,9 +13,17 @@
  * limitations under the License.
  */
 
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 #include "edm_errors.h"
 #include "hilog_wrapper.h"
 #include "ddk_api.h"
+#include "ddk_ashmem_pool.h"
 #include "ddk_types.h"
 #include "gtest/gtest.h"
 
@@ -26,6 +34,16 @@ using namespace testing::ext;
 #define PORT_READ 0x01
 #define PORT_WRITE 0x02
 #define PORT_ILLEGAL 0x08
+#define POOL_BLOCK_SIZE 512
+#define POOL_BLOCK_COUNT 64
+#define POOL_ALIGNMENT 64
+#define POOL_THREAD_NUM 4
+#define POOL_LOOP_TIMES 10000
+#define POOL_BENCH_TIMES 1000
+#define MAP_BENCH_SIZE (32 * 1024 * 1024)
+#define MAP_BENCH_PASSES 8
+#define MAP_LOCK_SIZE (64 * 1024)
+#define MAP_FLAG_ILLEGAL 0x80
 
 namespace OHOS {
 namespace ExternalDeviceManager {
@@ -169,5 +187,269 @@ HWTEST_F(DdkBaseTest, OH_DDK_DestroyAshmem_002, TestSize.Level1)
     ret = OH_DDK_DestroyAshmem(nullptr);
     EXPECT_EQ(ret, DDK_NULL_PTR);
 }
+
+HWTEST_F(DdkBaseTest, OH_DDK_CreateAshmemPool_001, TestSize.Level1)
+{
+    DDK_AshmemPool *pool = nullptr;
+    const uint8_t name[100] = "TestAshmemPool";
+    auto ret = OH_DDK_CreateAshmemPool(name, POOL_BLOCK_SIZE, POOL_BLOCK_COUNT, PORT_READ | PORT_WRITE, &pool);
+    EXPECT_EQ(ret, DDK_SUCCESS);
+    DDK_AshmemPoolStats stats;
+    ret = OH_DDK_GetAshmemPoolStats(pool, &stats);
+    EXPECT_EQ(ret, DDK_SUCCESS);
+    EXPECT_EQ(stats.blockSize, POOL_BLOCK_SIZE);
+    EXPECT_EQ(stats.blockCount, POOL_BLOCK_COUNT);
+    EXPECT_EQ(stats.usedBlocks, 0);
+    ret = OH_DDK_DestroyAshmemPool(pool);
+    EXPECT_EQ(ret, DDK_SUCCESS);
+}
+
+HWTEST_F(DdkBaseTest, OH_DDK_CreateAshmemPool_002, TestSize.Level1)
+{
+    DDK_AshmemPool *pool = nullptr;
+    const uint8_t name[100] = "TestAshmemPool";
+    EXPECT_EQ(OH_DDK_CreateAshmemPool(nullptr, POOL_BLOCK_SIZE, POOL_BLOCK_COUNT, PORT_READ, &pool),
+        DDK_INVALID_PARAMETER);
+    EXPECT_EQ(OH_DDK_CreateAshmemPool(name, POOL_BLOCK_SIZE, POOL_BLOCK_COUNT, PORT_READ, nullptr),
+        DDK_INVALID_PARAMETER);
+    EXPECT_EQ(OH_DDK_CreateAshmemPool(name, 0, POOL_BLOCK_COUNT, PORT_READ, &pool), DDK_INVALID_PARAMETER);
+    EXPECT_EQ(OH_DDK_CreateAshmemPool(name, POOL_BLOCK_SIZE, 0, PORT_READ, &pool), DDK_INVALID_PARAMETER);
+    EXPECT_EQ(OH_DDK_CreateAshmemPool(name, UINT32_MAX, POOL_BLOCK_COUNT, PORT_READ, &pool), DDK_INVALID_PARAMETER);
+    EXPECT_EQ(OH_DDK_CreateAshmemPool(name, POOL_BLOCK_SIZE, POOL_BLOCK_COUNT, PORT_WRITE, &pool),
+        DDK_INVALID_OPERATION);
+    EXPECT_EQ(OH_DDK_CreateAshmemPool(name, POOL_BLOCK_SIZE, POOL_BLOCK_COUNT, PORT_ILLEGAL, &pool),
+        DDK_INVALID_OPERATION);
+    EXPECT_EQ(OH_DDK_DestroyAshmemPool(nullptr), DDK_NULL_PTR);
+}
+
+HWTEST_F(DdkBaseTest, OH_DDK_AllocAshmemBuffer_001, TestSize.Level1)
+{
+    DDK_AshmemPool *pool = nullptr;
+    const uint8_t name[100] = "TestAshmemPool";
+    // block size is rounded up to the pool alignment
+    auto ret = OH_DDK_CreateAshmemPool(name, POOL_BLOCK_SIZE - 1, POOL_BLOCK_COUNT, PORT_READ | PORT_WRITE, &pool);
+    ASSERT_EQ(ret, DDK_SUCCESS);
+    const uint32_t sizes[] = {1, POOL_BLOCK_SIZE, POOL_BLOCK_SIZE + 1, POOL_BLOCK_SIZE * 3};
+    std::vector<DDK_Ashmem *> buffers;
+    for (uint32_t size : sizes) {
+        DDK_Ashmem *buffer = nullptr;
+        ret = OH_DDK_AllocAshmemBuffer(pool, size, &buffer);
+        ASSERT_EQ(ret, DDK_SUCCESS);
+        EXPECT_EQ(buffer->offset % POOL_ALIGNMENT, 0);
+        EXPECT_EQ(buffer->bufferLength, size);
+        EXPECT_EQ(buffer->size, POOL_BLOCK_SIZE * POOL_BLOCK_COUNT);
+        EXPECT_LE(buffer->offset + buffer->bufferLength, buffer->size);
+        for (auto other : buffers) {
+            EXPECT_EQ(other->ashmemFd, buffer->ashmemFd);
+            EXPECT_TRUE(buffer->offset >= other->offset + other->bufferLength ||
+                other->offset >= buffer->offset + buffer->bufferLength);
+        }
+        uint8_t *data = const_cast<uint8_t *>(buffer->address) + buffer->offset;
+        data[0] = static_cast<uint8_t>(size);
+        data[size - 1] = static_cast<uint8_t>(size);
+        buffers.push_back(buffer);
+    }
+    DDK_Ashmem *buffer = nullptr;
+    EXPECT_EQ(OH_DDK_AllocAshmemBuffer(pool, 0, &buffer), DDK_INVALID_PARAMETER);
+    EXPECT_EQ(OH_DDK_AllocAshmemBuffer(pool, POOL_BLOCK_SIZE * (AshmemBlockAllocator::MAX_RUN_BLOCKS + 1), &buffer),
+        DDK_INVALID_PARAMETER);
+    EXPECT_EQ(OH_DDK_AllocAshmemBuffer(nullptr, 1, &buffer), DDK_NULL_PTR);
+    DDK_Ashmem foreign = {buffers[0]->ashmemFd, buffers[0]->address, buffers[0]->size, 0, 1, 0};
+    EXPECT_EQ(OH_DDK_FreeAshmemBuffer(pool, &foreign), DDK_INVALID_PARAMETER);
+    for (auto allocated : buffers) {
+        EXPECT_EQ(OH_DDK_FreeAshmemBuffer(pool, allocated), DDK_SUCCESS);
+    }
+    EXPECT_EQ(OH_DDK_FreeAshmemBuffer(pool, buffers[0]), DDK_INVALID_OPERATION);
+    EXPECT_EQ(OH_DDK_DestroyAshmemPool(pool), DDK_SUCCESS);
+}
+
+HWTEST_F(DdkBaseTest, OH_DDK_GetAshmemPoolStats_001, TestSize.Level1)
+{
+    DDK_AshmemPool *pool = nullptr;
+    const uint8_t name[100] = "TestAshmemPool";
+    auto ret = OH_DDK_CreateAshmemPool(name, POOL_BLOCK_SIZE, POOL_BLOCK_COUNT, PORT_READ | PORT_WRITE, &pool);
+    ASSERT_EQ(ret, DDK_SUCCESS);
+    std::vector<DDK_Ashmem *> buffers(POOL_BLOCK_COUNT);
+    for (auto &buffer : buffers) {
+        ASSERT_EQ(OH_DDK_AllocAshmemBuffer(pool, POOL_BLOCK_SIZE, &buffer), DDK_SUCCESS);
+    }
+    // free every other block: half of the pool is free but no two free blocks are adjacent
+    for (uint32_t i = 0; i < POOL_BLOCK_COUNT; i += 2) {
+        ASSERT_EQ(OH_DDK_FreeAshmemBuffer(pool, buffers[i]), DDK_SUCCESS);
+    }
+    DDK_Ashmem *buffer = nullptr;
+    EXPECT_EQ(OH_DDK_AllocAshmemBuffer(pool, POOL_BLOCK_SIZE * 2, &buffer), DDK_FAILURE);
+    DDK_AshmemPoolStats stats;
+    ASSERT_EQ(OH_DDK_GetAshmemPoolStats(pool, &stats), DDK_SUCCESS);
+    EXPECT_EQ(stats.usedBlocks, POOL_BLOCK_COUNT / 2);
+    EXPECT_EQ(stats.freeRuns, POOL_BLOCK_COUNT / 2);
+    EXPECT_EQ(stats.largestFreeBlocks, 1);
+    EXPECT_EQ(stats.allocCount, POOL_BLOCK_COUNT);
+    EXPECT_EQ(stats.allocFailures, 1);
+    EXPECT_EQ(OH_DDK_GetAshmemPoolStats(nullptr, &stats), DDK_NULL_PTR);
+    EXPECT_EQ(OH_DDK_DestroyAshmemPool(pool), DDK_SUCCESS);
+}
+
+HWTEST_F(DdkBaseTest, AshmemBlockAllocator_001, TestSize.Level1)
+{
+    // a pool that does not fill its last bitmap word
+    const uint32_t blockCount = AshmemBlockAllocator::BLOCKS_PER_WORD + 3;
+    AshmemBlockAllocator allocator(blockCount);
+    EXPECT_EQ(allocator.Alloc(0), AshmemBlockAllocator::INVALID_BLOCK);
+    EXPECT_EQ(allocator.Alloc(AshmemBlockAllocator::MAX_RUN_BLOCKS + 1), AshmemBlockAllocator::INVALID_BLOCK);
+    uint32_t full = allocator.Alloc(AshmemBlockAllocator::MAX_RUN_BLOCKS);
+    EXPECT_EQ(full, 0);
+    EXPECT_EQ(allocator.Alloc(4), AshmemBlockAllocator::INVALID_BLOCK);
+    EXPECT_EQ(allocator.Alloc(3), AshmemBlockAllocator::BLOCKS_PER_WORD);
+    DDK_AshmemPoolStats stats;
+    allocator.GetStats(stats);
+    EXPECT_EQ(stats.usedBlocks, blockCount);
+    EXPECT_EQ(stats.freeRuns, 0);
+    EXPECT_EQ(allocator.Free(1), 0);
+    EXPECT_EQ(allocator.Free(full), AshmemBlockAllocator::MAX_RUN_BLOCKS);
+    EXPECT_EQ(allocator.Free(blockCount), 0);
+    allocator.GetStats(stats);
+    EXPECT_EQ(stats.largestFreeBlocks, AshmemBlockAllocator::MAX_RUN_BLOCKS);
+}
+
+HWTEST_F(DdkBaseTest, AshmemBlockAllocator_002, TestSize.Level1)
+{
+    const uint32_t blockCount = AshmemBlockAllocator::BLOCKS_PER_WORD * POOL_THREAD_NUM;
+    AshmemBlockAllocator allocator(blockCount);
+    std::vector<std::atomic<uint32_t>> owners(blockCount);
+    std::atomic<uint32_t> overlaps {0};
+    std::vector<std::thread> workers;
+    for (uint32_t t = 1; t <= POOL_THREAD_NUM; ++t) {
+        workers.emplace_back([&allocator, &owners, &overlaps, t]() {
+            for (uint32_t i = 0; i < POOL_LOOP_TIMES; ++i) {
+                uint32_t blocks = 1 + (i + t) % 8;
+                uint32_t index = allocator.Alloc(blocks);
+                if (index == AshmemBlockAllocator::INVALID_BLOCK) {
+                    continue;
+                }
+                for (uint32_t b = index; b < index + blocks; ++b) {
+                    if (owners[b].exchange(t) != 0) {
+                        overlaps++;
+                    }
+                }
+                for (uint32_t b = index; b < index + blocks; ++b) {
+                    owners[b].store(0);
+                }
+                allocator.Free(index);
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    EXPECT_EQ(overlaps.load(), 0);
+    DDK_AshmemPoolStats stats;
+    allocator.GetStats(stats);
+    EXPECT_EQ(stats.usedBlocks, 0);
+    EXPECT_EQ(stats.freeRuns, POOL_THREAD_NUM);
+}
+
+HWTEST_F(DdkBaseTest, AshmemPoolBenchTest, TestSize.Level1)
+{
+    const uint8_t name[100] = "TestAshmemPool";
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < POOL_BENCH_TIMES; ++i) {
+        DDK_Ashmem *ashmem = nullptr;
+        ASSERT_EQ(OH_DDK_CreateAshmem(name, POOL_BLOCK_SIZE, &ashmem), DDK_SUCCESS);
+        ASSERT_EQ(OH_DDK_MapAshmem(ashmem, PORT_READ | PORT_WRITE), DDK_SUCCESS);
+        ASSERT_EQ(OH_DDK_UnmapAshmem(ashmem), DDK_SUCCESS);
+        ASSERT_EQ(OH_DDK_DestroyAshmem(ashmem), DDK_SUCCESS);
+    }
+    auto ashmemCost = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count() / POOL_BENCH_TIMES;
+
+    DDK_AshmemPool *pool = nullptr;
+    ASSERT_EQ(OH_DDK_CreateAshmemPool(name, POOL_BLOCK_SIZE, POOL_BLOCK_COUNT, PORT_READ | PORT_WRITE, &pool),
+        DDK_SUCCESS);
+    begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < POOL_BENCH_TIMES; ++i) {
+        DDK_Ashmem *buffer = nullptr;
+        ASSERT_EQ(OH_DDK_AllocAshmemBuffer(pool, POOL_BLOCK_SIZE, &buffer), DDK_SUCCESS);
+        ASSERT_EQ(OH_DDK_FreeAshmemBuffer(pool, buffer), DDK_SUCCESS);
+    }
+    auto poolCost = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count() / POOL_BENCH_TIMES;
+    EXPECT_EQ(OH_DDK_DestroyAshmemPool(pool), DDK_SUCCESS);
+    std::cout << "ashmem create/map/destroy(ns):" << ashmemCost << " pool alloc/free(ns):" << poolCost << std::endl;
+}
+
+HWTEST_F(DdkBaseTest, OH_DDK_MapAshmemWithFlags_001, TestSize.Level1)
+{
+    DDK_Ashmem *ashmem = nullptr;
+    const uint8_t name[100] = "TestAshmem";
+    auto ret = OH_DDK_CreateAshmem(name, MAP_LOCK_SIZE, &ashmem);
+    ASSERT_EQ(ret, DDK_SUCCESS);
+    EXPECT_EQ(OH_DDK_MapAshmemWithFlags(nullptr, PORT_READ | PORT_WRITE, DDK_MAP_FLAG_PREFAULT), DDK_NULL_PTR);
+    EXPECT_EQ(OH_DDK_MapAshmemWithFlags(ashmem, PORT_READ | PORT_WRITE, MAP_FLAG_ILLEGAL), DDK_INVALID_PARAMETER);
+    EXPECT_EQ(OH_DDK_MapAshmemWithFlags(ashmem, PORT_ILLEGAL, DDK_MAP_FLAG_PREFAULT), DDK_INVALID_OPERATION);
+    // a write-only mapping has no address to apply the flags to, they are reported instead of dropped
+    EXPECT_EQ(OH_DDK_MapAshmemWithFlags(ashmem, PORT_WRITE, DDK_MAP_FLAG_PREFAULT), DDK_INVALID_OPERATION);
+    EXPECT_EQ(ashmem->address, nullptr);
+    ret = OH_DDK_MapAshmemWithFlags(ashmem, PORT_READ | PORT_WRITE, DDK_MAP_FLAG_PREFAULT | DDK_MAP_FLAG_HUGE_PAGE);
+    EXPECT_EQ(ret, DDK_SUCCESS);
+    EXPECT_NE(ashmem->address, nullptr);
+    EXPECT_EQ(OH_DDK_UnmapAshmem(ashmem), DDK_SUCCESS);
+    EXPECT_EQ(OH_DDK_DestroyAshmem(ashmem), DDK_SUCCESS);
+}
+
+HWTEST_F(DdkBaseTest, OH_DDK_MapAshmemWithFlags_002, TestSize.Level1)
+{
+    DDK_Ashmem *ashmem = nullptr;
+    const uint8_t name[100] = "TestAshmem";
+    auto ret = OH_DDK_CreateAshmem(name, MAP_LOCK_SIZE, &ashmem);
+    ASSERT_EQ(ret, DDK_SUCCESS);
+    // locking is subject to RLIMIT_MEMLOCK, a failed lock leaves the ashmem unmapped
+    ret = OH_DDK_MapAshmemWithFlags(ashmem, PORT_READ | PORT_WRITE, DDK_MAP_FLAG_LOCK);
+    if (ret == DDK_SUCCESS) {
+        EXPECT_NE(ashmem->address, nullptr);
+        EXPECT_EQ(OH_DDK_UnmapAshmem(ashmem), DDK_SUCCESS);
+    } else {
+        EXPECT_EQ(ret, DDK_FAILURE);
+        EXPECT_EQ(ashmem->address, nullptr);
+    }
+    EXPECT_EQ(OH_DDK_DestroyAshmem(ashmem), DDK_SUCCESS);
+}
+
+static void RunMapFlagsBench(const char *label, uint32_t mapFlags)
+{
+    DDK_Ashmem *ashmem = nullptr;
+    const uint8_t name[100] = "TestAshmemBench";
+    ASSERT_EQ(OH_DDK_CreateAshmem(name, MAP_BENCH_SIZE, &ashmem), DDK_SUCCESS);
+    auto begin = std::chrono::steady_clock::now();
+    ASSERT_EQ(OH_DDK_MapAshmemWithFlags(ashmem, PORT_READ | PORT_WRITE, mapFlags), DDK_SUCCESS);
+    auto mapped = std::chrono::steady_clock::now();
+    uint8_t *data = const_cast<uint8_t *>(ashmem->address);
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t offset = 0; offset < MAP_BENCH_SIZE; offset += pageSize) {
+        data[offset] = 1;
+    }
+    auto touched = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < MAP_BENCH_PASSES; ++i) {
+        (void)memset(data, static_cast<int>(i), MAP_BENCH_SIZE);
+    }
+    auto end = std::chrono::steady_clock::now();
+    EXPECT_EQ(data[MAP_BENCH_SIZE - 1], MAP_BENCH_PASSES - 1);
+    EXPECT_EQ(OH_DDK_UnmapAshmem(ashmem), DDK_SUCCESS);
+    EXPECT_EQ(OH_DDK_DestroyAshmem(ashmem), DDK_SUCCESS);
+
+    auto mapCost = std::chrono::duration_cast<std::chrono::microseconds>(mapped - begin).count();
+    auto firstTouchCost = std::chrono::duration_cast<std::chrono::microseconds>(touched - mapped).count();
+    double seconds = std::chrono::duration<double>(end - touched).count();
+    double throughput = static_cast<double>(MAP_BENCH_SIZE) * MAP_BENCH_PASSES / seconds / (1024 * 1024);
+    std::cout << label << " map(us):" << mapCost << " first touch(us):" << firstTouchCost
+        << " steady state(MiB/s):" << static_cast<uint64_t>(throughput) << std::endl;
+}
+
+HWTEST_F(DdkBaseTest, MapAshmemWithFlagsBenchTest, TestSize.Level1)
+{
+    RunMapFlagsBench("lazy", 0);
+    RunMapFlagsBench("prefault", DDK_MAP_FLAG_PREFAULT);
+    RunMapFlagsBench("prefault+hugepage", DDK_MAP_FLAG_PREFAULT | DDK_MAP_FLAG_HUGE_PAGE);
+}
 } // ExternalDeviceManager
 } // OHOS
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "gtest/gtest.h"
+#include "hilog_wrapper.h"
+#define private public
+#include "ext_dev_api_histogram.h"
+#undef private
+
+using namespace testing::ext;
+
+#define THREAD_NUM 4
+#define RECORD_TIMES 100000
+#define BENCH_TIMES 1000000
+#define DUMP_BUFF_SIZE 4096
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+class ExtDevApiHistogramTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_BASE_DDK, "ExtDevApiHistogramTest SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_BASE_DDK, "ExtDevApiHistogramTest TearDown");
+    }
+};
+
+// within 1/8 of the value, the width of a bucket
+static bool IsClose(uint64_t actual, uint64_t expected)
+{
+    uint64_t diff = actual > expected ? actual - expected : expected - actual;
+    return diff * ExtDevApiHistogram::SUB_BUCKET_NUM <= expected;
+}
+
+static void TimedApi()
+{
+    EXT_DEV_API_TIMER();
+    usleep(1);
+}
+
+HWTEST_F(ExtDevApiHistogramTest, BucketTest001, TestSize.Level1)
+{
+    uint32_t last = 0;
+    for (uint64_t ns = 0; ns < (1ULL << ExtDevApiHistogram::MAX_BITS); ns = ns * 9 / 8 + 1) {
+        uint32_t bucket = ExtDevApiHistogram::BucketOf(ns);
+        ASSERT_GE(bucket, last) << ns;
+        ASSERT_LT(bucket, ExtDevApiHistogram::BUCKET_NUM) << ns;
+        uint64_t upper = ExtDevApiHistogram::BucketUpperBound(bucket);
+        ASSERT_GE(upper, ns);
+        ASSERT_TRUE(IsClose(upper, ns)) << ns << " " << upper;
+        last = bucket;
+    }
+    ASSERT_EQ(ExtDevApiHistogram::BucketOf(UINT64_MAX), ExtDevApiHistogram::BUCKET_NUM - 1);
+}
+
+HWTEST_F(ExtDevApiHistogramTest, PercentileTest001, TestSize.Level1)
+{
+    ExtDevApiHistogram histogram("PercentileTest001");
+    ASSERT_EQ(histogram.GetSnapshot().Percentile(0.5), 0);
+    for (uint64_t ns = 1; ns <= RECORD_TIMES; ++ns) {
+        histogram.Record(ns);
+    }
+    ExtDevApiSnapshot snapshot = histogram.GetSnapshot();
+    ASSERT_EQ(snapshot.count, RECORD_TIMES);
+    ASSERT_EQ(snapshot.maxNs, RECORD_TIMES);
+    ASSERT_EQ(snapshot.sumNs, static_cast<uint64_t>(RECORD_TIMES) * (RECORD_TIMES + 1) / 2);
+    ASSERT_TRUE(IsClose(snapshot.Percentile(0.5), RECORD_TIMES / 2)) << snapshot.Percentile(0.5);
+    ASSERT_TRUE(IsClose(snapshot.Percentile(0.9), RECORD_TIMES * 9 / 10)) << snapshot.Percentile(0.9);
+    ASSERT_TRUE(IsClose(snapshot.Percentile(0.99), RECORD_TIMES * 99 / 100)) << snapshot.Percentile(0.99);
+    ASSERT_EQ(snapshot.Percentile(1.0), RECORD_TIMES);
+}
+
+HWTEST_F(ExtDevApiHistogramTest, MergeTest001, TestSize.Level1)
+{
+    ExtDevApiHistogram histogram("MergeTest001");
+    std::vector<std::thread> threads;
+    for (uint64_t i = 0; i < THREAD_NUM; ++i) {
+        threads.emplace_back([&histogram, i]() {
+            for (int j = 0; j < RECORD_TIMES; ++j) {
+                histogram.Record(i + 1);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    // the threads are gone, what they recorded is not
+    ExtDevApiSnapshot snapshot = histogram.GetSnapshot();
+    ASSERT_EQ(snapshot.count, THREAD_NUM * RECORD_TIMES);
+    ASSERT_EQ(snapshot.sumNs, static_cast<uint64_t>(RECORD_TIMES) * (1 + THREAD_NUM) * THREAD_NUM / 2);
+    ASSERT_EQ(snapshot.maxNs, THREAD_NUM);
+    for (uint64_t i = 1; i <= THREAD_NUM; ++i) {
+        ASSERT_EQ(snapshot.buckets[ExtDevApiHistogram::BucketOf(i)], RECORD_TIMES);
+    }
+}
+
+HWTEST_F(ExtDevApiHistogramTest, ShardReuseTest001, TestSize.Level1)
+{
+    ExtDevApiHistogram histogram("ShardReuseTest001");
+    // one thread after the other, the shard of each is retired and handed to the next
+    for (uint64_t i = 0; i < THREAD_NUM; ++i) {
+        std::thread([&histogram, i]() {
+            histogram.Record(i + 1);
+        }).join();
+    }
+    ASSERT_EQ(histogram.shards_.size(), 1);
+    ASSERT_EQ(histogram.freeShards_.size(), 1);
+    ExtDevApiSnapshot snapshot = histogram.GetSnapshot();
+    ASSERT_EQ(snapshot.count, THREAD_NUM);
+    ASSERT_EQ(snapshot.sumNs, static_cast<uint64_t>(1 + THREAD_NUM) * THREAD_NUM / 2);
+    ASSERT_EQ(snapshot.maxNs, THREAD_NUM);
+}
+
+HWTEST_F(ExtDevApiHistogramTest, RegistryTest001, TestSize.Level1)
+{
+    ExtDevApiHistogram &histogram = ExtDevApiHistogram::Get("RegistryTest001");
+    ASSERT_EQ(&histogram, &ExtDevApiHistogram::Get("RegistryTest001"));
+    TimedApi();
+    TimedApi();
+    bool found = false;
+    for (const auto &snapshot : ExtDevApiHistogram::GetSnapshots()) {
+        if (snapshot.name == "TimedApi") {
+            found = true;
+            ASSERT_EQ(snapshot.count, 2);
+            ASSERT_GT(snapshot.maxNs, 0);
+        }
+    }
+    ASSERT_TRUE(found);
+
+    FILE *file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    ExtDevApiHistogram::Dump(fileno(file));
+    rewind(file);
+    std::string dump;
+    char buff[DUMP_BUFF_SIZE] = {0};
+    while (fgets(buff, sizeof(buff), file) != nullptr) {
+        dump += buff;
+    }
+    fclose(file);
+    ASSERT_NE(dump.find("TimedApi"), std::string::npos);
+    // nothing recorded, nothing to show
+    ASSERT_EQ(dump.find("RegistryTest001"), std::string::npos);
+}
+
+HWTEST_F(ExtDevApiHistogramTest, RecordOverheadTest001, TestSize.Level1)
+{
+    ExtDevApiHistogram histogram("RecordOverheadTest001");
+    // the first record of a thread adds its shard
+    histogram.Record(1);
+    uint64_t begin = ExtDevApiHistogram::NowNs();
+    for (uint64_t i = 0; i < BENCH_TIMES; ++i) {
+        histogram.Record(i);
+    }
+    uint64_t perRecordNs = (ExtDevApiHistogram::NowNs() - begin) / BENCH_TIMES;
+    // report only, the time depends on the device and on the build
+    std::cout << "record: " << perRecordNs << " ns" << std::endl;
+    ASSERT_EQ(histogram.GetSnapshot().count, BENCH_TIMES + 1);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
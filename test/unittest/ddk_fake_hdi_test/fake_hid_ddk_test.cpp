@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "fake_hid_ddk.h"
+#include "hid_ddk_api.h"
+#include "hid_ddk_types.h"
+
+using namespace std;
+using namespace testing::ext;
+using namespace OHOS::ExternalDeviceManager;
+
+namespace {
+constexpr uint64_t TEST_DEVICE_ID = 0x100000001;
+constexpr uint32_t TEST_BUS_USB = 3;
+constexpr uint16_t TEST_VENDOR_ID = 0x12D1;
+constexpr uint16_t TEST_PRODUCT_ID = 0x5678;
+constexpr uint32_t TEST_BUFF_SIZE = 64;
+constexpr int32_t TEST_READ_TIMEOUT_MS = 50;
+constexpr uint32_t TEST_THREAD_NUM = 8;
+constexpr uint32_t TEST_EMIT_PER_THREAD = 500;
+
+class FakeHidDdkTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        fakeDdk_ = OHOS::sptr<FakeHidDdk>::MakeSptr();
+        FakeHidDdk::RawDevice device;
+        device.info = {TEST_BUS_USB, TEST_VENDOR_ID, TEST_PRODUCT_ID};
+        device.name = "fake keyboard";
+        device.physicalAddress = "usb-fake/input0";
+        device.uniqueId = "0001";
+        fakeDdk_->AddRawDevice(TEST_DEVICE_ID, device);
+        auto fakeDdk = fakeDdk_;
+        SetDdkFactory([fakeDdk]() { return OHOS::sptr<HidDdkHdi::IHidDdk>(fakeDdk); });
+        ASSERT_EQ(OH_Hid_Init(), HID_DDK_SUCCESS);
+        ASSERT_EQ(OH_Hid_Open(TEST_DEVICE_ID, 0, &dev_), HID_DDK_SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        if (dev_ != nullptr) {
+            (void)OH_Hid_Close(&dev_);
+        }
+        (void)OH_Hid_Release();
+        SetDdkFactory(nullptr);
+        fakeDdk_ = nullptr;
+    }
+
+    static int32_t CreateKeyboard()
+    {
+        vector<Hid_DeviceProp> deviceProp = {HID_PROP_DIRECT};
+        Hid_Device hidDevice = {"fake virtual keyboard", TEST_VENDOR_ID, TEST_PRODUCT_ID, 1, TEST_BUS_USB,
+            deviceProp.data(), static_cast<uint16_t>(deviceProp.size())};
+        vector<Hid_EventType> eventType = {HID_EV_KEY, HID_EV_SYN};
+        vector<Hid_KeyCode> keyCode = {HID_KEY_A};
+        Hid_EventProperties hidEventProp = {};
+        hidEventProp.hidEventTypes = {eventType.data(), static_cast<uint16_t>(eventType.size())};
+        hidEventProp.hidKeys = {keyCode.data(), static_cast<uint16_t>(keyCode.size())};
+        return OH_Hid_CreateDevice(&hidDevice, &hidEventProp);
+    }
+
+protected:
+    OHOS::sptr<FakeHidDdk> fakeDdk_;
+    Hid_DeviceHandle *dev_ = nullptr;
+};
+
+HWTEST_F(FakeHidDdkTest, EmitEventTest, TestSize.Level1)
+{
+    int32_t deviceId = CreateKeyboard();
+    ASSERT_GE(deviceId, 0);
+    EXPECT_EQ(fakeDdk_->GetVirtualDeviceCount(), 1);
+    Hid_EmitItem items[] = {{HID_EV_KEY, HID_KEY_A, 1}, {HID_EV_SYN, HID_SYN_REPORT, 0}};
+    ASSERT_EQ(OH_Hid_EmitEvent(deviceId, items, sizeof(items) / sizeof(items[0])), HID_DDK_SUCCESS);
+    auto recent = fakeDdk_->GetRecentItems(deviceId);
+    ASSERT_EQ(recent.size(), 2);
+    EXPECT_EQ(recent[0].type, HID_EV_KEY);
+    EXPECT_EQ(recent[0].code, HID_KEY_A);
+    EXPECT_EQ(recent[0].value, 1);
+    EXPECT_EQ(recent[1].type, HID_EV_SYN);
+    ASSERT_EQ(OH_Hid_DestroyDevice(deviceId), HID_DDK_SUCCESS);
+    EXPECT_EQ(fakeDdk_->GetVirtualDeviceCount(), 0);
+}
+
+HWTEST_F(FakeHidDdkTest, RawInfoTest, TestSize.Level1)
+{
+    Hid_RawDevInfo info = {0};
+    ASSERT_EQ(OH_Hid_GetRawInfo(dev_, &info), HID_DDK_SUCCESS);
+    EXPECT_EQ(info.busType, TEST_BUS_USB);
+    EXPECT_EQ(info.vendor, TEST_VENDOR_ID);
+    EXPECT_EQ(info.product, TEST_PRODUCT_ID);
+
+    char name[TEST_BUFF_SIZE] = {0};
+    ASSERT_EQ(OH_Hid_GetRawName(dev_, name, sizeof(name)), HID_DDK_SUCCESS);
+    EXPECT_STREQ(name, "fake keyboard");
+    char physicalAddress[TEST_BUFF_SIZE] = {0};
+    ASSERT_EQ(OH_Hid_GetPhysicalAddress(dev_, physicalAddress, sizeof(physicalAddress)), HID_DDK_SUCCESS);
+    EXPECT_STREQ(physicalAddress, "usb-fake/input0");
+}
+
+HWTEST_F(FakeHidDdkTest, ReportTest, TestSize.Level1)
+{
+    vector<uint8_t> input = {0x01, 0x00, 0x04};
+    fakeDdk_->PushInputReport(TEST_DEVICE_ID, input);
+    uint8_t buff[TEST_BUFF_SIZE] = {0};
+    uint32_t bytesRead = 0;
+    ASSERT_EQ(OH_Hid_ReadTimeout(dev_, buff, sizeof(buff), TEST_READ_TIMEOUT_MS, &bytesRead), HID_DDK_SUCCESS);
+    ASSERT_EQ(bytesRead, input.size());
+    EXPECT_EQ(vector<uint8_t>(buff, buff + bytesRead), input);
+    EXPECT_EQ(OH_Hid_ReadTimeout(dev_, buff, sizeof(buff), TEST_READ_TIMEOUT_MS, &bytesRead), HID_DDK_TIMEOUT);
+
+    uint8_t feature[] = {0x02, 0x10, 0x20};
+    ASSERT_EQ(OH_Hid_SendReport(dev_, HID_FEATURE_REPORT, feature, sizeof(feature)), HID_DDK_SUCCESS);
+    uint8_t report[sizeof(feature)] = {0x02};
+    ASSERT_EQ(OH_Hid_GetReport(dev_, HID_FEATURE_REPORT, report, sizeof(report)), HID_DDK_SUCCESS);
+    EXPECT_EQ(memcmp(report, feature, sizeof(feature)), 0);
+
+    uint8_t output[] = {0x00, 0x01};
+    uint32_t bytesWritten = 0;
+    ASSERT_EQ(OH_Hid_Write(dev_, output, sizeof(output), &bytesWritten), HID_DDK_SUCCESS);
+    auto outputReports = fakeDdk_->PopOutputReports(TEST_DEVICE_ID);
+    ASSERT_EQ(outputReports.size(), 1);
+    EXPECT_EQ(outputReports[0], vector<uint8_t>(output, output + sizeof(output)));
+}
+
+HWTEST_F(FakeHidDdkTest, ErrorInjectionTest, TestSize.Level1)
+{
+    int32_t deviceId = CreateKeyboard();
+    ASSERT_GE(deviceId, 0);
+    Hid_EmitItem items[] = {{HID_EV_KEY, HID_KEY_A, 1}};
+    fakeDdk_->InjectError("EmitEvent", HID_DDK_IO_ERROR, 1);
+    EXPECT_EQ(OH_Hid_EmitEvent(deviceId, items, 1), HID_DDK_IO_ERROR);
+    EXPECT_EQ(OH_Hid_EmitEvent(deviceId, items, 1), HID_DDK_SUCCESS);
+    EXPECT_EQ(fakeDdk_->GetEmittedItemCount(deviceId), 1);
+    EXPECT_EQ(fakeDdk_->GetCallCount("EmitEvent"), 2);
+    (void)OH_Hid_DestroyDevice(deviceId);
+}
+
+HWTEST_F(FakeHidDdkTest, ConcurrentEmitEventTest, TestSize.Level1)
+{
+    int32_t deviceId = CreateKeyboard();
+    ASSERT_GE(deviceId, 0);
+    atomic<uint32_t> failures {0};
+    vector<thread> threads;
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        threads.emplace_back([&failures, deviceId]() {
+            Hid_EmitItem items[] = {{HID_EV_KEY, HID_KEY_A, 1}, {HID_EV_SYN, HID_SYN_REPORT, 0}};
+            for (uint32_t j = 0; j < TEST_EMIT_PER_THREAD; ++j) {
+                if (OH_Hid_EmitEvent(deviceId, items, sizeof(items) / sizeof(items[0])) != HID_DDK_SUCCESS) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(fakeDdk_->GetEmittedItemCount(deviceId), TEST_THREAD_NUM * TEST_EMIT_PER_THREAD * 2);
+    (void)OH_Hid_DestroyDevice(deviceId);
+}
+} // namespace
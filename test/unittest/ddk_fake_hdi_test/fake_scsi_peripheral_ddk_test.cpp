@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "fake_scsi_peripheral_ddk.h"
+#include "scsi_peripheral_api.h"
+#include "scsi_peripheral_types.h"
+
+using namespace std;
+using namespace testing::ext;
+using namespace OHOS::ExternalDeviceManager;
+
+namespace {
+constexpr uint64_t TEST_DEVICE_ID = 0x100000001;
+constexpr uint32_t TEST_BLOCK_COUNT = 1024;
+constexpr uint32_t TEST_BLOCK_SIZE = 512;
+constexpr uint32_t TEST_IO_BLOCKS = 8;
+constexpr uint32_t TEST_TIMEOUT = 1000;
+constexpr uint16_t TEST_INQUIRY_LENGTH = 96;
+constexpr uint8_t TEST_SENSE_KEY_BYTE = 2;
+constexpr uint8_t TEST_SENSE_ASC_BYTE = 12;
+constexpr uint8_t TEST_SENSE_KEY_NOT_READY = 0x02;
+constexpr uint8_t TEST_SENSE_KEY_ILLEGAL_REQUEST = 0x05;
+constexpr uint8_t TEST_ASC_LBA_OUT_OF_RANGE = 0x21;
+constexpr uint8_t TEST_ASC_INVALID_OPCODE = 0x20;
+constexpr uint8_t TEST_UNKNOWN_OPCODE = 0xFF;
+constexpr uint8_t TEST_CDB_LENGTH = 10;
+constexpr int8_t TEST_DXFER_NONE = -1;
+constexpr auto TEST_LATENCY = chrono::milliseconds(5);
+constexpr uint32_t TEST_THREAD_NUM = 4;
+constexpr uint32_t TEST_IO_PER_THREAD = 20;
+
+class FakeScsiPeripheralDdkTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        fakeDdk_ = OHOS::sptr<FakeScsiPeripheralDdk>::MakeSptr();
+        fakeDdk_->AddDisk(TEST_DEVICE_ID, TEST_BLOCK_COUNT, TEST_BLOCK_SIZE);
+        auto fakeDdk = fakeDdk_;
+        SetDdkFactory([fakeDdk]() { return OHOS::sptr<ScsiDdkHdi::IScsiPeripheralDdk>(fakeDdk); });
+        ASSERT_EQ(OH_ScsiPeripheral_Init(), SCSIPERIPHERAL_DDK_SUCCESS);
+        ASSERT_EQ(OH_ScsiPeripheral_Open(TEST_DEVICE_ID, 0, &dev_), SCSIPERIPHERAL_DDK_SUCCESS);
+        ASSERT_EQ(OH_ScsiPeripheral_CreateDeviceMemMap(dev_, TEST_IO_BLOCKS * TEST_BLOCK_SIZE, &devMmap_),
+            SCSIPERIPHERAL_DDK_SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        if (devMmap_ != nullptr) {
+            (void)OH_ScsiPeripheral_DestroyDeviceMemMap(devMmap_);
+            devMmap_ = nullptr;
+        }
+        if (dev_ != nullptr) {
+            (void)OH_ScsiPeripheral_Close(&dev_);
+        }
+        (void)OH_ScsiPeripheral_Release();
+        SetDdkFactory(nullptr);
+        fakeDdk_ = nullptr;
+    }
+
+protected:
+    OHOS::sptr<FakeScsiPeripheralDdk> fakeDdk_;
+    ScsiPeripheral_Device *dev_ = nullptr;
+    ScsiPeripheral_DeviceMemMap *devMmap_ = nullptr;
+};
+
+HWTEST_F(FakeScsiPeripheralDdkTest, ReadWriteTest, TestSize.Level1)
+{
+    for (uint32_t i = 0; i < devMmap_->size; ++i) {
+        devMmap_->address[i] = static_cast<uint8_t>(i * 7);
+    }
+    vector<uint8_t> written(devMmap_->address, devMmap_->address + devMmap_->size);
+    ScsiPeripheral_IORequest request = {16, TEST_IO_BLOCKS, 0, 0, 0, devMmap_, TEST_TIMEOUT};
+    ScsiPeripheral_Response response = {{0}};
+    ASSERT_EQ(OH_ScsiPeripheral_Write10(dev_, &request, &response), SCSIPERIPHERAL_DDK_SUCCESS);
+    EXPECT_EQ(response.status, SCSIPERIPHERAL_STATUS_GOOD);
+    EXPECT_EQ(fakeDdk_->ReadBlocks(TEST_DEVICE_ID, 16, TEST_IO_BLOCKS), written);
+
+    (void)memset(devMmap_->address, 0, devMmap_->size);
+    ASSERT_EQ(OH_ScsiPeripheral_Read10(dev_, &request, &response), SCSIPERIPHERAL_DDK_SUCCESS);
+    EXPECT_EQ(response.status, SCSIPERIPHERAL_STATUS_GOOD);
+    EXPECT_EQ(devMmap_->transferredLength, TEST_IO_BLOCKS * TEST_BLOCK_SIZE);
+    EXPECT_EQ(vector<uint8_t>(devMmap_->address, devMmap_->address + devMmap_->size), written);
+}
+
+HWTEST_F(FakeScsiPeripheralDdkTest, CapacityAndInquiryTest, TestSize.Level1)
+{
+    ScsiPeripheral_ReadCapacityRequest capacityRequest = {0, 0, 0, TEST_TIMEOUT};
+    ScsiPeripheral_CapacityInfo capacityInfo = {0};
+    ScsiPeripheral_Response response = {{0}};
+    ASSERT_EQ(OH_ScsiPeripheral_ReadCapacity10(dev_, &capacityRequest, &capacityInfo, &response),
+        SCSIPERIPHERAL_DDK_SUCCESS);
+    EXPECT_EQ(capacityInfo.lbAddress, TEST_BLOCK_COUNT - 1);
+    EXPECT_EQ(capacityInfo.lbLength, TEST_BLOCK_SIZE);
+
+    ScsiPeripheral_InquiryRequest inquiryRequest = {0, TEST_INQUIRY_LENGTH, 0, 0, TEST_TIMEOUT};
+    ScsiPeripheral_InquiryInfo inquiryInfo = {0};
+    inquiryInfo.data = devMmap_;
+    ASSERT_EQ(OH_ScsiPeripheral_Inquiry(dev_, &inquiryRequest, &inquiryInfo, &response), SCSIPERIPHERAL_DDK_SUCCESS);
+    EXPECT_EQ(strncmp(inquiryInfo.idVendor, "FAKE", strlen("FAKE")), 0);
+}
+
+HWTEST_F(FakeScsiPeripheralDdkTest, CheckConditionTest, TestSize.Level1)
+{
+    ScsiPeripheral_IORequest request = {TEST_BLOCK_COUNT - 1, TEST_IO_BLOCKS, 0, 0, 0, devMmap_, TEST_TIMEOUT};
+    ScsiPeripheral_Response response = {{0}};
+    ASSERT_EQ(OH_ScsiPeripheral_Read10(dev_, &request, &response), SCSIPERIPHERAL_DDK_SUCCESS);
+    EXPECT_EQ(response.status, SCSIPERIPHERAL_STATUS_CHECK_CONDITION_NEEDED);
+    EXPECT_EQ(response.senseData[TEST_SENSE_KEY_BYTE], TEST_SENSE_KEY_ILLEGAL_REQUEST);
+    EXPECT_EQ(response.senseData[TEST_SENSE_ASC_BYTE], TEST_ASC_LBA_OUT_OF_RANGE);
+
+    ScsiPeripheral_Request cdbRequest = {{TEST_UNKNOWN_OPCODE}, TEST_CDB_LENGTH, TEST_DXFER_NONE, devMmap_,
+        TEST_TIMEOUT};
+    ASSERT_EQ(OH_ScsiPeripheral_SendRequestByCdb(dev_, &cdbRequest, &response), SCSIPERIPHERAL_DDK_SUCCESS);
+    EXPECT_EQ(response.status, SCSIPERIPHERAL_STATUS_CHECK_CONDITION_NEEDED);
+    EXPECT_EQ(response.senseData[TEST_SENSE_ASC_BYTE], TEST_ASC_INVALID_OPCODE);
+
+    fakeDdk_->SetReady(TEST_DEVICE_ID, false);
+    ScsiPeripheral_TestUnitReadyRequest readyRequest = {0, TEST_TIMEOUT};
+    ASSERT_EQ(OH_ScsiPeripheral_TestUnitReady(dev_, &readyRequest, &response), SCSIPERIPHERAL_DDK_SUCCESS);
+    EXPECT_EQ(response.status, SCSIPERIPHERAL_STATUS_CHECK_CONDITION_NEEDED);
+    EXPECT_EQ(response.senseData[TEST_SENSE_KEY_BYTE], TEST_SENSE_KEY_NOT_READY);
+}
+
+HWTEST_F(FakeScsiPeripheralDdkTest, ErrorInjectionTest, TestSize.Level1)
+{
+    ScsiPeripheral_IORequest request = {0, 1, 0, 0, 0, devMmap_, TEST_TIMEOUT};
+    ScsiPeripheral_Response response = {{0}};
+    fakeDdk_->InjectError("Read10", SCSIPERIPHERAL_DDK_IO_ERROR, 2);
+    EXPECT_EQ(OH_ScsiPeripheral_Read10(dev_, &request, &response), SCSIPERIPHERAL_DDK_IO_ERROR);
+    EXPECT_EQ(OH_ScsiPeripheral_Read10(dev_, &request, &response), SCSIPERIPHERAL_DDK_IO_ERROR);
+    EXPECT_EQ(OH_ScsiPeripheral_Read10(dev_, &request, &response), SCSIPERIPHERAL_DDK_SUCCESS);
+    EXPECT_EQ(fakeDdk_->GetCallCount("Read10"), 3);
+}
+
+// each thread owns a device handle and a block range, with service latency the commands overlap
+HWTEST_F(FakeScsiPeripheralDdkTest, ConcurrentIoTest, TestSize.Level1)
+{
+    fakeDdk_->SetLatency(TEST_LATENCY);
+    atomic<uint32_t> failures {0};
+    vector<thread> threads;
+    auto begin = chrono::steady_clock::now();
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        threads.emplace_back([&failures, i]() {
+            ScsiPeripheral_Device *dev = nullptr;
+            ScsiPeripheral_DeviceMemMap *devMmap = nullptr;
+            if (OH_ScsiPeripheral_Open(TEST_DEVICE_ID, 0, &dev) != SCSIPERIPHERAL_DDK_SUCCESS ||
+                OH_ScsiPeripheral_CreateDeviceMemMap(dev, TEST_BLOCK_SIZE, &devMmap) != SCSIPERIPHERAL_DDK_SUCCESS) {
+                failures++;
+                return;
+            }
+            (void)memset(devMmap->address, static_cast<int>(i + 1), devMmap->size);
+            ScsiPeripheral_IORequest request = {i, 1, 0, 0, 0, devMmap, TEST_TIMEOUT};
+            ScsiPeripheral_Response response = {{0}};
+            for (uint32_t j = 0; j < TEST_IO_PER_THREAD; ++j) {
+                if (OH_ScsiPeripheral_Write10(dev, &request, &response) != SCSIPERIPHERAL_DDK_SUCCESS ||
+                    response.status != SCSIPERIPHERAL_STATUS_GOOD) {
+                    failures++;
+                }
+            }
+            (void)OH_ScsiPeripheral_DestroyDeviceMemMap(devMmap);
+            (void)OH_ScsiPeripheral_Close(&dev);
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    auto elapsed = chrono::steady_clock::now() - begin;
+    EXPECT_EQ(failures.load(), 0);
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        EXPECT_EQ(fakeDdk_->ReadBlocks(TEST_DEVICE_ID, i, 1), vector<uint8_t>(TEST_BLOCK_SIZE, i + 1));
+    }
+    EXPECT_LT(elapsed, TEST_LATENCY * TEST_THREAD_NUM * TEST_IO_PER_THREAD);
+}
+} // namespace
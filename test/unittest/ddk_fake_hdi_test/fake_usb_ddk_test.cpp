@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "ddk_api.h"
+#include "fake_usb_ddk.h"
+#include "usb_ddk_api.h"
+#include "usb_ddk_types.h"
+
+using namespace std;
+using namespace testing::ext;
+using namespace OHOS::ExternalDeviceManager;
+
+namespace {
+constexpr uint64_t TEST_DEVICE_ID = 0x100000001;
+constexpr uint16_t TEST_VENDOR_ID = 0x12D1;
+constexpr uint16_t TEST_PRODUCT_ID = 0x5678;
+constexpr uint8_t TEST_ENDPOINT_IN = 0x81;
+constexpr uint8_t TEST_ENDPOINT_OUT = 0x01;
+constexpr uint32_t TEST_TIMEOUT = 1000;
+constexpr size_t TEST_MEMMAP_SIZE = 4096;
+constexpr uint32_t TEST_POOL_BLOCK_SIZE = 1024;
+constexpr uint32_t TEST_POOL_BLOCK_COUNT = 4;
+constexpr uint8_t TEST_ASHMEM_MAP_READ_WRITE = 0x03;
+constexpr uint8_t TEST_VENDOR_REQUEST = 0x01;
+constexpr uint8_t TEST_REQUEST_TYPE_IN = 0xC0;
+constexpr uint8_t TEST_REQUEST_TYPE_OUT = 0x40;
+constexpr uint8_t TEST_GET_DESCRIPTOR = 0x06;
+constexpr uint16_t TEST_DEVICE_DESCRIPTOR_VALUE = 0x0100;
+constexpr uint16_t TEST_DEVICE_DESCRIPTOR_LENGTH = 18;
+constexpr auto TEST_LATENCY = chrono::milliseconds(20);
+constexpr uint32_t TEST_THREAD_NUM = 8;
+constexpr uint32_t TEST_TRANSFERS_PER_THREAD = 200;
+
+// one interface with a bulk in and a bulk out endpoint
+const vector<uint8_t> TEST_CONFIG_DESCRIPTOR = {
+    0x09, 0x02, 0x20, 0x00, 0x01, 0x01, 0x00, 0x80, 0x32,
+    0x09, 0x04, 0x00, 0x00, 0x02, 0xFF, 0x00, 0x00, 0x00,
+    0x07, 0x05, TEST_ENDPOINT_IN, 0x02, 0x00, 0x02, 0x00,
+    0x07, 0x05, TEST_ENDPOINT_OUT, 0x02, 0x00, 0x02, 0x00,
+};
+
+class FakeUsbDdkTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        fakeDdk_ = OHOS::sptr<FakeUsbDdk>::MakeSptr();
+        UsbDdkHdi::UsbDeviceDescriptor desc = {};
+        desc.bLength = TEST_DEVICE_DESCRIPTOR_LENGTH;
+        desc.idVendor = TEST_VENDOR_ID;
+        desc.idProduct = TEST_PRODUCT_ID;
+        desc.bNumConfigurations = 1;
+        fakeDdk_->AddDevice(TEST_DEVICE_ID, desc, TEST_CONFIG_DESCRIPTOR);
+        auto fakeDdk = fakeDdk_;
+        SetDdkFactory([fakeDdk]() { return OHOS::sptr<UsbDdkHdi::IUsbDdk>(fakeDdk); });
+        ASSERT_EQ(OH_Usb_Init(), USB_DDK_SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        OH_Usb_Release();
+        SetDdkFactory(nullptr);
+        fakeDdk_ = nullptr;
+    }
+
+protected:
+    OHOS::sptr<FakeUsbDdk> fakeDdk_;
+};
+
+HWTEST_F(FakeUsbDdkTest, InitThroughFactoryTest, TestSize.Level1)
+{
+    EXPECT_TRUE(fakeDdk_->IsInitialized());
+    EXPECT_EQ(fakeDdk_->GetCallCount("Init"), 1);
+    UsbDeviceDescriptor desc = {};
+    ASSERT_EQ(OH_Usb_GetDeviceDescriptor(TEST_DEVICE_ID, &desc), USB_DDK_SUCCESS);
+    EXPECT_EQ(desc.idVendor, TEST_VENDOR_ID);
+    EXPECT_EQ(desc.idProduct, TEST_PRODUCT_ID);
+}
+
+HWTEST_F(FakeUsbDdkTest, GetConfigDescriptorTest, TestSize.Level1)
+{
+    UsbDdkConfigDescriptor *config = nullptr;
+    ASSERT_EQ(OH_Usb_GetConfigDescriptor(TEST_DEVICE_ID, 0, &config), USB_DDK_SUCCESS);
+    ASSERT_NE(config, nullptr);
+    EXPECT_EQ(config->configDescriptor.bNumInterfaces, 1);
+    EXPECT_EQ(config->configDescriptor.wTotalLength, TEST_CONFIG_DESCRIPTOR.size());
+    OH_Usb_FreeConfigDescriptor(config);
+}
+
+HWTEST_F(FakeUsbDdkTest, PipeLoopbackTest, TestSize.Level1)
+{
+    uint64_t interfaceHandle = 0;
+    ASSERT_EQ(OH_Usb_ClaimInterface(TEST_DEVICE_ID, 0, &interfaceHandle), USB_DDK_SUCCESS);
+    UsbDeviceMemMap *devMmap = nullptr;
+    ASSERT_EQ(OH_Usb_CreateDeviceMemMap(TEST_DEVICE_ID, TEST_MEMMAP_SIZE, &devMmap), USB_DDK_SUCCESS);
+    ASSERT_NE(devMmap, nullptr);
+
+    for (size_t i = 0; i < TEST_MEMMAP_SIZE; ++i) {
+        devMmap->address[i] = static_cast<uint8_t>(i);
+    }
+    devMmap->bufferLength = TEST_MEMMAP_SIZE;
+    UsbRequestPipe pipe = {interfaceHandle, TEST_TIMEOUT, TEST_ENDPOINT_OUT};
+    ASSERT_EQ(OH_Usb_SendPipeRequest(&pipe, devMmap), USB_DDK_SUCCESS);
+    EXPECT_EQ(devMmap->transferedLength, TEST_MEMMAP_SIZE);
+    vector<uint8_t> written = fakeDdk_->PopOutData(TEST_DEVICE_ID);
+    EXPECT_EQ(written, vector<uint8_t>(devMmap->address, devMmap->address + TEST_MEMMAP_SIZE));
+
+    // the device answers the next IN transfer with what the test side queued
+    fakeDdk_->PushInData(TEST_DEVICE_ID, {0xAA, 0xBB, 0xCC});
+    pipe.endpoint = TEST_ENDPOINT_IN;
+    ASSERT_EQ(OH_Usb_SendPipeRequest(&pipe, devMmap), USB_DDK_SUCCESS);
+    ASSERT_EQ(devMmap->transferedLength, 3);
+    EXPECT_EQ(devMmap->address[0], 0xAA);
+    EXPECT_EQ(devMmap->address[2], 0xCC);
+
+    OH_Usb_DestroyDeviceMemMap(devMmap);
+    EXPECT_EQ(OH_Usb_ReleaseInterface(interfaceHandle), USB_DDK_SUCCESS);
+}
+
+// a pool buffer moves only its own part of the pool
+HWTEST_F(FakeUsbDdkTest, AshmemPoolBufferTest, TestSize.Level1)
+{
+    uint64_t interfaceHandle = 0;
+    ASSERT_EQ(OH_Usb_ClaimInterface(TEST_DEVICE_ID, 0, &interfaceHandle), USB_DDK_SUCCESS);
+    DDK_AshmemPool *pool = nullptr;
+    ASSERT_EQ(OH_DDK_CreateAshmemPool(reinterpret_cast<const uint8_t *>("fake_usb_pool"), TEST_POOL_BLOCK_SIZE,
+        TEST_POOL_BLOCK_COUNT, TEST_ASHMEM_MAP_READ_WRITE, &pool), DDK_SUCCESS);
+    DDK_Ashmem *first = nullptr;
+    DDK_Ashmem *second = nullptr;
+    ASSERT_EQ(OH_DDK_AllocAshmemBuffer(pool, TEST_POOL_BLOCK_SIZE, &first), DDK_SUCCESS);
+    ASSERT_EQ(OH_DDK_AllocAshmemBuffer(pool, TEST_POOL_BLOCK_SIZE, &second), DDK_SUCCESS);
+    ASSERT_NE(second->offset, first->offset);
+
+    auto data = const_cast<uint8_t *>(second->address) + second->offset;
+    for (uint32_t i = 0; i < second->bufferLength; ++i) {
+        data[i] = static_cast<uint8_t>(i * 3);
+    }
+    UsbRequestPipe pipe = {interfaceHandle, TEST_TIMEOUT, TEST_ENDPOINT_OUT};
+    ASSERT_EQ(OH_Usb_SendPipeRequestWithAshmem(&pipe, second), USB_DDK_SUCCESS);
+    EXPECT_EQ(second->transferredLength, TEST_POOL_BLOCK_SIZE);
+    EXPECT_EQ(fakeDdk_->PopOutData(TEST_DEVICE_ID), vector<uint8_t>(data, data + second->bufferLength));
+
+    fakeDdk_->PushInData(TEST_DEVICE_ID, {0xAA, 0xBB});
+    pipe.endpoint = TEST_ENDPOINT_IN;
+    ASSERT_EQ(OH_Usb_SendPipeRequestWithAshmem(&pipe, first), USB_DDK_SUCCESS);
+    ASSERT_EQ(first->transferredLength, 2);
+    EXPECT_EQ(first->address[first->offset], 0xAA);
+    EXPECT_EQ(data[1], 3);
+
+    EXPECT_EQ(OH_DDK_FreeAshmemBuffer(pool, first), DDK_SUCCESS);
+    EXPECT_EQ(OH_DDK_FreeAshmemBuffer(pool, second), DDK_SUCCESS);
+    EXPECT_EQ(OH_DDK_DestroyAshmemPool(pool), DDK_SUCCESS);
+    EXPECT_EQ(OH_Usb_ReleaseInterface(interfaceHandle), USB_DDK_SUCCESS);
+}
+
+HWTEST_F(FakeUsbDdkTest, ControlTransferTest, TestSize.Level1)
+{
+    vector<uint8_t> data = {1, 2, 3, 4};
+    UsbControlRequestSetup setup = {TEST_REQUEST_TYPE_OUT, TEST_VENDOR_REQUEST, 0, 0,
+        static_cast<uint16_t>(data.size())};
+    ASSERT_GE(OH_Usb_ControlTransfer(TEST_DEVICE_ID, &setup, data.data(), TEST_TIMEOUT), 0);
+
+    vector<uint8_t> readBack(data.size());
+    setup.bmRequestType = TEST_REQUEST_TYPE_IN;
+    EXPECT_EQ(OH_Usb_ControlTransfer(TEST_DEVICE_ID, &setup, readBack.data(), TEST_TIMEOUT),
+        static_cast<int32_t>(data.size()));
+    EXPECT_EQ(readBack, data);
+
+    vector<uint8_t> desc(TEST_DEVICE_DESCRIPTOR_LENGTH);
+    setup = {0x80, TEST_GET_DESCRIPTOR, TEST_DEVICE_DESCRIPTOR_VALUE, 0, TEST_DEVICE_DESCRIPTOR_LENGTH};
+    EXPECT_EQ(OH_Usb_ControlTransfer(TEST_DEVICE_ID, &setup, desc.data(), TEST_TIMEOUT),
+        TEST_DEVICE_DESCRIPTOR_LENGTH);
+    EXPECT_EQ(desc[0], TEST_DEVICE_DESCRIPTOR_LENGTH);
+}
+
+HWTEST_F(FakeUsbDdkTest, ErrorInjectionTest, TestSize.Level1)
+{
+    uint64_t interfaceHandle = 0;
+    fakeDdk_->InjectError("ClaimInterface", HDF_ERR_NOPERM, 1);
+    EXPECT_EQ(OH_Usb_ClaimInterface(TEST_DEVICE_ID, 0, &interfaceHandle), USB_DDK_NO_PERM);
+    ASSERT_EQ(OH_Usb_ClaimInterface(TEST_DEVICE_ID, 0, &interfaceHandle), USB_DDK_SUCCESS);
+
+    UsbDeviceMemMap *devMmap = nullptr;
+    ASSERT_EQ(OH_Usb_CreateDeviceMemMap(TEST_DEVICE_ID, TEST_MEMMAP_SIZE, &devMmap), USB_DDK_SUCCESS);
+    devMmap->bufferLength = TEST_MEMMAP_SIZE;
+    UsbRequestPipe pipe = {interfaceHandle, TEST_TIMEOUT, TEST_ENDPOINT_IN};
+    fakeDdk_->InjectError("SendPipeRequest", HDF_ERR_TIMEOUT);
+    EXPECT_EQ(OH_Usb_SendPipeRequest(&pipe, devMmap), USB_DDK_TIMEOUT);
+    EXPECT_EQ(OH_Usb_SendPipeRequest(&pipe, devMmap), USB_DDK_TIMEOUT);
+    fakeDdk_->ClearErrors();
+    EXPECT_EQ(OH_Usb_SendPipeRequest(&pipe, devMmap), USB_DDK_SUCCESS);
+    EXPECT_EQ(fakeDdk_->GetCallCount("SendPipeRequest"), 3);
+    OH_Usb_DestroyDeviceMemMap(devMmap);
+}
+
+HWTEST_F(FakeUsbDdkTest, LatencyTest, TestSize.Level1)
+{
+    fakeDdk_->SetLatency("GetDeviceDescriptor", TEST_LATENCY);
+    UsbDeviceDescriptor desc = {};
+    auto begin = chrono::steady_clock::now();
+    ASSERT_EQ(OH_Usb_GetDeviceDescriptor(TEST_DEVICE_ID, &desc), USB_DDK_SUCCESS);
+    EXPECT_GE(chrono::steady_clock::now() - begin, TEST_LATENCY);
+}
+
+// transfers of several threads overlap in the service and all of them arrive
+HWTEST_F(FakeUsbDdkTest, ConcurrentControlTransferTest, TestSize.Level1)
+{
+    atomic<uint32_t> failures {0};
+    vector<thread> threads;
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        threads.emplace_back([&failures, i]() {
+            uint8_t value = static_cast<uint8_t>(i);
+            UsbControlRequestSetup setup = {TEST_REQUEST_TYPE_OUT, TEST_VENDOR_REQUEST, static_cast<uint16_t>(i), 0, 1};
+            for (uint32_t j = 0; j < TEST_TRANSFERS_PER_THREAD; ++j) {
+                if (OH_Usb_ControlTransfer(TEST_DEVICE_ID, &setup, &value, TEST_TIMEOUT) < 0) {
+                    failures++;
+                }
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(fakeDdk_->GetCallCount("ControlTransfer"), TEST_THREAD_NUM * TEST_TRANSFERS_PER_THREAD);
+}
+} // namespace
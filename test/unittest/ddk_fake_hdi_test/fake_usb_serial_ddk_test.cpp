@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <poll.h>
+#include <thread>
+#include <vector>
+#include "fake_usb_serial_ddk.h"
+#include "usb_serial_api.h"
+
+using namespace std;
+using namespace testing::ext;
+using namespace OHOS::ExternalDeviceManager;
+
+namespace {
+constexpr uint64_t TEST_DEVICE_ID = 0x100000001;
+constexpr uint32_t TEST_BAUDRATE = 115200;
+constexpr uint8_t TEST_DATA_BITS = 8;
+constexpr int32_t TEST_READ_TIMEOUT_MS = 50;
+constexpr int32_t TEST_POLL_TIMEOUT_MS = 2000;
+constexpr uint32_t TEST_CHUNK_SIZE = 4096;
+constexpr uint32_t TEST_STREAM_SIZE = 1024 * 1024;
+
+class FakeUsbSerialDdkTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        fakeDdk_ = OHOS::sptr<FakeUsbSerialDdk>::MakeSptr();
+        fakeDdk_->AddPort(TEST_DEVICE_ID);
+        auto fakeDdk = fakeDdk_;
+        SetDdkFactory([fakeDdk]() { return OHOS::sptr<UsbSerialDdkHdi::IUsbSerialDdk>(fakeDdk); });
+        ASSERT_EQ(OH_UsbSerial_Init(), USB_SERIAL_DDK_SUCCESS);
+        ASSERT_EQ(OH_UsbSerial_Open(TEST_DEVICE_ID, 0, &dev_), USB_SERIAL_DDK_SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        if (dev_ != nullptr) {
+            (void)OH_UsbSerial_Close(&dev_);
+        }
+        (void)OH_UsbSerial_Release();
+        SetDdkFactory(nullptr);
+        fakeDdk_ = nullptr;
+    }
+
+protected:
+    OHOS::sptr<FakeUsbSerialDdk> fakeDdk_;
+    UsbSerial_Device *dev_ = nullptr;
+};
+
+HWTEST_F(FakeUsbSerialDdkTest, LoopbackTest, TestSize.Level1)
+{
+    vector<uint8_t> data = {'h', 'e', 'l', 'l', 'o'};
+    uint32_t bytesWritten = 0;
+    ASSERT_EQ(OH_UsbSerial_Write(dev_, data.data(), data.size(), &bytesWritten), USB_SERIAL_DDK_SUCCESS);
+    EXPECT_EQ(bytesWritten, data.size());
+    EXPECT_EQ(fakeDdk_->PopTxData(TEST_DEVICE_ID), data);
+
+    vector<uint8_t> buff(TEST_CHUNK_SIZE);
+    uint32_t bytesRead = 0;
+    ASSERT_EQ(OH_UsbSerial_Read(dev_, buff.data(), buff.size(), &bytesRead), USB_SERIAL_DDK_SUCCESS);
+    ASSERT_EQ(bytesRead, data.size());
+    EXPECT_EQ(vector<uint8_t>(buff.begin(), buff.begin() + bytesRead), data);
+}
+
+HWTEST_F(FakeUsbSerialDdkTest, ParamsTest, TestSize.Level1)
+{
+    UsbSerial_Params params = {TEST_BAUDRATE, TEST_DATA_BITS, 1, 0};
+    ASSERT_EQ(OH_UsbSerial_SetParams(dev_, &params), USB_SERIAL_DDK_SUCCESS);
+    UsbSerialDdkHdi::UsbSerialParams stored = {};
+    ASSERT_TRUE(fakeDdk_->GetParams(TEST_DEVICE_ID, stored));
+    EXPECT_EQ(stored.baudRate, TEST_BAUDRATE);
+    EXPECT_EQ(stored.nDataBits, TEST_DATA_BITS);
+    EXPECT_EQ(OH_UsbSerial_SetBaudRate(dev_, 0), USB_SERIAL_DDK_INVALID_PARAMETER);
+}
+
+HWTEST_F(FakeUsbSerialDdkTest, ReadTimeoutTest, TestSize.Level1)
+{
+    ASSERT_EQ(OH_UsbSerial_SetTimeout(dev_, TEST_READ_TIMEOUT_MS), USB_SERIAL_DDK_SUCCESS);
+    vector<uint8_t> buff(TEST_CHUNK_SIZE);
+    uint32_t bytesRead = 1;
+    auto begin = chrono::steady_clock::now();
+    ASSERT_EQ(OH_UsbSerial_Read(dev_, buff.data(), buff.size(), &bytesRead), USB_SERIAL_DDK_SUCCESS);
+    EXPECT_GE(chrono::steady_clock::now() - begin, chrono::milliseconds(TEST_READ_TIMEOUT_MS));
+    EXPECT_EQ(bytesRead, 0);
+
+    // data arriving while the read waits ends the wait
+    thread pusher([this]() { fakeDdk_->PushRxData(TEST_DEVICE_ID, {0x55}); });
+    ASSERT_EQ(OH_UsbSerial_SetTimeout(dev_, TEST_POLL_TIMEOUT_MS), USB_SERIAL_DDK_SUCCESS);
+    ASSERT_EQ(OH_UsbSerial_Read(dev_, buff.data(), buff.size(), &bytesRead), USB_SERIAL_DDK_SUCCESS);
+    pusher.join();
+    EXPECT_EQ(bytesRead, 1);
+}
+
+HWTEST_F(FakeUsbSerialDdkTest, ErrorInjectionTest, TestSize.Level1)
+{
+    uint8_t data = 0;
+    uint32_t bytesWritten = 0;
+    fakeDdk_->InjectError("Write", USB_SERIAL_DDK_IO_ERROR, 1);
+    EXPECT_EQ(OH_UsbSerial_Write(dev_, &data, sizeof(data), &bytesWritten), USB_SERIAL_DDK_IO_ERROR);
+    EXPECT_EQ(OH_UsbSerial_Write(dev_, &data, sizeof(data), &bytesWritten), USB_SERIAL_DDK_SUCCESS);
+
+    UsbSerial_Device *other = nullptr;
+    fakeDdk_->InjectError("Open", USB_SERIAL_DDK_DEVICE_NOT_FOUND);
+    EXPECT_EQ(OH_UsbSerial_Open(TEST_DEVICE_ID, 0, &other), USB_SERIAL_DDK_DEVICE_NOT_FOUND);
+    EXPECT_EQ(fakeDdk_->GetCallCount("Write"), 2);
+}
+
+// a writer thread streams through the loopback while the reader waits on the read event fd
+HWTEST_F(FakeUsbSerialDdkTest, ReadEventStreamTest, TestSize.Level1)
+{
+    int32_t eventFd = -1;
+    ASSERT_EQ(OH_UsbSerial_StartReadEvent(dev_, &eventFd), USB_SERIAL_DDK_SUCCESS);
+    thread writer([this]() {
+        vector<uint8_t> chunk(TEST_CHUNK_SIZE);
+        for (uint32_t sent = 0; sent < TEST_STREAM_SIZE; sent += TEST_CHUNK_SIZE) {
+            for (uint32_t i = 0; i < TEST_CHUNK_SIZE; ++i) {
+                chunk[i] = static_cast<uint8_t>(sent + i);
+            }
+            uint32_t bytesWritten = 0;
+            (void)OH_UsbSerial_Write(dev_, chunk.data(), chunk.size(), &bytesWritten);
+        }
+    });
+
+    vector<uint8_t> buff(TEST_CHUNK_SIZE);
+    uint32_t received = 0;
+    bool ordered = true;
+    while (received < TEST_STREAM_SIZE) {
+        struct pollfd pfd = {eventFd, POLLIN, 0};
+        if (poll(&pfd, 1, TEST_POLL_TIMEOUT_MS) <= 0) {
+            break;
+        }
+        uint32_t bytesRead = 0;
+        if (OH_UsbSerial_Read(dev_, buff.data(), buff.size(), &bytesRead) != USB_SERIAL_DDK_SUCCESS) {
+            break;
+        }
+        for (uint32_t i = 0; i < bytesRead; ++i) {
+            ordered = ordered && buff[i] == static_cast<uint8_t>(received + i);
+        }
+        received += bytesRead;
+    }
+    writer.join();
+    EXPECT_EQ(received, TEST_STREAM_SIZE);
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(OH_UsbSerial_StopReadEvent(dev_), USB_SERIAL_DDK_SUCCESS);
+}
+} // namespace
@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <poll.h>
+#include <string>
+#include <thread>
+#include "hid_ddk_api.h"
+#include "hid_ddk_types.h"
+#include "v1_1/ihid_ddk.h"
+
+using namespace std;
+using namespace testing::ext;
+using namespace OHOS::HDI::Input::Ddk::V1_1;
+namespace HidV1_0 = OHOS::HDI::Input::Ddk::V1_0;
+
+void SetDdk(OHOS::sptr<IHidDdk> &);
+extern "C" Hid_DeviceHandle *NewHidDeviceHandle(void);
+extern "C" void DeleteHidDeviceHandle(Hid_DeviceHandle **dev);
+
+namespace {
+constexpr uint32_t HID_BENCH_DEVICE_NUM = 4;
+constexpr uint32_t HID_BENCH_EMIT_TIMES = 5000;
+constexpr uint16_t HID_BENCH_ITEM_NUM = 3;
+constexpr double HID_BENCH_PERCENTILE = 0.99;
+constexpr uint32_t HID_REPORT_SIZE = 8;
+constexpr uint32_t HID_BENCH_REPORT_NUM = 20000;
+constexpr uint32_t HID_BENCH_DRAIN_REPORTS = 64;
+constexpr int32_t HID_POLL_TIMEOUT_MS = 2000;
+constexpr auto HID_IDLE_READ_BLOCK = std::chrono::milliseconds(100);
+
+class MockHidDdk : public IHidDdk {
+public:
+    MOCK_METHOD(int32_t, CreateDevice, (const HidV1_0::Hid_Device &hidDevice,
+        const HidV1_0::Hid_EventProperties &hidEventProperties, uint32_t &deviceId), (override));
+    MOCK_METHOD(int32_t, EmitEvent, (uint32_t deviceId,
+        const vector<HidV1_0::Hid_EmitItem> &items), (override));
+    MOCK_METHOD(int32_t, DestroyDevice, (uint32_t deviceId), (override));
+    MOCK_METHOD(int32_t, Init, (), (override));
+    MOCK_METHOD(int32_t, Release, (), (override));
+    MOCK_METHOD(int32_t, Open, (uint64_t deviceId, uint8_t interfaceIndex, HidDeviceHandle &dev), (override));
+    MOCK_METHOD(int32_t, Close, (const HidDeviceHandle &dev), (override));
+    MOCK_METHOD(int32_t, Write, (const HidDeviceHandle &dev, const vector<uint8_t> &data, uint32_t &bytesWritten),
+        (override));
+    MOCK_METHOD(int32_t, ReadTimeout, (const HidDeviceHandle &dev, vector<uint8_t> &data, uint32_t buffSize,
+        int32_t timeout, uint32_t &bytesRead), (override));
+    MOCK_METHOD(int32_t, SetNonBlocking, (const HidDeviceHandle &dev, int32_t nonBlock), (override));
+    MOCK_METHOD(int32_t, GetRawInfo, (const HidDeviceHandle &dev, HidRawDevInfo &rawDevInfo), (override));
+    MOCK_METHOD(int32_t, GetRawName, (const HidDeviceHandle &dev, vector<uint8_t> &data, uint32_t buffSize),
+        (override));
+    MOCK_METHOD(int32_t, GetPhysicalAddress, (const HidDeviceHandle &dev, vector<uint8_t> &data, uint32_t buffSize),
+        (override));
+    MOCK_METHOD(int32_t, GetRawUniqueId, (const HidDeviceHandle &dev, vector<uint8_t> &data, uint32_t buffSize),
+        (override));
+    MOCK_METHOD(int32_t, SendReport, (const HidDeviceHandle &dev, HidReportType reportType,
+        const vector<uint8_t> &data), (override));
+    MOCK_METHOD(int32_t, GetReport, (const HidDeviceHandle &dev, HidReportType reportType, uint8_t reportNumber,
+        vector<uint8_t> &data, uint32_t buffSize), (override));
+    MOCK_METHOD(int32_t, GetReportDescriptor, (const HidDeviceHandle &dev, vector<uint8_t> &buf, uint32_t buffSize,
+        uint32_t &bytesRead), (override));
+};
+
+class HidDdkTest : public testing::Test {
+public:
+    void TearDown() override
+    {
+        OHOS::sptr<IHidDdk> ddk = nullptr;
+        SetDdk(ddk);
+    }
+};
+
+HWTEST_F(HidDdkTest, EmitEventParamTest, TestSize.Level1)
+{
+    auto mockDdk = OHOS::sptr<MockHidDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    EXPECT_CALL(*mockDdk, EmitEvent(testing::_, testing::_)).Times(0);
+    auto ddk = OHOS::sptr<IHidDdk>(mockDdk);
+    SetDdk(ddk);
+    Hid_EmitItem items[] = {{0, 0, 0}};
+    ASSERT_EQ(OH_Hid_EmitEvent(-1, items, 1), HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_EmitEvent(0, nullptr, 1), HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_EmitEvent(0, items, UINT16_MAX), HID_DDK_INVALID_PARAMETER);
+}
+
+HWTEST_F(HidDdkTest, EmitEventItemsTest, TestSize.Level1)
+{
+    auto mockDdk = OHOS::sptr<MockHidDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    Hid_EmitItem items[] = {{1, 330, 1}, {3, 0, 100}, {0, 0, 0}};
+    vector<HidV1_0::Hid_EmitItem> received;
+    EXPECT_CALL(*mockDdk, EmitEvent(testing::_, testing::_))
+        .WillOnce(testing::DoAll(testing::SaveArg<1>(&received), testing::Return(HID_DDK_SUCCESS)));
+    auto ddk = OHOS::sptr<IHidDdk>(mockDdk);
+    SetDdk(ddk);
+    ASSERT_EQ(OH_Hid_EmitEvent(0, items, sizeof(items) / sizeof(items[0])), HID_DDK_SUCCESS);
+    ASSERT_EQ(received.size(), sizeof(items) / sizeof(items[0]));
+    for (size_t i = 0; i < received.size(); ++i) {
+        EXPECT_EQ(received[i].type, items[i].type);
+        EXPECT_EQ(received[i].code, items[i].code);
+        EXPECT_EQ(received[i].value, items[i].value);
+    }
+}
+
+HWTEST_F(HidDdkTest, EmitEventErrorTest, TestSize.Level1)
+{
+    auto mockDdk = OHOS::sptr<MockHidDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    EXPECT_CALL(*mockDdk, EmitEvent(testing::_, testing::_)).WillOnce(testing::Return(HID_DDK_FAILURE));
+    auto ddk = OHOS::sptr<IHidDdk>(mockDdk);
+    SetDdk(ddk);
+    Hid_EmitItem items[] = {{0, 0, 0}};
+    ASSERT_EQ(OH_Hid_EmitEvent(0, items, 1), HID_DDK_FAILURE);
+}
+
+HWTEST_F(HidDdkTest, EmitEventConcurrentBenchTest, TestSize.Level1)
+{
+    auto mockDdk = OHOS::sptr<MockHidDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    EXPECT_CALL(*mockDdk, EmitEvent(testing::_, testing::_)).WillRepeatedly(testing::Return(HID_DDK_SUCCESS));
+    auto ddk = OHOS::sptr<IHidDdk>(mockDdk);
+    SetDdk(ddk);
+
+    vector<vector<int64_t>> latencies(HID_BENCH_DEVICE_NUM);
+    vector<thread> emitters;
+    auto begin = chrono::steady_clock::now();
+    for (uint32_t dev = 0; dev < HID_BENCH_DEVICE_NUM; ++dev) {
+        emitters.emplace_back([dev, &latencies] {
+            // one touch frame: position, pressure, sync
+            Hid_EmitItem items[HID_BENCH_ITEM_NUM] = {{3, 53, dev}, {3, 58, 1}, {0, 0, 0}};
+            latencies[dev].reserve(HID_BENCH_EMIT_TIMES);
+            for (uint32_t i = 0; i < HID_BENCH_EMIT_TIMES; ++i) {
+                auto start = chrono::steady_clock::now();
+                int32_t ret = OH_Hid_EmitEvent(static_cast<int32_t>(dev), items, HID_BENCH_ITEM_NUM);
+                auto cost = chrono::steady_clock::now() - start;
+                EXPECT_EQ(ret, HID_DDK_SUCCESS);
+                latencies[dev].push_back(chrono::duration_cast<chrono::nanoseconds>(cost).count());
+            }
+        });
+    }
+    for (auto &emitter : emitters) {
+        emitter.join();
+    }
+    auto wall = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+
+    vector<int64_t> all;
+    for (auto &latency : latencies) {
+        all.insert(all.end(), latency.begin(), latency.end());
+    }
+    ASSERT_EQ(all.size(), HID_BENCH_DEVICE_NUM * HID_BENCH_EMIT_TIMES);
+    size_t p99Index = static_cast<size_t>(all.size() * HID_BENCH_PERCENTILE);
+    nth_element(all.begin(), all.begin() + p99Index, all.end());
+    double eventsPerSec = static_cast<double>(all.size()) * HID_BENCH_ITEM_NUM * std::nano::den / wall;
+    std::cout << "devices:" << HID_BENCH_DEVICE_NUM << " events/s:" << static_cast<uint64_t>(eventsPerSec)
+        << " p99 emit latency(ns):" << all[p99Index] << std::endl;
+}
+
+// produces `total` reports back to back, then behaves like an idle device whose read times out
+class ReportProducer {
+public:
+    explicit ReportProducer(uint32_t total) : total_(total) {}
+    int32_t operator()(const HidDeviceHandle &, vector<uint8_t> &data, uint32_t buffSize, int32_t,
+        uint32_t &bytesRead)
+    {
+        calls_++;
+        uint32_t index = produced_.load();
+        if (index >= total_) {
+            std::this_thread::sleep_for(HID_IDLE_READ_BLOCK);
+            bytesRead = 0;
+            return HID_DDK_TIMEOUT;
+        }
+        produced_++;
+        data.assign(HID_REPORT_SIZE, static_cast<uint8_t>(index));
+        bytesRead = std::min(buffSize, HID_REPORT_SIZE);
+        return HID_DDK_SUCCESS;
+    }
+    uint32_t Calls() const
+    {
+        return calls_.load();
+    }
+
+private:
+    uint32_t total_;
+    std::atomic<uint32_t> produced_ {0};
+    std::atomic<uint32_t> calls_ {0};
+};
+
+HWTEST_F(HidDdkTest, ReadEventParamTest, TestSize.Level1)
+{
+    auto mockDdk = OHOS::sptr<MockHidDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    auto ddk = OHOS::sptr<IHidDdk>(mockDdk);
+    SetDdk(ddk);
+    int32_t eventFd = -1;
+    auto dev = NewHidDeviceHandle();
+    ASSERT_EQ(OH_Hid_StartReadEvent(nullptr, HID_REPORT_SIZE, &eventFd), HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_StartReadEvent(dev, 0, &eventFd), HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_StartReadEvent(dev, HID_MAX_REPORT_BUFFER_SIZE + 1, &eventFd), HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_StartReadEvent(dev, HID_REPORT_SIZE, nullptr), HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_StopReadEvent(dev), HID_DDK_INVALID_OPERATION);
+    uint8_t data[HID_REPORT_SIZE];
+    uint32_t sizes[1];
+    uint32_t count = 0;
+    ASSERT_EQ(OH_Hid_ReadReports(dev, data, sizeof(data), sizes, 1, &count), HID_DDK_INVALID_OPERATION);
+    DeleteHidDeviceHandle(&dev);
+}
+
+HWTEST_F(HidDdkTest, ReadReportsTest, TestSize.Level1)
+{
+    auto mockDdk = OHOS::sptr<MockHidDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    constexpr uint32_t reportNum = 3;
+    ReportProducer producer(reportNum);
+    EXPECT_CALL(*mockDdk, ReadTimeout(testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillRepeatedly(testing::Invoke(std::ref(producer)));
+    auto ddk = OHOS::sptr<IHidDdk>(mockDdk);
+    SetDdk(ddk);
+    auto dev = NewHidDeviceHandle();
+    int32_t eventFd = -1;
+    ASSERT_EQ(OH_Hid_StartReadEvent(dev, HID_REPORT_SIZE, &eventFd), HID_DDK_SUCCESS);
+
+    uint8_t data[HID_REPORT_SIZE * reportNum];
+    uint32_t sizes[reportNum] = {0};
+    uint32_t received = 0;
+    struct pollfd pfd = {eventFd, POLLIN, 0};
+    while (received < reportNum) {
+        ASSERT_EQ(poll(&pfd, 1, HID_POLL_TIMEOUT_MS), 1);
+        uint32_t count = 0;
+        ASSERT_EQ(OH_Hid_ReadReports(dev, data + received * HID_REPORT_SIZE, sizeof(data) - received * HID_REPORT_SIZE,
+            sizes + received, reportNum - received, &count), HID_DDK_SUCCESS);
+        received += count;
+    }
+    for (uint32_t i = 0; i < reportNum; ++i) {
+        EXPECT_EQ(sizes[i], HID_REPORT_SIZE);
+        EXPECT_EQ(data[i * HID_REPORT_SIZE], i);
+    }
+    // drained: the fd is quiet and a plain read returns nothing without blocking
+    ASSERT_EQ(poll(&pfd, 1, 0), 0);
+    uint32_t bytesRead = UINT32_MAX;
+    ASSERT_EQ(OH_Hid_Read(dev, data, sizeof(data), &bytesRead), HID_DDK_SUCCESS);
+    ASSERT_EQ(bytesRead, 0U);
+    ASSERT_EQ(OH_Hid_StopReadEvent(dev), HID_DDK_SUCCESS);
+    DeleteHidDeviceHandle(&dev);
+}
+
+HWTEST_F(HidDdkTest, ReadReportsBenchTest, TestSize.Level1)
+{
+    auto mockDdk = OHOS::sptr<MockHidDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    ReportProducer producer(HID_BENCH_REPORT_NUM);
+    EXPECT_CALL(*mockDdk, ReadTimeout(testing::_, testing::_, testing::_, testing::_, testing::_))
+        .WillRepeatedly(testing::Invoke(std::ref(producer)));
+    auto ddk = OHOS::sptr<IHidDdk>(mockDdk);
+    SetDdk(ddk);
+    auto dev = NewHidDeviceHandle();
+    int32_t eventFd = -1;
+    ASSERT_EQ(OH_Hid_StartReadEvent(dev, HID_REPORT_SIZE, &eventFd), HID_DDK_SUCCESS);
+
+    vector<uint8_t> data(HID_REPORT_SIZE * HID_BENCH_DRAIN_REPORTS);
+    vector<uint32_t> sizes(HID_BENCH_DRAIN_REPORTS);
+    uint32_t received = 0;
+    uint32_t polls = 0;
+    uint32_t drains = 0;
+    struct pollfd pfd = {eventFd, POLLIN, 0};
+    auto begin = chrono::steady_clock::now();
+    while (received < HID_BENCH_REPORT_NUM) {
+        polls++;
+        ASSERT_EQ(poll(&pfd, 1, HID_POLL_TIMEOUT_MS), 1);
+        uint32_t count = 0;
+        drains++;
+        ASSERT_EQ(OH_Hid_ReadReports(dev, data.data(), data.size(), sizes.data(), sizes.size(), &count),
+            HID_DDK_SUCCESS);
+        received += count;
+    }
+    auto wall = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count();
+    ASSERT_EQ(OH_Hid_StopReadEvent(dev), HID_DDK_SUCCESS);
+    DeleteHidDeviceHandle(&dev);
+
+    double reportsPerSec = static_cast<double>(received) * std::nano::den / wall;
+    // consumer side syscalls: one poll and one drain call per wakeup, plus the eventfd reset done by the drain
+    double syscallsPerReport = static_cast<double>(polls + drains * 2) / received;
+    std::cout << "reports/s:" << static_cast<uint64_t>(reportsPerSec)
+        << " consumer syscalls/report:" << syscallsPerReport
+        << " hdi reads/report:" << static_cast<double>(producer.Calls()) / received << std::endl;
+}
+} // namespace
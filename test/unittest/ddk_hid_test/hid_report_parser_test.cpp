@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "hid_ddk_api.h"
+#include "hid_ddk_types.h"
+
+using namespace std;
+using namespace testing::ext;
+
+namespace {
+constexpr uint16_t USAGE_PAGE_GENERIC_DESKTOP = 0x01;
+constexpr uint16_t USAGE_PAGE_KEYBOARD = 0x07;
+constexpr uint16_t USAGE_PAGE_LED = 0x08;
+constexpr uint16_t USAGE_PAGE_BUTTON = 0x09;
+constexpr uint16_t USAGE_PAGE_CONSUMER = 0x0C;
+constexpr uint16_t USAGE_X = 0x30;
+constexpr uint16_t USAGE_Y = 0x31;
+constexpr uint16_t USAGE_HAT_SWITCH = 0x39;
+constexpr uint32_t MAX_VALUES = 64;
+
+// boot protocol mouse, HID 1.11 appendix E.10
+const vector<uint8_t> MOUSE_DESCRIPTOR = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x09, 0x01, 0xA1, 0x00, 0x05, 0x09, 0x19, 0x01, 0x29, 0x03,
+    0x15, 0x00, 0x25, 0x01, 0x95, 0x03, 0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x05, 0x81, 0x01,
+    0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x02, 0x81, 0x06,
+    0xC0, 0xC0,
+};
+
+// boot protocol keyboard, HID 1.11 appendix E.6
+const vector<uint8_t> KEYBOARD_DESCRIPTOR = {
+    0x05, 0x01, 0x09, 0x06, 0xA1, 0x01, 0x05, 0x07, 0x19, 0xE0, 0x29, 0xE7, 0x15, 0x00, 0x25, 0x01,
+    0x75, 0x01, 0x95, 0x08, 0x81, 0x02, 0x95, 0x01, 0x75, 0x08, 0x81, 0x01, 0x95, 0x05, 0x75, 0x01,
+    0x05, 0x08, 0x19, 0x01, 0x29, 0x05, 0x91, 0x02, 0x95, 0x01, 0x75, 0x03, 0x91, 0x01, 0x95, 0x06,
+    0x75, 0x08, 0x15, 0x00, 0x25, 0x65, 0x05, 0x07, 0x19, 0x00, 0x29, 0x65, 0x81, 0x00, 0xC0,
+};
+
+// wireless receiver style composite: 16 bit mouse with report id 1, consumer control with report id 2
+const vector<uint8_t> COMPOSITE_DESCRIPTOR = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01, 0x85, 0x01, 0x09, 0x01, 0xA1, 0x00, 0x05, 0x09, 0x19, 0x01,
+    0x29, 0x05, 0x15, 0x00, 0x25, 0x01, 0x95, 0x05, 0x75, 0x01, 0x81, 0x02, 0x95, 0x01, 0x75, 0x03,
+    0x81, 0x01, 0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x16, 0x01, 0x80, 0x26, 0xFF, 0x7F, 0x75, 0x10,
+    0x95, 0x02, 0x81, 0x06, 0xC0, 0xC0, 0x05, 0x0C, 0x09, 0x01, 0xA1, 0x01, 0x85, 0x02, 0x19, 0x00,
+    0x2A, 0x3C, 0x02, 0x15, 0x00, 0x26, 0x3C, 0x02, 0x95, 0x01, 0x75, 0x10, 0x81, 0x00, 0xC0,
+};
+
+// generic gamepad: 16 buttons, hat switch with null state, four 8 bit axes declared with a one byte maximum
+const vector<uint8_t> GAMEPAD_DESCRIPTOR = {
+    0x05, 0x01, 0x09, 0x05, 0xA1, 0x01, 0x15, 0x00, 0x25, 0x01, 0x35, 0x00, 0x45, 0x01, 0x75, 0x01,
+    0x95, 0x10, 0x05, 0x09, 0x19, 0x01, 0x29, 0x10, 0x81, 0x02, 0x05, 0x01, 0x25, 0x07, 0x46, 0x3B,
+    0x01, 0x75, 0x04, 0x95, 0x01, 0x65, 0x14, 0x09, 0x39, 0x81, 0x42, 0x65, 0x00, 0x95, 0x01, 0x81,
+    0x01, 0x26, 0xFF, 0x00, 0x46, 0xFF, 0x00, 0x09, 0x30, 0x09, 0x31, 0x09, 0x32, 0x09, 0x35, 0x75,
+    0x08, 0x95, 0x04, 0x81, 0x02, 0xC0,
+};
+
+// vendor sensor with 32 bit signed fields at unaligned offsets, using push/pop and a long item
+const vector<uint8_t> WIDE_FIELD_DESCRIPTOR = {
+    0x06, 0x00, 0xFF, 0x09, 0x01, 0xA1, 0x01, 0x75, 0x03, 0x95, 0x01, 0x81, 0x03, 0xA4, 0x17, 0x00,
+    0x00, 0x00, 0x80, 0x27, 0xFF, 0xFF, 0xFF, 0x7F, 0x75, 0x20, 0x95, 0x02, 0x09, 0x02, 0x09, 0x03,
+    0x81, 0x02, 0xB4, 0xFE, 0x02, 0x10, 0xAA, 0xBB, 0x75, 0x05, 0x95, 0x01, 0x81, 0x01, 0xC0,
+};
+
+class HidReportParserTest : public testing::Test {
+};
+
+static Hid_ReportLayout *CreateLayout(const vector<uint8_t> &descriptor)
+{
+    Hid_ReportLayout *layout = nullptr;
+    EXPECT_EQ(OH_Hid_CreateReportLayout(descriptor.data(), descriptor.size(), &layout), HID_DDK_SUCCESS);
+    return layout;
+}
+
+static vector<Hid_ReportField> GetFields(const Hid_ReportLayout *layout)
+{
+    const Hid_ReportField *fields = nullptr;
+    uint32_t count = 0;
+    EXPECT_EQ(OH_Hid_GetReportFields(layout, &fields, &count), HID_DDK_SUCCESS);
+    return vector<Hid_ReportField>(fields, fields + count);
+}
+
+static vector<int32_t> Decode(const Hid_ReportLayout *layout, const vector<uint8_t> &report, uint32_t &firstField)
+{
+    int32_t values[MAX_VALUES] = {0};
+    uint32_t decodedCount = 0;
+    EXPECT_EQ(OH_Hid_DecodeInputReport(layout, report.data(), report.size(), values, MAX_VALUES, &firstField,
+        &decodedCount), HID_DDK_SUCCESS);
+    return vector<int32_t>(values, values + decodedCount);
+}
+
+HWTEST_F(HidReportParserTest, ParamTest, TestSize.Level1)
+{
+    Hid_ReportLayout *layout = nullptr;
+    ASSERT_EQ(OH_Hid_CreateReportLayout(nullptr, 1, &layout), HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_CreateReportLayout(MOUSE_DESCRIPTOR.data(), 0, &layout), HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_CreateReportLayout(MOUSE_DESCRIPTOR.data(), MOUSE_DESCRIPTOR.size(), nullptr),
+        HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_GetReportFields(nullptr, nullptr, nullptr), HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_DestroyReportLayout(nullptr), HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_DestroyReportLayout(&layout), HID_DDK_INVALID_PARAMETER);
+}
+
+HWTEST_F(HidReportParserTest, MalformedDescriptorTest, TestSize.Level1)
+{
+    Hid_ReportLayout *layout = nullptr;
+    // truncated in the middle of a two byte logical maximum
+    const vector<uint8_t> truncated = {0x05, 0x01, 0x26, 0xFF};
+    ASSERT_EQ(OH_Hid_CreateReportLayout(truncated.data(), truncated.size(), &layout), HID_DDK_INVALID_PARAMETER);
+    // collection never closed
+    vector<uint8_t> unbalanced(MOUSE_DESCRIPTOR.begin(), MOUSE_DESCRIPTOR.end() - 1);
+    ASSERT_EQ(OH_Hid_CreateReportLayout(unbalanced.data(), unbalanced.size(), &layout), HID_DDK_INVALID_PARAMETER);
+    // pop without push
+    const vector<uint8_t> pop = {0xB4};
+    ASSERT_EQ(OH_Hid_CreateReportLayout(pop.data(), pop.size(), &layout), HID_DDK_INVALID_PARAMETER);
+    // report id 0 is reserved
+    const vector<uint8_t> reportIdZero = {0x85, 0x00};
+    ASSERT_EQ(OH_Hid_CreateReportLayout(reportIdZero.data(), reportIdZero.size(), &layout),
+        HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(layout, nullptr);
+}
+
+HWTEST_F(HidReportParserTest, MouseTest, TestSize.Level1)
+{
+    Hid_ReportLayout *layout = CreateLayout(MOUSE_DESCRIPTOR);
+    ASSERT_NE(layout, nullptr);
+    auto fields = GetFields(layout);
+    ASSERT_EQ(fields.size(), 5);
+    for (uint32_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(fields[i].usagePage, USAGE_PAGE_BUTTON);
+        EXPECT_EQ(fields[i].usage, i + 1);
+        EXPECT_EQ(fields[i].bitOffset, i);
+        EXPECT_EQ(fields[i].bitSize, 1);
+        EXPECT_EQ(fields[i].flags & HID_FIELD_FLAG_VARIABLE, HID_FIELD_FLAG_VARIABLE);
+    }
+    EXPECT_EQ(fields[3].usagePage, USAGE_PAGE_GENERIC_DESKTOP);
+    EXPECT_EQ(fields[3].usage, USAGE_X);
+    EXPECT_EQ(fields[3].bitOffset, 8);
+    EXPECT_EQ(fields[3].logicalMin, -127);
+    EXPECT_EQ(fields[3].logicalMax, 127);
+    EXPECT_EQ(fields[3].flags & HID_FIELD_FLAG_RELATIVE, HID_FIELD_FLAG_RELATIVE);
+    EXPECT_EQ(fields[4].usage, USAGE_Y);
+    EXPECT_EQ(fields[4].bitOffset, 16);
+
+    uint32_t firstField = UINT32_MAX;
+    auto values = Decode(layout, {0x05, 0x10, 0xF0}, firstField);
+    EXPECT_EQ(firstField, 0);
+    EXPECT_EQ(values, vector<int32_t>({1, 0, 1, 16, -16}));
+    ASSERT_EQ(OH_Hid_DestroyReportLayout(&layout), HID_DDK_SUCCESS);
+    ASSERT_EQ(layout, nullptr);
+}
+
+HWTEST_F(HidReportParserTest, KeyboardTest, TestSize.Level1)
+{
+    Hid_ReportLayout *layout = CreateLayout(KEYBOARD_DESCRIPTOR);
+    ASSERT_NE(layout, nullptr);
+    auto fields = GetFields(layout);
+    // 8 modifiers and 6 key slots as input, 5 leds as output
+    ASSERT_EQ(fields.size(), 19);
+    EXPECT_EQ(fields[0].usagePage, USAGE_PAGE_KEYBOARD);
+    EXPECT_EQ(fields[0].usage, 0xE0);
+    EXPECT_EQ(fields[7].usage, 0xE7);
+    EXPECT_EQ(fields[8].bitOffset, 16);
+    EXPECT_EQ(fields[8].flags & HID_FIELD_FLAG_VARIABLE, 0);
+    EXPECT_EQ(fields[8].logicalMax, 0x65);
+    EXPECT_EQ(fields[13].bitOffset, 56);
+    EXPECT_EQ(fields[14].reportType, HID_OUTPUT_REPORT);
+    EXPECT_EQ(fields[14].usagePage, USAGE_PAGE_LED);
+    EXPECT_EQ(fields[18].usage, 5);
+    EXPECT_EQ(fields[18].bitOffset, 4);
+
+    uint32_t firstField = UINT32_MAX;
+    auto values = Decode(layout, {0x02, 0x00, 0x04, 0x05, 0x00, 0x00, 0x00, 0x00}, firstField);
+    EXPECT_EQ(firstField, 0);
+    EXPECT_EQ(values, vector<int32_t>({0, 1, 0, 0, 0, 0, 0, 0, 4, 5, 0, 0, 0, 0}));
+
+    int32_t small[4] = {0};
+    uint32_t decodedCount = 0;
+    const uint8_t report[8] = {0};
+    ASSERT_EQ(OH_Hid_DecodeInputReport(layout, report, sizeof(report), small, 4, &firstField, &decodedCount),
+        HID_DDK_MEMORY_ERROR);
+    ASSERT_EQ(OH_Hid_DecodeInputReport(layout, report, 7, small, 4, &firstField, &decodedCount),
+        HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_DestroyReportLayout(&layout), HID_DDK_SUCCESS);
+}
+
+HWTEST_F(HidReportParserTest, CompositeReportIdTest, TestSize.Level1)
+{
+    Hid_ReportLayout *layout = CreateLayout(COMPOSITE_DESCRIPTOR);
+    ASSERT_NE(layout, nullptr);
+    auto fields = GetFields(layout);
+    ASSERT_EQ(fields.size(), 8);
+    EXPECT_EQ(fields[0].reportId, 1);
+    EXPECT_EQ(fields[0].bitOffset, 8);
+    EXPECT_EQ(fields[5].usage, USAGE_X);
+    EXPECT_EQ(fields[5].bitOffset, 16);
+    EXPECT_EQ(fields[5].logicalMin, -32767);
+    EXPECT_EQ(fields[5].logicalMax, 32767);
+    EXPECT_EQ(fields[7].reportId, 2);
+    EXPECT_EQ(fields[7].usagePage, USAGE_PAGE_CONSUMER);
+    EXPECT_EQ(fields[7].logicalMax, 0x23C);
+
+    uint32_t firstField = UINT32_MAX;
+    auto values = Decode(layout, {0x01, 0x03, 0x34, 0x12, 0xFE, 0xFF}, firstField);
+    EXPECT_EQ(firstField, 0);
+    EXPECT_EQ(values, vector<int32_t>({1, 1, 0, 0, 0, 0x1234, -2}));
+    values = Decode(layout, {0x02, 0xE9, 0x00}, firstField);
+    EXPECT_EQ(firstField, 7);
+    EXPECT_EQ(values, vector<int32_t>({0xE9}));
+
+    int32_t value = 0;
+    uint32_t decodedCount = 0;
+    const uint8_t unknownReport[] = {0x03, 0x00, 0x00};
+    ASSERT_EQ(OH_Hid_DecodeInputReport(layout, unknownReport, sizeof(unknownReport), &value, 1, &firstField,
+        &decodedCount), HID_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_Hid_DestroyReportLayout(&layout), HID_DDK_SUCCESS);
+}
+
+HWTEST_F(HidReportParserTest, GamepadTest, TestSize.Level1)
+{
+    Hid_ReportLayout *layout = CreateLayout(GAMEPAD_DESCRIPTOR);
+    ASSERT_NE(layout, nullptr);
+    auto fields = GetFields(layout);
+    ASSERT_EQ(fields.size(), 21);
+    EXPECT_EQ(fields[16].usage, USAGE_HAT_SWITCH);
+    EXPECT_EQ(fields[16].bitOffset, 16);
+    EXPECT_EQ(fields[16].bitSize, 4);
+    EXPECT_EQ(fields[16].flags & HID_FIELD_FLAG_NULL_STATE, HID_FIELD_FLAG_NULL_STATE);
+    EXPECT_EQ(fields[17].bitOffset, 24);
+    EXPECT_EQ(fields[17].logicalMin, 0);
+    EXPECT_EQ(fields[17].logicalMax, 255);
+    EXPECT_EQ(fields[17].flags & HID_FIELD_FLAG_SIGNED, 0);
+
+    uint32_t firstField = UINT32_MAX;
+    auto values = Decode(layout, {0x01, 0x80, 0x03, 0x80, 0x7F, 0x00, 0xFF}, firstField);
+    ASSERT_EQ(values.size(), 21);
+    EXPECT_EQ(values[0], 1);
+    EXPECT_EQ(values[15], 1);
+    EXPECT_EQ(values[16], 3);
+    EXPECT_EQ(vector<int32_t>(values.begin() + 17, values.end()), vector<int32_t>({128, 127, 0, 255}));
+    ASSERT_EQ(OH_Hid_DestroyReportLayout(&layout), HID_DDK_SUCCESS);
+}
+
+HWTEST_F(HidReportParserTest, WideFieldTest, TestSize.Level1)
+{
+    Hid_ReportLayout *layout = CreateLayout(WIDE_FIELD_DESCRIPTOR);
+    ASSERT_NE(layout, nullptr);
+    auto fields = GetFields(layout);
+    ASSERT_EQ(fields.size(), 2);
+    EXPECT_EQ(fields[0].usagePage, 0xFF00);
+    EXPECT_EQ(fields[0].bitOffset, 3);
+    EXPECT_EQ(fields[0].bitSize, 32);
+    EXPECT_EQ(fields[0].logicalMin, INT32_MIN);
+    EXPECT_EQ(fields[0].logicalMax, INT32_MAX);
+    EXPECT_EQ(fields[1].bitOffset, 35);
+
+    // field 0 = -2, field 1 = 0x12345678, both shifted left by 3 bits, followed by 5 bits of padding
+    uint64_t packed = (static_cast<uint64_t>(0x12345678) << 35) | (static_cast<uint64_t>(0xFFFFFFFE) << 3);
+    vector<uint8_t> report;
+    for (uint32_t i = 0; i < sizeof(packed); ++i) {
+        report.push_back(static_cast<uint8_t>(packed >> (i * 8)));
+    }
+    report.push_back(0x00);
+    uint32_t firstField = UINT32_MAX;
+    auto values = Decode(layout, report, firstField);
+    EXPECT_EQ(values, vector<int32_t>({-2, 0x12345678}));
+    ASSERT_EQ(OH_Hid_DestroyReportLayout(&layout), HID_DDK_SUCCESS);
+}
+} // namespace
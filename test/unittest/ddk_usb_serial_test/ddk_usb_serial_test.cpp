@@ -15,7 +15,14 @@
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <poll.h>
 #include <string>
+#include <thread>
 #include "usb_serial_api.h"
 #include "v1_0/iusb_serial_ddk.h"
 
@@ -40,12 +47,32 @@ bool operator==(const UsbSerialDeviceHandle &lhs, const UsbSerialDeviceHandle &r
 
 void SetDdk(OHOS::sptr<IUsbSerialDdk>&);
 UsbSerial_Device *NewSerialDeviceHandle();
+void DeleteUsbSerialDeviceHandle(UsbSerial_Device **dev);
 
 namespace {
 
 constexpr int TEST_TIMES = 1;
 constexpr uint32_t USB_SERIAL_TEST_BAUDRATE = 9600;
 constexpr uint8_t USB_SERIAL_TEST_DATA_BITS = 8;
+constexpr uint32_t USB_SERIAL_BENCH_BAUDRATES[] = {115200, 921600, 3000000, 12000000};
+constexpr uint32_t USB_SERIAL_BENCH_BITS_PER_BYTE = 10;
+constexpr uint32_t USB_SERIAL_BENCH_POLL_PER_SECOND = 1000;
+constexpr uint32_t USB_SERIAL_BENCH_MAX_CHUNK = 4096;
+constexpr uint32_t USB_SERIAL_EVENT_PORT_NUM = 8;
+constexpr auto USB_SERIAL_IDLE_READ_BLOCK = std::chrono::milliseconds(100);
+constexpr auto USB_SERIAL_IDLE_WINDOW = std::chrono::seconds(1);
+constexpr int32_t USB_SERIAL_POLL_TIMEOUT_MS = 2000;
+constexpr int32_t USB_SERIAL_RX_POLL_TIMEOUT_MS = 1000;
+constexpr int32_t USB_SERIAL_USER_TIMEOUT_MS = 500;
+
+// stops the read event mode of a handle even when an assertion returns early, a joinable rx thread would terminate
+struct SerialDeviceDeleter {
+    void operator()(UsbSerial_Device *dev) const
+    {
+        DeleteUsbSerialDeviceHandle(&dev);
+    }
+};
+using SerialDevicePtr = std::unique_ptr<UsbSerial_Device, SerialDeviceDeleter>;
 
 class MockUsbSerialDdk : public IUsbSerialDdk {
 public:
@@ -432,4 +459,176 @@ HWTEST_F(UsbSerialTest, FlushOutputErrorTest002, TestSize.Level1)
     auto dev = NewSerialDeviceHandle();
     ASSERT_EQ(OH_UsbSerial_FlushOutput(dev), USB_SERIAL_DDK_IO_ERROR);
 }
+
+static void RunSerialBench(uint32_t baudRate, bool isRead)
+{
+    // bytes the line delivers between two polls at this baud rate, capped by the per-call limit
+    uint32_t chunk = baudRate / USB_SERIAL_BENCH_BITS_PER_BYTE / USB_SERIAL_BENCH_POLL_PER_SECOND;
+    chunk = std::max<uint32_t>(1, std::min(chunk, USB_SERIAL_BENCH_MAX_CHUNK));
+    uint32_t calls = USB_SERIAL_BENCH_POLL_PER_SECOND;
+
+    auto mockDdk = OHOS::sptr<MockUsbSerialDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    std::vector<uint8_t> payload(chunk, 0x5A);
+    EXPECT_CALL(*mockDdk, Read(testing::_, testing::_, testing::_))
+        .WillRepeatedly(testing::DoAll(testing::SetArgReferee<2>(payload), testing::Return(0)));
+    EXPECT_CALL(*mockDdk, Write(testing::_, testing::_, testing::_))
+        .WillRepeatedly(testing::DoAll(testing::SetArgReferee<2>(chunk), testing::Return(0)));
+    auto ddk = OHOS::sptr<IUsbSerialDdk>(mockDdk);
+    SetDdk(ddk);
+    auto dev = NewSerialDeviceHandle();
+    ASSERT_NE(dev, nullptr);
+    std::vector<uint8_t> userBuff(chunk, 0xA5);
+
+    uint64_t totalBytes = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < calls; ++i) {
+        uint32_t transferred = 0;
+        int32_t ret = isRead ? OH_UsbSerial_Read(dev, userBuff.data(), chunk, &transferred) :
+            OH_UsbSerial_Write(dev, userBuff.data(), chunk, &transferred);
+        ASSERT_EQ(ret, USB_SERIAL_DDK_SUCCESS);
+        ASSERT_EQ(transferred, chunk);
+        totalBytes += transferred;
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+    double seconds = static_cast<double>(cost.count()) / std::nano::den;
+    double lineRate = static_cast<double>(baudRate) / USB_SERIAL_BENCH_BITS_PER_BYTE;
+    // report only, a wall clock rate against a mock is no pass criterion
+    std::cout << (isRead ? "read" : "write") << " baud:" << baudRate << " chunk:" << chunk
+        << " latency(ns/call):" << cost.count() / calls
+        << " throughput(B/s):" << static_cast<uint64_t>(totalBytes / seconds)
+        << " line rate(B/s):" << static_cast<uint64_t>(lineRate)
+        << " margin:" << (totalBytes / seconds) / lineRate << std::endl;
+    delete dev;
+}
+
+HWTEST_F(UsbSerialTest, ReadThroughputBenchTest, TestSize.Level1)
+{
+    for (uint32_t baudRate : USB_SERIAL_BENCH_BAUDRATES) {
+        RunSerialBench(baudRate, true);
+    }
+}
+
+HWTEST_F(UsbSerialTest, WriteThroughputBenchTest, TestSize.Level1)
+{
+    for (uint32_t baudRate : USB_SERIAL_BENCH_BAUDRATES) {
+        RunSerialBench(baudRate, false);
+    }
+}
+
+static int IdleRead(const UsbSerialDeviceHandle &, uint32_t, vector<uint8_t> &buff)
+{
+    // emulate a port with no incoming data: the service blocks until the read timeout expires
+    std::this_thread::sleep_for(USB_SERIAL_IDLE_READ_BLOCK);
+    buff.clear();
+    return 0;
+}
+
+static int64_t ProcessCpuTimeNs()
+{
+    struct timespec ts = {};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * std::nano::den + ts.tv_nsec;
+}
+
+HWTEST_F(UsbSerialTest, ReadEventParamTest, TestSize.Level1)
+{
+    auto mockDdk = OHOS::sptr<MockUsbSerialDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    auto ddk = OHOS::sptr<IUsbSerialDdk>(mockDdk);
+    SetDdk(ddk);
+    int32_t eventFd = -1;
+    ASSERT_EQ(OH_UsbSerial_StartReadEvent(nullptr, &eventFd), USB_SERIAL_DDK_INVALID_PARAMETER);
+    SerialDevicePtr dev(NewSerialDeviceHandle());
+    ASSERT_EQ(OH_UsbSerial_StartReadEvent(dev.get(), nullptr), USB_SERIAL_DDK_INVALID_PARAMETER);
+    ASSERT_EQ(OH_UsbSerial_StopReadEvent(dev.get()), USB_SERIAL_DDK_INVALID_OPERATION);
+}
+
+HWTEST_F(UsbSerialTest, ReadEventDataTest, TestSize.Level1)
+{
+    auto mockDdk = OHOS::sptr<MockUsbSerialDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    vector<uint8_t> payload = {0x01, 0x03, 0x00, 0x00, 0x00, 0x01, 0x84, 0x0A};
+    EXPECT_CALL(*mockDdk, SetTimeout(testing::_, testing::_)).WillRepeatedly(testing::Return(0));
+    EXPECT_CALL(*mockDdk, Read(testing::_, testing::_, testing::_))
+        .WillOnce(testing::DoAll(testing::SetArgReferee<2>(payload), testing::Return(0)))
+        .WillRepeatedly(testing::Invoke(IdleRead));
+    auto ddk = OHOS::sptr<IUsbSerialDdk>(mockDdk);
+    SetDdk(ddk);
+    SerialDevicePtr dev(NewSerialDeviceHandle());
+    int32_t eventFd = -1;
+    ASSERT_EQ(OH_UsbSerial_StartReadEvent(dev.get(), &eventFd), USB_SERIAL_DDK_SUCCESS);
+    ASSERT_GE(eventFd, 0);
+    ASSERT_EQ(OH_UsbSerial_SetTimeout(dev.get(), 0), USB_SERIAL_DDK_INVALID_OPERATION);
+
+    struct pollfd pfd = {eventFd, POLLIN, 0};
+    ASSERT_EQ(poll(&pfd, 1, USB_SERIAL_POLL_TIMEOUT_MS), 1);
+    uint8_t dataBuff[16];
+    uint32_t bytesRead = 0;
+    ASSERT_EQ(OH_UsbSerial_Read(dev.get(), dataBuff, sizeof(dataBuff), &bytesRead), USB_SERIAL_DDK_SUCCESS);
+    ASSERT_EQ(bytesRead, payload.size());
+    ASSERT_EQ(vector<uint8_t>(dataBuff, dataBuff + bytesRead), payload);
+    // drained: the fd is no longer readable and a further read returns nothing without blocking
+    ASSERT_EQ(poll(&pfd, 1, 0), 0);
+    ASSERT_EQ(OH_UsbSerial_Read(dev.get(), dataBuff, sizeof(dataBuff), &bytesRead), USB_SERIAL_DDK_SUCCESS);
+    ASSERT_EQ(bytesRead, 0U);
+    ASSERT_EQ(OH_UsbSerial_StopReadEvent(dev.get()), USB_SERIAL_DDK_SUCCESS);
+}
+
+HWTEST_F(UsbSerialTest, ReadEventRestoreTimeoutTest, TestSize.Level1)
+{
+    auto mockDdk = OHOS::sptr<MockUsbSerialDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    {
+        testing::InSequence seq;
+        EXPECT_CALL(*mockDdk, SetTimeout(testing::_, USB_SERIAL_USER_TIMEOUT_MS)).WillOnce(testing::Return(0));
+        EXPECT_CALL(*mockDdk, SetTimeout(testing::_, USB_SERIAL_RX_POLL_TIMEOUT_MS)).WillOnce(testing::Return(0));
+        EXPECT_CALL(*mockDdk, SetTimeout(testing::_, USB_SERIAL_USER_TIMEOUT_MS)).WillOnce(testing::Return(0));
+    }
+    EXPECT_CALL(*mockDdk, Read(testing::_, testing::_, testing::_)).WillRepeatedly(testing::Invoke(IdleRead));
+    auto ddk = OHOS::sptr<IUsbSerialDdk>(mockDdk);
+    SetDdk(ddk);
+    SerialDevicePtr dev(NewSerialDeviceHandle());
+    ASSERT_EQ(OH_UsbSerial_SetTimeout(dev.get(), USB_SERIAL_USER_TIMEOUT_MS), USB_SERIAL_DDK_SUCCESS);
+    int32_t eventFd = -1;
+    ASSERT_EQ(OH_UsbSerial_StartReadEvent(dev.get(), &eventFd), USB_SERIAL_DDK_SUCCESS);
+    // a blocking read after the mode ends gets the caller's timeout back, not the rx poll interval
+    ASSERT_EQ(OH_UsbSerial_StopReadEvent(dev.get()), USB_SERIAL_DDK_SUCCESS);
+}
+
+HWTEST_F(UsbSerialTest, ReadEventIdleCpuTest, TestSize.Level1)
+{
+    auto mockDdk = OHOS::sptr<MockUsbSerialDdk>::MakeSptr();
+    ASSERT_NE(mockDdk, nullptr);
+    EXPECT_CALL(*mockDdk, SetTimeout(testing::_, testing::_)).WillRepeatedly(testing::Return(0));
+    EXPECT_CALL(*mockDdk, Read(testing::_, testing::_, testing::_)).WillRepeatedly(testing::Invoke(IdleRead));
+    auto ddk = OHOS::sptr<IUsbSerialDdk>(mockDdk);
+    SetDdk(ddk);
+
+    std::vector<SerialDevicePtr> devs;
+    std::vector<struct pollfd> pfds;
+    for (uint32_t i = 0; i < USB_SERIAL_EVENT_PORT_NUM; ++i) {
+        devs.emplace_back(NewSerialDeviceHandle());
+        int32_t eventFd = -1;
+        ASSERT_EQ(OH_UsbSerial_StartReadEvent(devs.back().get(), &eventFd), USB_SERIAL_DDK_SUCCESS);
+        pfds.push_back({eventFd, POLLIN, 0});
+    }
+
+    int64_t cpuBegin = ProcessCpuTimeNs();
+    auto wallBegin = std::chrono::steady_clock::now();
+    // a single thread services all ports; with no traffic it stays asleep in poll
+    int32_t ready = poll(pfds.data(), pfds.size(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(USB_SERIAL_IDLE_WINDOW).count());
+    int64_t cpuCost = ProcessCpuTimeNs() - cpuBegin;
+    auto wallCost = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - wallBegin).count();
+    ASSERT_EQ(ready, 0);
+    // report only, process cpu time against the wall clock depends on the runner load
+    double cpuUsage = static_cast<double>(cpuCost) / wallCost;
+    std::cout << "idle ports:" << USB_SERIAL_EVENT_PORT_NUM << " cpu usage:" << cpuUsage * 100 << "%" << std::endl;
+
+    for (auto &dev : devs) {
+        EXPECT_EQ(OH_UsbSerial_StopReadEvent(dev.get()), USB_SERIAL_DDK_SUCCESS);
+    }
+}
 } // namespace
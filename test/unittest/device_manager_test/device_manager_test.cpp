@@ -13,10 +13,20 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <gtest/gtest.h>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
 #include "edm_errors.h"
 #include "hilog_wrapper.h"
 #define private public
+#define protected public
+#include "bundle_update_callback.h"
 #include "dev_change_callback.h"
 #include "etx_device_mgr.h"
 #include "ibus_extension.h"
@@ -25,6 +35,7 @@
 #include "driver_pkg_manager.h"
 #include "usb_device_info.h"
 #include "usb_driver_info.h"
+#undef protected
 #undef private
 
 namespace OHOS {
@@ -50,6 +61,8 @@ static void clearDeviceMap(ExtDeviceManager &instance)
 {
     unordered_map<BusType, unordered_map<uint64_t, shared_ptr<Device>>> map;
     instance.deviceMap_ = map;
+    instance.matchKeyIndex_.clear();
+    instance.deviceMatchKeys_.clear();
 }
 
 static size_t getDeviceNum(unordered_map<uint64_t, shared_ptr<Device>> map)
@@ -164,6 +177,96 @@ HWTEST_F(DeviceManagerTest, QueryDeviceTest, TestSize.Level1)
     ASSERT_EQ(getDeviceNum(extMgr.deviceMap_[BusType::BUS_TYPE_TEST]), 0);
 }
 
+static std::shared_ptr<DeviceInfo> MakeTestDevice(uint32_t busDeviceId)
+{
+    std::shared_ptr<DeviceInfo> device = std::make_shared<DeviceInfo>(0);
+    device->devInfo_.devBusInfo.busType = BusType::BUS_TYPE_TEST;
+    device->devInfo_.devBusInfo.busDeviceId = busDeviceId;
+    return device;
+}
+
+// hot-plug storm against a subscriber: deltas must be gap free and replay to the final device set
+HWTEST_F(DeviceManagerTest, DeviceChangeSubscribeStormTest, TestSize.Level1)
+{
+    constexpr uint32_t stableDeviceNum = 4;
+    constexpr uint32_t threadNum = 4;
+    constexpr uint32_t devicePerThread = 8;
+    constexpr uint32_t plugCycles = 50;
+    constexpr uint32_t pollsPerCycle = 1;
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    clearDeviceMap(extMgr);
+    std::shared_ptr<DevChangeCallback> callback = std::make_shared<DevChangeCallback>();
+    for (uint32_t i = 1; i <= stableDeviceNum; ++i) {
+        ASSERT_EQ(callback->OnDeviceAdd(MakeTestDevice(i)), EDM_OK);
+    }
+
+    std::mutex deltaMutex;
+    std::vector<std::tuple<uint64_t, DeviceChangeType, uint64_t>> deltas;
+    bool subscribed = false;
+    extMgr.SetDeviceChangeHandler([&](uint64_t sequence, DeviceChangeType type, const shared_ptr<Device> &device) {
+        std::lock_guard<std::mutex> lock(deltaMutex);
+        if (subscribed) {
+            deltas.emplace_back(sequence, type, device->GetDeviceInfo()->GetDeviceId());
+        }
+    });
+    uint64_t baseSequence = 0;
+    std::vector<std::shared_ptr<Device>> snapshot = extMgr.QueryAllDevices(baseSequence, [&]() {
+        std::lock_guard<std::mutex> lock(deltaMutex);
+        subscribed = true;
+    });
+    ASSERT_EQ(snapshot.size(), stableDeviceNum);
+
+    std::vector<std::thread> pluggers;
+    for (uint32_t t = 0; t < threadNum; ++t) {
+        pluggers.emplace_back([&callback, t]() {
+            for (uint32_t cycle = 0; cycle < plugCycles; ++cycle) {
+                for (uint32_t d = 0; d < devicePerThread; ++d) {
+                    auto device = MakeTestDevice(stableDeviceNum + 1 + t * devicePerThread + d);
+                    callback->OnDeviceAdd(device);
+                    callback->OnDeviceRemove(device);
+                }
+            }
+        });
+    }
+    for (auto &plugger : pluggers) {
+        plugger.join();
+    }
+    extMgr.SetDeviceChangeHandler(nullptr);
+
+    std::map<uint64_t, bool> replayed;
+    for (const auto &device : snapshot) {
+        replayed[device->GetDeviceInfo()->GetDeviceId()] = true;
+    }
+    uint64_t expectedSequence = baseSequence;
+    for (const auto &[sequence, type, deviceId] : deltas) {
+        ASSERT_EQ(sequence, ++expectedSequence);
+        if (type == DeviceChangeType::DEVICE_CHANGE_ADDED) {
+            ASSERT_FALSE(replayed[deviceId]);
+            replayed[deviceId] = true;
+        } else {
+            ASSERT_TRUE(replayed[deviceId]);
+            replayed[deviceId] = false;
+        }
+    }
+    size_t replayedNum = 0;
+    for (const auto &[_, present] : replayed) {
+        replayedNum += present ? 1 : 0;
+    }
+    ASSERT_EQ(replayedNum, extMgr.QueryAllDevices().size());
+
+    // one delta per change, where polling once per plug cycle would marshal every attached device each time
+    const size_t changes = static_cast<size_t>(threadNum) * devicePerThread * plugCycles * 2;
+    ASSERT_EQ(deltas.size(), changes);
+    size_t polledRecords = static_cast<size_t>(threadNum) * devicePerThread * plugCycles * pollsPerCycle *
+        (stableDeviceNum + threadNum);
+    std::cout << "changes:" << changes << " deltas sent:" << deltas.size()
+        << " records marshalled by polling:" << polledRecords << std::endl;
+
+    for (uint32_t i = 1; i <= stableDeviceNum; ++i) {
+        ASSERT_EQ(callback->OnDeviceRemove(MakeTestDevice(i)), EDM_OK);
+    }
+}
+
 HWTEST_F(DeviceManagerTest, GetBusExtensionByNameTest, TestSize.Level1)
 {
     BusExtensionCore &core = BusExtensionCore::GetInstance();
@@ -482,5 +585,318 @@ HWTEST_F(DeviceManagerTest, DisConnectDeviceTest2, TestSize.Level1)
     ret = extMgr.DisConnectDriverWithDeviceId(deviceId, tokenId2);
     ASSERT_EQ(ret, EDM_ERR_SERVICE_NOT_BOUND);
 }
+
+static std::shared_ptr<Device> AddConnectedDevice(ExtDeviceManager &extMgr, uint64_t deviceId)
+{
+    std::shared_ptr<DevChangeCallback> callback = std::make_shared<DevChangeCallback>();
+    std::shared_ptr<DeviceInfo> deviceInfo = std::make_shared<DeviceInfo>(deviceId,
+        BusType::BUS_TYPE_TEST, "testInfo1");
+    deviceInfo->devInfo_.deviceId = deviceId;
+    if (callback->OnDeviceAdd(deviceInfo) != EDM_OK) {
+        return nullptr;
+    }
+    std::shared_ptr<Device> device = extMgr.QueryDeviceByDeviceID(deviceId);
+    if (device == nullptr) {
+        return nullptr;
+    }
+    device->driverInfo_ = make_shared<DriverInfo>("testBundleName1", "testDriverName1");
+    device->driverInfo_->accessAllowed_ = true;
+    device->OnConnect(sptr<TestRemoteObjectStub>::MakeSptr(), static_cast<int>(UsbErrCode::EDM_OK));
+    return device;
+}
+
+HWTEST_F(DeviceManagerTest, AppProvisionCacheTest, TestSize.Level1)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    clearDeviceMap(extMgr);
+    uint64_t deviceId = 3;
+    std::shared_ptr<Device> device = AddConnectedDevice(extMgr, deviceId);
+    ASSERT_NE(device, nullptr);
+    std::atomic<uint32_t> bmsCalls {0};
+    extMgr.provisionFetcher_ = [&bmsCalls](const std::string &bundleName, int32_t userId, std::string &appId) {
+        bmsCalls++;
+        appId = bundleName;
+        return EDM_OK;
+    };
+    extMgr.InvalidateAppProvision("testBundleName1", device->driverInfo_->GetUserId());
+
+    sptr<IDriverExtMgrCallback> connectCallback = sptr<TestDriverExtMgrCallback>::MakeSptr();
+    int32_t ret = extMgr.ConnectDriverWithDeviceId(deviceId, 1, accessibleBundles, connectCallback);
+    ASSERT_EQ(ret, EDM_OK);
+    ASSERT_EQ(bmsCalls.load(), 1U);
+
+    // repeated binds to the same driver are answered from the cache
+    const uint32_t bindCount = 100;
+    bmsCalls = 0;
+    for (uint32_t tokenId = 2; tokenId <= bindCount; tokenId++) {
+        ret = extMgr.ConnectDriverWithDeviceId(deviceId, tokenId, accessibleBundles, connectCallback);
+        ASSERT_EQ(ret, EDM_OK);
+    }
+    ASSERT_EQ(bmsCalls.load(), 0U);
+    ASSERT_EQ(device->boundCallerInfos_.size(), bindCount);
+    extMgr.provisionFetcher_ = ExtDeviceManager::QueryAppIdentifier;
+}
+
+HWTEST_F(DeviceManagerTest, AppProvisionCacheInvalidateTest, TestSize.Level1)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    clearDeviceMap(extMgr);
+    uint64_t deviceId = 3;
+    std::shared_ptr<Device> device = AddConnectedDevice(extMgr, deviceId);
+    ASSERT_NE(device, nullptr);
+    int32_t userId = device->driverInfo_->GetUserId();
+    std::atomic<uint32_t> bmsCalls {0};
+    std::string currentAppId = "testBundleName1";
+    extMgr.provisionFetcher_ = [&bmsCalls, &currentAppId](const std::string &, int32_t, std::string &appId) {
+        bmsCalls++;
+        appId = currentAppId;
+        return EDM_OK;
+    };
+    extMgr.InvalidateAppProvision("testBundleName1", userId);
+
+    sptr<IDriverExtMgrCallback> connectCallback = sptr<TestDriverExtMgrCallback>::MakeSptr();
+    ASSERT_EQ(extMgr.ConnectDriverWithDeviceId(deviceId, 1, accessibleBundles, connectCallback), EDM_OK);
+    ASSERT_EQ(extMgr.ConnectDriverWithDeviceId(deviceId, 2, accessibleBundles, connectCallback), EDM_OK);
+    ASSERT_EQ(bmsCalls.load(), 1U);
+
+    // the bundle is reinstalled with another signature, the next bind must see it
+    currentAppId = "testBundleName3";
+    BundleUpdateCallback bundleUpdateCallback;
+    bundleUpdateCallback.OnBundleChanged("testBundleName1", userId);
+    ASSERT_EQ(extMgr.ConnectDriverWithDeviceId(deviceId, 3, accessibleBundles, connectCallback), EDM_ERR_NO_PERM);
+    ASSERT_EQ(bmsCalls.load(), 2U);
+
+    // failed lookups are not cached
+    extMgr.provisionFetcher_ = [&bmsCalls](const std::string &, int32_t, std::string &) {
+        bmsCalls++;
+        return EDM_ERR_NO_PERM;
+    };
+    bundleUpdateCallback.OnBundleChanged("testBundleName1", userId);
+    ASSERT_EQ(extMgr.ConnectDriverWithDeviceId(deviceId, 4, accessibleBundles, connectCallback), EDM_ERR_NO_PERM);
+    ASSERT_EQ(extMgr.ConnectDriverWithDeviceId(deviceId, 5, accessibleBundles, connectCallback), EDM_ERR_NO_PERM);
+    ASSERT_EQ(bmsCalls.load(), 4U);
+    extMgr.provisionFetcher_ = ExtDeviceManager::QueryAppIdentifier;
+}
+
+static std::shared_ptr<DriverInfo> MakeUsbDriver(uint32_t index, const std::vector<uint16_t> &vids)
+{
+    std::shared_ptr<DriverInfo> driverInfo = std::make_shared<DriverInfo>("matchBundle" + std::to_string(index),
+        "matchDriver");
+    driverInfo->bus_ = "usb";
+    driverInfo->busType_ = BusType::BUS_TYPE_USB;
+    driverInfo->launchOnBind_ = true;
+    std::shared_ptr<UsbDriverInfo> usbDriverInfo = std::make_shared<UsbDriverInfo>();
+    usbDriverInfo->vids_ = vids;
+    usbDriverInfo->pids_ = {1};
+    driverInfo->driverInfoExt_ = usbDriverInfo;
+    return driverInfo;
+}
+
+static std::map<uint64_t, std::string> GetBoundDrivers(ExtDeviceManager &extMgr)
+{
+    std::map<uint64_t, std::string> boundDrivers;
+    for (const auto &device : extMgr.QueryAllDevices()) {
+        boundDrivers[device->GetDeviceInfo()->GetDeviceId()] = device->GetBundleInfo();
+    }
+    return boundDrivers;
+}
+
+// re-matching only the devices a changed bundle can affect must give the bindings of a full re-match
+HWTEST_F(DeviceManagerTest, IncrementalRematchTest, TestSize.Level1)
+{
+    constexpr uint32_t deviceNum = 200;
+    constexpr uint32_t driverNum = 500;
+    constexpr uint16_t baseVid = 0x2000;
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    clearDeviceMap(extMgr);
+    extMgr.DeleteBundlesOfBundleInfoMap();
+    BusExtensionCore &core = BusExtensionCore::GetInstance();
+    if (core.GetBusExtensionByType(BusType::BUS_TYPE_USB) == nullptr) {
+        ASSERT_EQ(core.Register(BusType::BUS_TYPE_USB, std::make_shared<UsbBusExtension>()), EDM_OK);
+    }
+    std::shared_ptr<IBusExtension> usbBus = core.GetBusExtensionByType(BusType::BUS_TYPE_USB);
+
+    // the rows of pkg.db in order, driver i serves the even device 2 * i, the odd devices have no driver
+    std::vector<std::shared_ptr<DriverInfo>> installed;
+    for (uint32_t i = 0; i < driverNum; ++i) {
+        installed.push_back(MakeUsbDriver(i, {static_cast<uint16_t>(baseVid + 2 * i)}));
+    }
+    uint32_t matchQueries = 0;
+    extMgr.driverMatcher_ = [&installed, &usbBus, &matchQueries](shared_ptr<DeviceInfo> devInfo,
+        const std::string &type) -> shared_ptr<DriverInfo> {
+        matchQueries++;
+        for (const auto &driverInfo : installed) {
+            if (usbBus->MatchDriver(*driverInfo, *devInfo, type)) {
+                return driverInfo;
+            }
+        }
+        return nullptr;
+    };
+    auto uninstall = [&installed](const std::string &bundleName) {
+        installed.erase(std::remove_if(installed.begin(), installed.end(),
+            [&bundleName](const auto &driverInfo) { return driverInfo->GetBundleName() == bundleName; }),
+            installed.end());
+    };
+    std::map<uint16_t, uint64_t> deviceIdOfVid;
+    for (uint32_t d = 0; d < deviceNum; ++d) {
+        std::shared_ptr<UsbDeviceInfo> deviceInfo = std::make_shared<UsbDeviceInfo>(d + 1);
+        deviceInfo->idVendor_ = baseVid + d;
+        deviceInfo->idProduct_ = 1;
+        deviceIdOfVid[deviceInfo->idVendor_] = deviceInfo->GetDeviceId();
+        ASSERT_EQ(extMgr.RegisterDevice(deviceInfo), EDM_OK);
+    }
+    auto matchAll = [&installed, &extMgr, &usbBus]() {
+        std::map<uint64_t, std::string> expected;
+        for (const auto &device : extMgr.QueryAllDevices()) {
+            std::string bundleInfo;
+            for (const auto &driverInfo : installed) {
+                if (usbBus->MatchDriver(*driverInfo, *device->GetDeviceInfo())) {
+                    bundleInfo = driverInfo->GetBundleName() + Device::GetStiching() + driverInfo->GetDriverName();
+                    break;
+                }
+            }
+            expected[device->GetDeviceInfo()->GetDeviceId()] = bundleInfo;
+        }
+        return expected;
+    };
+    ASSERT_EQ(GetBoundDrivers(extMgr), matchAll());
+
+    // bundle 10 is updated: device 20 loses its driver, devices 1, 3 and 5 gain it, device 40 keeps driver 20
+    std::shared_ptr<DriverInfo> updated = MakeUsbDriver(10, {baseVid + 1, baseVid + 3, baseVid + 5, baseVid + 40});
+    uninstall(updated->GetBundleName());
+    installed.push_back(updated);
+    matchQueries = 0;
+    auto begin = std::chrono::steady_clock::now();
+    auto deviceIds = extMgr.DeleteBundlesOfBundleInfoMap(updated->GetBundleName());
+    extMgr.MatchDriverInfos(deviceIds, {updated});
+    auto incrementalUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    uint32_t incrementalQueries = matchQueries;
+    auto expected = matchAll();
+    ASSERT_EQ(GetBoundDrivers(extMgr), expected);
+    ASSERT_EQ(deviceIds, std::unordered_set<uint64_t>({deviceIdOfVid[baseVid + 20]}));
+    ASSERT_TRUE(expected[deviceIdOfVid[baseVid + 20]].empty());
+    ASSERT_EQ(expected[deviceIdOfVid[baseVid + 1]], "matchBundle10-matchDriver");
+    ASSERT_EQ(expected[deviceIdOfVid[baseVid + 40]], "matchBundle20-matchDriver");
+    ASSERT_EQ(incrementalQueries, 4U);
+
+    matchQueries = 0;
+    begin = std::chrono::steady_clock::now();
+    deviceIds = extMgr.DeleteBundlesOfBundleInfoMap(updated->GetBundleName());
+    extMgr.MatchDriverInfos(deviceIds);
+    auto fullUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    ASSERT_EQ(GetBoundDrivers(extMgr), expected);
+    ASSERT_EQ(matchQueries, deviceNum);
+    std::cout << deviceNum << " devices x " << driverNum << " drivers, incremental re-match: " << incrementalUs
+        << " us, " << incrementalQueries << " match queries; full re-match: " << fullUs << " us, "
+        << matchQueries << " match queries" << std::endl;
+
+    // bundle 20 is removed, device 40 is left without a driver and nothing else is queried
+    uninstall("matchBundle20");
+    matchQueries = 0;
+    deviceIds = extMgr.DeleteBundlesOfBundleInfoMap("matchBundle20");
+    extMgr.MatchDriverInfos(deviceIds, {});
+    ASSERT_EQ(GetBoundDrivers(extMgr), matchAll());
+    ASSERT_EQ(matchQueries, 1U);
+
+    extMgr.driverMatcher_ = ExtDeviceManager::QueryMatchDriver;
+    extMgr.DeleteBundlesOfBundleInfoMap();
+    clearDeviceMap(extMgr);
+}
+
+static std::shared_ptr<UsbDeviceInfo> MakeCompositeDevice(uint32_t busDeviceId, const std::vector<uint8_t> &classes)
+{
+    std::shared_ptr<UsbDeviceInfo> device = std::make_shared<UsbDeviceInfo>(busDeviceId);
+    device->idVendor_ = 0x3000;
+    device->idProduct_ = 1;
+    device->deviceClass_ = UsbDeviceInfo::USB_CLASS_PER_INTERFACE;
+    for (uint8_t i = 0; i < classes.size(); ++i) {
+        UsbInterfaceDescriptor desc {};
+        desc.bInterfaceNumber = i;
+        desc.bInterfaceClass = classes[i];
+        device->interfaceDescList_.push_back(desc);
+    }
+    for (const auto &desc : device->interfaceDescList_) {
+        std::shared_ptr<UsbDeviceInfo> interfaceInfo = std::make_shared<UsbDeviceInfo>(busDeviceId);
+        interfaceInfo->idVendor_ = device->idVendor_;
+        interfaceInfo->idProduct_ = device->idProduct_;
+        interfaceInfo->SetInterfaceNumber(desc.bInterfaceNumber);
+        interfaceInfo->interfaceDescList_.push_back(desc);
+        device->interfaceInfos_.push_back(interfaceInfo);
+    }
+    return device;
+}
+
+// every function of a composite device gets its own record and its own driver
+HWTEST_F(DeviceManagerTest, CompositeDeviceBindTest, TestSize.Level1)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    clearDeviceMap(extMgr);
+    extMgr.DeleteBundlesOfBundleInfoMap();
+    BusExtensionCore &core = BusExtensionCore::GetInstance();
+    if (core.GetBusExtensionByType(BusType::BUS_TYPE_USB) == nullptr) {
+        ASSERT_EQ(core.Register(BusType::BUS_TYPE_USB, std::make_shared<UsbBusExtension>()), EDM_OK);
+    }
+    std::shared_ptr<IBusExtension> usbBus = core.GetBusExtensionByType(BusType::BUS_TYPE_USB);
+    std::vector<std::shared_ptr<DriverInfo>> installed = {MakeUsbDriver(0, {0x3000}), MakeUsbDriver(1, {}),
+        MakeUsbDriver(2, {})};
+    ASSERT_TRUE(static_pointer_cast<UsbDriverInfo>(installed[1]->driverInfoExt_)->SetMatchRules("ifClass=0x03"));
+    ASSERT_TRUE(static_pointer_cast<UsbDriverInfo>(installed[2]->driverInfoExt_)->SetMatchRules("ifClass=0x0a"));
+    extMgr.driverMatcher_ = [&installed, &usbBus](shared_ptr<DeviceInfo> devInfo,
+        const std::string &type) -> shared_ptr<DriverInfo> {
+        for (const auto &driverInfo : installed) {
+            if (usbBus->MatchDriver(*driverInfo, *devInfo, type)) {
+                return driverInfo;
+            }
+        }
+        return nullptr;
+    };
+
+    // subscribers see the whole device only, the interface records take no sequence number
+    std::vector<std::pair<DeviceChangeType, uint64_t>> changes;
+    extMgr.SetDeviceChangeHandler([&changes](uint64_t sequence, DeviceChangeType type,
+        const shared_ptr<Device> &device) {
+        changes.emplace_back(type, device->GetDeviceInfo()->GetDeviceId());
+    });
+
+    // audio control, HID and CDC data
+    std::shared_ptr<UsbDeviceInfo> device = MakeCompositeDevice(1, {0x01, 0x03, 0x0a});
+    ASSERT_EQ(extMgr.RegisterDevice(device), EDM_OK);
+    ASSERT_EQ(changes.size(), 1U);
+    ASSERT_EQ(changes[0].second, device->GetDeviceId());
+    auto boundDrivers = GetBoundDrivers(extMgr);
+    ASSERT_EQ(boundDrivers.size(), 4U);
+    const auto &interfaceInfos = device->GetInterfaceInfos();
+    ASSERT_EQ(boundDrivers[device->GetDeviceId()], "matchBundle0-matchDriver");
+    ASSERT_TRUE(boundDrivers[interfaceInfos[0]->GetDeviceId()].empty());
+    ASSERT_EQ(boundDrivers[interfaceInfos[1]->GetDeviceId()], "matchBundle1-matchDriver");
+    ASSERT_EQ(boundDrivers[interfaceInfos[2]->GetDeviceId()], "matchBundle2-matchDriver");
+    ASSERT_EQ(extMgr.QueryDevice(BusType::BUS_TYPE_USB).size(), 4U);
+
+    // an interface record is bound by its own deviceId, the interface id above the bus type is not part of it
+    uint64_t interfaceId = interfaceInfos[1]->GetDeviceId();
+    ASSERT_EQ(DeviceInfo::GetBusTypeByDeviceId(interfaceId), BusType::BUS_TYPE_USB);
+    std::shared_ptr<Device> interfaceDevice = extMgr.QueryDeviceByDeviceID(interfaceId);
+    ASSERT_NE(interfaceDevice, nullptr);
+    ASSERT_EQ(interfaceDevice->GetDeviceInfo()->GetInterfaceNumber(), 1);
+    interfaceDevice->OnConnect(sptr<TestRemoteObjectStub>::MakeSptr(), static_cast<int>(UsbErrCode::EDM_OK));
+    interfaceDevice->driverInfo_->accessAllowed_ = true;
+    sptr<IDriverExtMgrCallback> connectCallback = sptr<TestDriverExtMgrCallback>::MakeSptr();
+    ASSERT_EQ(extMgr.ConnectDevice(interfaceId, 1, connectCallback), EDM_OK);
+    ASSERT_EQ(interfaceDevice->boundCallerInfos_.size(), 1U);
+
+    // the bus reports the removal of the device only
+    extMgr.UnRegisterDevice(std::make_shared<UsbDeviceInfo>(1));
+    ASSERT_TRUE(extMgr.QueryAllDevices().empty());
+    ASSERT_TRUE(extMgr.bundleMatchMap_.empty());
+    extMgr.SetDeviceChangeHandler(nullptr);
+    ASSERT_EQ(changes.size(), 2U);
+    ASSERT_EQ(changes[1], std::make_pair(DeviceChangeType::DEVICE_CHANGE_REMOVED, device->GetDeviceId()));
+
+    extMgr.driverMatcher_ = ExtDeviceManager::QueryMatchDriver;
+    extMgr.DeleteBundlesOfBundleInfoMap();
+    clearDeviceMap(extMgr);
+}
 } // namespace ExternalDeviceManager
 } // namespace OHOS
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "ipc_object_stub.h"
+#define private public
+#define protected public
+#include "device.h"
+#include "driver_extension_controller.h"
+#include "etx_device_mgr.h"
+#undef protected
+#undef private
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+using namespace testing::ext;
+
+constexpr uint32_t UNBIND_TOKEN_ID = 1;
+constexpr uint32_t UNBIND_BUS_DEVICE_ID = 0x21;
+
+class UnbindRemoteObjectStub : public IRemoteObject {
+public:
+    UnbindRemoteObjectStub() : IRemoteObject(u"IRemoteObject") {}
+    int32_t GetObjectRefCount() { return 0; };
+    int SendRequest(uint32_t code, MessageParcel &data, MessageParcel &reply, MessageOption &option) { return 0; };
+    bool AddDeathRecipient(const sptr<DeathRecipient> &recipient) { return true; };
+    bool RemoveDeathRecipient(const sptr<DeathRecipient> &recipient) { return true; };
+    int Dump(int fd, const std::vector<std::u16string> &args) { return 0; };
+};
+
+class UnbindDriverExtMgrCallback : public IDriverExtMgrCallback {
+public:
+    sptr<IRemoteObject> AsObject()
+    {
+        return sptr<UnbindRemoteObjectStub>::MakeSptr();
+    };
+    ErrCode OnConnect(uint64_t deviceId, const sptr<IRemoteObject> &drvExtObj, const ErrMsg &errMsg)
+    {
+        return EDM_OK;
+    };
+    ErrCode OnDisconnect(uint64_t deviceId, const ErrMsg &errMsg)
+    {
+        return EDM_OK;
+    };
+    ErrCode OnUnBind(uint64_t deviceId, const ErrMsg &errMsg)
+    {
+        return EDM_OK;
+    };
+};
+
+// Binds a launch-on-bind driver through the device manager with the ability manager calls replaced, the
+// connect and disconnect callbacks come on threads of their own as they do from the ability manager.
+class DriverExtensionUnbindTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+        extMgr.deviceMap_.clear();
+        extMgr.DeleteBundlesOfBundleInfoMap();
+        auto driverInfo = make_shared<DriverInfo>("com.example.unbindtest", "UnbindDriver");
+        driverInfo->launchOnBind_ = true;
+        extMgr.driverMatcher_ = [driverInfo](shared_ptr<DeviceInfo> devInfo, const std::string &type) {
+            return driverInfo;
+        };
+
+        DriverExtensionController &controller = DriverExtensionController::GetInstance();
+        sptr<IRemoteObject> remote = new IPCObjectStub(u"unbindTest");
+        controller.abilityConnector_ = [this, remote](const shared_ptr<DrvExtConnectionInfo> &info) {
+            connects_++;
+            thread([info, remote]() {
+                DriverExtensionController::NotifyConnectDone(info->connectInner_, remote, EDM_OK);
+            }).detach();
+            return EDM_OK;
+        };
+        controller.abilityDisconnector_ = [this](const shared_ptr<DrvExtConnectionInfo> &info) {
+            disconnects_++;
+            thread([info]() {
+                DriverExtensionController::NotifyDisconnectDone(info->connectInner_, EDM_OK);
+            }).detach();
+            return EDM_OK;
+        };
+        controller.abilityStopper_ = [this](const std::string &bundleName, const std::string &abilityName,
+            int32_t userId) {
+            stops_++;
+            return EDM_OK;
+        };
+    }
+
+    void TearDown() override
+    {
+        DriverExtensionController &controller = DriverExtensionController::GetInstance();
+        controller.abilityConnector_ = DriverExtensionController::ConnectAbility;
+        controller.abilityDisconnector_ = DriverExtensionController::DisconnectAbility;
+        controller.abilityStopper_ = DriverExtensionController::StopAbility;
+        ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+        extMgr.driverMatcher_ = ExtDeviceManager::QueryMatchDriver;
+        extMgr.deviceMap_.clear();
+        extMgr.DeleteBundlesOfBundleInfoMap();
+    }
+
+    // no bus extension serves the test bus, the device is matched through driverMatcher_ only
+    static shared_ptr<DeviceInfo> MakeDeviceInfo()
+    {
+        auto devInfo = make_shared<DeviceInfo>(UNBIND_BUS_DEVICE_ID, BusType::BUS_TYPE_TEST);
+        devInfo->devInfo_.deviceId = (static_cast<uint64_t>(UNBIND_BUS_DEVICE_ID) << 32) | BusType::BUS_TYPE_TEST;
+        return devInfo;
+    }
+
+    // returns once the device is bound or unbound as asked, or false after 5 seconds
+    static bool WaitBound(const shared_ptr<Device> &device, bool bound)
+    {
+        auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+        while (chrono::steady_clock::now() < deadline) {
+            {
+                lock_guard<recursive_mutex> lock(device->deviceMutex_);
+                if ((device->drvExtRemote_ != nullptr) == bound) {
+                    return true;
+                }
+            }
+            this_thread::yield();
+        }
+        return false;
+    }
+
+    bool WaitStops(uint32_t stops)
+    {
+        auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+        while (stops_.load() < stops) {
+            if (chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            this_thread::yield();
+        }
+        return true;
+    }
+
+    atomic<uint32_t> connects_ {0};
+    atomic<uint32_t> disconnects_ {0};
+    atomic<uint32_t> stops_ {0};
+};
+
+HWTEST_F(DriverExtensionUnbindTest, UnbindStopsExtensionTest, TestSize.Level1)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    auto devInfo = MakeDeviceInfo();
+    ASSERT_EQ(extMgr.RegisterDevice(devInfo), EDM_OK);
+    shared_ptr<Device> device = extMgr.QueryDeviceByDeviceID(devInfo->GetDeviceId());
+    ASSERT_NE(device, nullptr);
+    // launched on bind, nothing is connected for the attach alone
+    ASSERT_EQ(connects_.load(), 0U);
+
+    sptr<IDriverExtMgrCallback> callback = sptr<UnbindDriverExtMgrCallback>::MakeSptr();
+    ASSERT_EQ(extMgr.ConnectDevice(devInfo->GetDeviceId(), UNBIND_TOKEN_ID, callback), EDM_OK);
+    ASSERT_TRUE(WaitBound(device, true));
+
+    // the last caller unbinds while the device stays attached: the extension is disconnected and stopped
+    ASSERT_EQ(extMgr.DisConnectDevice(devInfo->GetDeviceId(), UNBIND_TOKEN_ID), EDM_OK);
+    ASSERT_TRUE(WaitBound(device, false));
+    ASSERT_TRUE(WaitStops(1));
+    ASSERT_EQ(disconnects_.load(), 1U);
+    ASSERT_NE(extMgr.QueryDeviceByDeviceID(devInfo->GetDeviceId()), nullptr);
+
+    // the same through the unbind by deviceId
+    ASSERT_EQ(extMgr.ConnectDevice(devInfo->GetDeviceId(), UNBIND_TOKEN_ID, callback), EDM_OK);
+    ASSERT_TRUE(WaitBound(device, true));
+    ASSERT_EQ(extMgr.DisConnectDriverWithDeviceId(devInfo->GetDeviceId(), UNBIND_TOKEN_ID), EDM_OK);
+    ASSERT_TRUE(WaitBound(device, false));
+    ASSERT_TRUE(WaitStops(2));
+    ASSERT_EQ(connects_.load(), 2U);
+    ASSERT_EQ(disconnects_.load(), 2U);
+}
+
+HWTEST_F(DriverExtensionUnbindTest, UnplugStopsExtensionTest, TestSize.Level1)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    auto devInfo = MakeDeviceInfo();
+    ASSERT_EQ(extMgr.RegisterDevice(devInfo), EDM_OK);
+    shared_ptr<Device> device = extMgr.QueryDeviceByDeviceID(devInfo->GetDeviceId());
+    ASSERT_NE(device, nullptr);
+    sptr<IDriverExtMgrCallback> callback = sptr<UnbindDriverExtMgrCallback>::MakeSptr();
+    ASSERT_EQ(extMgr.ConnectDevice(devInfo->GetDeviceId(), UNBIND_TOKEN_ID, callback), EDM_OK);
+    ASSERT_TRUE(WaitBound(device, true));
+
+    ASSERT_EQ(extMgr.UnRegisterDevice(devInfo), EDM_OK);
+    ASSERT_TRUE(WaitBound(device, false));
+    ASSERT_TRUE(WaitStops(1));
+    ASSERT_EQ(disconnects_.load(), 1U);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include "edm_trace.h"
+#include "hilog_wrapper.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+using namespace testing::ext;
+
+// a trace captured with "hitrace -b 20480 ohos > /data/local/tmp/edm_attach.trace" while plugging devices in
+static constexpr const char *CAPTURED_TRACE_PATH = "/data/local/tmp/edm_attach.trace";
+static constexpr const char *TRACE_MARKER = ": tracing_mark_write: ";
+static constexpr double US_PER_SECOND = 1000000.0;
+// from plugging the device in to its driver extension being connected
+static constexpr const char *ATTACH_TO_BIND = "AttachToBind";
+
+struct TraceEvent {
+    char phase = 0;
+    int32_t tid = 0;
+    double timestampUs = 0;
+    string name;
+    string taskId;
+};
+
+// Turns the tracing_mark_write lines of a captured trace into latencies per stage, each span of a stage is one
+// sample. Spans of the same thread nest, async spans are matched by name and task id.
+class EdmTraceBreakdown {
+public:
+    void Feed(const string &line)
+    {
+        TraceEvent event;
+        if (!ParseLine(line, event)) {
+            return;
+        }
+        switch (event.phase) {
+            case 'B':
+                if (StageOf(event.name) == TRACE_USB_DEVICE_CONNECT || StageOf(event.name) == TRACE_REGISTER_DEVICE) {
+                    attachBegins_.emplace(DeviceOf(event.name), event.timestampUs);
+                }
+                openSpans_[event.tid].push_back(event);
+                break;
+            case 'E':
+                if (!openSpans_[event.tid].empty()) {
+                    const TraceEvent &begin = openSpans_[event.tid].back();
+                    AddSample(StageOf(begin.name), event.timestampUs - begin.timestampUs);
+                    openSpans_[event.tid].pop_back();
+                }
+                break;
+            case 'S':
+                openAsyncSpans_[event.name + "|" + event.taskId] = event.timestampUs;
+                break;
+            case 'F': {
+                auto iter = openAsyncSpans_.find(event.name + "|" + event.taskId);
+                if (iter == openAsyncSpans_.end()) {
+                    break;
+                }
+                AddSample(StageOf(event.name), event.timestampUs - iter->second);
+                openAsyncSpans_.erase(iter);
+                auto attach = attachBegins_.find(DeviceOf(event.name));
+                if (StageOf(event.name) == TRACE_BIND_DRIVER && attach != attachBegins_.end()) {
+                    AddSample(ATTACH_TO_BIND, event.timestampUs - attach->second);
+                    attachBegins_.erase(attach);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    const vector<double> &GetSamples(const string &stage)
+    {
+        return samples_[stage];
+    }
+
+    void Report(ostream &out)
+    {
+        out << "stage                        count     mean(us)      p50(us)      max(us)" << endl;
+        for (const char *stage : {TRACE_USB_DEVICE_CONNECT, TRACE_REGISTER_DEVICE, TRACE_QUERY_MATCH_DRIVER,
+            TRACE_PKG_DB_QUERY, TRACE_DEVICE_CONNECT, TRACE_CONNECT_DRIVER_EXTENSION, TRACE_START_DRIVER_EXTENSION,
+            TRACE_BIND_DRIVER, ATTACH_TO_BIND}) {
+            vector<double> samples = samples_[stage];
+            if (samples.empty()) {
+                continue;
+            }
+            sort(samples.begin(), samples.end());
+            double sum = 0;
+            for (double sample : samples) {
+                sum += sample;
+            }
+            char line[128] = {0};
+            (void)snprintf(line, sizeof(line), "%-26s %7zu %12.1f %12.1f %12.1f", stage, samples.size(),
+                sum / samples.size(), samples[(samples.size() - 1) / 2], samples.back());
+            out << line << endl;
+        }
+    }
+
+private:
+    //           <...>-1234  (   1200) [003] .... 1024.123456: tracing_mark_write: B|1200|H:EdmRegisterDevice ...
+    static bool ParseLine(const string &line, TraceEvent &event)
+    {
+        size_t marker = line.find(TRACE_MARKER);
+        if (marker == string::npos) {
+            return false;
+        }
+        size_t timestampBegin = line.find_last_of(' ', marker);
+        size_t task = line.find_first_not_of(' ');
+        size_t taskEnd = line.find_first_of(" (", task);
+        size_t tidBegin = line.rfind('-', taskEnd);
+        if (timestampBegin == string::npos || tidBegin == string::npos || tidBegin < task) {
+            return false;
+        }
+        event.timestampUs = atof(line.substr(timestampBegin + 1, marker - timestampBegin - 1).c_str()) * US_PER_SECOND;
+        event.tid = atoi(line.substr(tidBegin + 1, taskEnd - tidBegin - 1).c_str());
+        vector<string> fields;
+        stringstream payload(line.substr(marker + strlen(TRACE_MARKER)));
+        string field;
+        while (getline(payload, field, '|')) {
+            fields.push_back(field);
+        }
+        if (fields.empty() || fields[0].size() != 1) {
+            return false;
+        }
+        event.phase = fields[0][0];
+        if (event.phase == 'E') {
+            return true;
+        }
+        const size_t nameIndex = 2;
+        const size_t taskIdIndex = 3;
+        if (fields.size() <= nameIndex) {
+            return false;
+        }
+        event.name = fields[nameIndex].compare(0, strlen("H:"), "H:") == 0 ? fields[nameIndex].substr(strlen("H:")) :
+            fields[nameIndex];
+        if (event.phase == 'S' || event.phase == 'F') {
+            if (fields.size() <= taskIdIndex) {
+                return false;
+            }
+            event.taskId = fields[taskIdIndex];
+        }
+        return true;
+    }
+
+    static string StageOf(const string &name)
+    {
+        return name.substr(0, name.find(' '));
+    }
+
+    static string DeviceOf(const string &name)
+    {
+        size_t pos = name.find(' ');
+        return pos == string::npos ? "" : name.substr(pos + 1);
+    }
+
+    void AddSample(const string &stage, double durationUs)
+    {
+        samples_[stage].push_back(durationUs);
+    }
+
+    map<int32_t, vector<TraceEvent>> openSpans_;
+    map<string, double> openAsyncSpans_;
+    map<string, double> attachBegins_;
+    map<string, vector<double>> samples_;
+};
+
+class EdmTraceBreakdownTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_DEV_MGR, "EdmTraceBreakdownTest SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_DEV_MGR, "EdmTraceBreakdownTest TearDown");
+    }
+};
+
+static void ExpectSamples(EdmTraceBreakdown &breakdown, const string &stage, const vector<double> &expected)
+{
+    const vector<double> &samples = breakdown.GetSamples(stage);
+    ASSERT_EQ(samples.size(), expected.size()) << stage;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(samples[i], expected[i], 0.5) << stage << " " << i;
+    }
+}
+
+HWTEST_F(EdmTraceBreakdownTest, TraceNameTest001, TestSize.Level1)
+{
+    uint64_t deviceId = 0x0000000100020001;
+    ASSERT_EQ(EdmTraceName(TRACE_REGISTER_DEVICE, deviceId), "EdmRegisterDevice 0000000100020001");
+    ASSERT_EQ(EdmTraceTaskId(deviceId), 0x00020000);
+    ASSERT_NE(EdmTraceTaskId(deviceId), EdmTraceTaskId(deviceId + 1));
+}
+
+// Two devices plugged in 1 ms apart, the first bound through a new extension, the second through an idle one.
+HWTEST_F(EdmTraceBreakdownTest, BreakdownTest001, TestSize.Level1)
+{
+    const vector<string> trace = {
+        "  usb_host-1301  ( 1200) [001] .... 100.000000: tracing_mark_write: B|1200|H:EdmUsbDeviceConnect "
+            "0000000100010001",
+        "  usb_host-1301  ( 1200) [001] .... 100.000400: tracing_mark_write: B|1200|H:EdmRegisterDevice "
+            "0000000100010001",
+        "  usb_host-1301  ( 1200) [001] .... 100.000410: tracing_mark_write: B|1200|H:EdmQueryMatchDriver "
+            "0000000100010001",
+        "  usb_host-1301  ( 1200) [001] .... 100.000420: tracing_mark_write: B|1200|H:EdmPkgDbQuery",
+        "  usb_host-1301  ( 1200) [001] .... 100.000620: tracing_mark_write: E|1200|",
+        "  usb_host-1301  ( 1200) [001] .... 100.000700: tracing_mark_write: E|1200|",
+        "  usb_host-1301  ( 1200) [001] .... 100.000710: tracing_mark_write: B|1200|H:EdmDeviceConnect "
+            "0000000100010001",
+        "  usb_host-1301  ( 1200) [001] .... 100.000720: tracing_mark_write: S|1200|H:EdmBindDriver "
+            "0000000100010001|65536",
+        "  usb_host-1301  ( 1200) [001] .... 100.000730: tracing_mark_write: B|1200|H:EdmConnectDriverExtension",
+        "  usb_host-1301  ( 1200) [001] .... 100.000930: tracing_mark_write: E|1200|",
+        "  usb_host-1301  ( 1200) [001] .... 100.000940: tracing_mark_write: E|1200|",
+        "  usb_host-1301  ( 1200) [001] .... 100.000950: tracing_mark_write: E|1200|",
+        "  usb_host-1301  ( 1200) [001] .... 100.000960: tracing_mark_write: E|1200|",
+        "  usb_host-1301  ( 1200) [001] .... 100.001000: tracing_mark_write: B|1200|H:EdmUsbDeviceConnect "
+            "0000000100010002",
+        "  usb_host-1301  ( 1200) [001] .... 100.001300: tracing_mark_write: B|1200|H:EdmRegisterDevice "
+            "0000000100010002",
+        "  usb_host-1301  ( 1200) [001] .... 100.001310: tracing_mark_write: B|1200|H:EdmQueryMatchDriver "
+            "0000000100010002",
+        "  usb_host-1301  ( 1200) [001] .... 100.001320: tracing_mark_write: B|1200|H:EdmPkgDbQuery",
+        "  usb_host-1301  ( 1200) [001] .... 100.001420: tracing_mark_write: E|1200|",
+        "  usb_host-1301  ( 1200) [001] .... 100.001500: tracing_mark_write: E|1200|",
+        "  usb_host-1301  ( 1200) [001] .... 100.001510: tracing_mark_write: B|1200|H:EdmDeviceConnect "
+            "0000000100010002",
+        "  usb_host-1301  ( 1200) [001] .... 100.001520: tracing_mark_write: S|1200|H:EdmBindDriver "
+            "0000000100010002|65539",
+        "  usb_host-1301  ( 1200) [001] .... 100.001530: tracing_mark_write: B|1200|H:EdmConnectDriverExtension",
+        "  usb_host-1301  ( 1200) [001] .... 100.001560: tracing_mark_write: E|1200|",
+        "  usb_host-1301  ( 1200) [001] .... 100.001570: tracing_mark_write: E|1200|",
+        "  usb_host-1301  ( 1200) [001] .... 100.001580: tracing_mark_write: E|1200|",
+        "  usb_host-1301  ( 1200) [001] .... 100.001590: tracing_mark_write: E|1200|",
+        // the idle extension answers at once, the new one has to be started by the ability manager first
+        "  <...>-1377  ( 1200) [002] .... 100.001720: tracing_mark_write: F|1200|H:EdmBindDriver "
+            "0000000100010002|65539",
+        "  binder:1200_2-1290  ( 1200) [000] .... 100.045720: tracing_mark_write: F|1200|H:EdmBindDriver "
+            "0000000100010001|65536",
+    };
+    EdmTraceBreakdown breakdown;
+    for (const auto &line : trace) {
+        breakdown.Feed(line);
+    }
+    breakdown.Report(cout);
+    ExpectSamples(breakdown, TRACE_USB_DEVICE_CONNECT, {960, 590});
+    ExpectSamples(breakdown, TRACE_REGISTER_DEVICE, {550, 280});
+    ExpectSamples(breakdown, TRACE_QUERY_MATCH_DRIVER, {290, 190});
+    ExpectSamples(breakdown, TRACE_PKG_DB_QUERY, {200, 100});
+    ExpectSamples(breakdown, TRACE_DEVICE_CONNECT, {230, 60});
+    ExpectSamples(breakdown, TRACE_CONNECT_DRIVER_EXTENSION, {200, 30});
+    ExpectSamples(breakdown, TRACE_BIND_DRIVER, {200, 45000});
+    ExpectSamples(breakdown, ATTACH_TO_BIND, {720, 45720});
+}
+
+HWTEST_F(EdmTraceBreakdownTest, CapturedTraceTest001, TestSize.Level1)
+{
+    if (access(CAPTURED_TRACE_PATH, R_OK) != 0) {
+        GTEST_SKIP() << "no trace at " << CAPTURED_TRACE_PATH;
+    }
+    ifstream file(CAPTURED_TRACE_PATH);
+    EdmTraceBreakdown breakdown;
+    string line;
+    while (getline(file, line)) {
+        breakdown.Feed(line);
+    }
+    breakdown.Report(cout);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#include "ipc_object_stub.h"
+#define private public
+#define protected public
+#include "bus_extension_core.h"
+#include "dev_change_callback.h"
+#include "device.h"
+#include "driver_extension_controller.h"
+#include "etx_device_mgr.h"
+#include "virtual_bus_extension.h"
+#undef protected
+#undef private
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+using namespace testing::ext;
+
+class HotplugStormBenchmark : public testing::Test {
+public:
+    void SetUp() override
+    {
+        EDM_LOGD(MODULE_DEV_MGR, "HotplugStormBenchmark SetUp");
+    }
+    void TearDown() override
+    {
+        EDM_LOGD(MODULE_DEV_MGR, "HotplugStormBenchmark TearDown");
+    }
+};
+
+class LatencySamples {
+public:
+    explicit LatencySamples(const string &name) : name_(name) {}
+
+    void Add(chrono::steady_clock::duration sample)
+    {
+        samples_.push_back(chrono::duration_cast<chrono::microseconds>(sample).count());
+    }
+
+    void Report()
+    {
+        sort(samples_.begin(), samples_.end());
+        auto at = [this](double percentile) {
+            return samples_[static_cast<size_t>(percentile * (samples_.size() - 1))];
+        };
+        cout << name_ << ": p50 " << at(0.5) << " us, p99 " << at(0.99) << " us, max " << samples_.back()
+            << " us" << endl;
+    }
+
+    size_t Size() const
+    {
+        return samples_.size();
+    }
+
+private:
+    string name_;
+    vector<int64_t> samples_;
+};
+
+static shared_ptr<Device> FindDevice(ExtDeviceManager &extMgr, uint64_t deviceId)
+{
+    lock_guard<mutex> lock(extMgr.deviceMapMutex_);
+    auto &map = extMgr.deviceMap_[BusType::BUS_TYPE_VIRTUAL];
+    auto iter = map.find(deviceId);
+    return iter != map.end() ? iter->second : nullptr;
+}
+
+static bool IsBound(const shared_ptr<Device> &device)
+{
+    lock_guard<recursive_mutex> lock(device->deviceMutex_);
+    return device->drvExtRemote_ != nullptr;
+}
+
+// the connect and disconnect callbacks come on threads of their own, as they do from the ability manager
+template <typename Condition>
+static bool SpinUntil(Condition condition)
+{
+    auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+    while (!condition()) {
+        if (chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        this_thread::yield();
+    }
+    return true;
+}
+
+static shared_ptr<DriverInfo> MakeVirtualDriver(uint32_t index, uint16_t vid)
+{
+    auto driverInfo = make_shared<DriverInfo>("stormBundle" + to_string(index), "stormDriver");
+    driverInfo->bus_ = "virtual";
+    driverInfo->busType_ = BusType::BUS_TYPE_VIRTUAL;
+    // started as soon as its device is plugged in, so every attach ends in a bind
+    driverInfo->launchOnBind_ = false;
+    auto virtualDriverInfo = make_shared<VirtualDriverInfo>();
+    virtualDriverInfo->vids_ = {vid};
+    virtualDriverInfo->pids_ = {1};
+    driverInfo->driverInfoExt_ = virtualDriverInfo;
+    return driverInfo;
+}
+
+// Plugs and unplugs virtual devices back to back through the whole attach path: the bus reports the device,
+// it is registered and matched, and its driver extension is connected. Starting the extension is stubbed
+// out, so what is left is the cost of the device manager itself.
+HWTEST_F(HotplugStormBenchmark, TenThousandReplugs, TestSize.Level1)
+{
+    constexpr uint32_t cycles = 10000;
+    constexpr uint32_t driverNum = 100;
+    constexpr uint32_t stormDriverNum = 4;
+    constexpr uint16_t baseVid = 0x5000;
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    extMgr.deviceMap_.clear();
+    extMgr.matchKeyIndex_.clear();
+    extMgr.deviceMatchKeys_.clear();
+    extMgr.DeleteBundlesOfBundleInfoMap();
+    BusExtensionCore &core = BusExtensionCore::GetInstance();
+    if (core.GetBusExtensionByType(BusType::BUS_TYPE_VIRTUAL) == nullptr) {
+        ASSERT_EQ(core.Register(BusType::BUS_TYPE_VIRTUAL, make_shared<VirtualBusExtension>()), EDM_OK);
+    }
+    auto bus = static_pointer_cast<VirtualBusExtension>(core.GetBusExtensionByType(BusType::BUS_TYPE_VIRTUAL));
+    ASSERT_EQ(bus->SetDevChangeCallback(make_shared<DevChangeCallback>()), EDM_OK);
+
+    // the drivers of the storm come last, every match walks the whole list like a query of pkg.db does
+    vector<shared_ptr<DriverInfo>> installed;
+    for (uint32_t i = 0; i < driverNum; ++i) {
+        installed.push_back(MakeVirtualDriver(i, static_cast<uint16_t>(baseVid + driverNum - 1 - i)));
+    }
+    LatencySamples matchLatency("match");
+    extMgr.driverMatcher_ = [&installed, &bus, &matchLatency](shared_ptr<DeviceInfo> devInfo,
+        const std::string &type) -> shared_ptr<DriverInfo> {
+        auto begin = chrono::steady_clock::now();
+        shared_ptr<DriverInfo> matched;
+        for (const auto &driverInfo : installed) {
+            if (bus->MatchDriver(*driverInfo, *devInfo, type)) {
+                matched = driverInfo;
+                break;
+            }
+        }
+        matchLatency.Add(chrono::steady_clock::now() - begin);
+        return matched;
+    };
+
+    DriverExtensionController &controller = DriverExtensionController::GetInstance();
+    sptr<IRemoteObject> remote = new IPCObjectStub(u"hotplugStormTest");
+    atomic<uint32_t> connects {0};
+    controller.abilityConnector_ = [&connects, remote](const shared_ptr<DrvExtConnectionInfo> &info) {
+        connects++;
+        thread([info, remote]() { DriverExtensionController::NotifyConnectDone(info->connectInner_, remote, EDM_OK); })
+            .detach();
+        return EDM_OK;
+    };
+    controller.abilityDisconnector_ = [](const shared_ptr<DrvExtConnectionInfo> &info) {
+        thread([info]() { DriverExtensionController::NotifyDisconnectDone(info->connectInner_, EDM_OK); }).detach();
+        return EDM_OK;
+    };
+    atomic<uint32_t> stops {0};
+    controller.abilityStopper_ = [&stops](const string &bundleName, const string &abilityName, int32_t userId) {
+        stops++;
+        return EDM_OK;
+    };
+
+    LatencySamples registerLatency("register");
+    LatencySamples bindLatency("attach to bind");
+    LatencySamples unplugLatency("unplug");
+    auto stormBegin = chrono::steady_clock::now();
+    for (uint32_t cycle = 0; cycle < cycles; ++cycle) {
+        // a replugged device comes back at a new address, as it does on a real bus
+        auto device = make_shared<VirtualDeviceInfo>(cycle + 1);
+        device->SetVendorId(static_cast<uint16_t>(baseVid + cycle % stormDriverNum));
+        device->SetProductId(1);
+        auto begin = chrono::steady_clock::now();
+        ASSERT_EQ(bus->Attach(device), EDM_OK);
+        registerLatency.Add(chrono::steady_clock::now() - begin);
+        shared_ptr<Device> registered = FindDevice(extMgr, device->GetDeviceId());
+        ASSERT_NE(registered, nullptr);
+        ASSERT_TRUE(SpinUntil([&registered]() { return IsBound(registered); })) << cycle;
+        bindLatency.Add(chrono::steady_clock::now() - begin);
+
+        begin = chrono::steady_clock::now();
+        ASSERT_EQ(bus->Detach(device->GetBusDevId()), EDM_OK);
+        ASSERT_TRUE(SpinUntil([&extMgr, &device]() {
+            return FindDevice(extMgr, device->GetDeviceId()) == nullptr;
+        })) << cycle;
+        unplugLatency.Add(chrono::steady_clock::now() - begin);
+    }
+    auto stormMs = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - stormBegin).count();
+
+    cout << cycles << " attach/detach cycles over " << driverNum << " drivers in " << stormMs << " ms, "
+        << connects.load() << " extensions started, " << stops.load() << " stopped" << endl;
+    registerLatency.Report();
+    matchLatency.Report();
+    bindLatency.Report();
+    unplugLatency.Report();
+    ASSERT_EQ(bindLatency.Size(), cycles);
+    ASSERT_EQ(matchLatency.Size(), cycles);
+    ASSERT_EQ(connects.load(), cycles);
+    ASSERT_TRUE(SpinUntil([&stops]() { return stops.load() == cycles; }));
+    ASSERT_EQ(bus->GetAttachedCount(), 0U);
+    ASSERT_TRUE(extMgr.bundleMatchMap_.empty());
+
+    ASSERT_EQ(bus->SetDevChangeCallback(nullptr), EDM_OK);
+    controller.abilityConnector_ = DriverExtensionController::ConnectAbility;
+    controller.abilityDisconnector_ = DriverExtensionController::DisconnectAbility;
+    controller.abilityStopper_ = DriverExtensionController::StopAbility;
+    extMgr.driverMatcher_ = ExtDeviceManager::QueryMatchDriver;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include "edm_errors.h"
+#include "hilog_wrapper.h"
+#define private public
+#include "dev_change_callback.h"
+#include "etx_device_mgr.h"
+#include "unload_policy.h"
+#undef private
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+using namespace testing::ext;
+
+class UnloadPolicyTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        nowMs_ = 0;
+        underPressure_ = false;
+        savedState_.clear();
+        bootId_ = "boot-a";
+    }
+    void TearDown() override {}
+
+    std::shared_ptr<AdaptiveUnloadPolicy> MakePolicy()
+    {
+        return std::make_shared<AdaptiveUnloadPolicy>(
+            [this]() { return nowMs_; },
+            [this]() { return underPressure_; },
+            [this](std::string &state) {
+                state = savedState_;
+                return !state.empty();
+            },
+            [this](const std::string &state) { savedState_ = state; },
+            [this]() { return bootId_; });
+    }
+
+    // the last device leaves, the next one arrives gapMs later
+    static void Reconnect(AdaptiveUnloadPolicy &policy, int64_t &nowMs, int64_t gapMs)
+    {
+        policy.OnIdle();
+        nowMs += gapMs;
+        policy.OnDeviceAttached();
+    }
+
+    int64_t nowMs_ = 0;
+    bool underPressure_ = false;
+    std::string savedState_;
+    std::string bootId_;
+};
+
+class RecordingUnloadPolicy : public IUnloadPolicy {
+public:
+    void OnDeviceAttached() override
+    {
+        attached++;
+    }
+    int64_t OnIdle() override
+    {
+        idle++;
+        return AdaptiveUnloadPolicy::MAX_HOLD_OFF_MS;
+    }
+    void OnUnload() override {}
+    UnloadPolicyStats GetStats() override
+    {
+        return {};
+    }
+
+    uint32_t attached = 0;
+    uint32_t idle = 0;
+};
+
+HWTEST_F(UnloadPolicyTest, DefaultHoldOffTest, TestSize.Level1)
+{
+    auto policy = MakePolicy();
+    // nothing learned yet, the service waits as long as it always did
+    ASSERT_EQ(policy->OnIdle(), AdaptiveUnloadPolicy::DEFAULT_HOLD_OFF_MS);
+    ASSERT_EQ(FixedUnloadPolicy(AdaptiveUnloadPolicy::DEFAULT_HOLD_OFF_MS).OnIdle(),
+        AdaptiveUnloadPolicy::DEFAULT_HOLD_OFF_MS);
+    auto stats = policy->GetStats();
+    ASSERT_EQ(stats.idlePeriods, 1U);
+    ASSERT_EQ(stats.holdOffMs, AdaptiveUnloadPolicy::DEFAULT_HOLD_OFF_MS);
+}
+
+HWTEST_F(UnloadPolicyTest, AdaptToReconnectGapTest, TestSize.Level1)
+{
+    auto policy = MakePolicy();
+    const int64_t gapMs = 60 * 1000;
+    for (int i = 0; i < 5; i++) {
+        Reconnect(*policy, nowMs_, gapMs);
+    }
+    int64_t holdOffMs = policy->OnIdle();
+    ASSERT_EQ(holdOffMs, static_cast<int64_t>(AdaptiveUnloadPolicy::GAP_MARGIN * gapMs));
+    auto stats = policy->GetStats();
+    ASSERT_EQ(stats.reconnectGapMs, gapMs);
+    ASSERT_GT(stats.reconnectRate, AdaptiveUnloadPolicy::MIN_RECONNECT_RATE);
+
+    // quick replugs bring the hold-off down, but not below the minimum
+    for (int i = 0; i < 20; i++) {
+        Reconnect(*policy, nowMs_, 100);
+    }
+    ASSERT_EQ(policy->OnIdle(), AdaptiveUnloadPolicy::MIN_HOLD_OFF_MS);
+}
+
+HWTEST_F(UnloadPolicyTest, HoldOffCapTest, TestSize.Level1)
+{
+    auto policy = MakePolicy();
+    for (int i = 0; i < 10; i++) {
+        Reconnect(*policy, nowMs_, AdaptiveUnloadPolicy::MAX_HOLD_OFF_MS);
+    }
+    ASSERT_EQ(policy->OnIdle(), AdaptiveUnloadPolicy::MAX_HOLD_OFF_MS);
+}
+
+HWTEST_F(UnloadPolicyTest, RareReconnectTest, TestSize.Level1)
+{
+    auto policy = MakePolicy();
+    Reconnect(*policy, nowMs_, 60 * 1000);
+    // devices mostly come back long after any hold-off, waiting only costs memory
+    for (int i = 0; i < 5; i++) {
+        Reconnect(*policy, nowMs_, AdaptiveUnloadPolicy::MAX_HOLD_OFF_MS * 10);
+    }
+    ASSERT_LT(policy->GetStats().reconnectRate, AdaptiveUnloadPolicy::MIN_RECONNECT_RATE);
+    ASSERT_EQ(policy->OnIdle(), AdaptiveUnloadPolicy::MIN_HOLD_OFF_MS);
+}
+
+HWTEST_F(UnloadPolicyTest, MemoryPressureTest, TestSize.Level1)
+{
+    auto policy = MakePolicy();
+    for (int i = 0; i < 5; i++) {
+        Reconnect(*policy, nowMs_, 60 * 1000);
+    }
+    underPressure_ = true;
+    ASSERT_EQ(policy->OnIdle(), AdaptiveUnloadPolicy::MIN_HOLD_OFF_MS);
+    ASSERT_EQ(policy->GetStats().pressureUnloads, 1U);
+    underPressure_ = false;
+    ASSERT_GT(policy->OnIdle(), AdaptiveUnloadPolicy::DEFAULT_HOLD_OFF_MS);
+}
+
+HWTEST_F(UnloadPolicyTest, ColdStartsAvoidedTest, TestSize.Level1)
+{
+    auto policy = MakePolicy();
+    const int64_t gapMs = 45 * 1000;
+    // the first gap is longer than the default hold-off, the service would have been unloaded already
+    Reconnect(*policy, nowMs_, gapMs);
+    ASSERT_EQ(policy->GetStats().coldStartsAvoided, 0U);
+    int64_t holdOffMs = policy->OnIdle();
+    ASSERT_GT(holdOffMs, gapMs);
+    nowMs_ += gapMs;
+    policy->OnDeviceAttached();
+    // this time the service was still loaded, the fixed timer would have unloaded it
+    ASSERT_EQ(policy->GetStats().coldStartsAvoided, 1U);
+
+    // a reconnect within the fixed hold-off was never a cold start
+    Reconnect(*policy, nowMs_, 1000);
+    ASSERT_EQ(policy->GetStats().coldStartsAvoided, 1U);
+}
+
+HWTEST_F(UnloadPolicyTest, PersistAcrossLoadsTest, TestSize.Level1)
+{
+    const int64_t gapMs = 90 * 1000;
+    {
+        auto policy = MakePolicy();
+        for (int i = 0; i < 5; i++) {
+            Reconnect(*policy, nowMs_, gapMs);
+        }
+        policy->OnIdle();
+        policy->OnUnload();
+    }
+    ASSERT_FALSE(savedState_.empty());
+
+    // loaded again because a device arrived after the service went away
+    nowMs_ += AdaptiveUnloadPolicy::MAX_HOLD_OFF_MS * 2;
+    auto policy = MakePolicy();
+    policy->OnDeviceAttached();
+    auto stats = policy->GetStats();
+    ASSERT_EQ(stats.coldStarts, 1U);
+    ASSERT_EQ(stats.idlePeriods, 6U);
+    ASSERT_EQ(stats.reconnectGapMs, gapMs);
+    ASSERT_EQ(policy->OnIdle(), static_cast<int64_t>(AdaptiveUnloadPolicy::GAP_MARGIN * gapMs));
+}
+
+HWTEST_F(UnloadPolicyTest, DiscardBadStateTest, TestSize.Level1)
+{
+    savedState_ = "not a state";
+    auto policy = MakePolicy();
+    ASSERT_EQ(policy->OnIdle(), AdaptiveUnloadPolicy::DEFAULT_HOLD_OFF_MS);
+
+    // written before the boot id was saved
+    savedState_ = "1 500000 60000 3 1 3 0 0 0";
+    policy = MakePolicy();
+    ASSERT_EQ(policy->OnIdle(), AdaptiveUnloadPolicy::DEFAULT_HOLD_OFF_MS);
+
+    // saved in an earlier boot, the idle period it recorded is in the future of this clock
+    nowMs_ = 1000;
+    savedState_ = "2 boot-a 500000 60000 3 1 3 0 0 0";
+    policy = MakePolicy();
+    policy->OnDeviceAttached();
+    ASSERT_EQ(policy->GetStats().coldStarts, 0U);
+    ASSERT_EQ(policy->GetStats().reconnectGapMs, 60 * 1000);
+
+    // saved in an earlier boot that ran longer than this one has so far, only the boot id tells
+    nowMs_ = 600000;
+    bootId_ = "boot-b";
+    policy = MakePolicy();
+    policy->OnDeviceAttached();
+    ASSERT_EQ(policy->GetStats().coldStarts, 0U);
+    ASSERT_EQ(policy->GetStats().reconnectGapMs, 60 * 1000);
+    ASSERT_EQ(policy->OnIdle(), static_cast<int64_t>(AdaptiveUnloadPolicy::GAP_MARGIN * 60 * 1000));
+}
+
+HWTEST_F(UnloadPolicyTest, DeviceManagerUsesPolicyTest, TestSize.Level1)
+{
+    ExtDeviceManager &extMgr = ExtDeviceManager::GetInstance();
+    extMgr.deviceMap_.clear();
+    extMgr.matchKeyIndex_.clear();
+    extMgr.deviceMatchKeys_.clear();
+    auto previous = extMgr.unloadPolicy_;
+    auto policy = std::make_shared<RecordingUnloadPolicy>();
+    extMgr.SetUnloadPolicy(policy);
+
+    std::shared_ptr<DevChangeCallback> callback = std::make_shared<DevChangeCallback>();
+    std::shared_ptr<DeviceInfo> device = std::make_shared<DeviceInfo>(0);
+    device->devInfo_.devBusInfo.busType = BusType::BUS_TYPE_TEST;
+    device->devInfo_.devBusInfo.busDeviceId = 1;
+    ASSERT_EQ(callback->OnDeviceAdd(device), EDM_OK);
+    ASSERT_EQ(callback->OnDeviceRemove(device), EDM_OK);
+    ASSERT_EQ(policy->attached, 1U);
+    ASSERT_GE(policy->idle, 1U);
+
+    extMgr.unloadSelftimer_.Unregister(extMgr.unloadSelftimerId_);
+    extMgr.SetUnloadPolicy(previous);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -13,12 +13,18 @@
  * limitations under the License.
  */
 
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
 #include <gtest/gtest.h>
 #include "edm_errors.h"
+#include "ext_permission_manager.h"
 #include "hilog_wrapper.h"
 #define private public
 #include "driver_ext_mgr.h"
 #undef private
+#include "startup_graph.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
@@ -329,5 +335,119 @@ HWTEST_F(DriverExtMgrTest, OnAddSystemAbilityCommonEventTest, TestSize.Level1)
     instance.OnStop();
     EDM_LOGI(MODULE_FRAMEWORK, "OnAddSystemAbilityCommonEventTest: CommonEvent service added");
 }
+
+HWTEST_F(DriverExtMgrTest, PermissionCacheTtlTest, TestSize.Level1)
+{
+    ExtPermissionCache cache(ExtPermissionCache::DEFAULT_MAX_TOKENS, std::chrono::milliseconds(20));
+    bool granted = false;
+    cache.PutGrant(1, "perm", true, cache.GetEpoch());
+    ASSERT_TRUE(cache.GetGrant(1, "perm", granted));
+    ASSERT_TRUE(granted);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    ASSERT_FALSE(cache.GetGrant(1, "perm", granted));
+}
+
+HWTEST_F(DriverExtMgrTest, PermissionCacheBoundTest, TestSize.Level1)
+{
+    ExtPermissionCache cache(2);
+    bool granted = false;
+    cache.PutGrant(1, "perm", true, cache.GetEpoch());
+    cache.PutGrant(2, "perm", false, cache.GetEpoch());
+    ASSERT_TRUE(cache.GetGrant(1, "perm", granted));
+    // token 2 is the least recently used one
+    cache.PutGrant(3, "perm", true, cache.GetEpoch());
+    ASSERT_EQ(cache.Size(), 2U);
+    ASSERT_TRUE(cache.GetGrant(1, "perm", granted));
+    ASSERT_FALSE(cache.GetGrant(2, "perm", granted));
+    ASSERT_TRUE(cache.GetGrant(3, "perm", granted));
+}
+
+HWTEST_F(DriverExtMgrTest, PermissionCacheInvalidateTest, TestSize.Level1)
+{
+    ExtPermissionCache cache;
+    bool granted = false;
+    cache.PutGrant(1, "perm", true, cache.GetEpoch());
+    std::unordered_set<std::string> values = {"appId1", "appId2"};
+    cache.PutValues(1, "perm", values, cache.GetEpoch());
+    cache.Invalidate(1);
+    ASSERT_FALSE(cache.GetGrant(1, "perm", granted));
+    std::unordered_set<std::string> cachedValues;
+    ASSERT_FALSE(cache.GetValues(1, "perm", cachedValues));
+
+    // a decision queried before an invalidation must not be stored after it
+    uint64_t epoch = cache.GetEpoch();
+    cache.Invalidate(2);
+    cache.PutGrant(1, "perm", true, epoch);
+    ASSERT_FALSE(cache.GetGrant(1, "perm", granted));
+    cache.PutValues(1, "perm", values, cache.GetEpoch());
+    ASSERT_TRUE(cache.GetValues(1, "perm", cachedValues));
+    ASSERT_EQ(cachedValues, values);
+}
+
+HWTEST_F(DriverExtMgrTest, PermissionCacheQueryDeviceInfoBenchmark, TestSize.Level1)
+{
+    constexpr int32_t loops = 1000;
+    DriverExtMgr &instance = DriverExtMgr::GetInstance();
+    instance.OnStart();
+    auto measure = [&instance]() {
+        auto start = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < loops; i++) {
+            int32_t errorCode = EDM_OK;
+            std::vector<std::shared_ptr<DeviceInfoData>> deviceInfos;
+            (void)instance.QueryDeviceInfo(errorCode, deviceInfos);
+        }
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count() /
+            loops;
+    };
+    ExtPermissionManager::DisableCache();
+    auto uncached = measure();
+    bool enabled = ExtPermissionManager::EnableCache({ "ohos.permission.ACCESS_EXTENSIONAL_DEVICE_DRIVER" });
+    auto cached = measure();
+    std::cout << "QueryDeviceInfo per call, uncached: " << uncached << "ns, cached: " << cached << "ns"
+              << (enabled ? "" : " (cache unavailable)") << std::endl;
+    instance.OnStop();
+}
+
+HWTEST_F(DriverExtMgrTest, StartupGraphOverlapTest, TestSize.Level1)
+{
+    const auto phaseCost = std::chrono::milliseconds(20);
+    StartupGraph graph;
+    auto sleep = [phaseCost]() { std::this_thread::sleep_for(phaseCost); };
+    ASSERT_TRUE(graph.AddPhase("first", {}, sleep));
+    ASSERT_TRUE(graph.AddPhase("second", {}, sleep));
+    ASSERT_TRUE(graph.AddPhase("last", {"first", "second"}, sleep));
+    ASSERT_FALSE(graph.AddPhase("orphan", {"unknown"}, sleep));
+    auto timings = graph.Run();
+    ASSERT_EQ(timings.size(), 3U);
+    ASSERT_EQ(timings[2].name, "last");
+    // the two independent phases overlap, the last one waits for both
+    ASSERT_LT(timings[1].startUs, timings[0].startUs + timings[0].durationUs);
+    ASSERT_GE(timings[2].startUs, timings[0].startUs + timings[0].durationUs);
+    ASSERT_GE(timings[2].startUs, timings[1].startUs + timings[1].durationUs);
+}
+
+HWTEST_F(DriverExtMgrTest, DumpStartupPhasesTest, TestSize.Level1)
+{
+    DriverExtMgr &instance = DriverExtMgr::GetInstance();
+    instance.OnStart();
+    (void)instance.GetEventConfig();
+    FILE *file = tmpfile();
+    ASSERT_NE(file, nullptr);
+    std::vector<std::u16string> args;
+    ASSERT_EQ(instance.Dump(fileno(file), args), EDM_OK);
+    rewind(file);
+    std::string output;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), file) != nullptr) {
+        output += buffer;
+    }
+    fclose(file);
+    std::cout << output;
+    ASSERT_NE(output.find("BusExtensionCoreInit"), std::string::npos);
+    ASSERT_NE(output.find("Publish"), std::string::npos);
+    ASSERT_NE(output.find("EventConfigParse"), std::string::npos);
+    ASSERT_NE(output.find("cold starts"), std::string::npos);
+    instance.OnStop();
+}
 } // namespace ExternalDeviceManager
 } // namespace OHOS
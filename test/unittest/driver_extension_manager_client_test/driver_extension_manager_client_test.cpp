@@ -22,7 +22,9 @@
 #include "nativetoken_kit.h"
 #include "token_setproc.h"
 #include "driver_ext_mgr_callback_stub.h"
+#define private public
 #include "driver_ext_mgr_client.h"
+#undef private
 #include "edm_errors.h"
 #include "ext_object.h"
 #include "hilog_wrapper.h"
@@ -240,6 +242,126 @@ HWTEST_F(DrvExtMgrClientTest, UnBindDevice001, TestSize.Level1)
     ASSERT_EQ(ret, UsbErrCode::EDM_NOK);
 }
 
+class QueryCacheCallbackTest : public QueryCacheCallbackStub {
+public:
+    ErrCode OnQueryInvalidated(uint64_t generation) override
+    {
+        std::cout << "OnQueryInvalidated {generation:" << generation << "}" << std::endl;
+        return EDM_OK;
+    }
+};
+
+HWTEST_F(DrvExtMgrClientTest, RegisterQueryCacheCallback001, TestSize.Level1)
+{
+    auto &client = DriverExtMgrClient::GetInstance();
+    ASSERT_EQ(client.Connect(), UsbErrCode::EDM_OK);
+    sptr<IQueryCacheCallback> callback = new QueryCacheCallbackTest {};
+    int32_t errorCode = EDM_OK;
+    uint64_t generation = 0;
+    ASSERT_EQ(client.proxy_->RegisterQueryCacheCallback(errorCode, callback, generation), ERR_OK);
+    ASSERT_EQ(errorCode, UsbErrCode::EDM_OK);
+    ASSERT_EQ(client.proxy_->UnregisterQueryCacheCallback(errorCode, callback), ERR_OK);
+    ASSERT_EQ(errorCode, UsbErrCode::EDM_OK);
+    ASSERT_EQ(client.proxy_->UnregisterQueryCacheCallback(errorCode, callback), ERR_OK);
+    ASSERT_EQ(errorCode, UsbErrCode::EDM_ERR_INVALID_PARAM);
+}
+
+// results served from the client cache must match what the service returns for the same generation
+HWTEST_F(DrvExtMgrClientTest, QueryCacheCoherence001, TestSize.Level1)
+{
+    auto &client = DriverExtMgrClient::GetInstance();
+    std::vector<std::shared_ptr<DeviceInfoData>> cachedDevices;
+    ASSERT_EQ(client.QueryDeviceInfo(cachedDevices), UsbErrCode::EDM_OK);
+    std::vector<std::shared_ptr<DriverInfoData>> cachedDrivers;
+    ASSERT_EQ(client.QueryDriverInfo(cachedDrivers), UsbErrCode::EDM_OK);
+    ASSERT_TRUE(client.cacheRegistered_);
+
+    int32_t errorCode = EDM_OK;
+    std::vector<std::shared_ptr<DeviceInfoData>> devices;
+    ASSERT_EQ(client.proxy_->QueryDeviceInfo(errorCode, devices, false, 0), ERR_OK);
+    ASSERT_EQ(errorCode, UsbErrCode::EDM_OK);
+    std::vector<std::shared_ptr<DriverInfoData>> drivers;
+    ASSERT_EQ(client.proxy_->QueryDriverInfo(errorCode, drivers, false, ""), ERR_OK);
+    ASSERT_EQ(errorCode, UsbErrCode::EDM_OK);
+
+    {
+        std::lock_guard<std::mutex> lock(client.cacheMutex_);
+        if (client.deviceInfoCache_.generation != client.generation_ ||
+            client.driverInfoCache_.generation != client.generation_) {
+            std::cout << "device or driver set changed during the test, skip comparing" << std::endl;
+            return;
+        }
+    }
+    ASSERT_EQ(cachedDevices.size(), devices.size());
+    for (size_t i = 0; i < devices.size(); i++) {
+        ASSERT_EQ(cachedDevices[i]->deviceId, devices[i]->deviceId);
+        ASSERT_EQ(cachedDevices[i]->isDriverMatched, devices[i]->isDriverMatched);
+        ASSERT_EQ(cachedDevices[i]->driverUid, devices[i]->driverUid);
+
+        std::vector<std::shared_ptr<DeviceInfoData>> byId;
+        ASSERT_EQ(client.QueryDeviceInfo(devices[i]->deviceId, byId), UsbErrCode::EDM_OK);
+        ASSERT_EQ(byId.size(), 1U);
+        ASSERT_EQ(byId[0]->deviceId, devices[i]->deviceId);
+    }
+    ASSERT_EQ(cachedDrivers.size(), drivers.size());
+    for (size_t i = 0; i < drivers.size(); i++) {
+        ASSERT_EQ(cachedDrivers[i]->driverUid, drivers[i]->driverUid);
+        std::vector<std::shared_ptr<DriverInfoData>> byUid;
+        ASSERT_EQ(client.QueryDriverInfo(drivers[i]->driverUid, byUid), UsbErrCode::EDM_OK);
+        ASSERT_FALSE(byUid.empty());
+        ASSERT_EQ(byUid[0]->driverUid, drivers[i]->driverUid);
+    }
+}
+
+HWTEST_F(DrvExtMgrClientTest, QueryCacheInvalidate001, TestSize.Level1)
+{
+    auto &client = DriverExtMgrClient::GetInstance();
+    std::vector<std::shared_ptr<DeviceInfoData>> deviceInfos;
+    ASSERT_EQ(client.QueryDeviceInfo(deviceInfos), UsbErrCode::EDM_OK);
+    ASSERT_TRUE(client.deviceInfoCache_.valid);
+
+    // a push carrying an older generation must not drop the cache, a newer one must
+    uint64_t generation = client.generation_;
+    client.OnQueryInvalidated(generation);
+    ASSERT_TRUE(client.deviceInfoCache_.valid);
+    client.OnQueryInvalidated(generation + 1);
+    ASSERT_FALSE(client.deviceInfoCache_.valid);
+    ASSERT_EQ(client.generation_, generation + 1);
+
+    // the service restarting resets the cache and the registration
+    client.ResetQueryCache();
+    ASSERT_FALSE(client.cacheRegistered_);
+    deviceInfos.clear();
+    ASSERT_EQ(client.QueryDeviceInfo(deviceInfos), UsbErrCode::EDM_OK);
+    ASSERT_TRUE(client.cacheRegistered_);
+    ASSERT_TRUE(client.deviceInfoCache_.valid);
+}
+
+HWTEST_F(DrvExtMgrClientTest, QueryCachePerf001, TestSize.Level1)
+{
+    constexpr int32_t loops = 1000;
+    auto &client = DriverExtMgrClient::GetInstance();
+    ASSERT_EQ(client.Connect(), UsbErrCode::EDM_OK);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < loops; i++) {
+        int32_t errorCode = EDM_OK;
+        std::vector<std::shared_ptr<DeviceInfoData>> deviceInfos;
+        ASSERT_EQ(client.proxy_->QueryDeviceInfo(errorCode, deviceInfos, false, 0), ERR_OK);
+    }
+    auto ipcCost = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < loops; i++) {
+        std::vector<std::shared_ptr<DeviceInfoData>> deviceInfos;
+        ASSERT_EQ(client.QueryDeviceInfo(deviceInfos), UsbErrCode::EDM_OK);
+    }
+    auto cachedCost = std::chrono::steady_clock::now() - start;
+    std::cout << "QueryDeviceInfo x" << loops << " ipc: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(ipcCost).count() << "us, cached: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(cachedCost).count() << "us" << std::endl;
+}
+
 HWTEST_F(DrvExtMgrClientTest, InvalidCode001, TestSize.Level1)
 {
     sptr<ISystemAbilityManager> samgr = SystemAbilityManagerClient::GetInstance().GetSystemAbilityManager();
@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "driver_report_sys_event.h"
+#include "edm_errors.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+using namespace std;
+using namespace testing::ext;
+
+class DriverReportSysEventTest : public testing::Test {
+public:
+    void SetUp() override {}
+    void TearDown() override {}
+};
+
+struct WrittenEvent {
+    ExtDevEvent event;
+    uint32_t repeatCount;
+};
+
+class RecordingWriter {
+public:
+    ExtDevEventReporter::Writer Get()
+    {
+        return [this](const ExtDevEvent &event, uint32_t repeatCount) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            events_.push_back({event, repeatCount});
+            return EDM_OK;
+        };
+    }
+
+    std::vector<WrittenEvent> Events()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return events_;
+    }
+
+    uint32_t TotalCount()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t total = 0;
+        for (const auto &written : events_) {
+            total += written.repeatCount;
+        }
+        return total;
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<WrittenEvent> events_;
+};
+
+static ExtDevEvent MakeEvent(uint64_t deviceId, int32_t errCode = 0)
+{
+    ExtDevEvent event("QueryMatchDriver", DRIVER_DEVICE_MATCH, deviceId);
+    event.errCode = errCode;
+    event.bundleName = "testBundleName";
+    return event;
+}
+
+HWTEST_F(DriverReportSysEventTest, ParseIdVectorTest, TestSize.Level1)
+{
+    ASSERT_EQ(ExtDevReportSysEvent::ParseIdVector({}), "");
+    ASSERT_EQ(ExtDevReportSysEvent::ParseIdVector({1}), "1");
+    ASSERT_EQ(ExtDevReportSysEvent::ParseIdVector({1, 22, 65535}), "1,22,65535");
+}
+
+HWTEST_F(DriverReportSysEventTest, CoalesceIdenticalEventsTest, TestSize.Level1)
+{
+    RecordingWriter writer;
+    ExtDevEventReporter reporter(writer.Get(), ExtDevEventReporter::DEFAULT_CAPACITY, std::chrono::seconds(10));
+    const uint32_t eventCount = 100;
+    for (uint32_t i = 0; i < eventCount; i++) {
+        ASSERT_TRUE(reporter.Push(MakeEvent(1)));
+    }
+    ASSERT_TRUE(reporter.Push(MakeEvent(2)));
+    ASSERT_TRUE(reporter.Push(MakeEvent(1, static_cast<int32_t>(
+        ExtDevReportSysEvent::EventErrCode::NO_MATCHING_DRIVER_FOUND))));
+    reporter.Flush();
+
+    // the first of each kind right away, the other 99 of device 1 as one record
+    auto events = writer.Events();
+    ASSERT_EQ(events.size(), 4U);
+    ASSERT_EQ(events[0].event.deviceId, 1U);
+    ASSERT_EQ(events[0].repeatCount, 1U);
+    ASSERT_EQ(writer.TotalCount(), eventCount + 2);
+    auto stats = reporter.GetStats();
+    ASSERT_EQ(stats.pushed, eventCount + 2);
+    ASSERT_EQ(stats.written, 4U);
+    ASSERT_EQ(stats.coalesced, eventCount - 1);
+    ASSERT_EQ(stats.dropped, 0U);
+}
+
+HWTEST_F(DriverReportSysEventTest, CoalesceWindowExpiresTest, TestSize.Level1)
+{
+    RecordingWriter writer;
+    ExtDevEventReporter reporter(writer.Get(), ExtDevEventReporter::DEFAULT_CAPACITY, std::chrono::milliseconds(20));
+    ASSERT_TRUE(reporter.Push(MakeEvent(1)));
+    ASSERT_TRUE(reporter.Push(MakeEvent(1)));
+    // the repeat count is written when the window closes, without a flush
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    auto events = writer.Events();
+    ASSERT_EQ(events.size(), 2U);
+    ASSERT_EQ(events[1].repeatCount, 1U);
+
+    ASSERT_TRUE(reporter.Push(MakeEvent(1)));
+    reporter.Flush();
+    events = writer.Events();
+    ASSERT_EQ(events.size(), 3U);
+    ASSERT_EQ(events[2].repeatCount, 1U);
+}
+
+HWTEST_F(DriverReportSysEventTest, FormatIdsOnWriterTest, TestSize.Level1)
+{
+    RecordingWriter writer;
+    ExtDevEventReporter reporter(writer.Get());
+    ExtDevEvent event = MakeEvent(1);
+    event.vidList = {0x1234, 0x5678};
+    event.pidList = {1};
+    event.snNum = "0123456789";
+    ASSERT_TRUE(reporter.Push(std::move(event)));
+    reporter.Flush();
+    auto events = writer.Events();
+    ASSERT_EQ(events.size(), 1U);
+    ASSERT_EQ(events[0].event.vids, "4660,22136");
+    ASSERT_EQ(events[0].event.pids, "1");
+    ASSERT_EQ(events[0].event.snNum, "56789");
+}
+
+HWTEST_F(DriverReportSysEventTest, DropOnOverflowTest, TestSize.Level1)
+{
+    std::mutex gate;
+    std::unique_lock<std::mutex> closed(gate);
+    std::atomic<uint32_t> written {0};
+    const size_t capacity = 8;
+    ExtDevEventReporter reporter([&gate, &written](const ExtDevEvent &, uint32_t repeatCount) {
+        std::lock_guard<std::mutex> lock(gate);
+        written += repeatCount;
+        return EDM_OK;
+    }, capacity);
+
+    // the writer blocks on the first event, the queue fills up behind it
+    const uint32_t attempts = 100;
+    uint32_t accepted = 0;
+    for (uint32_t i = 0; i < attempts; i++) {
+        if (reporter.Push(MakeEvent(i))) {
+            accepted++;
+        }
+    }
+    auto stats = reporter.GetStats();
+    // at most one batch is with the writer, at most capacity events wait behind it
+    ASSERT_GE(stats.dropped, attempts - capacity * 2);
+    ASSERT_EQ(stats.pushed + stats.dropped, attempts);
+    ASSERT_EQ(stats.pushed, accepted);
+
+    closed.unlock();
+    reporter.Flush();
+    ASSERT_EQ(written.load(), accepted);
+}
+
+HWTEST_F(DriverReportSysEventTest, StopFlushesPendingTest, TestSize.Level1)
+{
+    RecordingWriter writer;
+    ExtDevEventReporter reporter(writer.Get(), ExtDevEventReporter::DEFAULT_CAPACITY, std::chrono::seconds(10));
+    for (uint32_t i = 0; i < 5; i++) {
+        ASSERT_TRUE(reporter.Push(MakeEvent(1)));
+    }
+    reporter.Stop();
+    ASSERT_EQ(writer.TotalCount(), 5U);
+
+    // the writer comes back for events reported after the stop
+    ASSERT_TRUE(reporter.Push(MakeEvent(2)));
+    reporter.Stop();
+    ASSERT_EQ(writer.TotalCount(), 6U);
+}
+
+HWTEST_F(DriverReportSysEventTest, ConcurrentProducersTest, TestSize.Level1)
+{
+    RecordingWriter writer;
+    const uint32_t threadCount = 4;
+    const uint32_t eventsPerThread = 1000;
+    const uint32_t devicesPerThread = 10;
+    ExtDevEventReporter reporter(writer.Get(), threadCount * eventsPerThread, std::chrono::seconds(10));
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < threadCount; t++) {
+        threads.emplace_back([&reporter, t]() {
+            for (uint32_t i = 0; i < eventsPerThread; i++) {
+                reporter.Push(MakeEvent(t * eventsPerThread + i % devicesPerThread));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    reporter.Flush();
+    auto stats = reporter.GetStats();
+    ASSERT_EQ(stats.dropped, 0U);
+    ASSERT_EQ(writer.TotalCount(), threadCount * eventsPerThread);
+    // one record for the first event of each device and one for its repeats
+    ASSERT_EQ(stats.written, threadCount * devicesPerThread * 2);
+    ASSERT_EQ(stats.coalesced, stats.pushed - threadCount * devicesPerThread);
+}
+
+HWTEST_F(DriverReportSysEventTest, CallerLatencyBenchmark, TestSize.Level1)
+{
+    // stands in for HiSysEventWrite: an IPC to hiview and the formatting in front of it
+    const auto writeCost = std::chrono::microseconds(50);
+    auto slowWriter = [writeCost](const ExtDevEvent &, uint32_t) {
+        std::this_thread::sleep_for(writeCost);
+        return EDM_OK;
+    };
+    const uint32_t eventCount = 2000;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < eventCount; i++) {
+        ExtDevEvent event = MakeEvent(i);
+        event.vids = ExtDevReportSysEvent::ParseIdVector({0x1234, 0x5678});
+        slowWriter(event, 1);
+    }
+    auto syncNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count() / eventCount;
+
+    ExtDevEventReporter reporter(slowWriter, eventCount);
+    begin = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < eventCount; i++) {
+        ExtDevEvent event = MakeEvent(i);
+        event.vidList = {0x1234, 0x5678};
+        reporter.Push(std::move(event));
+    }
+    auto asyncNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin).count() / eventCount;
+    reporter.Flush();
+
+    std::cout << "per report on the caller: synchronous " << syncNs << " ns, queued " << asyncNs << " ns"
+              << std::endl;
+    ASSERT_EQ(reporter.GetStats().dropped, 0U);
+    ASSERT_LT(asyncNs, syncNs);
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
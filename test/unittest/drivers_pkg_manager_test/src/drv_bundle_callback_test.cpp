@@ -14,8 +14,19 @@
  */
  
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
+#define private public
 #include "drv_bundle_state_callback.h"
+#include "pkg_db_helper.h"
+#undef private
 namespace OHOS {
 namespace ExternalDeviceManager {
 using namespace std;
@@ -49,6 +60,245 @@ HWTEST_F(DrvBundleStateCallbackTest, DrvBundleCallback_GetStiching_Test, TestSiz
     cout << "Ptr DrvBundleCallback_GetStiching_Test" << endl;
 }
 
+class RecordingBundleUpdateCallback : public IBundleUpdateCallback {
+public:
+    void OnBundlesUpdated(const std::string &bundleName,
+        const std::vector<std::shared_ptr<DriverInfo>> &drivers) override
+    {
+        Record("update:" + bundleName);
+    }
+    void OnBundlesReseted(const int32_t oldUserId) override
+    {
+        Record("reset:" + std::to_string(oldUserId));
+    }
+    void OnBundleChanged(const std::string &bundleName, const int32_t userId) override {}
+
+    void Record(const std::string &event)
+    {
+        if (inFlight_.fetch_add(1) != 0) {
+            overlapped_ = true;
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            events_.push_back(event);
+            entered_.notify_all();
+            gateCv_.wait(lock, [this]() { return open_; });
+        }
+        inFlight_.fetch_sub(1);
+    }
+
+    void WaitEntered()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        entered_.wait(lock, [this]() { return !events_.empty(); });
+    }
+
+    void Open()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_ = true;
+        gateCv_.notify_all();
+    }
+
+    std::vector<std::string> events_;
+    std::atomic<bool> overlapped_ {false};
+
+private:
+    std::mutex mutex_;
+    std::condition_variable entered_;
+    std::condition_variable gateCv_;
+    bool open_ = false;
+    std::atomic<uint32_t> inFlight_ {0};
+};
+
+HWTEST_F(DrvBundleStateCallbackTest, DrvBundleCallback_TaskStorm_Test, TestSize.Level1)
+{
+    auto recorder = std::make_shared<RecordingBundleUpdateCallback>();
+    drvbundleInstance.bundleUpdateCallback_ = recorder;
+
+    // the first task blocks the worker, everything after it queues up behind
+    drvbundleInstance.PostBundleUpdate("bundle0");
+    recorder->WaitEntered();
+
+    const uint32_t eventCount = 500;
+    const uint32_t bundleCount = 20;
+    const uint32_t resetInterval = 97;
+    std::vector<std::string> expected = {"update:bundle0"};
+    std::unordered_set<std::string> waiting;
+    for (uint32_t i = 1; i < eventCount; i++) {
+        if (i % resetInterval == 0) {
+            int32_t userId = static_cast<int32_t>(i);
+            drvbundleInstance.ResetMatchedBundles(userId);
+            expected.push_back("reset:" + std::to_string(userId));
+            waiting.clear();
+            continue;
+        }
+        std::string bundleName = "bundle" + std::to_string((i * 7) % bundleCount);
+        drvbundleInstance.PostBundleUpdate(bundleName);
+        if (waiting.insert(bundleName).second) {
+            expected.push_back("update:" + bundleName);
+        }
+    }
+    recorder->Open();
+    drvbundleInstance.taskQueue_.WaitIdle();
+
+    // in posting order, one update per bundle between two resets, never two tasks at once
+    EXPECT_EQ(recorder->events_, expected);
+    EXPECT_FALSE(recorder->overlapped_.load());
+    uint64_t resets = (eventCount - 1) / resetInterval;
+    EXPECT_EQ(drvbundleInstance.taskQueue_.GetCoalescedCount() + expected.size(), eventCount);
+    EXPECT_LT(expected.size(), bundleCount * (resets + 1) + resets + 2);
+    drvbundleInstance.bundleUpdateCallback_ = nullptr;
+}
+
+HWTEST_F(DrvBundleStateCallbackTest, DrvBundleCallback_StopTasks_Test, TestSize.Level1)
+{
+    auto recorder = std::make_shared<RecordingBundleUpdateCallback>();
+    drvbundleInstance.bundleUpdateCallback_ = recorder;
+    drvbundleInstance.PostBundleUpdate("bundle0");
+    recorder->WaitEntered();
+    drvbundleInstance.PostBundleUpdate("bundle1");
+    drvbundleInstance.ResetMatchedBundles(1);
+
+    // the running task finishes, the waiting ones are dropped and later ones refused
+    std::thread stopper([this]() { drvbundleInstance.StopBundleTasks(); });
+    while (drvbundleInstance.taskQueue_.PostUpdate("bundle2")) {
+        std::this_thread::yield();
+    }
+    recorder->Open();
+    stopper.join();
+    EXPECT_EQ(recorder->events_.size(), 1U);
+    drvbundleInstance.bundleUpdateCallback_ = nullptr;
+}
+
+static std::vector<ExtensionAbilityInfo> MakeDriverAbilities(uint32_t count)
+{
+    std::vector<ExtensionAbilityInfo> driverInfos;
+    for (uint32_t i = 0; i < count; i++) {
+        ExtensionAbilityInfo driverInfo;
+        driverInfo.type = ExtensionAbilityType::DRIVER;
+        driverInfo.bundleName = "com.example.driver" + std::to_string(i);
+        driverInfo.name = "DriverExtAbility";
+        driverInfo.applicationInfo.versionName = "1.0.0";
+        driverInfo.metadata = {{"bus", "usb", ""}, {"vid", "0x1234", ""}, {"pid", std::to_string(i), ""}};
+        driverInfos.push_back(driverInfo);
+    }
+    return driverInfos;
+}
+
+HWTEST_F(DrvBundleStateCallbackTest, DrvBundleCallback_Fingerprint_Test, TestSize.Level1)
+{
+    auto driverInfos = MakeDriverAbilities(3);
+    std::string fingerprint = DrvBundleStateCallback::GetDriverFingerprint(100, driverInfos);
+    std::reverse(driverInfos.begin(), driverInfos.end());
+    EXPECT_EQ(DrvBundleStateCallback::GetDriverFingerprint(100, driverInfos), fingerprint);
+    EXPECT_NE(DrvBundleStateCallback::GetDriverFingerprint(101, driverInfos), fingerprint);
+    driverInfos[0].metadata[2].value = "0x5678";
+    EXPECT_NE(DrvBundleStateCallback::GetDriverFingerprint(100, driverInfos), fingerprint);
+    driverInfos = MakeDriverAbilities(3);
+    driverInfos[1].applicationInfo.versionCode++;
+    EXPECT_NE(DrvBundleStateCallback::GetDriverFingerprint(100, driverInfos), fingerprint);
+}
+
+HWTEST_F(DrvBundleStateCallbackTest, DrvBundleCallback_SaveFingerprint_Test, TestSize.Level1)
+{
+    DrvBundleStateCallback callback;
+    std::shared_ptr<PkgDbHelper> helper = PkgDbHelper::GetInstance();
+    uint64_t liveChanges = callback.GetLiveChanges();
+    // a bundle change seen after the rows were read: the check has to run again, nothing is saved
+    callback.InvalidateDriverFingerprint();
+    EXPECT_EQ(callback.SaveDriverFingerprint("100:raced", liveChanges), DrvBundleStateCallback::FingerprintSave::RACED);
+    std::string fingerprint;
+    if (helper->QueryPkgState(DrvBundleStateCallback::BMS_FINGERPRINT_KEY, fingerprint) == PKG_OK) {
+        EXPECT_NE(fingerprint, "100:raced");
+    }
+
+    EXPECT_EQ(callback.SaveDriverFingerprint("100:saved", callback.GetLiveChanges()),
+        DrvBundleStateCallback::FingerprintSave::SAVED);
+    ASSERT_EQ(helper->QueryPkgState(DrvBundleStateCallback::BMS_FINGERPRINT_KEY, fingerprint), PKG_OK);
+    EXPECT_EQ(fingerprint, "100:saved");
+    EXPECT_EQ(helper->UpdatePkgState(DrvBundleStateCallback::BMS_FINGERPRINT_KEY, ""), PKG_OK);
+}
+
+struct FirstBindResult {
+    int64_t latencyUs;
+    size_t driverCount;
+    std::vector<std::string> events;
+};
+
+// time from a new service instance to the driver list the first device is matched against
+static FirstBindResult MeasureFirstBind(const DrvBundleStateCallback::DriverInfosFetcher &fetcher)
+{
+    DrvBundleStateCallback callback;
+    auto recorder = std::make_shared<RecordingBundleUpdateCallback>();
+    recorder->Open();
+    callback.bundleUpdateCallback_ = recorder;
+    callback.driverInfosFetcher_ = fetcher;
+
+    auto begin = std::chrono::steady_clock::now();
+    EXPECT_TRUE(callback.GetAllDriverInfos());
+    std::vector<PkgInfoTable> pkgInfos;
+    PkgDbHelper::GetInstance()->QueryPkgInfos(pkgInfos);
+    auto latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+
+    callback.taskQueue_.WaitIdle();
+    callback.bundleUpdateCallback_ = nullptr;
+    return {latencyUs, pkgInfos.size(), recorder->events_};
+}
+
+HWTEST_F(DrvBundleStateCallbackTest, DrvBundleCallback_WarmStart_Benchmark, TestSize.Level1)
+{
+    // stands in for QueryExtensionAbilityInfos, an IPC to the bundle manager
+    const auto queryCost = std::chrono::milliseconds(20);
+    uint32_t driverCount = 50;
+    std::atomic<uint32_t> queryCount {0};
+    auto fetcher = [&](int32_t userId, std::vector<ExtensionAbilityInfo> &driverInfos) {
+        queryCount++;
+        std::this_thread::sleep_for(queryCost);
+        driverInfos = MakeDriverAbilities(driverCount);
+        return true;
+    };
+    std::shared_ptr<PkgDbHelper> helper = PkgDbHelper::GetInstance();
+    ASSERT_EQ(helper->UpdatePkgState(DrvBundleStateCallback::BMS_FINGERPRINT_KEY, ""), PKG_OK);
+
+    // nothing saved yet: the query and the rebuild are on the way to the first bind
+    auto cold = MeasureFirstBind(fetcher);
+    EXPECT_EQ(queryCount.load(), 1U);
+    EXPECT_EQ(cold.events, std::vector<std::string> {"update:"});
+
+    // unchanged packages: pkg.db is used right away and the check afterwards rewrites nothing
+    auto warm = MeasureFirstBind(fetcher);
+    EXPECT_EQ(queryCount.load(), 2U);
+    EXPECT_EQ(warm.driverCount, cold.driverCount);
+    EXPECT_TRUE(warm.events.empty());
+
+    // a package installed while the service was not running: the check rebuilds pkg.db and rematches
+    driverCount++;
+    auto changed = MeasureFirstBind(fetcher);
+    EXPECT_EQ(queryCount.load(), 3U);
+    EXPECT_EQ(changed.events, std::vector<std::string> {"update:"});
+
+    // a package changed while the service was running: the next load uses pkg.db but rebuilds it in the check
+    {
+        DrvBundleStateCallback callback;
+        callback.InvalidateDriverFingerprint();
+    }
+    std::string fingerprint;
+    ASSERT_EQ(helper->QueryPkgState(DrvBundleStateCallback::BMS_FINGERPRINT_KEY, fingerprint), PKG_OK);
+    EXPECT_EQ(fingerprint.substr(fingerprint.find(':') + 1), "stale");
+    auto live = MeasureFirstBind(fetcher);
+    EXPECT_EQ(queryCount.load(), 4U);
+    EXPECT_EQ(live.driverCount, driverCount);
+    EXPECT_EQ(live.events, std::vector<std::string> {"update:"});
+
+    std::cout << "first bind after load: cold " << cold.latencyUs << " us, warm " << warm.latencyUs << " us"
+              << std::endl;
+    EXPECT_LT(warm.latencyUs, cold.latencyUs);
+    // leave pkg.db to be rebuilt from the real bundle manager on the next load
+    EXPECT_EQ(helper->UpdatePkgState(DrvBundleStateCallback::BMS_FINGERPRINT_KEY, ""), PKG_OK);
+}
+
 class DrvBundleStateCallbackPtrTest : public testing::Test {
 public:
     DrvBundleStateCallback *drvbundleInstance = nullptr;
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FAKE_HDI_CONTROL_H
+#define FAKE_HDI_CONTROL_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+constexpr uint32_t FAKE_HDI_ERROR_ALWAYS = UINT32_MAX;
+
+// Latency, error injection and call counting shared by the in-process HDI fakes.
+// Methods are addressed by their interface name, e.g. "Read10" or "SendPipeRequest".
+class FakeHdiControl {
+public:
+    virtual ~FakeHdiControl() = default;
+
+    // delay added to every call, on top of the per-method delay
+    void SetLatency(std::chrono::microseconds latency);
+    void SetLatency(const std::string &method, std::chrono::microseconds latency);
+    // the next times calls of the method fail with error and leave the fake untouched
+    void InjectError(const std::string &method, int32_t error, uint32_t times = FAKE_HDI_ERROR_ALWAYS);
+    void ClearErrors();
+    uint32_t GetCallCount(const std::string &method) const;
+    void ResetControl();
+
+protected:
+    // counts the call, sleeps for the configured latency and returns the injected error or HDF_SUCCESS
+    int32_t Enter(const char *method);
+
+private:
+    struct InjectedError {
+        int32_t error;
+        uint32_t remaining;
+    };
+
+    mutable std::mutex controlMutex_;
+    std::chrono::microseconds latency_ {0};
+    std::unordered_map<std::string, std::chrono::microseconds> methodLatency_;
+    std::unordered_map<std::string, InjectedError> errors_;
+    std::unordered_map<std::string, uint32_t> callCounts_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // FAKE_HDI_CONTROL_H
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FAKE_HID_DDK_H
+#define FAKE_HID_DDK_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "fake_hdi_control.h"
+#include "v1_1/ihid_ddk.h"
+
+// the injection point of the hid ddk, OH_Hid_Init and the virtual device calls take the service from the factory
+// while it is set
+void SetDdkFactory(std::function<OHOS::sptr<OHOS::HDI::Input::Ddk::V1_1::IHidDdk>()> factory);
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace HidDdkHdi = OHOS::HDI::Input::Ddk::V1_1;
+namespace HidEmitHdi = OHOS::HDI::Input::Ddk::V1_0;
+
+// An in-memory input service. Virtual devices record what is emitted to them. Raw devices answer the hidraw
+// queries from their description, ReadTimeout waits for reports pushed from the test side and everything the
+// driver writes or sends is recorded.
+class FakeHidDdk : public HidDdkHdi::IHidDdk, public FakeHdiControl {
+public:
+    struct RawDevice {
+        HidDdkHdi::HidRawDevInfo info;
+        std::string name;
+        std::string physicalAddress;
+        std::string uniqueId;
+        std::vector<uint8_t> reportDescriptor;
+    };
+
+    FakeHidDdk() = default;
+    ~FakeHidDdk() override = default;
+
+    void AddRawDevice(uint64_t deviceId, const RawDevice &device);
+    void RemoveRawDevice(uint64_t deviceId);
+    void PushInputReport(uint64_t deviceId, const std::vector<uint8_t> &report);
+    // reports written or sent as output reports, drained by the call
+    std::vector<std::vector<uint8_t>> PopOutputReports(uint64_t deviceId);
+    size_t GetVirtualDeviceCount();
+    uint64_t GetEmittedItemCount(uint32_t deviceId);
+    // the most recent items emitted to a virtual device, oldest first
+    std::vector<HidEmitHdi::Hid_EmitItem> GetRecentItems(uint32_t deviceId);
+
+    int32_t CreateDevice(const HidEmitHdi::Hid_Device &hidDevice,
+        const HidEmitHdi::Hid_EventProperties &hidEventProperties, uint32_t &deviceId) override;
+    int32_t EmitEvent(uint32_t deviceId, const std::vector<HidEmitHdi::Hid_EmitItem> &items) override;
+    int32_t DestroyDevice(uint32_t deviceId) override;
+    int32_t Init() override;
+    int32_t Release() override;
+    int32_t Open(uint64_t deviceId, uint8_t interfaceIndex, HidDdkHdi::HidDeviceHandle &dev) override;
+    int32_t Close(const HidDdkHdi::HidDeviceHandle &dev) override;
+    int32_t Write(const HidDdkHdi::HidDeviceHandle &dev, const std::vector<uint8_t> &data,
+        uint32_t &bytesWritten) override;
+    int32_t ReadTimeout(const HidDdkHdi::HidDeviceHandle &dev, std::vector<uint8_t> &data, uint32_t buffSize,
+        int32_t timeout, uint32_t &bytesRead) override;
+    int32_t SetNonBlocking(const HidDdkHdi::HidDeviceHandle &dev, int32_t nonBlock) override;
+    int32_t GetRawInfo(const HidDdkHdi::HidDeviceHandle &dev, HidDdkHdi::HidRawDevInfo &rawDevInfo) override;
+    int32_t GetRawName(const HidDdkHdi::HidDeviceHandle &dev, std::vector<uint8_t> &data, uint32_t buffSize) override;
+    int32_t GetPhysicalAddress(const HidDdkHdi::HidDeviceHandle &dev, std::vector<uint8_t> &data,
+        uint32_t buffSize) override;
+    int32_t GetRawUniqueId(const HidDdkHdi::HidDeviceHandle &dev, std::vector<uint8_t> &data,
+        uint32_t buffSize) override;
+    int32_t SendReport(const HidDdkHdi::HidDeviceHandle &dev, HidDdkHdi::HidReportType reportType,
+        const std::vector<uint8_t> &data) override;
+    int32_t GetReport(const HidDdkHdi::HidDeviceHandle &dev, HidDdkHdi::HidReportType reportType,
+        uint8_t reportNumber, std::vector<uint8_t> &data, uint32_t buffSize) override;
+    int32_t GetReportDescriptor(const HidDdkHdi::HidDeviceHandle &dev, std::vector<uint8_t> &buf, uint32_t buffSize,
+        uint32_t &bytesRead) override;
+
+private:
+    struct RawState {
+        RawDevice device;
+        std::deque<std::vector<uint8_t>> inputReports;
+        std::vector<std::vector<uint8_t>> outputReports;
+        // reports set through SendReport, keyed by type and report number
+        std::map<std::pair<int32_t, uint8_t>, std::vector<uint8_t>> reports;
+    };
+    struct VirtualDevice {
+        std::string name;
+        uint64_t emittedItems = 0;
+        std::deque<HidEmitHdi::Hid_EmitItem> recentItems;
+    };
+    struct Handle {
+        uint64_t deviceId;
+        bool nonBlock;
+    };
+
+    RawState *FindLocked(const HidDdkHdi::HidDeviceHandle &dev);
+
+    std::mutex mutex_;
+    std::condition_variable inputCond_;
+    bool initialized_ = false;
+    std::map<uint64_t, RawState> rawDevices_;
+    std::map<int32_t, Handle> handles_;
+    int32_t nextHandle_ = 1;
+    std::map<uint32_t, VirtualDevice> virtualDevices_;
+    uint32_t nextVirtualId_ = 0;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // FAKE_HID_DDK_H
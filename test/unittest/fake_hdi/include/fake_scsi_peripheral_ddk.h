@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FAKE_SCSI_PERIPHERAL_DDK_H
+#define FAKE_SCSI_PERIPHERAL_DDK_H
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "fake_hdi_control.h"
+#include "v1_0/iscsi_peripheral_ddk.h"
+
+// the injection point of the scsi ddk, OH_ScsiPeripheral_Init takes the service from the factory while it is set
+void SetDdkFactory(std::function<OHOS::sptr<OHOS::HDI::Usb::ScsiDdk::V1_0::IScsiPeripheralDdk>()> factory);
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace ScsiDdkHdi = OHOS::HDI::Usb::ScsiDdk::V1_0;
+
+// An in-memory block device per device id. READ(10) and WRITE(10) move data between the disk and the shared
+// buffer of the opened device, a command the disk cannot serve completes with CHECK CONDITION and fixed format
+// sense data the way a real target reports it.
+class FakeScsiPeripheralDdk : public ScsiDdkHdi::IScsiPeripheralDdk, public FakeHdiControl {
+public:
+    FakeScsiPeripheralDdk() = default;
+    ~FakeScsiPeripheralDdk() override;
+
+    void AddDisk(uint64_t deviceId, uint32_t blockCount, uint32_t blockSize);
+    void RemoveDisk(uint64_t deviceId);
+    // a disk without medium answers every command with NOT READY
+    void SetReady(uint64_t deviceId, bool ready);
+    // direct access to the disk content, bypassing the commands
+    std::vector<uint8_t> ReadBlocks(uint64_t deviceId, uint32_t lbAddress, uint32_t blocks);
+    void WriteBlocks(uint64_t deviceId, uint32_t lbAddress, const std::vector<uint8_t> &data);
+
+    int32_t Init() override;
+    int32_t Release() override;
+    int32_t Open(uint64_t deviceId, uint8_t interfaceIndex, ScsiDdkHdi::ScsiPeripheralDevice &dev,
+        int &memMapFd) override;
+    int32_t Close(const ScsiDdkHdi::ScsiPeripheralDevice &dev) override;
+    int32_t ReadCapacity10(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+        const ScsiDdkHdi::ScsiPeripheralReadCapacityRequest &request,
+        ScsiDdkHdi::ScsiPeripheralCapacityInfo &capacityInfo, ScsiDdkHdi::ScsiPeripheralResponse &response) override;
+    int32_t TestUnitReady(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+        const ScsiDdkHdi::ScsiPeripheralTestUnitReadyRequest &request,
+        ScsiDdkHdi::ScsiPeripheralResponse &response) override;
+    int32_t Inquiry(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+        const ScsiDdkHdi::ScsiPeripheralInquiryRequest &request, ScsiDdkHdi::ScsiPeripheralInquiryInfo &inquiryInfo,
+        ScsiDdkHdi::ScsiPeripheralResponse &response) override;
+    int32_t RequestSense(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+        const ScsiDdkHdi::ScsiPeripheralRequestSenseRequest &request,
+        ScsiDdkHdi::ScsiPeripheralResponse &response) override;
+    int32_t Read10(const ScsiDdkHdi::ScsiPeripheralDevice &dev, const ScsiDdkHdi::ScsiPeripheralIORequest &request,
+        ScsiDdkHdi::ScsiPeripheralResponse &response) override;
+    int32_t Write10(const ScsiDdkHdi::ScsiPeripheralDevice &dev, const ScsiDdkHdi::ScsiPeripheralIORequest &request,
+        ScsiDdkHdi::ScsiPeripheralResponse &response) override;
+    int32_t Verify10(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+        const ScsiDdkHdi::ScsiPeripheralVerifyRequest &request, ScsiDdkHdi::ScsiPeripheralResponse &response) override;
+    int32_t SendRequestByCDB(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+        const ScsiDdkHdi::ScsiPeripheralRequest &request, ScsiDdkHdi::ScsiPeripheralResponse &response) override;
+
+private:
+    struct Disk {
+        uint32_t blockCount;
+        uint32_t blockSize;
+        bool ready = true;
+        std::vector<uint8_t> data;
+        // sense data of the last failed command, returned by REQUEST SENSE
+        std::vector<uint8_t> sense;
+    };
+    struct Handle {
+        uint64_t deviceId;
+        int memMapFd;
+    };
+
+    int32_t FindLocked(const ScsiDdkHdi::ScsiPeripheralDevice &dev, Disk *&disk, Handle *&handle);
+    bool CheckReadyLocked(Disk &disk, ScsiDdkHdi::ScsiPeripheralResponse &response);
+    void CheckCondition(Disk &disk, uint8_t senseKey, uint8_t asc, ScsiDdkHdi::ScsiPeripheralResponse &response);
+    int32_t TransferLocked(Disk &disk, const Handle &handle, uint32_t lbAddress, uint32_t blocks, uint32_t memMapSize,
+        bool toDevice, ScsiDdkHdi::ScsiPeripheralResponse &response);
+
+    std::mutex mutex_;
+    bool initialized_ = false;
+    std::map<uint64_t, Disk> disks_;
+    std::map<int, Handle> handles_;
+    int nextHandle_ = 1;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // FAKE_SCSI_PERIPHERAL_DDK_H
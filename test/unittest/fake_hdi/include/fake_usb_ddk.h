@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FAKE_USB_DDK_H
+#define FAKE_USB_DDK_H
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+#include "fake_hdi_control.h"
+#include "v1_2/iusb_ddk.h"
+
+// the injection point of the usb ddk, OH_Usb_Init takes the service from the factory while it is set
+void SetDdkFactory(std::function<OHOS::sptr<OHOS::HDI::Usb::Ddk::V1_2::IUsbDdk>()> factory);
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace UsbDdkHdi = OHOS::HDI::Usb::Ddk::V1_2;
+
+// An in-memory usb ddk service. Each device is a loopback: bulk and interrupt OUT transfers queue their data and
+// IN transfers drain it, an empty queue reads as zeros. Control transfers answer GET_DESCRIPTOR from the device's
+// descriptors and echo back the data of the last write with the same request.
+class FakeUsbDdk : public UsbDdkHdi::IUsbDdk, public FakeHdiControl {
+public:
+    FakeUsbDdk() = default;
+    ~FakeUsbDdk() override;
+
+    void AddDevice(uint64_t deviceId, const UsbDdkHdi::UsbDeviceDescriptor &desc,
+        const std::vector<uint8_t> &configDesc);
+    void RemoveDevice(uint64_t deviceId);
+    // data the next IN transfers of the device return
+    void PushInData(uint64_t deviceId, const std::vector<uint8_t> &data);
+    // data the device received from OUT transfers, drained by the call
+    std::vector<uint8_t> PopOutData(uint64_t deviceId);
+    bool IsInitialized() const;
+
+    int32_t Init() override;
+    int32_t Release() override;
+    int32_t GetDeviceDescriptor(uint64_t deviceId, UsbDdkHdi::UsbDeviceDescriptor &desc) override;
+    int32_t GetConfigDescriptor(uint64_t deviceId, uint8_t configIndex, std::vector<uint8_t> &configDesc) override;
+    int32_t ClaimInterface(uint64_t deviceId, uint8_t interfaceIndex, uint64_t &interfaceHandle) override;
+    int32_t ReleaseInterface(uint64_t interfaceHandle) override;
+    int32_t SelectInterfaceSetting(uint64_t interfaceHandle, uint8_t settingIndex) override;
+    int32_t GetCurrentInterfaceSetting(uint64_t interfaceHandle, uint8_t &settingIndex) override;
+    int32_t SendControlReadRequest(uint64_t interfaceHandle, const UsbDdkHdi::UsbControlRequestSetup &setup,
+        uint32_t timeout, std::vector<uint8_t> &data) override;
+    int32_t SendControlWriteRequest(uint64_t interfaceHandle, const UsbDdkHdi::UsbControlRequestSetup &setup,
+        uint32_t timeout, const std::vector<uint8_t> &data) override;
+    int32_t SendPipeRequest(const UsbDdkHdi::UsbRequestPipe &pipe, uint32_t size, uint32_t offset, uint32_t length,
+        uint32_t &transferedLength) override;
+    int32_t GetDeviceMemMapFd(uint64_t deviceId, int &fd) override;
+    int32_t SendPipeRequestWithAshmem(const UsbDdkHdi::UsbRequestPipe &pipe, const UsbDdkHdi::UsbAshmem &ashmem,
+        uint32_t &transferredLength) override;
+    int32_t GetDevices(std::vector<uint64_t> &deviceIds) override;
+    int32_t UpdateDriverInfo(const UsbDdkHdi::DriverAbilityInfo &driverInfo) override;
+    int32_t RemoveDriverInfo(const std::string &driverUid) override;
+    int32_t ControlTransfer(uint64_t deviceId, const UsbDdkHdi::UsbControlRequestSetup &setupPacket,
+        uint32_t timeout, std::vector<uint8_t> &data, uint32_t &transferredLength) override;
+    int32_t GetNonRootHubs(std::vector<uint64_t> &nonRootHubIds) override;
+
+private:
+    struct Device {
+        UsbDdkHdi::UsbDeviceDescriptor desc;
+        std::vector<uint8_t> configDesc;
+        std::deque<uint8_t> inData;
+        std::deque<uint8_t> outData;
+        // control data written by the driver, keyed by request and value
+        std::map<uint32_t, std::vector<uint8_t>> controlData;
+        int memMapFd = -1;
+    };
+    struct Interface {
+        uint64_t deviceId;
+        uint8_t interfaceIndex;
+        uint8_t settingIndex;
+    };
+
+    Device *FindDeviceLocked(uint64_t deviceId);
+    Device *FindInterfaceDeviceLocked(uint64_t interfaceHandle);
+    int32_t ControlLocked(Device &device, const UsbDdkHdi::UsbControlRequestSetup &setup, std::vector<uint8_t> &data);
+    uint32_t TransferLocked(Device &device, uint8_t endpoint, uint8_t *buffer, uint32_t length);
+
+    mutable std::mutex mutex_;
+    bool initialized_ = false;
+    std::map<uint64_t, Device> devices_;
+    std::map<uint64_t, Interface> interfaces_;
+    uint64_t nextInterfaceHandle_ = 1;
+    std::map<std::string, UsbDdkHdi::DriverAbilityInfo> driverInfos_;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // FAKE_USB_DDK_H
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FAKE_USB_SERIAL_DDK_H
+#define FAKE_USB_SERIAL_DDK_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+#include "fake_hdi_control.h"
+#include "v1_0/iusb_serial_ddk.h"
+
+// the injection point of the usb serial ddk, OH_UsbSerial_Init takes the service from the factory while it is set
+void SetDdkFactory(std::function<OHOS::sptr<OHOS::HDI::Usb::UsbSerialDdk::V1_0::IUsbSerialDdk>()> factory);
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace UsbSerialDdkHdi = OHOS::HDI::Usb::UsbSerialDdk::V1_0;
+
+// In-memory serial ports. A port in loopback mode receives what is written to it, data can also be pushed from the
+// test side. Read waits for data up to the port timeout, a negative timeout blocks in slices so that a reader thread
+// still notices a close.
+class FakeUsbSerialDdk : public UsbSerialDdkHdi::IUsbSerialDdk, public FakeHdiControl {
+public:
+    FakeUsbSerialDdk() = default;
+    ~FakeUsbSerialDdk() override = default;
+
+    void AddPort(uint64_t deviceId, bool loopback = true);
+    void RemovePort(uint64_t deviceId);
+    void PushRxData(uint64_t deviceId, const std::vector<uint8_t> &data);
+    // data written to the port, drained by the call
+    std::vector<uint8_t> PopTxData(uint64_t deviceId);
+    bool GetParams(uint64_t deviceId, UsbSerialDdkHdi::UsbSerialParams &params);
+
+    int32_t Init() override;
+    int32_t Release() override;
+    int32_t Open(uint64_t deviceId, uint64_t interfaceIndex, UsbSerialDdkHdi::UsbSerialDeviceHandle &dev) override;
+    int32_t Close(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev) override;
+    int32_t Read(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev, uint32_t bufferSize,
+        std::vector<uint8_t> &buff) override;
+    int32_t Write(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev, const std::vector<uint8_t> &buff,
+        uint32_t &bytesWritten) override;
+    int32_t SetBaudRate(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev, uint32_t baudRate) override;
+    int32_t SetParams(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev,
+        const UsbSerialDdkHdi::UsbSerialParams &params) override;
+    int32_t SetTimeout(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev, int32_t timeout) override;
+    int32_t SetFlowControl(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev,
+        UsbSerialDdkHdi::UsbSerialFlowControl flowControl) override;
+    int32_t Flush(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev) override;
+    int32_t FlushInput(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev) override;
+    int32_t FlushOutput(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev) override;
+
+private:
+    struct Port {
+        bool loopback = true;
+        std::deque<uint8_t> rxData;
+        std::vector<uint8_t> txData;
+        UsbSerialDdkHdi::UsbSerialParams params {};
+        UsbSerialDdkHdi::UsbSerialFlowControl flowControl {};
+        // negative blocks until data arrives, zero returns at once
+        int32_t timeout = -1;
+    };
+
+    Port *FindPortLocked(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev);
+
+    std::mutex mutex_;
+    std::condition_variable rxCond_;
+    bool initialized_ = false;
+    std::map<uint64_t, Port> ports_;
+    std::map<int32_t, uint64_t> handles_;
+    int32_t nextHandle_ = 1;
+};
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // FAKE_USB_SERIAL_DDK_H
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fake_hdi_control.h"
+
+#include <thread>
+#include "hdf_base.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+void FakeHdiControl::SetLatency(std::chrono::microseconds latency)
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    latency_ = latency;
+}
+
+void FakeHdiControl::SetLatency(const std::string &method, std::chrono::microseconds latency)
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    methodLatency_[method] = latency;
+}
+
+void FakeHdiControl::InjectError(const std::string &method, int32_t error, uint32_t times)
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    if (times == 0) {
+        errors_.erase(method);
+        return;
+    }
+    errors_[method] = {error, times};
+}
+
+void FakeHdiControl::ClearErrors()
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    errors_.clear();
+}
+
+uint32_t FakeHdiControl::GetCallCount(const std::string &method) const
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    auto iter = callCounts_.find(method);
+    return iter == callCounts_.end() ? 0 : iter->second;
+}
+
+void FakeHdiControl::ResetControl()
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    latency_ = std::chrono::microseconds(0);
+    methodLatency_.clear();
+    errors_.clear();
+    callCounts_.clear();
+}
+
+int32_t FakeHdiControl::Enter(const char *method)
+{
+    std::chrono::microseconds delay = std::chrono::microseconds(0);
+    int32_t ret = HDF_SUCCESS;
+    {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        callCounts_[method]++;
+        delay = latency_;
+        auto latencyIter = methodLatency_.find(method);
+        if (latencyIter != methodLatency_.end()) {
+            delay += latencyIter->second;
+        }
+        auto errorIter = errors_.find(method);
+        if (errorIter != errors_.end()) {
+            ret = errorIter->second.error;
+            if (errorIter->second.remaining != FAKE_HDI_ERROR_ALWAYS && --errorIter->second.remaining == 0) {
+                errors_.erase(errorIter);
+            }
+        }
+    }
+    // sleep outside the lock so concurrent callers overlap like they would on a real service
+    if (delay.count() > 0) {
+        std::this_thread::sleep_for(delay);
+    }
+    return ret;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
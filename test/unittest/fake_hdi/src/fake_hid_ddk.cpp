@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fake_hid_ddk.h"
+
+#include <algorithm>
+#include <chrono>
+#include "hdf_base.h"
+#include "hid_ddk_types.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr size_t RECENT_ITEMS_LIMIT = 1024;
+
+// hidraw strings come back NUL terminated and cut to the buffer
+void FillString(std::vector<uint8_t> &data, const std::string &value, uint32_t buffSize)
+{
+    data.assign(value.begin(), value.end());
+    data.push_back('\0');
+    if (data.size() > buffSize) {
+        data.resize(buffSize);
+        if (!data.empty()) {
+            data.back() = '\0';
+        }
+    }
+}
+} // namespace
+
+void FakeHidDdk::AddRawDevice(uint64_t deviceId, const RawDevice &device)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    rawDevices_[deviceId].device = device;
+}
+
+void FakeHidDdk::RemoveRawDevice(uint64_t deviceId)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rawDevices_.erase(deviceId);
+    }
+    inputCond_.notify_all();
+}
+
+void FakeHidDdk::PushInputReport(uint64_t deviceId, const std::vector<uint8_t> &report)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = rawDevices_.find(deviceId);
+        if (iter == rawDevices_.end()) {
+            return;
+        }
+        iter->second.inputReports.push_back(report);
+    }
+    inputCond_.notify_all();
+}
+
+std::vector<std::vector<uint8_t>> FakeHidDdk::PopOutputReports(uint64_t deviceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = rawDevices_.find(deviceId);
+    if (iter == rawDevices_.end()) {
+        return {};
+    }
+    std::vector<std::vector<uint8_t>> reports;
+    reports.swap(iter->second.outputReports);
+    return reports;
+}
+
+size_t FakeHidDdk::GetVirtualDeviceCount()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return virtualDevices_.size();
+}
+
+uint64_t FakeHidDdk::GetEmittedItemCount(uint32_t deviceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = virtualDevices_.find(deviceId);
+    return iter == virtualDevices_.end() ? 0 : iter->second.emittedItems;
+}
+
+std::vector<HidEmitHdi::Hid_EmitItem> FakeHidDdk::GetRecentItems(uint32_t deviceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = virtualDevices_.find(deviceId);
+    if (iter == virtualDevices_.end()) {
+        return {};
+    }
+    return std::vector<HidEmitHdi::Hid_EmitItem>(iter->second.recentItems.begin(), iter->second.recentItems.end());
+}
+
+int32_t FakeHidDdk::CreateDevice(const HidEmitHdi::Hid_Device &hidDevice,
+    const HidEmitHdi::Hid_EventProperties &hidEventProperties, uint32_t &deviceId)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    deviceId = nextVirtualId_++;
+    virtualDevices_[deviceId].name = hidDevice.deviceName;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::EmitEvent(uint32_t deviceId, const std::vector<HidEmitHdi::Hid_EmitItem> &items)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = virtualDevices_.find(deviceId);
+    if (iter == virtualDevices_.end()) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    VirtualDevice &device = iter->second;
+    device.emittedItems += items.size();
+    device.recentItems.insert(device.recentItems.end(), items.begin(), items.end());
+    while (device.recentItems.size() > RECENT_ITEMS_LIMIT) {
+        device.recentItems.pop_front();
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::DestroyDevice(uint32_t deviceId)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return virtualDevices_.erase(deviceId) > 0 ? HDF_SUCCESS : HID_DDK_INVALID_PARAMETER;
+}
+
+int32_t FakeHidDdk::Init()
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    initialized_ = true;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::Release()
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    initialized_ = false;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::Open(uint64_t deviceId, uint8_t interfaceIndex, HidDdkHdi::HidDeviceHandle &dev)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (rawDevices_.find(deviceId) == rawDevices_.end()) {
+        return HID_DDK_DEVICE_NOT_FOUND;
+    }
+    dev.fd = nextHandle_++;
+    dev.nonBlock = 0;
+    handles_[dev.fd] = {deviceId, false};
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::Close(const HidDdkHdi::HidDeviceHandle &dev)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (handles_.erase(dev.fd) == 0) {
+            return HID_DDK_INVALID_PARAMETER;
+        }
+    }
+    // a reader blocked on the closed handle returns with an error
+    inputCond_.notify_all();
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::Write(const HidDdkHdi::HidDeviceHandle &dev, const std::vector<uint8_t> &data,
+    uint32_t &bytesWritten)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    RawState *state = FindLocked(dev);
+    if (state == nullptr) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    state->outputReports.push_back(data);
+    bytesWritten = static_cast<uint32_t>(data.size());
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::ReadTimeout(const HidDdkHdi::HidDeviceHandle &dev, std::vector<uint8_t> &data, uint32_t buffSize,
+    int32_t timeout, uint32_t &bytesRead)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    RawState *state = FindLocked(dev);
+    if (state == nullptr) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    bool nonBlock = handles_[dev.fd].nonBlock;
+    if (state->inputReports.empty() && !nonBlock && timeout != 0) {
+        auto ready = [this, &dev] {
+            RawState *current = FindLocked(dev);
+            return current == nullptr || !current->inputReports.empty();
+        };
+        if (timeout < 0) {
+            inputCond_.wait(lock, ready);
+        } else {
+            inputCond_.wait_for(lock, std::chrono::milliseconds(timeout), ready);
+        }
+        state = FindLocked(dev);
+        if (state == nullptr) {
+            return HID_DDK_IO_ERROR;
+        }
+    }
+    if (state->inputReports.empty()) {
+        bytesRead = 0;
+        return nonBlock ? HDF_SUCCESS : HID_DDK_TIMEOUT;
+    }
+    // like hidraw one read returns one report, cut to the buffer
+    std::vector<uint8_t> &report = state->inputReports.front();
+    bytesRead = static_cast<uint32_t>(std::min<size_t>(report.size(), buffSize));
+    data.assign(report.begin(), report.begin() + bytesRead);
+    state->inputReports.pop_front();
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::SetNonBlocking(const HidDdkHdi::HidDeviceHandle &dev, int32_t nonBlock)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = handles_.find(dev.fd);
+    if (iter == handles_.end()) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    iter->second.nonBlock = nonBlock != 0;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::GetRawInfo(const HidDdkHdi::HidDeviceHandle &dev, HidDdkHdi::HidRawDevInfo &rawDevInfo)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    RawState *state = FindLocked(dev);
+    if (state == nullptr) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    rawDevInfo = state->device.info;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::GetRawName(const HidDdkHdi::HidDeviceHandle &dev, std::vector<uint8_t> &data, uint32_t buffSize)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    RawState *state = FindLocked(dev);
+    if (state == nullptr) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    FillString(data, state->device.name, buffSize);
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::GetPhysicalAddress(const HidDdkHdi::HidDeviceHandle &dev, std::vector<uint8_t> &data,
+    uint32_t buffSize)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    RawState *state = FindLocked(dev);
+    if (state == nullptr) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    FillString(data, state->device.physicalAddress, buffSize);
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::GetRawUniqueId(const HidDdkHdi::HidDeviceHandle &dev, std::vector<uint8_t> &data,
+    uint32_t buffSize)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    RawState *state = FindLocked(dev);
+    if (state == nullptr) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    FillString(data, state->device.uniqueId, buffSize);
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::SendReport(const HidDdkHdi::HidDeviceHandle &dev, HidDdkHdi::HidReportType reportType,
+    const std::vector<uint8_t> &data)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    RawState *state = FindLocked(dev);
+    if (state == nullptr || data.empty()) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    // the first byte is the report number
+    state->reports[{static_cast<int32_t>(reportType), data[0]}] = data;
+    if (static_cast<int32_t>(reportType) == HID_OUTPUT_REPORT) {
+        state->outputReports.push_back(data);
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::GetReport(const HidDdkHdi::HidDeviceHandle &dev, HidDdkHdi::HidReportType reportType,
+    uint8_t reportNumber, std::vector<uint8_t> &data, uint32_t buffSize)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    RawState *state = FindLocked(dev);
+    if (state == nullptr) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    auto iter = state->reports.find({static_cast<int32_t>(reportType), reportNumber});
+    if (iter == state->reports.end()) {
+        return HID_DDK_IO_ERROR;
+    }
+    data.assign(iter->second.begin(), iter->second.begin() + std::min<size_t>(iter->second.size(), buffSize));
+    return HDF_SUCCESS;
+}
+
+int32_t FakeHidDdk::GetReportDescriptor(const HidDdkHdi::HidDeviceHandle &dev, std::vector<uint8_t> &buf,
+    uint32_t buffSize, uint32_t &bytesRead)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    RawState *state = FindLocked(dev);
+    if (state == nullptr) {
+        return HID_DDK_INVALID_PARAMETER;
+    }
+    const std::vector<uint8_t> &descriptor = state->device.reportDescriptor;
+    bytesRead = static_cast<uint32_t>(std::min<size_t>(descriptor.size(), buffSize));
+    buf.assign(descriptor.begin(), descriptor.begin() + bytesRead);
+    return HDF_SUCCESS;
+}
+
+FakeHidDdk::RawState *FakeHidDdk::FindLocked(const HidDdkHdi::HidDeviceHandle &dev)
+{
+    auto handleIter = handles_.find(dev.fd);
+    if (handleIter == handles_.end()) {
+        return nullptr;
+    }
+    auto deviceIter = rawDevices_.find(handleIter->second.deviceId);
+    return deviceIter == rawDevices_.end() ? nullptr : &deviceIter->second;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
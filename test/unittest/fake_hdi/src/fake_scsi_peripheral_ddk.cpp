@@ -0,0 +1,487 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fake_scsi_peripheral_ddk.h"
+
+#include <algorithm>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "hdf_base.h"
+#include "scsi_peripheral_types.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr uint8_t SENSE_RESPONSE_CODE_FIXED = 0x70;
+constexpr uint8_t SENSE_KEY_NOT_READY = 0x02;
+constexpr uint8_t SENSE_KEY_ILLEGAL_REQUEST = 0x05;
+constexpr uint8_t ASC_INVALID_COMMAND_OPERATION_CODE = 0x20;
+constexpr uint8_t ASC_LBA_OUT_OF_RANGE = 0x21;
+constexpr uint8_t ASC_MEDIUM_NOT_PRESENT = 0x3A;
+constexpr uint8_t FIXED_SENSE_LENGTH = 18;
+constexpr uint8_t FIXED_SENSE_ADDITIONAL_LENGTH = 10;
+constexpr uint8_t FIXED_SENSE_KEY_BYTE = 2;
+constexpr uint8_t FIXED_SENSE_ADDITIONAL_LENGTH_BYTE = 7;
+constexpr uint8_t FIXED_SENSE_ASC_BYTE = 12;
+constexpr uint8_t OPCODE_TEST_UNIT_READY = 0x00;
+constexpr uint8_t OPCODE_READ_CAPACITY10 = 0x25;
+constexpr uint8_t OPCODE_READ10 = 0x28;
+constexpr uint8_t OPCODE_WRITE10 = 0x2A;
+constexpr uint8_t CDB10_LENGTH = 10;
+constexpr uint8_t CDB10_LBA_BYTE = 2;
+constexpr uint8_t CDB10_LENGTH_BYTE = 7;
+constexpr uint8_t READ_CAPACITY10_DATA_LENGTH = 8;
+constexpr uint8_t INQUIRY_DEVICE_TYPE_DISK = 0x00;
+constexpr uint32_t BYTE_BITS = 8;
+constexpr uint32_t WORD_BYTES = 4;
+const std::string FAKE_VENDOR = "FAKE";
+const std::string FAKE_PRODUCT = "IN-MEMORY DISK";
+const std::string FAKE_REVISION = "1.0";
+
+uint32_t GetBigEndian(const std::vector<uint8_t> &buf, size_t start, size_t bytes)
+{
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value = (value << BYTE_BITS) | buf[start + i];
+    }
+    return value;
+}
+
+void PutBigEndian(uint8_t *buf, uint32_t value)
+{
+    for (uint32_t i = 0; i < WORD_BYTES; ++i) {
+        buf[i] = static_cast<uint8_t>(value >> (BYTE_BITS * (WORD_BYTES - 1 - i)));
+    }
+}
+
+// the caller sizes the field, the string is cut or space padded to it like in the standard inquiry data
+void FillInquiryString(std::vector<uint8_t> &field, const std::string &value)
+{
+    size_t size = field.empty() ? value.size() : field.size();
+    field.assign(size, ' ');
+    std::copy_n(value.begin(), std::min(size, value.size()), field.begin());
+}
+
+void SetGood(ScsiDdkHdi::ScsiPeripheralResponse &response, int32_t transferredLength)
+{
+    response.status = SCSIPERIPHERAL_STATUS_GOOD;
+    response.sbLenWr = 0;
+    response.transferredLength = transferredLength;
+}
+} // namespace
+
+FakeScsiPeripheralDdk::~FakeScsiPeripheralDdk()
+{
+    for (auto &[id, handle] : handles_) {
+        close(handle.memMapFd);
+    }
+}
+
+void FakeScsiPeripheralDdk::AddDisk(uint64_t deviceId, uint32_t blockCount, uint32_t blockSize)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Disk &disk = disks_[deviceId];
+    disk.blockCount = blockCount;
+    disk.blockSize = blockSize;
+    disk.data.assign(static_cast<size_t>(blockCount) * blockSize, 0);
+}
+
+void FakeScsiPeripheralDdk::RemoveDisk(uint64_t deviceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    disks_.erase(deviceId);
+}
+
+void FakeScsiPeripheralDdk::SetReady(uint64_t deviceId, bool ready)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = disks_.find(deviceId);
+    if (iter != disks_.end()) {
+        iter->second.ready = ready;
+    }
+}
+
+std::vector<uint8_t> FakeScsiPeripheralDdk::ReadBlocks(uint64_t deviceId, uint32_t lbAddress, uint32_t blocks)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = disks_.find(deviceId);
+    if (iter == disks_.end() || lbAddress > iter->second.blockCount || blocks > iter->second.blockCount - lbAddress) {
+        return {};
+    }
+    auto begin = iter->second.data.begin() + static_cast<size_t>(lbAddress) * iter->second.blockSize;
+    return std::vector<uint8_t>(begin, begin + static_cast<size_t>(blocks) * iter->second.blockSize);
+}
+
+void FakeScsiPeripheralDdk::WriteBlocks(uint64_t deviceId, uint32_t lbAddress, const std::vector<uint8_t> &data)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = disks_.find(deviceId);
+    if (iter == disks_.end()) {
+        return;
+    }
+    size_t start = static_cast<size_t>(lbAddress) * iter->second.blockSize;
+    if (start > iter->second.data.size() || data.size() > iter->second.data.size() - start) {
+        return;
+    }
+    std::copy(data.begin(), data.end(), iter->second.data.begin() + start);
+}
+
+int32_t FakeScsiPeripheralDdk::Init()
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    initialized_ = true;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeScsiPeripheralDdk::Release()
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    initialized_ = false;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeScsiPeripheralDdk::Open(
+    uint64_t deviceId, uint8_t interfaceIndex, ScsiDdkHdi::ScsiPeripheralDevice &dev, int &memMapFd)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = disks_.find(deviceId);
+    if (iter == disks_.end()) {
+        return SCSIPERIPHERAL_DDK_DEVICE_NOT_FOUND;
+    }
+    int fd = memfd_create("fake_scsi_ddk", MFD_CLOEXEC);
+    if (fd < 0) {
+        return SCSIPERIPHERAL_DDK_MEMORY_ERROR;
+    }
+    // the caller closes memMapFd on close, the fake keeps its own to reach the shared buffer
+    memMapFd = dup(fd);
+    if (memMapFd < 0) {
+        close(fd);
+        return SCSIPERIPHERAL_DDK_MEMORY_ERROR;
+    }
+    dev.devFd = nextHandle_++;
+    dev.memMapFd = memMapFd;
+    dev.lbLength = static_cast<int32_t>(iter->second.blockSize);
+    handles_[dev.devFd] = {deviceId, fd};
+    return HDF_SUCCESS;
+}
+
+int32_t FakeScsiPeripheralDdk::Close(const ScsiDdkHdi::ScsiPeripheralDevice &dev)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = handles_.find(dev.devFd);
+    if (iter == handles_.end()) {
+        return SCSIPERIPHERAL_DDK_INVALID_PARAMETER;
+    }
+    close(iter->second.memMapFd);
+    handles_.erase(iter);
+    return HDF_SUCCESS;
+}
+
+int32_t FakeScsiPeripheralDdk::ReadCapacity10(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+    const ScsiDdkHdi::ScsiPeripheralReadCapacityRequest &request, ScsiDdkHdi::ScsiPeripheralCapacityInfo &capacityInfo,
+    ScsiDdkHdi::ScsiPeripheralResponse &response)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Disk *disk = nullptr;
+    Handle *handle = nullptr;
+    ret = FindLocked(dev, disk, handle);
+    if (ret != HDF_SUCCESS || !CheckReadyLocked(*disk, response)) {
+        return ret;
+    }
+    capacityInfo.lbAddress = disk->blockCount - 1;
+    capacityInfo.lbLength = disk->blockSize;
+    SetGood(response, READ_CAPACITY10_DATA_LENGTH);
+    return HDF_SUCCESS;
+}
+
+int32_t FakeScsiPeripheralDdk::TestUnitReady(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+    const ScsiDdkHdi::ScsiPeripheralTestUnitReadyRequest &request, ScsiDdkHdi::ScsiPeripheralResponse &response)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Disk *disk = nullptr;
+    Handle *handle = nullptr;
+    ret = FindLocked(dev, disk, handle);
+    if (ret != HDF_SUCCESS || !CheckReadyLocked(*disk, response)) {
+        return ret;
+    }
+    SetGood(response, 0);
+    return HDF_SUCCESS;
+}
+
+int32_t FakeScsiPeripheralDdk::Inquiry(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+    const ScsiDdkHdi::ScsiPeripheralInquiryRequest &request, ScsiDdkHdi::ScsiPeripheralInquiryInfo &inquiryInfo,
+    ScsiDdkHdi::ScsiPeripheralResponse &response)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Disk *disk = nullptr;
+    Handle *handle = nullptr;
+    ret = FindLocked(dev, disk, handle);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    inquiryInfo.deviceType = INQUIRY_DEVICE_TYPE_DISK;
+    FillInquiryString(inquiryInfo.idVendor, FAKE_VENDOR);
+    FillInquiryString(inquiryInfo.idProduct, FAKE_PRODUCT);
+    FillInquiryString(inquiryInfo.revProduct, FAKE_REVISION);
+    SetGood(response, std::min<int32_t>(request.allocationLength, static_cast<int32_t>(request.memMapSize)));
+    return HDF_SUCCESS;
+}
+
+int32_t FakeScsiPeripheralDdk::RequestSense(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+    const ScsiDdkHdi::ScsiPeripheralRequestSenseRequest &request, ScsiDdkHdi::ScsiPeripheralResponse &response)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Disk *disk = nullptr;
+    Handle *handle = nullptr;
+    ret = FindLocked(dev, disk, handle);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    // reporting the sense clears it, a disk without a pending error reports NO SENSE
+    std::vector<uint8_t> sense = disk->sense;
+    if (sense.empty()) {
+        sense.assign(FIXED_SENSE_LENGTH, 0);
+        sense[0] = SENSE_RESPONSE_CODE_FIXED;
+        sense[FIXED_SENSE_ADDITIONAL_LENGTH_BYTE] = FIXED_SENSE_ADDITIONAL_LENGTH;
+    }
+    disk->sense.clear();
+    size_t length = std::min<size_t>(sense.size(), request.allocationLength);
+    response.senseData.resize(std::max(response.senseData.size(), length));
+    std::copy_n(sense.begin(), length, response.senseData.begin());
+    SetGood(response, static_cast<int32_t>(length));
+    return HDF_SUCCESS;
+}
+
+int32_t FakeScsiPeripheralDdk::Read10(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+    const ScsiDdkHdi::ScsiPeripheralIORequest &request, ScsiDdkHdi::ScsiPeripheralResponse &response)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Disk *disk = nullptr;
+    Handle *handle = nullptr;
+    ret = FindLocked(dev, disk, handle);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    return TransferLocked(*disk, *handle, request.lbAddress, request.transferLength, request.memMapSize, false,
+        response);
+}
+
+int32_t FakeScsiPeripheralDdk::Write10(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+    const ScsiDdkHdi::ScsiPeripheralIORequest &request, ScsiDdkHdi::ScsiPeripheralResponse &response)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Disk *disk = nullptr;
+    Handle *handle = nullptr;
+    ret = FindLocked(dev, disk, handle);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    return TransferLocked(*disk, *handle, request.lbAddress, request.transferLength, request.memMapSize, true,
+        response);
+}
+
+int32_t FakeScsiPeripheralDdk::Verify10(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+    const ScsiDdkHdi::ScsiPeripheralVerifyRequest &request, ScsiDdkHdi::ScsiPeripheralResponse &response)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Disk *disk = nullptr;
+    Handle *handle = nullptr;
+    ret = FindLocked(dev, disk, handle);
+    if (ret != HDF_SUCCESS || !CheckReadyLocked(*disk, response)) {
+        return ret;
+    }
+    if (request.lbAddress > disk->blockCount || request.verificationLength > disk->blockCount - request.lbAddress) {
+        CheckCondition(*disk, SENSE_KEY_ILLEGAL_REQUEST, ASC_LBA_OUT_OF_RANGE, response);
+        return HDF_SUCCESS;
+    }
+    SetGood(response, 0);
+    return HDF_SUCCESS;
+}
+
+int32_t FakeScsiPeripheralDdk::SendRequestByCDB(const ScsiDdkHdi::ScsiPeripheralDevice &dev,
+    const ScsiDdkHdi::ScsiPeripheralRequest &request, ScsiDdkHdi::ScsiPeripheralResponse &response)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Disk *disk = nullptr;
+    Handle *handle = nullptr;
+    ret = FindLocked(dev, disk, handle);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    const std::vector<uint8_t> &cdb = request.commandDescriptorBlock;
+    if (cdb.empty()) {
+        return SCSIPERIPHERAL_DDK_INVALID_PARAMETER;
+    }
+    uint8_t opcode = cdb[0];
+    if ((opcode == OPCODE_READ10 || opcode == OPCODE_WRITE10 || opcode == OPCODE_READ_CAPACITY10) &&
+        cdb.size() < CDB10_LENGTH) {
+        return SCSIPERIPHERAL_DDK_INVALID_PARAMETER;
+    }
+    switch (opcode) {
+        case OPCODE_TEST_UNIT_READY:
+            if (CheckReadyLocked(*disk, response)) {
+                SetGood(response, 0);
+            }
+            return HDF_SUCCESS;
+        case OPCODE_READ10:
+        case OPCODE_WRITE10:
+            return TransferLocked(*disk, *handle, GetBigEndian(cdb, CDB10_LBA_BYTE, sizeof(uint32_t)),
+                GetBigEndian(cdb, CDB10_LENGTH_BYTE, sizeof(uint16_t)), request.memMapSize, opcode == OPCODE_WRITE10,
+                response);
+        case OPCODE_READ_CAPACITY10: {
+            if (!CheckReadyLocked(*disk, response)) {
+                return HDF_SUCCESS;
+            }
+            if (request.memMapSize < READ_CAPACITY10_DATA_LENGTH) {
+                return SCSIPERIPHERAL_DDK_INVALID_PARAMETER;
+            }
+            auto buffer = static_cast<uint8_t *>(
+                mmap(nullptr, request.memMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, handle->memMapFd, 0));
+            if (buffer == MAP_FAILED) {
+                return SCSIPERIPHERAL_DDK_MEMORY_ERROR;
+            }
+            PutBigEndian(buffer, disk->blockCount - 1);
+            PutBigEndian(buffer + WORD_BYTES, disk->blockSize);
+            munmap(buffer, request.memMapSize);
+            SetGood(response, READ_CAPACITY10_DATA_LENGTH);
+            return HDF_SUCCESS;
+        }
+        default:
+            CheckCondition(*disk, SENSE_KEY_ILLEGAL_REQUEST, ASC_INVALID_COMMAND_OPERATION_CODE, response);
+            return HDF_SUCCESS;
+    }
+}
+
+int32_t FakeScsiPeripheralDdk::FindLocked(const ScsiDdkHdi::ScsiPeripheralDevice &dev, Disk *&disk, Handle *&handle)
+{
+    auto handleIter = handles_.find(dev.devFd);
+    if (handleIter == handles_.end()) {
+        return SCSIPERIPHERAL_DDK_INVALID_PARAMETER;
+    }
+    auto diskIter = disks_.find(handleIter->second.deviceId);
+    if (diskIter == disks_.end()) {
+        return SCSIPERIPHERAL_DDK_DEVICE_NOT_FOUND;
+    }
+    handle = &handleIter->second;
+    disk = &diskIter->second;
+    return HDF_SUCCESS;
+}
+
+bool FakeScsiPeripheralDdk::CheckReadyLocked(Disk &disk, ScsiDdkHdi::ScsiPeripheralResponse &response)
+{
+    if (!disk.ready) {
+        CheckCondition(disk, SENSE_KEY_NOT_READY, ASC_MEDIUM_NOT_PRESENT, response);
+    }
+    return disk.ready;
+}
+
+void FakeScsiPeripheralDdk::CheckCondition(
+    Disk &disk, uint8_t senseKey, uint8_t asc, ScsiDdkHdi::ScsiPeripheralResponse &response)
+{
+    disk.sense.assign(FIXED_SENSE_LENGTH, 0);
+    disk.sense[0] = SENSE_RESPONSE_CODE_FIXED;
+    disk.sense[FIXED_SENSE_KEY_BYTE] = senseKey;
+    disk.sense[FIXED_SENSE_ADDITIONAL_LENGTH_BYTE] = FIXED_SENSE_ADDITIONAL_LENGTH;
+    disk.sense[FIXED_SENSE_ASC_BYTE] = asc;
+    response.senseData.resize(std::max<size_t>(response.senseData.size(), FIXED_SENSE_LENGTH));
+    std::copy(disk.sense.begin(), disk.sense.end(), response.senseData.begin());
+    response.status = SCSIPERIPHERAL_STATUS_CHECK_CONDITION_NEEDED;
+    response.sbLenWr = FIXED_SENSE_LENGTH;
+    response.transferredLength = 0;
+}
+
+int32_t FakeScsiPeripheralDdk::TransferLocked(Disk &disk, const Handle &handle, uint32_t lbAddress, uint32_t blocks,
+    uint32_t memMapSize, bool toDevice, ScsiDdkHdi::ScsiPeripheralResponse &response)
+{
+    if (!CheckReadyLocked(disk, response)) {
+        return HDF_SUCCESS;
+    }
+    if (lbAddress > disk.blockCount || blocks > disk.blockCount - lbAddress) {
+        CheckCondition(disk, SENSE_KEY_ILLEGAL_REQUEST, ASC_LBA_OUT_OF_RANGE, response);
+        return HDF_SUCCESS;
+    }
+    size_t length = static_cast<size_t>(blocks) * disk.blockSize;
+    if (length > memMapSize) {
+        return SCSIPERIPHERAL_DDK_INVALID_PARAMETER;
+    }
+    if (length == 0) {
+        SetGood(response, 0);
+        return HDF_SUCCESS;
+    }
+    auto buffer =
+        static_cast<uint8_t *>(mmap(nullptr, memMapSize, PROT_READ | PROT_WRITE, MAP_SHARED, handle.memMapFd, 0));
+    if (buffer == MAP_FAILED) {
+        return SCSIPERIPHERAL_DDK_MEMORY_ERROR;
+    }
+    uint8_t *block = disk.data.data() + static_cast<size_t>(lbAddress) * disk.blockSize;
+    if (toDevice) {
+        std::copy_n(buffer, length, block);
+    } else {
+        std::copy_n(block, length, buffer);
+    }
+    munmap(buffer, memMapSize);
+    SetGood(response, static_cast<int32_t>(length));
+    return HDF_SUCCESS;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -0,0 +1,472 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fake_usb_ddk.h"
+
+#include <algorithm>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "hdf_base.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr uint8_t USB_ENDPOINT_DIR_IN = 0x80;
+constexpr uint8_t USB_REQUEST_GET_DESCRIPTOR = 0x06;
+constexpr uint8_t USB_DESCRIPTOR_TYPE_DEVICE = 0x01;
+constexpr uint8_t USB_DESCRIPTOR_TYPE_CONFIG = 0x02;
+constexpr uint8_t USB_DEVICE_DESCRIPTOR_LENGTH = 18;
+constexpr uint8_t USB_CLASS_HUB = 0x09;
+constexpr uint32_t BYTE_BITS = 8;
+constexpr uint32_t REQUEST_KEY_SHIFT = 16;
+constexpr uint8_t BYTE_MASK = 0xFF;
+
+void AppendWord(std::vector<uint8_t> &buf, uint16_t value)
+{
+    buf.push_back(static_cast<uint8_t>(value & BYTE_MASK));
+    buf.push_back(static_cast<uint8_t>(value >> BYTE_BITS));
+}
+
+std::vector<uint8_t> SerializeDeviceDescriptor(const UsbDdkHdi::UsbDeviceDescriptor &desc)
+{
+    std::vector<uint8_t> buf;
+    buf.reserve(USB_DEVICE_DESCRIPTOR_LENGTH);
+    buf.push_back(USB_DEVICE_DESCRIPTOR_LENGTH);
+    buf.push_back(USB_DESCRIPTOR_TYPE_DEVICE);
+    AppendWord(buf, desc.bcdUSB);
+    buf.push_back(desc.bDeviceClass);
+    buf.push_back(desc.bDeviceSubClass);
+    buf.push_back(desc.bDeviceProtocol);
+    buf.push_back(desc.bMaxPacketSize0);
+    AppendWord(buf, desc.idVendor);
+    AppendWord(buf, desc.idProduct);
+    AppendWord(buf, desc.bcdDevice);
+    buf.push_back(desc.iManufacturer);
+    buf.push_back(desc.iProduct);
+    buf.push_back(desc.iSerialNumber);
+    buf.push_back(desc.bNumConfigurations);
+    return buf;
+}
+} // namespace
+
+FakeUsbDdk::~FakeUsbDdk()
+{
+    for (auto &[id, device] : devices_) {
+        if (device.memMapFd >= 0) {
+            close(device.memMapFd);
+        }
+    }
+}
+
+void FakeUsbDdk::AddDevice(
+    uint64_t deviceId, const UsbDdkHdi::UsbDeviceDescriptor &desc, const std::vector<uint8_t> &configDesc)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device &device = devices_[deviceId];
+    device.desc = desc;
+    device.configDesc = configDesc;
+}
+
+void FakeUsbDdk::RemoveDevice(uint64_t deviceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = devices_.find(deviceId);
+    if (iter == devices_.end()) {
+        return;
+    }
+    if (iter->second.memMapFd >= 0) {
+        close(iter->second.memMapFd);
+    }
+    devices_.erase(iter);
+    for (auto it = interfaces_.begin(); it != interfaces_.end();) {
+        it = it->second.deviceId == deviceId ? interfaces_.erase(it) : std::next(it);
+    }
+}
+
+void FakeUsbDdk::PushInData(uint64_t deviceId, const std::vector<uint8_t> &data)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device *device = FindDeviceLocked(deviceId);
+    if (device != nullptr) {
+        device->inData.insert(device->inData.end(), data.begin(), data.end());
+    }
+}
+
+std::vector<uint8_t> FakeUsbDdk::PopOutData(uint64_t deviceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device *device = FindDeviceLocked(deviceId);
+    if (device == nullptr) {
+        return {};
+    }
+    std::vector<uint8_t> data(device->outData.begin(), device->outData.end());
+    device->outData.clear();
+    return data;
+}
+
+bool FakeUsbDdk::IsInitialized() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return initialized_;
+}
+
+int32_t FakeUsbDdk::Init()
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    initialized_ = true;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::Release()
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    initialized_ = false;
+    interfaces_.clear();
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::GetDeviceDescriptor(uint64_t deviceId, UsbDdkHdi::UsbDeviceDescriptor &desc)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device *device = FindDeviceLocked(deviceId);
+    if (device == nullptr) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    desc = device->desc;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::GetConfigDescriptor(uint64_t deviceId, uint8_t configIndex, std::vector<uint8_t> &configDesc)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device *device = FindDeviceLocked(deviceId);
+    if (device == nullptr || configIndex >= std::max<uint8_t>(device->desc.bNumConfigurations, 1)) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    configDesc = device->configDesc;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::ClaimInterface(uint64_t deviceId, uint8_t interfaceIndex, uint64_t &interfaceHandle)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (FindDeviceLocked(deviceId) == nullptr) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    for (const auto &[handle, intf] : interfaces_) {
+        if (intf.deviceId == deviceId && intf.interfaceIndex == interfaceIndex) {
+            return HDF_ERR_DEVICE_BUSY;
+        }
+    }
+    interfaceHandle = nextInterfaceHandle_++;
+    interfaces_[interfaceHandle] = {deviceId, interfaceIndex, 0};
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::ReleaseInterface(uint64_t interfaceHandle)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return interfaces_.erase(interfaceHandle) > 0 ? HDF_SUCCESS : HDF_ERR_INVALID_PARAM;
+}
+
+int32_t FakeUsbDdk::SelectInterfaceSetting(uint64_t interfaceHandle, uint8_t settingIndex)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = interfaces_.find(interfaceHandle);
+    if (iter == interfaces_.end()) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    iter->second.settingIndex = settingIndex;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::GetCurrentInterfaceSetting(uint64_t interfaceHandle, uint8_t &settingIndex)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = interfaces_.find(interfaceHandle);
+    if (iter == interfaces_.end()) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    settingIndex = iter->second.settingIndex;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::SendControlReadRequest(uint64_t interfaceHandle, const UsbDdkHdi::UsbControlRequestSetup &setup,
+    uint32_t timeout, std::vector<uint8_t> &data)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device *device = FindInterfaceDeviceLocked(interfaceHandle);
+    if (device == nullptr || (setup.requestType & USB_ENDPOINT_DIR_IN) == 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    return ControlLocked(*device, setup, data);
+}
+
+int32_t FakeUsbDdk::SendControlWriteRequest(uint64_t interfaceHandle, const UsbDdkHdi::UsbControlRequestSetup &setup,
+    uint32_t timeout, const std::vector<uint8_t> &data)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device *device = FindInterfaceDeviceLocked(interfaceHandle);
+    if (device == nullptr || (setup.requestType & USB_ENDPOINT_DIR_IN) != 0) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    std::vector<uint8_t> written = data;
+    return ControlLocked(*device, setup, written);
+}
+
+int32_t FakeUsbDdk::SendPipeRequest(const UsbDdkHdi::UsbRequestPipe &pipe, uint32_t size, uint32_t offset,
+    uint32_t length, uint32_t &transferedLength)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device *device = FindInterfaceDeviceLocked(pipe.interfaceHandle);
+    if (device == nullptr || device->memMapFd < 0 || offset > size || length > size - offset) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    auto buffer = static_cast<uint8_t *>(mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, device->memMapFd, 0));
+    if (buffer == MAP_FAILED) {
+        return HDF_ERR_IO;
+    }
+    transferedLength = TransferLocked(*device, pipe.endpoint, buffer + offset, length);
+    munmap(buffer, size);
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::GetDeviceMemMapFd(uint64_t deviceId, int &fd)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device *device = FindDeviceLocked(deviceId);
+    if (device == nullptr) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if (device->memMapFd < 0) {
+        device->memMapFd = memfd_create("fake_usb_ddk", MFD_CLOEXEC);
+        if (device->memMapFd < 0) {
+            return HDF_ERR_IO;
+        }
+    }
+    // the caller owns and closes its fd, the fake keeps its own to reach the memory in SendPipeRequest
+    fd = dup(device->memMapFd);
+    return fd < 0 ? HDF_ERR_IO : HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::SendPipeRequestWithAshmem(
+    const UsbDdkHdi::UsbRequestPipe &pipe, const UsbDdkHdi::UsbAshmem &ashmem, uint32_t &transferredLength)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device *device = FindInterfaceDeviceLocked(pipe.interfaceHandle);
+    if (device == nullptr || ashmem.offset > ashmem.size || ashmem.bufferLength > ashmem.size - ashmem.offset) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    if ((pipe.endpoint & USB_ENDPOINT_DIR_IN) == 0) {
+        if (ashmem.address.size() < ashmem.size) {
+            return HDF_ERR_INVALID_PARAM;
+        }
+        auto data = const_cast<uint8_t *>(ashmem.address.data()) + ashmem.offset;
+        transferredLength = TransferLocked(*device, pipe.endpoint, data, ashmem.bufferLength);
+        return HDF_SUCCESS;
+    }
+    auto buffer =
+        static_cast<uint8_t *>(mmap(nullptr, ashmem.size, PROT_READ | PROT_WRITE, MAP_SHARED, ashmem.fd, 0));
+    if (buffer == MAP_FAILED) {
+        return HDF_ERR_IO;
+    }
+    transferredLength = TransferLocked(*device, pipe.endpoint, buffer + ashmem.offset, ashmem.bufferLength);
+    munmap(buffer, ashmem.size);
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::GetDevices(std::vector<uint64_t> &deviceIds)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    deviceIds.clear();
+    for (const auto &[id, device] : devices_) {
+        deviceIds.push_back(id);
+    }
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::UpdateDriverInfo(const UsbDdkHdi::DriverAbilityInfo &driverInfo)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    driverInfos_[driverInfo.driverUid] = driverInfo;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::RemoveDriverInfo(const std::string &driverUid)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    driverInfos_.erase(driverUid);
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbDdk::ControlTransfer(uint64_t deviceId, const UsbDdkHdi::UsbControlRequestSetup &setupPacket,
+    uint32_t timeout, std::vector<uint8_t> &data, uint32_t &transferredLength)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Device *device = FindDeviceLocked(deviceId);
+    if (device == nullptr) {
+        return HDF_ERR_INVALID_PARAM;
+    }
+    ret = ControlLocked(*device, setupPacket, data);
+    transferredLength = static_cast<uint32_t>(data.size());
+    return ret;
+}
+
+int32_t FakeUsbDdk::GetNonRootHubs(std::vector<uint64_t> &nonRootHubIds)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    nonRootHubIds.clear();
+    for (const auto &[id, device] : devices_) {
+        if (device.desc.bDeviceClass == USB_CLASS_HUB) {
+            nonRootHubIds.push_back(id);
+        }
+    }
+    return HDF_SUCCESS;
+}
+
+FakeUsbDdk::Device *FakeUsbDdk::FindDeviceLocked(uint64_t deviceId)
+{
+    auto iter = devices_.find(deviceId);
+    return iter == devices_.end() ? nullptr : &iter->second;
+}
+
+FakeUsbDdk::Device *FakeUsbDdk::FindInterfaceDeviceLocked(uint64_t interfaceHandle)
+{
+    auto iter = interfaces_.find(interfaceHandle);
+    return iter == interfaces_.end() ? nullptr : FindDeviceLocked(iter->second.deviceId);
+}
+
+// an IN request fills data with up to setup.length bytes, an OUT request stores data for later IN requests
+int32_t FakeUsbDdk::ControlLocked(
+    Device &device, const UsbDdkHdi::UsbControlRequestSetup &setup, std::vector<uint8_t> &data)
+{
+    uint32_t key = (static_cast<uint32_t>(setup.requestCmd) << REQUEST_KEY_SHIFT) | setup.value;
+    if ((setup.requestType & USB_ENDPOINT_DIR_IN) == 0) {
+        device.controlData[key] = std::vector<uint8_t>(data.begin(), data.begin() + std::min<size_t>(data.size(),
+            setup.length));
+        data.resize(std::min<size_t>(data.size(), setup.length));
+        return HDF_SUCCESS;
+    }
+    std::vector<uint8_t> reply;
+    if (setup.requestCmd == USB_REQUEST_GET_DESCRIPTOR) {
+        uint8_t type = static_cast<uint8_t>(setup.value >> BYTE_BITS);
+        if (type == USB_DESCRIPTOR_TYPE_DEVICE) {
+            reply = SerializeDeviceDescriptor(device.desc);
+        } else if (type == USB_DESCRIPTOR_TYPE_CONFIG) {
+            reply = device.configDesc;
+        } else {
+            return HDF_ERR_NOT_SUPPORT;
+        }
+    } else {
+        auto iter = device.controlData.find(key);
+        if (iter != device.controlData.end()) {
+            reply = iter->second;
+        }
+    }
+    reply.resize(std::min<size_t>(reply.size(), setup.length));
+    data = std::move(reply);
+    return HDF_SUCCESS;
+}
+
+// IN transfers drain the queued data, or return length zeros when nothing is queued so the device is always ready
+uint32_t FakeUsbDdk::TransferLocked(Device &device, uint8_t endpoint, uint8_t *buffer, uint32_t length)
+{
+    if ((endpoint & USB_ENDPOINT_DIR_IN) == 0) {
+        device.outData.insert(device.outData.end(), buffer, buffer + length);
+        return length;
+    }
+    if (device.inData.empty()) {
+        std::fill(buffer, buffer + length, 0);
+        return length;
+    }
+    uint32_t count = static_cast<uint32_t>(std::min<size_t>(length, device.inData.size()));
+    std::copy(device.inData.begin(), device.inData.begin() + count, buffer);
+    device.inData.erase(device.inData.begin(), device.inData.begin() + count);
+    return count;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
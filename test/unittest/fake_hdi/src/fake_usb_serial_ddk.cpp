@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fake_usb_serial_ddk.h"
+
+#include <algorithm>
+#include <chrono>
+#include "hdf_base.h"
+#include "usb_serial_types.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+namespace {
+constexpr auto BLOCKING_READ_SLICE = std::chrono::milliseconds(100);
+} // namespace
+
+void FakeUsbSerialDdk::AddPort(uint64_t deviceId, bool loopback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ports_[deviceId].loopback = loopback;
+}
+
+void FakeUsbSerialDdk::RemovePort(uint64_t deviceId)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ports_.erase(deviceId);
+    }
+    rxCond_.notify_all();
+}
+
+void FakeUsbSerialDdk::PushRxData(uint64_t deviceId, const std::vector<uint8_t> &data)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = ports_.find(deviceId);
+        if (iter == ports_.end()) {
+            return;
+        }
+        iter->second.rxData.insert(iter->second.rxData.end(), data.begin(), data.end());
+    }
+    rxCond_.notify_all();
+}
+
+std::vector<uint8_t> FakeUsbSerialDdk::PopTxData(uint64_t deviceId)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = ports_.find(deviceId);
+    if (iter == ports_.end()) {
+        return {};
+    }
+    std::vector<uint8_t> data;
+    data.swap(iter->second.txData);
+    return data;
+}
+
+bool FakeUsbSerialDdk::GetParams(uint64_t deviceId, UsbSerialDdkHdi::UsbSerialParams &params)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = ports_.find(deviceId);
+    if (iter == ports_.end()) {
+        return false;
+    }
+    params = iter->second.params;
+    return true;
+}
+
+int32_t FakeUsbSerialDdk::Init()
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    initialized_ = true;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::Release()
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    initialized_ = false;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::Open(
+    uint64_t deviceId, uint64_t interfaceIndex, UsbSerialDdkHdi::UsbSerialDeviceHandle &dev)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ports_.find(deviceId) == ports_.end()) {
+        return USB_SERIAL_DDK_DEVICE_NOT_FOUND;
+    }
+    dev.fd = nextHandle_++;
+    handles_[dev.fd] = deviceId;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::Close(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (handles_.erase(dev.fd) == 0) {
+            return USB_SERIAL_DDK_INVALID_PARAMETER;
+        }
+    }
+    // a reader blocked on the closed handle returns with an error
+    rxCond_.notify_all();
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::Read(
+    const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev, uint32_t bufferSize, std::vector<uint8_t> &buff)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    Port *port = FindPortLocked(dev);
+    if (port == nullptr) {
+        return USB_SERIAL_DDK_INVALID_PARAMETER;
+    }
+    if (port->rxData.empty() && port->timeout != 0) {
+        auto wait = port->timeout < 0 ? BLOCKING_READ_SLICE : std::chrono::milliseconds(port->timeout);
+        rxCond_.wait_for(lock, wait, [this, &dev] {
+            Port *current = FindPortLocked(dev);
+            return current == nullptr || !current->rxData.empty();
+        });
+        port = FindPortLocked(dev);
+        if (port == nullptr) {
+            return USB_SERIAL_DDK_IO_ERROR;
+        }
+    }
+    size_t count = std::min<size_t>(bufferSize, port->rxData.size());
+    buff.assign(port->rxData.begin(), port->rxData.begin() + count);
+    port->rxData.erase(port->rxData.begin(), port->rxData.begin() + count);
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::Write(
+    const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev, const std::vector<uint8_t> &buff, uint32_t &bytesWritten)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Port *port = FindPortLocked(dev);
+        if (port == nullptr) {
+            return USB_SERIAL_DDK_INVALID_PARAMETER;
+        }
+        port->txData.insert(port->txData.end(), buff.begin(), buff.end());
+        if (port->loopback) {
+            port->rxData.insert(port->rxData.end(), buff.begin(), buff.end());
+        }
+        bytesWritten = static_cast<uint32_t>(buff.size());
+    }
+    rxCond_.notify_all();
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::SetBaudRate(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev, uint32_t baudRate)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Port *port = FindPortLocked(dev);
+    if (port == nullptr || baudRate == 0) {
+        return USB_SERIAL_DDK_INVALID_PARAMETER;
+    }
+    port->params.baudRate = baudRate;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::SetParams(
+    const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev, const UsbSerialDdkHdi::UsbSerialParams &params)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Port *port = FindPortLocked(dev);
+    if (port == nullptr || params.baudRate == 0) {
+        return USB_SERIAL_DDK_INVALID_PARAMETER;
+    }
+    port->params = params;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::SetTimeout(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev, int32_t timeout)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Port *port = FindPortLocked(dev);
+    if (port == nullptr) {
+        return USB_SERIAL_DDK_INVALID_PARAMETER;
+    }
+    port->timeout = timeout;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::SetFlowControl(
+    const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev, UsbSerialDdkHdi::UsbSerialFlowControl flowControl)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Port *port = FindPortLocked(dev);
+    if (port == nullptr) {
+        return USB_SERIAL_DDK_INVALID_PARAMETER;
+    }
+    port->flowControl = flowControl;
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::Flush(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Port *port = FindPortLocked(dev);
+    if (port == nullptr) {
+        return USB_SERIAL_DDK_INVALID_PARAMETER;
+    }
+    port->rxData.clear();
+    port->txData.clear();
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::FlushInput(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Port *port = FindPortLocked(dev);
+    if (port == nullptr) {
+        return USB_SERIAL_DDK_INVALID_PARAMETER;
+    }
+    port->rxData.clear();
+    return HDF_SUCCESS;
+}
+
+int32_t FakeUsbSerialDdk::FlushOutput(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev)
+{
+    int32_t ret = Enter(__func__);
+    if (ret != HDF_SUCCESS) {
+        return ret;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Port *port = FindPortLocked(dev);
+    if (port == nullptr) {
+        return USB_SERIAL_DDK_INVALID_PARAMETER;
+    }
+    port->txData.clear();
+    return HDF_SUCCESS;
+}
+
+FakeUsbSerialDdk::Port *FakeUsbSerialDdk::FindPortLocked(const UsbSerialDdkHdi::UsbSerialDeviceHandle &dev)
+{
+    auto handleIter = handles_.find(dev.fd);
+    if (handleIter == handles_.end()) {
+        return nullptr;
+    }
+    auto portIter = ports_.find(handleIter->second);
+    return portIter == ports_.end() ? nullptr : &portIter->second;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -21,7 +21,7 @@
 #endif
 #include <cstdint>
 #include <string>
-#include <sys/time.h>
+#include "ext_dev_api_histogram.h"
 
 namespace OHOS {
 namespace ExternalDeviceManager {
@@ -33,7 +33,7 @@ public:
     void SetErrorCode(int32_t error);
 private:
     std::string metricsName_;
-    struct timeval startTime_;
+    uint64_t startNs_;
     int32_t errorCode_;
 };
 
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DDK_MAP_FLAGS_H
+#define DDK_MAP_FLAGS_H
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "ddk_types.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+constexpr uint32_t DDK_MAP_FLAG_ALL = DDK_MAP_FLAG_PREFAULT | DDK_MAP_FLAG_LOCK | DDK_MAP_FLAG_HUGE_PAGE;
+
+inline void PrefaultMapping(void *addr, size_t len, bool writable)
+{
+#ifdef MADV_POPULATE_WRITE
+    if (madvise(addr, len, writable ? MADV_POPULATE_WRITE : MADV_POPULATE_READ) == 0) {
+        return;
+    }
+#else
+    (void)writable;
+#endif
+    // kernels without MADV_POPULATE_*: read ahead, then fault every page in
+    (void)madvise(addr, len, MADV_WILLNEED);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    size_t step = pageSize > 0 ? static_cast<size_t>(pageSize) : 4096;
+    volatile const uint8_t *data = static_cast<const uint8_t *>(addr);
+    for (size_t offset = 0; offset < len; offset += step) {
+        (void)data[offset];
+    }
+}
+
+// Applies DDK_MapFlag options to a fresh mapping. Huge pages and pre-faulting are hints, locking is not:
+// returns 0, or the errno of a failed mlock.
+inline int32_t ApplyDdkMapFlags(void *addr, size_t len, uint32_t mapFlags, bool writable)
+{
+    if ((mapFlags & DDK_MAP_FLAG_HUGE_PAGE) != 0) {
+        // must precede the first fault; shmem THP may be disabled by the system, which is not an error
+        (void)madvise(addr, len, MADV_HUGEPAGE);
+    }
+    if ((mapFlags & DDK_MAP_FLAG_LOCK) != 0) {
+        // mlock faults every page in as well
+        return mlock(addr, len) == 0 ? 0 : errno;
+    }
+    if ((mapFlags & DDK_MAP_FLAG_PREFAULT) != 0) {
+        PrefaultMapping(addr, len, writable);
+    }
+    return 0;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // DDK_MAP_FLAGS_H
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EDM_TRACE_H
+#define EDM_TRACE_H
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "hitrace_meter.h"
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+constexpr uint64_t EDM_TRACE_LABEL = HITRACE_TAG_OHOS;
+
+// Stages of attaching a device up to the bind of its driver. The names are parsed from captured traces, do not
+// rename them. A span of a device is named "<stage> <deviceId>", the device id in 16 hex digits.
+constexpr const char *TRACE_USB_DEVICE_CONNECT = "EdmUsbDeviceConnect";
+constexpr const char *TRACE_REGISTER_DEVICE = "EdmRegisterDevice";
+constexpr const char *TRACE_QUERY_MATCH_DRIVER = "EdmQueryMatchDriver";
+constexpr const char *TRACE_PKG_DB_QUERY = "EdmPkgDbQuery";
+constexpr const char *TRACE_DEVICE_CONNECT = "EdmDeviceConnect";
+constexpr const char *TRACE_CONNECT_DRIVER_EXTENSION = "EdmConnectDriverExtension";
+constexpr const char *TRACE_START_DRIVER_EXTENSION = "EdmStartDriverExtension";
+// async, from asking the ability manager for the driver extension to its connect callback
+constexpr const char *TRACE_BIND_DRIVER = "EdmBindDriver";
+
+inline std::string EdmTraceName(const char *stage, uint64_t deviceId)
+{
+    char name[64] = {0};
+    (void)snprintf(name, sizeof(name), "%s %016" PRIx64, stage, deviceId);
+    return name;
+}
+
+// async spans of different devices may overlap, they are told apart by the task id
+inline int32_t EdmTraceTaskId(uint64_t deviceId)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(deviceId ^ (deviceId >> 32)));
+}
+
+class EdmTraceScope {
+public:
+    explicit EdmTraceScope(const char *stage)
+    {
+        StartTrace(EDM_TRACE_LABEL, stage);
+    }
+    EdmTraceScope(const char *stage, uint64_t deviceId)
+    {
+        StartTrace(EDM_TRACE_LABEL, EdmTraceName(stage, deviceId));
+    }
+    ~EdmTraceScope()
+    {
+        FinishTrace(EDM_TRACE_LABEL);
+    }
+    EdmTraceScope(const EdmTraceScope &) = delete;
+    EdmTraceScope &operator=(const EdmTraceScope &) = delete;
+};
+
+inline void EdmTraceAsyncBegin(const char *stage, uint64_t deviceId)
+{
+    StartAsyncTrace(EDM_TRACE_LABEL, EdmTraceName(stage, deviceId), EdmTraceTaskId(deviceId));
+}
+
+inline void EdmTraceAsyncEnd(const char *stage, uint64_t deviceId)
+{
+    FinishAsyncTrace(EDM_TRACE_LABEL, EdmTraceName(stage, deviceId), EdmTraceTaskId(deviceId));
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // EDM_TRACE_H
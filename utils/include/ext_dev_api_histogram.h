@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef EXT_DEV_API_HISTOGRAM_H
+#define EXT_DEV_API_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+struct ExtDevApiSnapshot {
+    std::string name;
+    uint64_t count = 0;
+    uint64_t sumNs = 0;
+    uint64_t maxNs = 0;
+    std::vector<uint64_t> buckets;
+
+    // the upper bound of the bucket the percentile falls in, at most 1/8 above the recorded value
+    uint64_t Percentile(double percentile) const;
+};
+
+// Latency of one API in nanoseconds of CLOCK_MONOTONIC. Every thread records into a shard of its own with plain
+// relaxed stores, so recording takes no lock and shares no cache line with other threads. The shards are merged
+// when a snapshot is taken, and the shard of an exiting thread is folded into a retired one and handed to the next
+// thread, so there are never more shards than threads alive at once. Each power of two is split into SUB_BUCKET_NUM
+// linear buckets.
+class ExtDevApiHistogram {
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 3;
+    static constexpr uint32_t SUB_BUCKET_NUM = 1U << SUB_BUCKET_BITS;
+    // values of 2^MAX_BITS ns, about 18 minutes, and more share the last bucket
+    static constexpr uint32_t MAX_BITS = 40;
+    static constexpr uint32_t BUCKET_NUM = (MAX_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_NUM;
+
+    explicit ExtDevApiHistogram(const std::string &name);
+    ~ExtDevApiHistogram();
+
+    // registered for GetSnapshots and Dump and never freed, callers keep the reference in a static
+    static ExtDevApiHistogram &Get(const std::string &name);
+    // all histograms registered in this library, sorted by name
+    static std::vector<ExtDevApiSnapshot> GetSnapshots();
+    static void Dump(int fd);
+    static uint64_t NowNs();
+    static uint32_t BucketOf(uint64_t ns);
+    static uint64_t BucketUpperBound(uint32_t bucket);
+
+    void Record(uint64_t ns);
+    ExtDevApiSnapshot GetSnapshot() const;
+
+private:
+    // written by one thread only
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, BUCKET_NUM> buckets {};
+        std::atomic<uint64_t> sumNs {0};
+        std::atomic<uint64_t> maxNs {0};
+    };
+    // the shards of one thread, indexed by histogram id, retired when the thread exits
+    struct ThreadShards {
+        ~ThreadShards();
+        std::vector<Shard *> shards;
+    };
+    static void Add(Shard &to, const Shard &from);
+    Shard &GetShard();
+    Shard &AddShard();
+    void RetireShard(Shard &shard);
+
+    const std::string name_;
+    // indexes the shards of each thread, never reused
+    const uint64_t id_;
+    mutable std::mutex shardMutex_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    // what the exited threads recorded, their shards are zeroed and wait in freeShards_ for a new thread
+    Shard retired_;
+    std::vector<Shard *> freeShards_;
+};
+
+class ExtDevApiTimer {
+public:
+    explicit ExtDevApiTimer(ExtDevApiHistogram &histogram)
+        : histogram_(histogram), startNs_(ExtDevApiHistogram::NowNs()) {}
+    ~ExtDevApiTimer()
+    {
+        histogram_.Record(ExtDevApiHistogram::NowNs() - startNs_);
+    }
+
+private:
+    ExtDevApiHistogram &histogram_;
+    uint64_t startNs_;
+};
+
+// times the rest of the calling function into a histogram named after it
+#define EXT_DEV_API_TIMER()                                                          \
+    static OHOS::ExternalDeviceManager::ExtDevApiHistogram &extDevApiHistogram =     \
+        OHOS::ExternalDeviceManager::ExtDevApiHistogram::Get(__func__);              \
+    OHOS::ExternalDeviceManager::ExtDevApiTimer extDevApiTimer(extDevApiHistogram)
+} // namespace ExternalDeviceManager
+} // namespace OHOS
+#endif // EXT_DEV_API_HISTOGRAM_H
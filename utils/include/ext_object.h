@@ -17,12 +17,15 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include "edm_errors.h"
 namespace OHOS {
 namespace ExternalDeviceManager {
 enum BusType : uint32_t {
     BUS_TYPE_INVALID = 0,
     BUS_TYPE_USB = 1,
+    // scripted devices for tests and benchmarks, not reported to applications
+    BUS_TYPE_VIRTUAL = 2,
     BUS_TYPE_MAX,
     BUS_TYPE_TEST,
 };
@@ -121,13 +124,14 @@ public:
         BusType busType = BusType::BUS_TYPE_INVALID,
         const std::string &description = "") : description_(description)
     {
-        devInfo_.devBusInfo.busType = busType;
+        devInfo_.deviceId = 0;
+        devInfo_.devBusInfo.busType = static_cast<uint16_t>(busType);
         devInfo_.devBusInfo.busDeviceId = busDeviceId;
     }
     virtual ~DeviceInfo() = default;
     BusType GetBusType() const
     {
-        return devInfo_.devBusInfo.busType;
+        return static_cast<BusType>(devInfo_.devBusInfo.busType);
     }
     uint64_t GetDeviceId() const
     {
@@ -141,12 +145,44 @@ public:
     {
         return description_;
     }
+    // -1 for the whole device
+    int32_t GetInterfaceNumber() const
+    {
+        return static_cast<int32_t>(devInfo_.devBusInfo.interfaceId) - 1;
+    }
+    // deviceId of the whole device an interface belongs to
+    uint64_t GetParentDeviceId() const
+    {
+        DevInfo parent = devInfo_;
+        parent.devBusInfo.interfaceId = 0;
+        return parent.deviceId;
+    }
+    // interfaces of a composite device registered as devices of their own
+    const std::vector<std::shared_ptr<DeviceInfo>>& GetInterfaceInfos() const
+    {
+        return interfaceInfos_;
+    }
+    // the bus type is the low 16 bits of any deviceId, the interface id above it is left out
+    static BusType GetBusTypeByDeviceId(uint64_t deviceId)
+    {
+        return static_cast<BusType>(deviceId & BUS_TYPE_MASK);
+    }
+
+protected:
+    void SetInterfaceNumber(uint8_t interfaceNumber)
+    {
+        devInfo_.devBusInfo.interfaceId = static_cast<uint16_t>(interfaceNumber) + 1;
+    }
+    std::vector<std::shared_ptr<DeviceInfo>> interfaceInfos_;
 
 private:
+    static constexpr uint64_t BUS_TYPE_MASK = 0xFFFF;
     union DevInfo {
         uint64_t deviceId;
         struct {
-            BusType busType;
+            uint16_t busType;
+            // interface number + 1, 0 for the whole device
+            uint16_t interfaceId;
             uint32_t busDeviceId;
         } devBusInfo;
     } devInfo_;
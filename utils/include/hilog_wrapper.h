@@ -71,6 +71,7 @@ enum UsbMgrSubModule {
     MODULE_BASE_DDK,
     MODULE_USB_SERIAL_DDK,
     MODULE_SCSIPERIPHERAL_DDK,
+    MODULE_BUS_VIRTUAL,
     EDM_MODULE_BUTT,
 };
 
@@ -98,6 +99,7 @@ static constexpr OHOS::HiviewDFX::HiLogLabel EDM_MGR_LABEL[EDM_MODULE_BUTT] = {
     { LOG_CORE, EDM_DDK_DOMAIN, "EdmBaseDdk" },
     { LOG_CORE, EDM_DDK_DOMAIN, "EdmUsbSerialDdk" },
     { LOG_CORE, EDM_DDK_DOMAIN, "EdmScsiDdk" },
+    { LOG_CORE, EDM_FRAMEWORK_DOMAIN, "EdmBusVirtualMgr" },
 };
 
 #ifndef EDM_FILENAME
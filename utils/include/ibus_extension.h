@@ -17,6 +17,7 @@
 #define IUSB_EXTENSION_H
 #include <vector>
 #include <map>
+#include <string>
 #include "ext_object.h"
 #include "idev_change_callback.h"
 #include "idriver_change_callback.h"
@@ -33,6 +34,16 @@ public:
     virtual int32_t SetDevChangeCallback(shared_ptr<IDevChangeCallback> callback) = 0;
     virtual BusType GetBusType() = 0;
     virtual shared_ptr<IDriverChangeCallback> AcquireDriverChangeCallback() = 0;
+    // Keys for narrowing a re-match down: a driver can only match devices that share one of its keys.
+    // Returns false if the bus does not support it, then every device has to be tried.
+    virtual bool GetMatchKeys(const DeviceInfo &device, vector<string> &keys)
+    {
+        return false;
+    }
+    virtual bool GetMatchKeys(const DriverInfo &driver, vector<string> &keys)
+    {
+        return false;
+    }
 };
 }
 }
@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ext_dev_api_histogram.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <map>
+
+namespace OHOS {
+namespace ExternalDeviceManager {
+static constexpr uint64_t NS_PER_SECOND = 1000000000;
+static constexpr double NS_PER_US = 1000.0;
+static constexpr double P50 = 0.5;
+static constexpr double P90 = 0.9;
+static constexpr double P99 = 0.99;
+
+static std::atomic<uint64_t> g_nextHistogramId {0};
+
+struct HistogramRegistry {
+    std::mutex mutex;
+    std::map<std::string, ExtDevApiHistogram *> histograms;
+};
+
+// the histograms not destroyed yet, by id, so an exiting thread only retires its shards into those
+struct LiveHistograms {
+    std::mutex mutex;
+    std::map<uint64_t, ExtDevApiHistogram *> histograms;
+};
+
+// never freed, an API may still be called while the library is being unloaded
+static HistogramRegistry &GetRegistry()
+{
+    static auto registry = new HistogramRegistry();
+    return *registry;
+}
+
+// never freed, a thread may exit after the static destructors ran
+static LiveHistograms &GetLiveHistograms()
+{
+    static auto live = new LiveHistograms();
+    return *live;
+}
+
+uint64_t ExtDevApiSnapshot::Percentile(double percentile) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile * count));
+    rank = rank == 0 ? 1 : rank;
+    uint64_t seen = 0;
+    for (uint32_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            return std::min(ExtDevApiHistogram::BucketUpperBound(bucket), maxNs);
+        }
+    }
+    return maxNs;
+}
+
+ExtDevApiHistogram::ExtDevApiHistogram(const std::string &name) : name_(name), id_(g_nextHistogramId++)
+{
+    LiveHistograms &live = GetLiveHistograms();
+    std::lock_guard<std::mutex> lock(live.mutex);
+    live.histograms.emplace(id_, this);
+}
+
+ExtDevApiHistogram::~ExtDevApiHistogram()
+{
+    LiveHistograms &live = GetLiveHistograms();
+    std::lock_guard<std::mutex> lock(live.mutex);
+    live.histograms.erase(id_);
+}
+
+ExtDevApiHistogram &ExtDevApiHistogram::Get(const std::string &name)
+{
+    HistogramRegistry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto iter = registry.histograms.find(name);
+    if (iter == registry.histograms.end()) {
+        iter = registry.histograms.emplace(name, new ExtDevApiHistogram(name)).first;
+    }
+    return *iter->second;
+}
+
+std::vector<ExtDevApiSnapshot> ExtDevApiHistogram::GetSnapshots()
+{
+    HistogramRegistry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::vector<ExtDevApiSnapshot> snapshots;
+    for (const auto &[_, histogram] : registry.histograms) {
+        snapshots.push_back(histogram->GetSnapshot());
+    }
+    return snapshots;
+}
+
+void ExtDevApiHistogram::Dump(int fd)
+{
+    dprintf(fd, "api latency, in microseconds:\n");
+    for (const auto &snapshot : GetSnapshots()) {
+        if (snapshot.count == 0) {
+            continue;
+        }
+        dprintf(fd, "  %-40s count %8" PRIu64 "  mean %10.1f  p50 %10.1f  p90 %10.1f  p99 %10.1f  max %10.1f\n",
+            snapshot.name.c_str(), snapshot.count, snapshot.sumNs / NS_PER_US / snapshot.count,
+            snapshot.Percentile(P50) / NS_PER_US, snapshot.Percentile(P90) / NS_PER_US,
+            snapshot.Percentile(P99) / NS_PER_US, snapshot.maxNs / NS_PER_US);
+    }
+}
+
+uint64_t ExtDevApiHistogram::NowNs()
+{
+    struct timespec now = {0, 0};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * NS_PER_SECOND + static_cast<uint64_t>(now.tv_nsec);
+}
+
+uint32_t ExtDevApiHistogram::BucketOf(uint64_t ns)
+{
+    // below SUB_BUCKET_NUM every value has a bucket of its own
+    if (ns < SUB_BUCKET_NUM) {
+        return static_cast<uint32_t>(ns);
+    }
+    uint32_t msb = 63 - static_cast<uint32_t>(__builtin_clzll(ns));
+    if (msb >= MAX_BITS) {
+        return BUCKET_NUM - 1;
+    }
+    uint32_t shift = msb - SUB_BUCKET_BITS;
+    uint32_t sub = static_cast<uint32_t>(ns >> shift) & (SUB_BUCKET_NUM - 1);
+    return (shift + 1) * SUB_BUCKET_NUM + sub;
+}
+
+uint64_t ExtDevApiHistogram::BucketUpperBound(uint32_t bucket)
+{
+    if (bucket < SUB_BUCKET_NUM) {
+        return bucket;
+    }
+    uint32_t shift = bucket / SUB_BUCKET_NUM - 1;
+    uint64_t lower = static_cast<uint64_t>(SUB_BUCKET_NUM + bucket % SUB_BUCKET_NUM) << shift;
+    return lower + (1ULL << shift) - 1;
+}
+
+void ExtDevApiHistogram::Record(uint64_t ns)
+{
+    Shard &shard = GetShard();
+    // only this thread writes the shard, a load and a store need no read-modify-write
+    std::atomic<uint64_t> &bucket = shard.buckets[BucketOf(ns)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    shard.sumNs.store(shard.sumNs.load(std::memory_order_relaxed) + ns, std::memory_order_relaxed);
+    if (ns > shard.maxNs.load(std::memory_order_relaxed)) {
+        shard.maxNs.store(ns, std::memory_order_relaxed);
+    }
+}
+
+ExtDevApiHistogram::ThreadShards::~ThreadShards()
+{
+    LiveHistograms &live = GetLiveHistograms();
+    std::lock_guard<std::mutex> lock(live.mutex);
+    for (uint64_t id = 0; id < shards.size(); ++id) {
+        if (shards[id] == nullptr) {
+            continue;
+        }
+        auto iter = live.histograms.find(id);
+        if (iter != live.histograms.end()) {
+            iter->second->RetireShard(*shards[id]);
+        }
+    }
+}
+
+void ExtDevApiHistogram::Add(Shard &to, const Shard &from)
+{
+    for (uint32_t i = 0; i < BUCKET_NUM; ++i) {
+        to.buckets[i].store(to.buckets[i].load(std::memory_order_relaxed) +
+            from.buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    to.sumNs.store(to.sumNs.load(std::memory_order_relaxed) + from.sumNs.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    to.maxNs.store(std::max(to.maxNs.load(std::memory_order_relaxed), from.maxNs.load(std::memory_order_relaxed)),
+        std::memory_order_relaxed);
+}
+
+ExtDevApiHistogram::Shard &ExtDevApiHistogram::GetShard()
+{
+    thread_local ThreadShards threadShards;
+    std::vector<Shard *> &shards = threadShards.shards;
+    if (id_ < shards.size() && shards[id_] != nullptr) {
+        return *shards[id_];
+    }
+    Shard &shard = AddShard();
+    if (id_ >= shards.size()) {
+        shards.resize(id_ + 1, nullptr);
+    }
+    shards[id_] = &shard;
+    return shard;
+}
+
+ExtDevApiHistogram::Shard &ExtDevApiHistogram::AddShard()
+{
+    std::lock_guard<std::mutex> lock(shardMutex_);
+    if (!freeShards_.empty()) {
+        Shard *shard = freeShards_.back();
+        freeShards_.pop_back();
+        return *shard;
+    }
+    shards_.push_back(std::make_unique<Shard>());
+    return *shards_.back();
+}
+
+// the thread owning the shard is exiting, nothing writes it any more
+void ExtDevApiHistogram::RetireShard(Shard &shard)
+{
+    std::lock_guard<std::mutex> lock(shardMutex_);
+    Add(retired_, shard);
+    for (auto &bucket : shard.buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    shard.sumNs.store(0, std::memory_order_relaxed);
+    shard.maxNs.store(0, std::memory_order_relaxed);
+    freeShards_.push_back(&shard);
+}
+
+ExtDevApiSnapshot ExtDevApiHistogram::GetSnapshot() const
+{
+    ExtDevApiSnapshot snapshot;
+    snapshot.name = name_;
+    snapshot.buckets.assign(BUCKET_NUM, 0);
+    std::lock_guard<std::mutex> lock(shardMutex_);
+    Shard merged;
+    Add(merged, retired_);
+    for (const auto &shard : shards_) {
+        Add(merged, *shard);
+    }
+    for (uint32_t i = 0; i < BUCKET_NUM; ++i) {
+        snapshot.buckets[i] = merged.buckets[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.sumNs = merged.sumNs.load(std::memory_order_relaxed);
+    snapshot.maxNs = merged.maxNs.load(std::memory_order_relaxed);
+    return snapshot;
+}
+} // namespace ExternalDeviceManager
+} // namespace OHOS
@@ -16,7 +16,7 @@
 #include "ext_dev_api_metrics.h"
 #include <vector>
 
-#define TIME_1000 1000
+#define NS_PER_MS 1000000
 #define ERROR_CODE_BOUNDARY 8
 
 namespace OHOS {
@@ -49,11 +49,13 @@ ExtDevApiMetrics::ExtDevApiMetrics(std::string name)
     : metricsName_(name)
 {
     errorCode_ = 0;
-    gettimeofday(&startTime_, nullptr);
+    startNs_ = ExtDevApiHistogram::NowNs();
 }
 
 ExtDevApiMetrics::~ExtDevApiMetrics()
 {
+    uint64_t runTimeNs = ExtDevApiHistogram::NowNs() - startNs_;
+    ExtDevApiHistogram::Get(metricsName_).Record(runTimeNs);
 #ifdef EDM_MANAGER_METRICS_ENABLE
     std::string boolMetricsName = metricsName_ + ".Boolean";
     std::string enumMetricsName = metricsName_ + ".Enum";
@@ -63,10 +65,7 @@ ExtDevApiMetrics::~ExtDevApiMetrics()
     } else {
         HISTOGRAM_BOOLEAN(boolMetricsName.c_str(), 0);
     }
-    struct timeval endTime;
-    gettimeofday(&endTime, nullptr);
-    int32_t runTime = (int32_t)((endTime.tv_sec - startTime_.tv_sec) * TIME_1000 +
-        (endTime.tv_usec - startTime_.tv_usec) / TIME_1000);
+    int32_t runTime = static_cast<int32_t>(runTimeNs / NS_PER_MS);
     HISTOGRAM_TIMES(timeMetricsName.c_str(), runTime);
     HISTOGRAM_ENUMERATION(enumMetricsName.c_str(), errorCode_, ERROR_CODE_BOUNDARY);
 #endif